@@ -22,13 +22,14 @@
 #include <memory>
 #include <vector>
 #include <string>
-#include <stack>
 
 #include "cleaner/ast/declarations/variable.h"
 #include "cleaner/ast/definitions/variable.h"
 #include "cleaner/symbols/scope.forward.h"
 #include "cleaner/ast/declarations/type.h"
 #include "cleaner/ast/statements/block.h"
+#include "common/native.h"
+#include "common/memo.h"
 
 
 struct CleanFunctionDefinition
@@ -39,7 +40,14 @@ struct CleanFunctionDefinition
     ) : name(name),
         scope(scope),
         return_type(nullptr),
-        body(nullptr)
+        body(nullptr),
+        is_intrinsic(false),
+        frame_size(0),
+        is_pure(false),
+        memo(nullptr),
+        compiled(nullptr),
+        invocations(0),
+        back_edges(0)
     {}
 
     std::string name;
@@ -48,7 +56,21 @@ struct CleanFunctionDefinition
         std::unique_ptr<CleanVariableDeclaration>> parameters;
     std::unique_ptr<CleanTypeDeclaration> return_type;
     std::unique_ptr<CleanBlockStatement> body;
-    std::stack<std::unique_ptr<CleanVariableDefinition>> stack_frame;
+    bool is_intrinsic;
+    std::size_t frame_size;
+
+    // Set by the purity analysis, declared by intrinsics
+    bool is_pure;
+
+    // Cached results when pure functions are memoized
+    std::unique_ptr<MemoTable> memo;
+
+    // Set by the JIT, machine code the interpreter runs instead of the body
+    CompiledFunction compiled;
+
+    // Counted by the interpreter when tiering, to find the functions worth compiling
+    std::size_t invocations;
+    std::size_t back_edges;
 };
 
 #endif
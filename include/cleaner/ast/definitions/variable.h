@@ -19,6 +19,7 @@
 #define PROTO_AST_CLEAN_VARIABLE_DEFINITION_H
 
 #include <utility>
+#include <cstddef>
 #include <memory>
 #include <string>
 
@@ -34,12 +35,14 @@ struct CleanVariableDefinition
         std::unique_ptr<CleanExpression>&& initializer
     ) : name(name),
         type(std::move(type)),
-        initializer(std::move(initializer))
+        initializer(std::move(initializer)),
+        slot(0)
     {}
 
     std::string name;
     std::unique_ptr<CleanTypeDeclaration> type;
     std::unique_ptr<CleanExpression> initializer;
+    std::size_t slot;
 };
 
 #endif
@@ -20,6 +20,7 @@
 
 #include <functional>
 #include <cstdint>
+#include <cstddef>
 #include <utility>
 #include <memory>
 #include <vector>
@@ -27,8 +28,13 @@
 
 #include "cleaner/ast/statements/statement.h"
 #include "cleaner/symbols/scope.forward.h"
+#include "common/operation.h"
+#include "common/native.h"
+#include "common/value.h"
 
 
+struct CleanFunctionDefinition;
+
 enum class CleanExpressionType {
     Boolean,
     SignedInt,
@@ -40,7 +46,8 @@ enum class CleanExpressionType {
     Call,
     TernaryIf,
     Assignment,
-    Intrinsic
+    Intrinsic,
+    Operation
 };
 
 struct CleanExpression : public CleanStatement
@@ -287,10 +294,17 @@ struct CleanVariableExpression : public CleanExpression
     CleanVariableExpression(
         std::string const& var_name
     ) : CleanExpression(CleanExpressionType::Variable),
-        var_name(var_name)
+        var_name(var_name),
+        depth(0),
+        slot(0)
     {}
 
     std::string var_name;
+
+    // Set by the resolver: the number of frames to walk up from
+    // the current one and the index of the variable in that frame
+    std::size_t depth;
+    std::size_t slot;
 };
 
 struct CleanGroupExpression : public CleanExpression
@@ -309,11 +323,19 @@ struct CleanCallExpression : public CleanExpression
     CleanCallExpression(
         std::string const& fun_name
     ) : CleanExpression(CleanExpressionType::Call),
-        fun_name(fun_name)
+        fun_name(fun_name),
+        is_tail_call(false),
+        fun_def(nullptr)
     {}
 
     std::string fun_name;
     std::vector<std::unique_ptr<CleanExpression>> arguments;
+
+    // Set by the cleaner: the caller returns the result of the call as is
+    bool is_tail_call;
+
+    // Set by the linker: the function called
+    CleanFunctionDefinition* fun_def;
 };
 
 struct CleanTernaryIfExpression : public CleanExpression
@@ -340,26 +362,48 @@ struct CleanAssignmentExpression : public CleanExpression
         std::unique_ptr<CleanExpression> rvalue
     ) : CleanExpression(CleanExpressionType::Assignment),
         lvalue(std::move(lvalue)),
-        rvalue(std::move(rvalue))
+        rvalue(std::move(rvalue)),
+        is_initializer(false)
     {}
 
     std::unique_ptr<CleanExpression> lvalue;
     std::unique_ptr<CleanExpression> rvalue;
+
+    // Set by the cleaner: the assignment gives a variable definition its first value
+    bool is_initializer;
 };
 
 struct CleanIntrinsicExpression : public CleanExpression
 {
     CleanIntrinsicExpression(
-        std::function<
-            std::unique_ptr<CleanExpression>(CleanScope* scope)
-        > callable
+        NativeFunction callable,
+        std::size_t arity
     ) : CleanExpression(CleanExpressionType::Intrinsic),
-        callable(std::move(callable))
+        callable(callable),
+        arity(arity)
     {}
 
-    std::function<
-        std::unique_ptr<CleanExpression>(CleanScope* scope)
-    > callable;
+    NativeFunction callable;
+    std::size_t arity;
 };
 
+struct CleanOperationExpression : public CleanExpression
+{
+    CleanOperationExpression(
+        enum Operation operation
+    ) : CleanExpression(CleanExpressionType::Operation),
+        operation(operation)
+    {}
+
+    enum Operation operation;
+    std::vector<std::unique_ptr<CleanExpression>> operands;
+};
+
+
+/**
+ * Returns a deep copy of the given expression.
+ */
+std::unique_ptr<CleanExpression>
+copy(CleanExpression* expr);
+
 #endif
@@ -18,11 +18,15 @@
 #ifndef PROTO_AST_CLEAN_FOR_STATEMENT_H
 #define PROTO_AST_CLEAN_FOR_STATEMENT_H
 
+#include <cstdbool>
+#include <cstdint>
+#include <cstddef>
 #include <utility>
 #include <memory>
 
 #include "cleaner/ast/expressions/expression.h"
 #include "cleaner/symbols/scope.forward.h"
+#include "common/operation.h"
 #include "statement.h"
 #include "block.h"
 
@@ -40,7 +44,13 @@ struct CleanForStatement : public CleanStatement
         term_clause(std::move(term_clause)),
         incr_clause(std::move(incr_clause)),
         body(std::move(body)),
-        scope(scope)
+        scope(scope),
+        is_counted(false),
+        counter_slot(0),
+        counter_step(0),
+        counter_test(Operation::LtI64),
+        counter_bound(nullptr),
+        is_bound_invariant(false)
     {}
 
     std::unique_ptr<CleanExpression> init_clause;
@@ -48,6 +58,15 @@ struct CleanForStatement : public CleanStatement
     std::unique_ptr<CleanExpression> incr_clause;
     std::unique_ptr<CleanBlockStatement> body;
     std::shared_ptr<CleanScope> scope;
+
+    // Set by the hoister: the loop steps a local integer by a constant
+    // and stops once comparing it to the bound fails, nothing else assigns it
+    bool is_counted;
+    std::size_t counter_slot;
+    int64_t counter_step;
+    enum Operation counter_test;            /* Counter on the left, bound on the right. */
+    CleanExpression* counter_bound;         /* Owned by the termination clause. */
+    bool is_bound_invariant;                /* Whether the bound can be computed once. */
 };
 
 #endif
@@ -18,6 +18,8 @@
 #ifndef PROTO_AST_CLEAN_STATEMENT_H
 #define PROTO_AST_CLEAN_STATEMENT_H
 
+#include "common/token.h"
+
 
 enum class CleanStatementType {
     Block,
@@ -41,6 +43,9 @@ struct CleanStatement
     {}
 
     enum CleanStatementType type;
+
+    // Set by the cleaner on statements in blocks: where the statement starts
+    Token token;
 };
 
 #endif
@@ -25,6 +25,7 @@
 #include "parsetree/statements/statement.h"
 #include "parsetree/statements/statement.h"
 #include "cleaner/symbols/scope.forward.h"
+#include "parsetree/definitions/variable.h"
 #include "parsetree/statements/continue.h"
 #include "cleaner/ast/statements/return.h"
 #include "cleaner/ast/statements/while.h"
@@ -89,11 +90,20 @@ class StatementCleaner
             std::shared_ptr<CleanScope> const& scope
         );
 
+        // Tail calls: marks calls whose result is returned as is
+        void markTailCalls(CleanExpression* expr);
+
         // Expression
         std::unique_ptr<CleanExpression> cleanExpression(
             Expression* expression_stmt,
             std::shared_ptr<CleanScope> const& scope
         );
+
+        // Initializer: assigns a variable definition its initial value
+        std::unique_ptr<CleanExpression> cleanInitializer(
+            VariableDefinition* var_def,
+            std::shared_ptr<CleanScope> const& scope
+        );
 };
 
 #endif
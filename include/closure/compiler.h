@@ -0,0 +1,120 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef PROTO_CLOSURE_COMPILER_H
+#define PROTO_CLOSURE_COMPILER_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <map>
+
+#include "cleaner/ast/expressions/expression.h"
+#include "cleaner/ast/definitions/function.h"
+#include "cleaner/ast/statements/statement.h"
+#include "cleaner/ast/statements/return.h"
+#include "cleaner/ast/statements/while.h"
+#include "cleaner/ast/statements/block.h"
+#include "cleaner/ast/statements/for.h"
+#include "cleaner/ast/statements/if.h"
+#include "cleaner/symbols/scope.h"
+#include "closure/node.h"
+
+
+/**
+ * A whole program compiled to closure nodes.
+ *
+ * Strings referenced by constants are owned by the AST
+ * so the AST must outlive the program.
+ */
+struct ClosureProgram
+{
+    ClosureProgram(
+    ) : main(nullptr)
+    {}
+
+    std::vector<std::unique_ptr<ClosureFunction>> functions;
+    std::vector<std::unique_ptr<ExpressionNode>> globals;
+    ClosureFunction* main;
+};
+
+class ClosureCompiler
+{
+    public:
+        ClosureCompiler(CleanScope* scope);
+
+        /**
+         * Compiles every user function in the global scope to closure nodes.
+         *
+         * The program must have gone through the resolver and the linker.
+         */
+        ClosureProgram compile();
+
+    private:
+        CleanScope* scope;                  /* The global scope. */
+        ClosureProgram program;             /* The program being compiled. */
+
+        /* User functions by the definition they were compiled from. */
+        std::map<CleanFunctionDefinition*, ClosureFunction*> functions;
+
+        // Statements
+        std::unique_ptr<StatementNode> compileStatement(CleanStatement* stmt);
+
+        // Blocks
+        std::unique_ptr<StatementNode> compileBlock(CleanBlockStatement* block_stmt);
+
+        // If
+        std::unique_ptr<StatementNode> compileIf(CleanIfStatement* if_stmt);
+
+        // For
+        std::unique_ptr<StatementNode> compileFor(CleanForStatement* for_stmt);
+        template <typename Test>
+        std::unique_ptr<StatementNode> compileCountedFor(CleanForStatement* for_stmt);
+
+        // While
+        std::unique_ptr<StatementNode> compileWhile(CleanWhileStatement* while_stmt);
+
+        // Return
+        std::unique_ptr<StatementNode> compileReturn(CleanReturnStatement* ret_stmt);
+
+        // Returned expressions: branches leading to tail calls become statements
+        std::unique_ptr<StatementNode> compileReturnedExpression(CleanExpression* expr);
+
+        // Expressions
+        std::unique_ptr<ExpressionNode> compileExpression(CleanExpression* expr);
+
+        // Variables
+        std::unique_ptr<ExpressionNode> compileVariable(
+            CleanVariableExpression* var_expr);
+
+        // Calls
+        std::unique_ptr<ExpressionNode> compileCall(CleanCallExpression* call_expr);
+
+        // Ternary if
+        std::unique_ptr<ExpressionNode> compileTernaryIf(
+            CleanTernaryIfExpression* ternif_expr);
+
+        // Assignments
+        std::unique_ptr<ExpressionNode> compileAssignment(
+            CleanAssignmentExpression* assign_expr);
+
+        // Operations
+        std::unique_ptr<ExpressionNode> compileOperation(
+            CleanOperationExpression* op_expr);
+};
+
+#endif
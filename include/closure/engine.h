@@ -0,0 +1,45 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef PROTO_CLOSURE_ENGINE_H
+#define PROTO_CLOSURE_ENGINE_H
+
+#include <cstddef>
+
+#include "closure/compiler.h"
+
+
+class ClosureEngine
+{
+    public:
+        ClosureEngine(ClosureProgram& program);
+
+        /**
+         * Runs the program starting with its main function.
+         */
+        int run();
+
+    private:
+        // Number of slots the call stack starts with and grows by,
+        // and the number it may hold at most before calls overflow it
+        static constexpr std::size_t stack_segment = 1 << 16;
+        static constexpr std::size_t stack_limit = 1 << 26;
+
+        ClosureProgram& program;
+};
+
+#endif
@@ -0,0 +1,437 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef PROTO_CLOSURE_NODE_H
+#define PROTO_CLOSURE_NODE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <memory>
+#include <vector>
+
+#include "interpreter/frame.h"
+#include "common/operation.h"
+#include "common/native.h"
+#include "common/value.h"
+#include "common/memo.h"
+
+
+/* How a statement finished, replaces the interpreter's control flow flags. */
+enum class Completion {
+    Normal,
+    Break,
+    Continue,
+    Return,
+    TailCall
+};
+
+struct ClosureFunction;
+
+/* What a function body leaves behind when it completes. */
+struct Result
+{
+    Result(
+    ) : tail_callee(nullptr)
+    {}
+
+    Value value;                        /* The returned value. */
+    ClosureFunction* tail_callee;       /* The function tail called, if any. */
+};
+
+/**
+ * An expression compiled once into a node that evaluates itself.
+ *
+ * Variables, call targets and operations are bound when the node is built.
+ */
+struct ExpressionNode
+{
+    virtual ~ExpressionNode() = default;
+
+    virtual Value eval(Frame& frame) = 0;
+};
+
+/**
+ * A statement compiled once into a node that executes itself.
+ *
+ * Return statements leave their value in the given result.
+ */
+struct StatementNode
+{
+    virtual ~StatementNode() = default;
+
+    virtual Completion exec(Frame& frame, Result& result) = 0;
+};
+
+/**
+ * A user function compiled to closure nodes.
+ */
+struct ClosureFunction
+{
+    ClosureFunction(
+        std::size_t frame_size,
+        MemoTable* memo
+    ) : frame_size(frame_size),
+        memo(memo)
+    {}
+
+    std::size_t frame_size;
+    std::unique_ptr<StatementNode> body;
+    MemoTable* memo;                    /* Cached results, null unless memoized. */
+};
+
+/**
+ * Runs the given function in the given frame, following its tail calls.
+ */
+Value runFunction(ClosureFunction* fun, Frame& frame);
+
+/* Expressions */
+
+struct ConstantNode : public ExpressionNode
+{
+    ConstantNode(
+        Value value
+    ) : value(value)
+    {}
+
+    Value eval(Frame& frame) override;
+
+    Value value;
+};
+
+struct LocalNode : public ExpressionNode
+{
+    LocalNode(
+        std::size_t slot
+    ) : slot(slot)
+    {}
+
+    Value eval(Frame& frame) override;
+
+    std::size_t slot;
+};
+
+struct GlobalNode : public ExpressionNode
+{
+    GlobalNode(
+        std::size_t slot
+    ) : slot(slot)
+    {}
+
+    Value eval(Frame& frame) override;
+
+    std::size_t slot;
+};
+
+struct AssignLocalNode : public ExpressionNode
+{
+    AssignLocalNode(
+        std::size_t slot,
+        std::unique_ptr<ExpressionNode>&& rvalue
+    ) : slot(slot),
+        rvalue(std::move(rvalue))
+    {}
+
+    Value eval(Frame& frame) override;
+
+    std::size_t slot;
+    std::unique_ptr<ExpressionNode> rvalue;
+};
+
+struct AssignGlobalNode : public ExpressionNode
+{
+    AssignGlobalNode(
+        std::size_t slot,
+        std::unique_ptr<ExpressionNode>&& rvalue
+    ) : slot(slot),
+        rvalue(std::move(rvalue))
+    {}
+
+    Value eval(Frame& frame) override;
+
+    std::size_t slot;
+    std::unique_ptr<ExpressionNode> rvalue;
+};
+
+struct CallNode : public ExpressionNode
+{
+    CallNode(
+        ClosureFunction* callee
+    ) : callee(callee)
+    {}
+
+    Value eval(Frame& frame) override;
+
+    ClosureFunction* callee;
+    std::vector<std::unique_ptr<ExpressionNode>> arguments;
+};
+
+struct NativeCallNode : public ExpressionNode
+{
+    NativeCallNode(
+        NativeFunction callable
+    ) : callable(callable)
+    {}
+
+    Value eval(Frame& frame) override;
+
+    NativeFunction callable;
+    std::vector<std::unique_ptr<ExpressionNode>> arguments;
+};
+
+struct TernaryIfNode : public ExpressionNode
+{
+    TernaryIfNode(
+        std::unique_ptr<ExpressionNode>&& condition,
+        std::unique_ptr<ExpressionNode>&& then_branch,
+        std::unique_ptr<ExpressionNode>&& else_branch
+    ) : condition(std::move(condition)),
+        then_branch(std::move(then_branch)),
+        else_branch(std::move(else_branch))
+    {}
+
+    Value eval(Frame& frame) override;
+
+    std::unique_ptr<ExpressionNode> condition;
+    std::unique_ptr<ExpressionNode> then_branch;
+    std::unique_ptr<ExpressionNode> else_branch;
+};
+
+struct UnaryOperationNode : public ExpressionNode
+{
+    UnaryOperationNode(
+        enum Operation operation,
+        std::unique_ptr<ExpressionNode>&& operand
+    ) : operation(operation),
+        operand(std::move(operand))
+    {}
+
+    Value eval(Frame& frame) override;
+
+    enum Operation operation;
+    std::unique_ptr<ExpressionNode> operand;
+};
+
+/* Operands a binary operation evaluates through their own node. */
+struct NodeOperand
+{
+    NodeOperand(
+        std::unique_ptr<ExpressionNode>&& node
+    ) : node(std::move(node))
+    {}
+
+    Value read(Frame& frame)
+    {
+        return node->eval(frame);
+    }
+
+    std::unique_ptr<ExpressionNode> node;
+};
+
+/* Operands a binary operation reads from a local slot. */
+struct LocalOperand
+{
+    LocalOperand(
+        std::size_t slot
+    ) : slot(slot)
+    {}
+
+    Value read(Frame& frame)
+    {
+        return frame.slots[slot];
+    }
+
+    std::size_t slot;
+};
+
+/* Operands a binary operation holds as a constant. */
+struct ConstantOperand
+{
+    ConstantOperand(
+        Value value
+    ) : value(value)
+    {}
+
+    Value read(Frame& /* frame */)
+    {
+        return value;
+    }
+
+    Value value;
+};
+
+/**
+ * A binary operation known when the node is built, so evaluating it
+ * applies that operation directly instead of selecting it at every run.
+ *
+ * Locals and constants are read in place rather than through a node of their own.
+ */
+template <enum Operation operation, typename Left, typename Right>
+struct BinaryOperationNode : public ExpressionNode
+{
+    BinaryOperationNode(
+        Left&& left,
+        Right&& right
+    ) : left(std::move(left)),
+        right(std::move(right))
+    {}
+
+    Value eval(Frame& frame) override
+    {
+        Value left_value = left.read(frame);
+        return applyOperation(operation, left_value, right.read(frame));
+    }
+
+    Left left;
+    Right right;
+};
+
+/* Statements */
+
+struct BlockNode : public StatementNode
+{
+    Completion exec(Frame& frame, Result& result) override;
+
+    std::vector<std::unique_ptr<StatementNode>> statements;
+};
+
+struct IfNode : public StatementNode
+{
+    Completion exec(Frame& frame, Result& result) override;
+
+    /* The main branch followed by elif branches. */
+    std::vector<std::unique_ptr<ExpressionNode>> conditions;
+    std::vector<std::unique_ptr<StatementNode>> bodies;
+    std::unique_ptr<StatementNode> else_body;
+};
+
+struct ForNode : public StatementNode
+{
+    Completion exec(Frame& frame, Result& result) override;
+
+    std::unique_ptr<ExpressionNode> init_clause;
+    std::unique_ptr<ExpressionNode> term_clause;
+    std::unique_ptr<ExpressionNode> incr_clause;
+    std::unique_ptr<StatementNode> body;
+};
+
+/**
+ * A for loop that steps a local integer by a constant until comparing it
+ * to the bound fails. The bound is computed once when it is invariant.
+ */
+template <typename Test>
+struct CountedForNode : public StatementNode
+{
+    CountedForNode(
+        std::size_t slot,
+        int64_t step,
+        bool is_bound_invariant
+    ) : slot(slot),
+        step(step),
+        is_bound_invariant(is_bound_invariant)
+    {}
+
+    Completion exec(Frame& frame, Result& result) override
+    {
+        if (init_clause)
+            init_clause->eval(frame);
+
+        Value& counter = frame.slots[slot];
+        int64_t bound_value = is_bound_invariant ? bound->eval(frame).as_int : 0;
+        Test test;
+        while (true) {
+            if (! is_bound_invariant)
+                bound_value = bound->eval(frame).as_int;
+            if (! test(counter.as_int, bound_value))
+                break;
+
+            Completion completion = body->exec(frame, result);
+            if (completion == Completion::Break)
+                break;
+            if (completion == Completion::Return || completion == Completion::TailCall)
+                return completion;
+
+            counter.as_int += step;
+        }
+
+        return Completion::Normal;
+    }
+
+    std::size_t slot;
+    int64_t step;
+    bool is_bound_invariant;
+    std::unique_ptr<ExpressionNode> init_clause;
+    std::unique_ptr<ExpressionNode> bound;
+    std::unique_ptr<StatementNode> body;
+};
+
+struct WhileNode : public StatementNode
+{
+    Completion exec(Frame& frame, Result& result) override;
+
+    std::unique_ptr<ExpressionNode> condition;
+    std::unique_ptr<StatementNode> body;
+};
+
+struct BreakNode : public StatementNode
+{
+    Completion exec(Frame& frame, Result& result) override;
+};
+
+struct ContinueNode : public StatementNode
+{
+    Completion exec(Frame& frame, Result& result) override;
+};
+
+struct ReturnNode : public StatementNode
+{
+    ReturnNode(
+        std::unique_ptr<ExpressionNode>&& expression
+    ) : expression(std::move(expression))
+    {}
+
+    Completion exec(Frame& frame, Result& result) override;
+
+    std::unique_ptr<ExpressionNode> expression;
+};
+
+struct TailCallNode : public StatementNode
+{
+    TailCallNode(
+        ClosureFunction* callee
+    ) : callee(callee)
+    {}
+
+    Completion exec(Frame& frame, Result& result) override;
+
+    ClosureFunction* callee;
+    std::vector<std::unique_ptr<ExpressionNode>> arguments;
+};
+
+struct ExpressionStatementNode : public StatementNode
+{
+    ExpressionStatementNode(
+        std::unique_ptr<ExpressionNode>&& expression
+    ) : expression(std::move(expression))
+    {}
+
+    Completion exec(Frame& frame, Result& result) override;
+
+    std::unique_ptr<ExpressionNode> expression;
+};
+
+#endif
@@ -0,0 +1,74 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef PROTO_COMMON_MEMO_H
+#define PROTO_COMMON_MEMO_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "common/value.h"
+
+
+/**
+ * A bounded cache of the results of a pure function.
+ *
+ * Entries are keyed on the bits of the arguments. All calls to a function
+ * pass arguments of the same types so the bits alone identify them.
+ * An entry replaces whichever entry hashed to the same place,
+ * so the cache never grows past its capacity.
+ */
+class MemoTable
+{
+    public:
+        MemoTable(std::size_t arity, std::size_t capacity);
+
+        /**
+         * Returns the cached result for the given arguments, null if there is none.
+         */
+        Value const* find(Value const* arguments);
+
+        /**
+         * Caches the result of a call with the given arguments.
+         */
+        void insert(Value const* arguments, Value result);
+
+        /**
+         * Returns the number of lookups that found a cached result.
+         */
+        std::size_t getHits() const;
+
+        /**
+         * Returns the number of lookups that didn't find a cached result.
+         */
+        std::size_t getMisses() const;
+
+    private:
+        std::size_t arity;
+        std::size_t capacity;
+        std::vector<uint64_t> keys;         /* The arguments of every entry, arity per entry. */
+        std::vector<Value> results;
+        std::vector<bool> used;
+        std::size_t hits;
+        std::size_t misses;
+
+        // The entry the given arguments hash to
+        std::size_t indexOf(Value const* arguments) const;
+};
+
+#endif
@@ -0,0 +1,61 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef PROTO_COMMON_NATIVE_H
+#define PROTO_COMMON_NATIVE_H
+
+#include <cstddef>
+
+#include "common/value.h"
+
+
+/**
+ * The arguments of a native function.
+ *
+ * Arguments are contiguous in the caller's frame or registers,
+ * the span only points at them and is passed by copy.
+ */
+struct NativeArguments
+{
+    NativeArguments(
+        Value const * values,
+        std::size_t size
+    ) : values(values),
+        size(size)
+    {}
+
+    Value const& operator[](std::size_t index) const
+    {
+        return values[index];
+    }
+
+    Value const * values;
+    std::size_t size;
+};
+
+/**
+ * A native function receives its arguments and returns its result directly.
+ */
+typedef Value (*NativeFunction)(NativeArguments args);
+
+/**
+ * A function compiled to machine code receives its arguments
+ * and the global variables of the program, and returns its result directly.
+ */
+typedef Value (*CompiledFunction)(Value const * args, Value* globals);
+
+#endif
@@ -0,0 +1,139 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef PROTO_COMMON_OPERATION_H
+#define PROTO_COMMON_OPERATION_H
+
+#include <stdexcept>
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <string>
+
+#include "common/value.h"
+
+
+/* Operations on primitive types that run inline instead of as calls. */
+enum class Operation {
+    // Signed integers
+    AddI64, SubI64, MulI64, DivI64, RemI64, NegI64, BnotI64,
+    EqI64, NeI64, GtI64, GeI64, LtI64, LeI64,
+
+    // Unsigned integers
+    AddU64, SubU64, MulU64, DivU64, RemU64, NegU64, BnotU64,
+    EqU64, NeU64, GtU64, GeU64, LtU64, LeU64,
+
+    // Floats
+    AddF64, SubF64, MulF64, DivF64, NegF64,
+    EqF64, NeF64, GtF64, GeF64, LtF64, LeF64,
+
+    // Booleans
+    NotBool, EqBool, NeBool
+};
+
+/**
+ * Returns the string representation of an operation.
+ *
+ * @param       operation the operation to get the string representation of.
+ *
+ * @return      the string representation of the operation.
+ */
+std::string operationToString(enum Operation operation);
+
+/**
+ * Returns the number of operands the given operation takes.
+ */
+std::size_t operationArity(enum Operation operation);
+
+/**
+ * Applies the given operation to its operands.
+ *
+ * Unary operations only read the left operand.
+ * Integer division or remainder by zero aborts the program.
+ */
+inline Value
+applyOperation(enum Operation operation, Value left, Value right)
+{
+    switch (operation) {
+        // Signed integers
+        case Operation::AddI64: return Value(left.as_int + right.as_int);
+        case Operation::SubI64: return Value(left.as_int - right.as_int);
+        case Operation::MulI64: return Value(left.as_int * right.as_int);
+        case Operation::DivI64:
+            if (right.as_int == 0)
+                std::abort();
+            return Value(left.as_int / right.as_int);
+        case Operation::RemI64:
+            if (right.as_int == 0)
+                std::abort();
+            return Value(left.as_int % right.as_int);
+        case Operation::NegI64: return Value(-left.as_int);
+        case Operation::BnotI64: return Value(~left.as_int);
+        case Operation::EqI64: return Value(left.as_int == right.as_int);
+        case Operation::NeI64: return Value(left.as_int != right.as_int);
+        case Operation::GtI64: return Value(left.as_int > right.as_int);
+        case Operation::GeI64: return Value(left.as_int >= right.as_int);
+        case Operation::LtI64: return Value(left.as_int < right.as_int);
+        case Operation::LeI64: return Value(left.as_int <= right.as_int);
+
+        // Unsigned integers
+        case Operation::AddU64: return Value(left.as_uint + right.as_uint);
+        case Operation::SubU64: return Value(left.as_uint - right.as_uint);
+        case Operation::MulU64: return Value(left.as_uint * right.as_uint);
+        case Operation::DivU64:
+            if (right.as_uint == 0)
+                std::abort();
+            return Value(left.as_uint / right.as_uint);
+        case Operation::RemU64:
+            if (right.as_uint == 0)
+                std::abort();
+            return Value(left.as_uint % right.as_uint);
+        case Operation::NegU64: return Value((uint64_t) -left.as_uint);
+        case Operation::BnotU64: return Value(~left.as_uint);
+        case Operation::EqU64: return Value(left.as_uint == right.as_uint);
+        case Operation::NeU64: return Value(left.as_uint != right.as_uint);
+        case Operation::GtU64: return Value(left.as_uint > right.as_uint);
+        case Operation::GeU64: return Value(left.as_uint >= right.as_uint);
+        case Operation::LtU64: return Value(left.as_uint < right.as_uint);
+        case Operation::LeU64: return Value(left.as_uint <= right.as_uint);
+
+        // Floats
+        case Operation::AddF64: return Value(left.as_float + right.as_float);
+        case Operation::SubF64: return Value(left.as_float - right.as_float);
+        case Operation::MulF64: return Value(left.as_float * right.as_float);
+        case Operation::DivF64: return Value(left.as_float / right.as_float);
+        case Operation::NegF64: return Value(-left.as_float);
+        case Operation::EqF64: return Value(left.as_float == right.as_float);
+        case Operation::NeF64: return Value(left.as_float != right.as_float);
+        case Operation::GtF64: return Value(left.as_float > right.as_float);
+        case Operation::GeF64: return Value(left.as_float >= right.as_float);
+        case Operation::LtF64: return Value(left.as_float < right.as_float);
+        case Operation::LeF64: return Value(left.as_float <= right.as_float);
+
+        // Booleans
+        case Operation::NotBool: return Value(! left.as_bool);
+        case Operation::EqBool: return Value(left.as_bool == right.as_bool);
+        case Operation::NeBool: return Value(left.as_bool != right.as_bool);
+
+        default:
+            throw std::runtime_error(
+                "Operation application failed: unknow operation."
+            );
+    }
+}
+
+#endif
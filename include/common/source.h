@@ -0,0 +1,157 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef PROTO_COMMON_SOURCE_H
+#define PROTO_COMMON_SOURCE_H
+
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <string>
+
+
+/**
+ * Text of a source, scanned in place.
+ *
+ * Regular files are mapped into memory, what can't be mapped like pipes
+ * and the standard input is read into memory instead. Either way the text
+ * is framed by zero characters so looking one character before its start
+ * or two past its end stays in bounds.
+ */
+class SourceBuffer
+{
+    public:
+        /* Offsets and lengths of lexemes must fit in a token. */
+        static std::size_t const max_size = UINT32_MAX;
+
+        SourceBuffer();
+        explicit SourceBuffer(std::string text);
+        SourceBuffer(SourceBuffer&& buffer) noexcept;
+        SourceBuffer& operator=(SourceBuffer&& buffer) noexcept;
+        SourceBuffer(SourceBuffer const& buffer) = delete;
+        SourceBuffer& operator=(SourceBuffer const& buffer) = delete;
+        ~SourceBuffer();
+
+        /**
+         * Opens the file at the given path once, then maps it or reads it.
+         * The path `-` stands for the standard input.
+         *
+         * Throws std::invalid_argument if there is no such file
+         * and std::runtime_error if it can't be read or is 4 GB or more.
+         */
+        static SourceBuffer open(std::string const& path);
+
+        /**
+         * Returns the text of the source.
+         */
+        std::string_view getText() const;
+
+        /**
+         * Returns true if the text is mapped from a file instead of held in memory.
+         */
+        bool isMapped() const
+        {
+            return mapping != nullptr;
+        }
+
+    private:
+        char*           mapping;        /* Mapped region, the zero pages around the file included. */
+        std::size_t     mapping_size;   /* Size of the mapped region. */
+        std::string     storage;        /* Text held in memory, framed by zero characters. */
+        std::size_t     size;           /* Length of the text. */
+
+        // Map a regular file, leaves the buffer unmapped if the system refuses
+        void map(int descriptor, std::size_t file_size);
+
+        // Read everything there is to read from the given descriptor
+        void read(int descriptor, std::string const& path);
+};
+
+
+struct Source;
+
+/**
+ * Owns the text of every source the frontend reads.
+ *
+ * Tokens refer to their source by the identifier it gets here
+ * and to their lexeme by where it starts in the text, so they
+ * stay small and copying them never touches the text.
+ *
+ * A compilation creates the manager its sources are added to,
+ * their text is released when the manager is destroyed.
+ * Builtin lexemes live in one source every manager shares.
+ */
+class SourceManager
+{
+    public:
+        /* Empty source of tokens made up by passes. */
+        static std::size_t const none = 0;
+
+        /* Source holding the lexemes of builtin tokens. */
+        static std::size_t const builtin = 1;
+
+        /* Identifiers must fit in a token. */
+        static std::size_t const max_sources = 0xFFFF;
+
+        /**
+         * Makes this manager the one sources are added to and found in
+         * until it is destroyed, then the one active before it is again.
+         */
+        SourceManager();
+        SourceManager(SourceManager const& manager) = delete;
+        SourceManager& operator=(SourceManager const& manager) = delete;
+        ~SourceManager();
+
+        /**
+         * Takes the text of a source and returns its identifier.
+         *
+         * Throws std::runtime_error if no manager is active, if it holds
+         * as many sources as tokens can tell apart or if the text is 4 GB or more.
+         */
+        static std::size_t add(SourceBuffer buffer, std::string const& path);
+        static std::size_t add(std::string text, std::string const& path);
+
+        /**
+         * Returns where the given lexeme starts in the builtin source,
+         * adding it the first time it is asked for.
+         *
+         * The builtin source is never moved so lexemes can be viewed
+         * in place for as long as the program runs.
+         */
+        static std::size_t addBuiltin(std::string const& lexeme);
+
+        /**
+         * Returns the text of the given source.
+         */
+        static std::string_view getText(std::size_t source);
+
+        /**
+         * Returns the path of the file the given source was read from.
+         */
+        static std::string const& getPath(std::size_t source);
+
+    private:
+        SourceManager* previous;                        /* Manager active before this one. */
+        std::vector<std::unique_ptr<Source>> sources;   /* Sources after the builtin one, by identifier. */
+
+        // Find a source added to the active manager
+        static Source& find(std::size_t source);
+};
+
+#endif
@@ -18,50 +18,65 @@
 #ifndef PROTO_COMMON_TOKEN_H
 #define PROTO_COMMON_TOKEN_H
 
-#include <memory>
+#include <type_traits>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
 #include <string>
 
 #include "token_type.h"
 
 
+/*
+ * Tokens are copied all over the frontend so they only hold where
+ * their lexeme is, the text is resolved through the source manager.
+ * Lines past 2^24 and columns past 2^16 saturate.
+ */
 struct Token
 {
     Token();
 
     Token(
         enum TokenType type,
-        std::shared_ptr<std::string>& source,
-        std::string const& source_path,
-        std::string::iterator start,
-        std::string::size_type length,
-        std::string::size_type line,
-        std::string::size_type column
+        std::size_t source,
+        std::size_t offset,
+        std::size_t length,
+        std::size_t line,
+        std::size_t column
     );
-    Token(Token const& token) = default;
-    Token& operator=(Token const& token) noexcept = default;
-    Token(Token&& token) noexcept = default;
-    Token& operator=(Token&& token) noexcept = default;
-    ~Token() noexcept = default;
 
     /**
      * Returns the lexeme for the given token.
      */
     std::string getLexeme() const;
 
+    /**
+     * Returns the lexeme for the given token without copying it.
+     * The view stays valid for as long as the manager of its source is alive.
+     */
+    std::string_view getLexemeView() const;
+
     /**
      * Returns line information where this token was found.
      */
     struct TokenLine getLine() const;
 
-    enum TokenType                  type;           /* Type of token */
-    std::shared_ptr<std::string>    source;         /* Source containing this token */
-    std::string                     source_path;    /* File containing the source where this token was found */
-    std::string::iterator           start;          /* Index where this token occurs in the source */
-    std::string::size_type          length;         /* Length of the token */
-    std::string::size_type          line;           /* Line where the token occurs */
-    std::string::size_type          column;         /* Column where the token occurs */
+    /**
+     * Returns the path of the file containing this token.
+     */
+    std::string const& getSourcePath() const;
+
+    uint32_t                        offset;         /* Index where this token occurs in the source */
+    uint32_t                        length;         /* Length of the token */
+    uint32_t                        line : 24;      /* Line where the token occurs */
+    enum TokenType                  type : 8;       /* Type of token */
+    uint32_t                        column : 16;    /* Column where the token occurs */
+    uint32_t                        source : 16;    /* Source containing this token in the source manager */
 };
 
+static_assert(sizeof(Token) == 16, "Tokens must fit in 16 bytes.");
+static_assert(std::is_trivially_copyable<Token>::value, "Tokens must be trivially copyable.");
+
 
 struct TokenLine
 {
@@ -18,10 +18,13 @@
 #ifndef PROTO_COMMON_TOKEN_TYPE_H
 #define PROTO_COMMON_TOKEN_TYPE_H
 
+#include <string_view>
+#include <cstdint>
 #include <string>
+#include <array>
 
 
-enum TokenType {
+enum TokenType : uint8_t {
     /* single-character tokens */
     PROTO_LOGICAL_NOT,        // !  (not)
     PROTO_BITWISE_NOT,        // ~  (bnot)
@@ -98,6 +101,30 @@ enum TokenType {
 };
 
 
+/* A keyword and the type of the token it lexes to. */
+struct Keyword
+{
+    std::string_view    lexeme;
+    enum TokenType      type;
+};
+
+/* All supported keywords, the lexer hashes them at compile time. */
+inline constexpr std::array<Keyword, 12> keywords = {{
+    {"true",        PROTO_TRUE},
+    {"false",       PROTO_FALSE},
+    {"function",    PROTO_FUNCTION},
+    {"const",       PROTO_CONST},
+    {"if",          PROTO_IF},
+    {"elif",        PROTO_ELIF},
+    {"else",        PROTO_ELSE},
+    {"for",         PROTO_FOR},
+    {"while",       PROTO_WHILE},
+    {"continue",    PROTO_CONTINUE},
+    {"break",       PROTO_BREAK},
+    {"return",      PROTO_RETURN},
+}};
+
+
 /**
  * Returns the string representation of a token type
  *
@@ -0,0 +1,93 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef PROTO_COMMON_VALUE_H
+#define PROTO_COMMON_VALUE_H
+
+#include <cstdbool>
+#include <cstdint>
+#include <string>
+
+
+enum class ValueType {
+    Void,
+    Boolean,
+    SignedInt,
+    UnsignedInt,
+    Float,
+    String
+};
+
+/**
+ * A runtime value.
+ *
+ * Values are 16 bytes and are passed around by copy.
+ * Strings are handles to storage owned elsewhere, usually the AST literal
+ * the value originates from, so copying a value never allocates.
+ */
+struct Value
+{
+    Value(
+    ) : type(ValueType::Void),
+        as_uint(0)
+    {}
+
+    explicit Value(
+        bool value
+    ) : type(ValueType::Boolean),
+        as_uint(0)
+    {
+        as_bool = value;
+    }
+
+    explicit Value(
+        int64_t value
+    ) : type(ValueType::SignedInt),
+        as_int(value)
+    {}
+
+    explicit Value(
+        uint64_t value
+    ) : type(ValueType::UnsignedInt),
+        as_uint(value)
+    {}
+
+    explicit Value(
+        double value
+    ) : type(ValueType::Float),
+        as_float(value)
+    {}
+
+    explicit Value(
+        std::string const * value
+    ) : type(ValueType::String),
+        as_string(value)
+    {}
+
+    enum ValueType type;
+    union {
+        bool as_bool;
+        int64_t as_int;
+        uint64_t as_uint;
+        double as_float;
+        std::string const * as_string;
+    };
+};
+
+static_assert(sizeof(Value) == 16, "Values must fit in 16 bytes.");
+
+#endif
@@ -0,0 +1,95 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef PROTO_ELIMINATOR_H
+#define PROTO_ELIMINATOR_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <string>
+
+#include "cleaner/ast/expressions/expression.h"
+#include "cleaner/ast/definitions/function.h"
+#include "cleaner/ast/statements/statement.h"
+#include "cleaner/ast/statements/block.h"
+#include "cleaner/cleaner_warning.h"
+#include "cleaner/symbols/scope.h"
+#include "common/token.h"
+
+
+class Eliminator
+{
+    public:
+        Eliminator(CleanScope* scope);
+
+        /**
+         * Removes the statements that can never run and the assignments
+         * to local variables whose value is never read.
+         *
+         * Constants must be folded first so conditions can be known.
+         */
+        void eliminate();
+
+        /* List of warnings to diplay after the elimination finishes. */
+        std::vector<CleanerWarning> warnings;
+
+    private:
+        /* Whether each slot of the frame may be read before it is written. */
+        typedef std::vector<bool> Liveness;
+
+        CleanScope* scope;                  /* The global scope. */
+        CleanFunctionDefinition* fun_def;   /* The function being analyzed. */
+        CleanScope* block_scope;            /* The scope of the block being analyzed. */
+        Liveness break_live;                /* Live slots where break jumps. */
+        Liveness continue_live;             /* Live slots where continue jumps. */
+
+        // Unreachable code
+        void pruneBlock(CleanBlockStatement* block_stmt);
+        void pruneStatement(std::unique_ptr<CleanStatement>& stmt);
+        void pruneIf(std::unique_ptr<CleanStatement>& stmt);
+
+        // Dead stores
+        Liveness liveBlock(
+            CleanBlockStatement* block_stmt,
+            Liveness live,
+            bool remove
+        );
+        Liveness liveStatement(
+            std::unique_ptr<CleanStatement>& stmt,
+            Liveness live,
+            bool remove
+        );
+        Liveness liveLoop(
+            CleanBlockStatement* body,
+            CleanExpression* condition,
+            CleanExpression* incr_clause,
+            Liveness const& live,
+            bool remove
+        );
+        void read(CleanExpression* expr, Liveness& live);
+        bool isConstant(CleanVariableExpression* var_expr);
+
+        // Warnings
+        void warn(
+            Token& token,
+            std::string const& primary_message,
+            std::string const& secondary_message
+        );
+};
+
+#endif
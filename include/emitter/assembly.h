@@ -0,0 +1,91 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef PROTO_EMITTER_ASSEMBLY_H
+#define PROTO_EMITTER_ASSEMBLY_H
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <map>
+
+#include "cleaner/ast/definitions/function.h"
+#include "cleaner/symbols/scope.h"
+#include "ir/allocator.h"
+#include "ir/ir.h"
+
+
+class AssemblyEmitter
+{
+    public:
+        AssemblyEmitter(IRModule& module, CleanScope* scope);
+
+        /**
+         * Translates every function of the module to GNU assembler
+         * for x86-64 System V, along with a runtime that prints with printf.
+         *
+         * Values live in callee saved registers or in stack slots, as linear
+         * scan decides. The result assembles and links with `cc`.
+         */
+        std::string emit();
+
+    private:
+        IRModule& module;                   /* The program in SSA form. */
+        CleanScope* scope;                  /* The global scope. */
+        std::ostringstream out;             /* The assembly being written. */
+        RegisterAllocation allocation;      /* Registers and stack slots of the function's values. */
+        std::size_t saved_count;            /* Callee saved registers the function uses. */
+        std::size_t function_index;         /* Number of the function, to keep its labels apart. */
+
+        /* Functions by the name they have in the global scope. */
+        std::map<CleanFunctionDefinition*, std::string> names;
+
+        /* Labels of the string literals of the program. */
+        std::map<std::string const *, std::string> strings;
+
+        // Functions
+        void emitFunction(IRFunction& function);
+        void emitEpilogue();
+
+        // Instructions
+        void emitInstruction(IRInstruction* instr, IRBlock* next);
+        void emitOperation(IRInstruction* instr);
+        void emitCall(IRInstruction* instr);
+        void emitIntrinsicCall(IRInstruction* instr);
+
+        // Copy the values flowing into the phis of a block as if all at once
+        void emitPhiCopies(IRBlock* from, IRBlock* to);
+
+        // Jump to a block unless it comes next
+        void emitJump(IRBlock* target, IRBlock* next);
+
+        // Values
+        void load(std::string const& dst, IRInstruction* value);
+        void store(IRInstruction* value, std::string const& src);
+        void move(std::string const& dst, std::string const& src);
+        std::string location(IRInstruction* value);
+        std::string immediate(IRInstruction* value);
+
+        // Labels
+        std::string blockLabel(IRBlock* block);
+        std::string stringLabel(std::string const * value);
+
+        // Start a new instruction
+        std::ostream& line();
+};
+
+#endif
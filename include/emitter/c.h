@@ -0,0 +1,104 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef PROTO_EMITTER_C_H
+#define PROTO_EMITTER_C_H
+
+#include <cstddef>
+#include <sstream>
+#include <memory>
+#include <vector>
+#include <string>
+#include <map>
+
+#include "cleaner/ast/expressions/expression.h"
+#include "cleaner/ast/definitions/function.h"
+#include "cleaner/ast/statements/statement.h"
+#include "cleaner/ast/declarations/type.h"
+#include "cleaner/ast/statements/return.h"
+#include "cleaner/ast/statements/while.h"
+#include "cleaner/ast/statements/block.h"
+#include "cleaner/ast/statements/for.h"
+#include "cleaner/ast/statements/if.h"
+#include "cleaner/symbols/scope.h"
+
+
+class CEmitter
+{
+    public:
+        CEmitter(CleanScope* scope);
+
+        /**
+         * Translates every user function in the global scope to C99.
+         *
+         * The program must have gone through the resolver, the lowerer
+         * and the linker. The result only needs the C standard library.
+         *
+         * C leaves the order operands are evaluated in unspecified, so when
+         * an operand calls a function the operands are first evaluated
+         * left to right into temporaries, as the interpreter does.
+         */
+        std::string emit();
+
+    private:
+        CleanScope* scope;                  /* The global scope. */
+        std::ostringstream out;             /* The C source being written. */
+        std::size_t depth;                  /* Indentation of the current line. */
+
+        /* Functions by the name they have in the global scope. */
+        std::map<CleanFunctionDefinition*, std::string> names;
+
+        /* C types of the temporaries of the function being written. */
+        std::vector<std::string> temporaries;
+
+        // Functions
+        void emitPrototype(CleanFunctionDefinition* fun_def);
+        void emitFunction(CleanFunctionDefinition* fun_def);
+
+        // Declare the temporaries operands were evaluated into
+        void emitTemporaries();
+
+        // Statements
+        void emitStatement(CleanStatement* stmt);
+        void emitBlock(CleanBlockStatement* block_stmt);
+        void emitIf(CleanIfStatement* if_stmt);
+        void emitFor(CleanForStatement* for_stmt);
+        void emitWhile(CleanWhileStatement* while_stmt);
+        void emitReturn(CleanReturnStatement* ret_stmt);
+
+        // Declare the variables of a scope, zeroed as frame slots start
+        void emitLocals(CleanScope* scope);
+
+        // Expressions
+        std::string expression(CleanExpression* expr);
+        std::string call(CleanCallExpression* call_expr);
+        std::string intrinsicCall(CleanCallExpression* call_expr);
+        std::string operation(CleanOperationExpression* op_expr);
+
+        // Evaluate operands left to right into temporaries when one of them calls a function,
+        // since a call may print or change a global the other operands read
+        std::vector<std::string> sequenced(
+            std::vector<std::unique_ptr<CleanExpression>>& operands,
+            std::vector<std::string> const& types,
+            std::string& sequence
+        );
+
+        // Start a new line at the current indentation
+        std::ostream& line();
+};
+
+#endif
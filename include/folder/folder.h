@@ -0,0 +1,94 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef PROTO_FOLDER_H
+#define PROTO_FOLDER_H
+
+#include <memory>
+#include <set>
+
+#include "cleaner/ast/expressions/expression.h"
+#include "cleaner/ast/definitions/function.h"
+#include "cleaner/ast/definitions/variable.h"
+#include "cleaner/ast/statements/statement.h"
+#include "cleaner/ast/statements/block.h"
+#include "cleaner/symbols/scope.h"
+
+
+class Folder
+{
+    public:
+        Folder(CleanScope* scope);
+
+        /**
+         * Evaluates the expressions whose operands are all literals
+         * and replaces them by the literal they evaluate to.
+         *
+         * Uses of const variables initialized with a literal
+         * are replaced by that literal.
+         *
+         * Intrinsics must be loaded in the global scope first.
+         */
+        void fold();
+
+    private:
+        CleanScope* scope;                  /* The global scope. */
+        CleanFunctionDefinition* fun_def;   /* The function being folded. */
+        std::set<CleanVariableDefinition*> folded;
+
+        // Function definitions
+        void foldFunction(CleanFunctionDefinition* fun_def);
+
+        // Statements
+        void foldStatement(
+            std::unique_ptr<CleanStatement>& stmt,
+            CleanScope* scope
+        );
+
+        // Blocks
+        void foldBlock(CleanBlockStatement* block_stmt);
+
+        // Expressions
+        void foldExpression(
+            std::unique_ptr<CleanExpression>& expr,
+            CleanScope* scope
+        );
+
+        // Variables
+        void foldVariable(
+            std::unique_ptr<CleanExpression>& expr,
+            CleanScope* scope
+        );
+        CleanVariableDefinition* foldInitializer(
+            CleanVariableDefinition* var_def,
+            CleanScope* scope
+        );
+
+        // Calls
+        void foldCall(
+            std::unique_ptr<CleanExpression>& expr,
+            CleanScope* scope
+        );
+
+        // Operations
+        void foldOperation(
+            std::unique_ptr<CleanExpression>& expr,
+            CleanScope* scope
+        );
+};
+
+#endif
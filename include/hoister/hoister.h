@@ -0,0 +1,77 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef PROTO_HOISTER_H
+#define PROTO_HOISTER_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <set>
+
+#include "cleaner/ast/expressions/expression.h"
+#include "cleaner/ast/definitions/function.h"
+#include "cleaner/ast/statements/statement.h"
+#include "cleaner/ast/statements/block.h"
+#include "cleaner/ast/statements/for.h"
+#include "cleaner/symbols/scope.h"
+
+
+class Hoister
+{
+    public:
+        Hoister(CleanScope* scope);
+
+        /**
+         * Computes the pure expressions whose operands do not change while
+         * a loop runs once before the loop instead of at every iteration.
+         * For loops that step a counter to a bound are marked as counted.
+         *
+         * Calls must be linked and purity analyzed first.
+         */
+        void hoist();
+
+    private:
+        CleanScope* scope;                      /* The global scope. */
+        CleanFunctionDefinition* fun_def;       /* The function whose loops we hoist from. */
+        std::set<std::size_t> local_writes;     /* Local slots the current loop assigns. */
+        std::set<std::size_t> global_writes;    /* Global slots the current loop assigns. */
+        bool calls_impure;                      /* Whether the current loop may write any global. */
+
+        /* Assignments of the temporaries to insert before the current loop. */
+        std::vector<std::unique_ptr<CleanStatement>> hoisted;
+
+        // Blocks
+        void hoistBlock(CleanBlockStatement* block_stmt);
+
+        // Loops
+        void hoistLoop(CleanStatement* stmt);
+        void hoistStatement(CleanStatement* stmt);
+        void hoistExpression(std::unique_ptr<CleanExpression>& expr);
+
+        // Counters
+        void findCounter(CleanForStatement* for_stmt);
+
+        // Writes
+        void findWrites(CleanStatement* stmt);
+        void findExpressionWrites(CleanExpression* expr);
+
+        // Invariants
+        bool isInvariant(CleanExpression* expr);
+};
+
+#endif
@@ -0,0 +1,98 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef PROTO_INLINER_H
+#define PROTO_INLINER_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <string>
+#include <set>
+#include <map>
+
+#include "cleaner/ast/expressions/expression.h"
+#include "cleaner/ast/definitions/function.h"
+#include "cleaner/ast/statements/statement.h"
+#include "cleaner/ast/statements/block.h"
+#include "cleaner/symbols/scope.h"
+
+
+class Inliner
+{
+    public:
+        Inliner(CleanScope* scope, std::size_t threshold);
+
+        /**
+         * Replaces calls to small non-recursive functions
+         * by the body of the function called.
+         *
+         * Runs before variables are resolved so the locals
+         * of inlined functions get slots in the caller's frame.
+         */
+        void inlineCalls();
+
+        /**
+         * Returns one line per call that was inlined.
+         */
+        std::vector<std::string> const& getReport() const;
+
+    private:
+        CleanScope* scope;                  /* The global scope. */
+        std::size_t threshold;              /* Largest body to inline. */
+        std::size_t sites;                  /* Calls inlined so far. */
+        CleanFunctionDefinition* caller;    /* The function being inlined into. */
+        std::set<CleanFunctionDefinition*> done;
+        std::map<std::string, std::set<std::string>> callees;
+        std::vector<std::map<std::string, std::string>> renames;
+        std::set<std::string> free_names;
+        std::vector<std::string> report;
+
+        // Function definitions
+        void inlineFunction(CleanFunctionDefinition* fun_def);
+        bool isInlinable(CleanFunctionDefinition* fun_def);
+        bool isRecursive(std::string const& fun_name);
+
+        // Statements
+        void inlineBlock(CleanBlockStatement* block_stmt);
+        void inlineStatement(
+            std::unique_ptr<CleanStatement>& stmt,
+            std::shared_ptr<CleanScope> const& scope
+        );
+        std::unique_ptr<CleanStatement> expand(
+            CleanCallExpression* call_expr,
+            CleanStatement* stmt,
+            std::shared_ptr<CleanScope> const& scope
+        );
+        bool isShadowed(std::string const& name, CleanScope* scope);
+
+        // Copies with the locals renamed
+        std::unique_ptr<CleanBlockStatement> cloneBlock(
+            CleanBlockStatement* block_stmt,
+            std::shared_ptr<CleanScope> const& scope
+        );
+        void cloneSymbols(CleanScope* scope, CleanScope* clone_scope);
+        std::unique_ptr<CleanStatement> cloneStatement(
+            CleanStatement* stmt,
+            std::shared_ptr<CleanScope> const& scope
+        );
+        std::unique_ptr<CleanExpression> cloneExpression(CleanExpression* expr);
+        void rename(CleanExpression* expr);
+        std::string renamed(std::string const& name);
+};
+
+#endif
@@ -19,11 +19,12 @@
 #define PROTO_FUNCTION_DEFINITION_INTERPRETER_H
 
 #include <memory>
-#include <vector>
 
 #include "cleaner/ast/expressions/expression.h"
 #include "cleaner/ast/definitions/function.h"
 #include "cleaner/symbols/scope.h"
+#include "interpreter/frame.h"
+#include "common/value.h"
 
 
 class FunctionDefinitionInterpreter
@@ -31,10 +32,19 @@ class FunctionDefinitionInterpreter
     public:
         /**
          * Interprets the given function definition.
+         *
+         * The caller pushes the function's frame on the call stack
+         * and writes the arguments into its first slots.
          */
-        std::unique_ptr<CleanExpression> interpret(
+        Value interpret(
             CleanFunctionDefinition* fun_def,
-            std::vector<std::unique_ptr<CleanExpression>>& arguments);
+            Frame* frame);
+
+    private:
+        // Intrinsics receive their arguments as a span over their frame
+        Value interpretIntrinsic(
+            CleanFunctionDefinition* fun_def,
+            Frame* frame);
 };
 
 #endif
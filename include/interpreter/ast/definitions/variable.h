@@ -23,6 +23,8 @@
 #include "cleaner/ast/expressions/expression.h"
 #include "cleaner/ast/definitions/variable.h"
 #include "cleaner/symbols/scope.h"
+#include "interpreter/frame.h"
+#include "common/value.h"
 
 
 class VariableDefinitionInterpreter
@@ -31,8 +33,8 @@ class VariableDefinitionInterpreter
         /**
          * Interprets the given variable definition.
          */
-        std::unique_ptr<CleanExpression> interpret(
-            CleanVariableDefinition* var_def, CleanScope* scope);
+        Value interpret(
+            CleanVariableDefinition* var_def, CleanScope* scope, Frame* frame);
 };
 
 #endif
@@ -20,66 +20,72 @@
 
 #include "cleaner/ast/expressions/expression.h"
 #include "cleaner/symbols/scope.h"
+#include "interpreter/frame.h"
+#include "common/value.h"
 
 
 class ExpressionInterpreter
 {
     public:
-        ExpressionInterpreter(CleanScope* scope);
+        ExpressionInterpreter(CleanScope* scope, Frame* frame);
 
         /**
          * Interprets the given expression.
          */
-        std::unique_ptr<CleanExpression> interpret(
+        Value interpret(
             CleanExpression* expr);
 
         // Bool
-        std::unique_ptr<CleanBoolExpression> interpretBool(
+        Value interpretBool(
             CleanBoolExpression* bool_expr);
 
         // Signed int
-        std::unique_ptr<CleanSignedIntExpression> interpretSignedInt(
+        Value interpretSignedInt(
             CleanSignedIntExpression* int_expr);
 
         // Unsigned int
-        std::unique_ptr<CleanUnsignedIntExpression> interpretUnsignedInt(
+        Value interpretUnsignedInt(
             CleanUnsignedIntExpression* uint_expr);
 
         // Float
-        std::unique_ptr<CleanFloatExpression> interpretFloat(
+        Value interpretFloat(
             CleanFloatExpression* float_expr);
 
         // String
-        std::unique_ptr<CleanStringExpression> interpretString(
+        Value interpretString(
             CleanStringExpression* string_expr);
 
         // Variable
-        std::unique_ptr<CleanExpression> interpretVariable(
+        Value interpretVariable(
             CleanVariableExpression* var_expr);
 
         // Group
-        std::unique_ptr<CleanExpression> interpretGroup(
+        Value interpretGroup(
             CleanGroupExpression* gr_expr);
 
         // Call
-        std::unique_ptr<CleanExpression> interpretCall(
+        Value interpretCall(
             CleanCallExpression* call_expr);
 
         // Ternary if
-        std::unique_ptr<CleanExpression> interpretTernaryIf(
+        Value interpretTernaryIf(
             CleanTernaryIfExpression* ternif_expr);
         
         // Assignment
-        std::unique_ptr<CleanExpression> interpretAssignment(
+        Value interpretAssignment(
             CleanAssignmentExpression* assign_expr);
         
+        // Operation
+        Value interpretOperation(
+            CleanOperationExpression* op_expr);
+
         // Intrinsic
-        std::unique_ptr<CleanExpression> interpretIntrinsic(
-            CleanIntrinsicExpression* intr_expr,
-            CleanScope* scope);
+        Value interpretIntrinsic(
+            CleanIntrinsicExpression* intr_expr);
 
     private:
         CleanScope* scope;
+        Frame* frame;
 };
 
 #endif
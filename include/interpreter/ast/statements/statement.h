@@ -22,6 +22,7 @@
 #include <memory>
 
 #include "cleaner/ast/expressions/expression.h"
+#include "cleaner/ast/definitions/function.h"
 #include "cleaner/ast/statements/statement.h"
 #include "cleaner/ast/statements/continue.h"
 #include "cleaner/ast/statements/return.h"
@@ -31,55 +32,73 @@
 #include "cleaner/ast/statements/for.h"
 #include "cleaner/ast/statements/if.h"
 #include "cleaner/symbols/scope.h"
+#include "interpreter/frame.h"
+#include "common/value.h"
 
 
 class StatementInterpreter
 {
     public:
-        StatementInterpreter();
+        StatementInterpreter(Frame* frame);
+        StatementInterpreter(Frame* frame, CleanFunctionDefinition* fun_def);
 
         /**
          * Interprets the given statement.
          */
-        std::unique_ptr<CleanExpression> interpret(
+        Value interpret(
             CleanStatement* stmt, CleanScope* scope);
 
         // Block
-        std::unique_ptr<CleanExpression> interpretBlock(
+        Value interpretBlock(
             CleanBlockStatement* block_stmt);
 
         // If
-        std::unique_ptr<CleanExpression> interpretIf(
+        Value interpretIf(
             CleanIfStatement* if_stmt, CleanScope* scope);
 
         // For
-        std::unique_ptr<CleanExpression> interpretFor(
+        Value interpretFor(
             CleanForStatement* for_stmt, CleanScope* scope);
+        Value interpretCountedFor(
+            CleanForStatement* for_stmt);
 
         // While
-        std::unique_ptr<CleanExpression> interpretWhile(
+        Value interpretWhile(
             CleanWhileStatement* while_stmt, CleanScope* scope);
 
         // Break
-        std::unique_ptr<CleanExpression> interpretBreak(
+        Value interpretBreak(
             CleanBreakStatement* br_stmt);
 
         // Continue
-        std::unique_ptr<CleanExpression> interpretContinue(
+        Value interpretContinue(
             CleanContinueStatement* cont_stmt);
 
         // Return
-        std::unique_ptr<CleanExpression> interpretReturn(
+        Value interpretReturn(
             CleanReturnStatement* ret_stmt, CleanScope* scope);
 
         // Expressions
-        std::unique_ptr<CleanExpression> interpretExpression(
+        Value interpretExpression(
             CleanExpression* expr_stmt, CleanScope* scope);
+
+        /**
+         * Returns the function tail called by the last return statement, if any.
+         *
+         * Its arguments sit on the call stack right above the frame.
+         */
+        CleanFunctionDefinition* getTailCallee();
     
     private:
+        Frame* frame;
+        CleanFunctionDefinition* fun_def;       /* The function running, null if unknown. */
         bool returned;
         bool broke;
         bool continued;
+        CleanFunctionDefinition* tail_callee;
+
+        // Loop iterations count toward the hotness of the running function
+        void countBackEdge();
 };
 
 #endif
@@ -0,0 +1,197 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef PROTO_INTERPRETER_FRAME_H
+#define PROTO_INTERPRETER_FRAME_H
+
+#include <stdexcept>
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "common/value.h"
+
+
+class Tiering;
+
+/**
+ * Storage for the activation records of all running functions.
+ *
+ * The storage grows by segments that never move, so slots handed out
+ * by push remain valid until the matching pop. The slots of a single
+ * push are contiguous, those of consecutive pushes may not be.
+ */
+struct CallStack
+{
+    CallStack(
+        std::size_t segment_size,
+        std::size_t limit
+    ) : segment_size(segment_size),
+        limit(limit),
+        current(0),
+        top(0),
+        allocated(segment_size),
+        tiering(nullptr)
+    {
+        segments.emplace_back(segment_size);
+    }
+
+    /**
+     * Reserves the given number of slots at the top of the stack.
+     */
+    Value* push(std::size_t size)
+    {
+        if (size > segments[current].size() - top)
+            grow(size);
+
+        Value* slots = segments[current].data() + top;
+        top += size;
+        return slots;
+    }
+
+    /**
+     * Releases the given number of slots from the top of the stack.
+     */
+    void pop(std::size_t size)
+    {
+        top -= size;
+
+        // Emptying a segment other than the first one resumes the segment below
+        if (top == 0 && size > 0 && current > 0) {
+            current--;
+            top = tops.back();
+            tops.pop_back();
+        }
+    }
+
+    /**
+     * Returns the given number of slots last pushed, they are still reserved.
+     */
+    Value* peek(std::size_t size)
+    {
+        return segments[current].data() + top - size;
+    }
+
+    std::vector<std::vector<Value>> segments;
+    std::vector<std::size_t> tops;  /* Where the segments below the current one were left. */
+    std::size_t segment_size;
+    std::size_t limit;              /* Number of slots the segments may hold at most. */
+    std::size_t current;
+    std::size_t top;
+    std::size_t allocated;
+    Tiering* tiering;               /* Counts what runs when functions may tier up. */
+
+    private:
+        // Continues in the next segment, large enough for the given number of slots
+        void grow(std::size_t size)
+        {
+            // A segment too small is kept for smaller pushes rather than replaced,
+            // a tail call may still read the arguments it holds
+            std::size_t capacity = std::max(segment_size, size);
+            if (current + 1 == segments.size() || segments[current + 1].size() < capacity) {
+                if (capacity > limit - allocated)
+                    throw std::runtime_error(
+                        "Call interpretation failed: stack overflow."
+                    );
+
+                segments.emplace(segments.begin() + current + 1, capacity);
+                allocated += capacity;
+            }
+
+            tops.push_back(top);
+            current++;
+            top = 0;
+        }
+};
+
+/**
+ * The activation record of a single function invocation.
+ *
+ * Variables are addressed by the slots assigned by the resolver.
+ * The parent of a function frame is the frame holding global variables.
+ * A frame occupies its slots on the call stack for as long as it lives.
+ */
+struct Frame
+{
+    Frame(
+        CallStack* stack,
+        std::size_t size,
+        Frame* parent
+    ) : stack(stack),
+        slots(stack->push(size)),
+        size(size),
+        parent(parent)
+    {}
+
+    Frame(Frame const&) = delete;
+    Frame& operator=(Frame const&) = delete;
+
+    ~Frame()
+    {
+        stack->pop(size);
+    }
+
+    /**
+     * Returns the slot at the given frame depth and index.
+     */
+    Value& getSlot(std::size_t depth, std::size_t slot)
+    {
+        Frame* frame = this;
+        while (depth-- > 0)
+            frame = frame->parent;
+
+        return frame->slots[slot];
+    }
+
+    /**
+     * Reuses the frame for a tail call to a function with the given frame size.
+     *
+     * The frame must be at the top of the call stack, followed by the
+     * given number of arguments which become the first slots of the frame.
+     */
+    void reuse(std::size_t new_size, std::size_t arg_count)
+    {
+        // Popped slots keep their values until pushed again, and the frame
+        // either starts where it was, below the arguments, or where they are
+        Value* arguments = stack->peek(arg_count);
+        stack->pop(arg_count);
+        stack->pop(size);
+        slots = stack->push(new_size);
+        size = new_size;
+        if (slots != arguments)
+            std::copy(arguments, arguments + arg_count, slots);
+    }
+
+    /**
+     * Returns the outermost frame, the one holding global variables.
+     */
+    Frame* getRoot()
+    {
+        Frame* frame = this;
+        while (frame->parent)
+            frame = frame->parent;
+
+        return frame;
+    }
+
+    CallStack* stack;
+    Value* slots;
+    std::size_t size;
+    Frame* parent;
+};
+
+#endif
@@ -18,15 +18,18 @@
 #ifndef PROTO_INTERPRETER_H
 #define PROTO_INTERPRETER_H
 
+#include <cstddef>
 #include <memory>
 
 #include "cleaner/symbols/scope.h"
+#include "interpreter/tiering.h"
 
 
 class Interpreter
 {
     public:
         Interpreter(CleanScope* scope);
+        Interpreter(CleanScope* scope, Tiering* tiering);
 
         /**
          * Interprets the program starting with the main function found in the global scope.
@@ -34,7 +37,13 @@ class Interpreter
         int interpret();
 
     private:
+        // Number of slots the call stack starts with and grows by,
+        // and the number it may hold at most before calls overflow it
+        static constexpr std::size_t stack_segment = 1 << 16;
+        static constexpr std::size_t stack_limit = 1 << 26;
+
         CleanScope* scope;
+        Tiering* tiering;                   /* Promotes hot functions, null to only interpret. */
 };
 
 #endif
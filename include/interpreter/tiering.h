@@ -0,0 +1,74 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef PROTO_INTERPRETER_TIERING_H
+#define PROTO_INTERPRETER_TIERING_H
+
+#include <cstddef>
+
+#include "cleaner/ast/definitions/function.h"
+
+
+/**
+ * Moves the functions the interpreter runs often to a faster tier.
+ *
+ * The interpreter counts the invocations and loop back edges of the
+ * functions it runs. A function is promoted once, when its count reaches
+ * the threshold, and runs its compiled code from then on if it got some.
+ * Loops already running stay interpreted until the function is called again.
+ */
+class Tiering
+{
+    public:
+        Tiering(
+            std::size_t threshold
+        ) : threshold(threshold)
+        {}
+
+        virtual ~Tiering()
+        {}
+
+        /**
+         * Counts one invocation of the given function.
+         */
+        void countInvocation(CleanFunctionDefinition* fun_def)
+        {
+            fun_def->invocations++;
+            if (fun_def->invocations + fun_def->back_edges == threshold)
+                promote(fun_def);
+        }
+
+        /**
+         * Counts one iteration of a loop in the given function.
+         */
+        void countBackEdge(CleanFunctionDefinition* fun_def)
+        {
+            fun_def->back_edges++;
+            if (fun_def->invocations + fun_def->back_edges == threshold)
+                promote(fun_def);
+        }
+
+    protected:
+        std::size_t threshold;      /* Invocations and back edges that make a function hot. */
+
+        /**
+         * Gives the given hot function compiled code if the faster tier supports it.
+         */
+        virtual void promote(CleanFunctionDefinition* fun_def) = 0;
+};
+
+#endif
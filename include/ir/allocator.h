@@ -0,0 +1,97 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef PROTO_IR_ALLOCATOR_H
+#define PROTO_IR_ALLOCATOR_H
+
+#include <cstddef>
+#include <vector>
+#include <map>
+
+#include "ir/ir.h"
+
+
+/**
+ * The registers given to the values of a function,
+ * and the stack slots of those that did not get one.
+ */
+struct RegisterAllocation
+{
+    RegisterAllocation(
+    ) : register_count(0),
+        spill_count(0)
+    {}
+
+    std::vector<IRBlock*> order;        /* Blocks in the order code is laid out. */
+    std::map<IRInstruction*, std::size_t> registers;
+    std::size_t register_count;
+    std::map<IRInstruction*, std::size_t> spills;
+    std::size_t spill_count;
+};
+
+class RegisterAllocator
+{
+    public:
+        RegisterAllocator(IRFunction& function);
+
+        /**
+         * Allocates at most the given number of registers, the values
+         * that don't fit go to stack slots. Parameters are allocated like
+         * any other value and constants get nothing, they are expected to be
+         * used as immediates.
+         */
+        RegisterAllocator(IRFunction& function, std::size_t register_limit);
+
+        /**
+         * Gives every instruction that produces a value a register,
+         * values live at the same time getting different registers.
+         *
+         * Parameters keep the register of their index. Phis are expected
+         * to be copied at the end of their predecessors, so critical edges
+         * must have been split first.
+         */
+        RegisterAllocation allocate();
+
+    private:
+        /* The positions between which a value may be live. */
+        struct Interval
+        {
+            IRInstruction* value;
+            std::size_t start;
+            std::size_t end;
+        };
+
+        IRFunction& function;
+        std::size_t register_limit;         /* Registers available, 0 if unlimited. */
+        std::vector<IRBlock*> order;
+        std::map<IRBlock*, std::size_t> block_start;
+        std::map<IRBlock*, std::size_t> block_end;
+        std::map<IRInstruction*, std::size_t> position;
+        std::map<IRInstruction*, Interval> intervals;
+
+        /* Values that had better share a register with the given one. */
+        std::map<IRInstruction*, std::vector<IRInstruction*>> hints;
+
+        // Positions
+        void numberInstructions();
+
+        // Liveness
+        void buildIntervals();
+        void extend(IRInstruction* value, std::size_t at);
+};
+
+#endif
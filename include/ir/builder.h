@@ -0,0 +1,126 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef PROTO_IR_BUILDER_H
+#define PROTO_IR_BUILDER_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <map>
+#include <set>
+
+#include "cleaner/ast/expressions/expression.h"
+#include "cleaner/ast/definitions/function.h"
+#include "cleaner/ast/statements/statement.h"
+#include "cleaner/ast/statements/return.h"
+#include "cleaner/ast/statements/while.h"
+#include "cleaner/ast/statements/block.h"
+#include "cleaner/ast/statements/for.h"
+#include "cleaner/ast/statements/if.h"
+#include "cleaner/symbols/scope.h"
+#include "common/value.h"
+#include "ir/ir.h"
+
+
+class IRBuilder
+{
+    public:
+        IRBuilder(CleanScope* scope);
+
+        /**
+         * Lowers every user function in the global scope to SSA form.
+         *
+         * The program must have gone through the resolver and the linker.
+         * Local variable slots become SSA values, global variables stay in memory.
+         */
+        IRModule build();
+
+    private:
+        /* Where break and continue statements go. */
+        struct Loop
+        {
+            IRBlock* break_target;
+            IRBlock* continue_target;
+        };
+
+        /* Values of the local variable slots, by block. */
+        typedef std::map<std::size_t, IRInstruction*> Definitions;
+
+        CleanScope* scope;                  /* The global scope. */
+        IRModule module;                    /* The program being lowered. */
+        IRFunction* function;               /* The function being lowered. */
+        IRBlock* current;                   /* The block instructions are appended to. */
+        IRInstruction* undefined;           /* The value of slots read before being assigned. */
+        std::vector<Loop> loops;            /* The loops enclosing the current statement. */
+        std::vector<enum ValueType> global_types;
+
+        /* State of the SSA construction of Braun et al. */
+        std::map<IRBlock*, Definitions> definitions;
+        std::map<IRBlock*, Definitions> incomplete_phis;
+        std::set<IRBlock*> sealed;
+        std::map<IRInstruction*, IRInstruction*> replaced;
+        std::vector<std::unique_ptr<IRInstruction>> graveyard;
+
+        // Function definitions
+        void buildFunction(CleanFunctionDefinition* fun_def);
+
+        // Statements
+        void buildStatement(CleanStatement* stmt);
+
+        // Blocks
+        void buildBlock(CleanBlockStatement* block_stmt);
+
+        // If
+        void buildIf(CleanIfStatement* if_stmt);
+
+        // For
+        void buildFor(CleanForStatement* for_stmt);
+
+        // While
+        void buildWhile(CleanWhileStatement* while_stmt);
+
+        // Return
+        void buildReturn(CleanReturnStatement* ret_stmt);
+
+        // Expressions
+        IRInstruction* buildExpression(CleanExpression* expr);
+        IRInstruction* buildCall(CleanCallExpression* call_expr);
+        IRInstruction* buildTernaryIf(CleanTernaryIfExpression* ternif_expr);
+        IRInstruction* buildOperation(CleanOperationExpression* op_expr);
+        IRInstruction* buildAssignment(CleanAssignmentExpression* assign_expr);
+        IRInstruction* buildConstant(Value value);
+
+        // Control flow
+        IRInstruction* emit(std::unique_ptr<IRInstruction> instr);
+        void jump(IRBlock* target);
+        void branch(IRInstruction* condition, IRBlock* then_target, IRBlock* else_target);
+        void startUnreachableBlock();
+
+        // SSA construction
+        void writeVariable(std::size_t slot, IRBlock* block, IRInstruction* value);
+        IRInstruction* readVariable(std::size_t slot, IRBlock* block);
+        IRInstruction* readVariableRecursive(std::size_t slot, IRBlock* block);
+        IRInstruction* addPhiOperands(std::size_t slot, IRInstruction* phi);
+        IRInstruction* tryRemoveTrivialPhi(IRInstruction* phi);
+        IRInstruction* createPhi(IRBlock* block);
+        IRInstruction* undefinedValue();
+        void sealBlock(IRBlock* block);
+        void inferPhiTypes();
+};
+
+#endif
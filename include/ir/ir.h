@@ -0,0 +1,241 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef PROTO_IR_H
+#define PROTO_IR_H
+
+#include <cstdbool>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <string>
+#include <map>
+
+#include "cleaner/ast/definitions/function.h"
+#include "common/operation.h"
+#include "common/value.h"
+
+
+enum class IROpcode {
+    Const,          /* value */
+    Param,          /* the index-th argument */
+    LoadGlobal,     /* G[index] */
+    StoreGlobal,    /* G[index] = operands[0] */
+    Operation,      /* operation(operands...) */
+    Call,           /* callee(operands...) */
+    Phi,            /* operands[i] if control came from block->predecessors[i] */
+    Copy,           /* operands[0] */
+    Jump,           /* goto targets[0] */
+    Branch,         /* if operands[0] goto targets[0] else goto targets[1] */
+    Return          /* return operands[0], or nothing without operands */
+};
+
+struct IRBlock;
+
+/**
+ * A single instruction, which is also the SSA value it computes.
+ *
+ * Each instruction is defined exactly once and operands refer
+ * to the instructions whose value they use.
+ */
+struct IRInstruction
+{
+    IRInstruction(
+        enum IROpcode opcode,
+        enum ValueType type
+    ) : opcode(opcode),
+        type(type),
+        id(0),
+        block(nullptr),
+        index(0),
+        operation(Operation::AddI64),
+        callee(nullptr),
+        is_tail_call(false)
+    {}
+
+    enum IROpcode opcode;
+    enum ValueType type;                /* Type of the value computed, Void if none. */
+    std::size_t id;                     /* Number of the value within its function. */
+    IRBlock* block;                     /* The block the instruction belongs to. */
+    std::vector<IRInstruction*> operands;
+    std::vector<IRBlock*> targets;      /* Blocks a jump or branch goes to. */
+
+    Value value;                        /* The constant of Const. */
+    std::size_t index;                  /* Parameter index or global slot. */
+    enum Operation operation;           /* The operation of Operation. */
+    CleanFunctionDefinition* callee;    /* The user function or intrinsic of Call. */
+    bool is_tail_call;                  /* Whether the call result is returned as is. */
+};
+
+/**
+ * A straight sequence of instructions ending with a jump, a branch or a return.
+ *
+ * Phi instructions come first.
+ */
+struct IRBlock
+{
+    IRBlock(
+        std::size_t id
+    ) : id(id)
+    {}
+
+    std::size_t id;
+    std::vector<std::unique_ptr<IRInstruction>> instructions;
+    std::vector<IRBlock*> predecessors;
+
+    /**
+     * Returns the last instruction if it ends the block, null otherwise.
+     */
+    IRInstruction* terminator() const;
+
+    /**
+     * Returns the blocks control may go to after this one.
+     */
+    std::vector<IRBlock*> successors() const;
+};
+
+/**
+ * A user function in SSA form.
+ *
+ * The first block is the entry block, it starts with the parameters.
+ */
+struct IRFunction
+{
+    IRFunction(
+        std::string const& name,
+        CleanFunctionDefinition* fun_def
+    ) : name(name),
+        fun_def(fun_def),
+        next_id(0),
+        next_block(0)
+    {}
+
+    std::string name;
+    CleanFunctionDefinition* fun_def;
+    std::vector<std::unique_ptr<IRBlock>> blocks;
+    std::size_t next_id;                /* Number of the next value created. */
+    std::size_t next_block;             /* Number of the next block created. */
+
+    /**
+     * Appends a new empty block.
+     */
+    IRBlock* addBlock();
+
+    /**
+     * Inserts the given instruction at the given position of the block.
+     */
+    IRInstruction* insert(
+        IRBlock* block,
+        std::size_t position,
+        std::unique_ptr<IRInstruction> instr
+    );
+
+    /**
+     * Appends the given instruction to the block.
+     */
+    IRInstruction* append(IRBlock* block, std::unique_ptr<IRInstruction> instr);
+};
+
+/**
+ * A whole program in SSA form.
+ *
+ * Strings referenced by constants are owned by the AST
+ * so the AST must outlive the module.
+ */
+struct IRModule
+{
+    std::vector<std::unique_ptr<IRFunction>> functions;
+    std::vector<Value> globals;         /* Initial values of global variables. */
+};
+
+/**
+ * Returns the string representation of an opcode.
+ *
+ * @param       opcode the opcode to get the string representation of.
+ *
+ * @return      the string representation of the opcode.
+ */
+std::string irOpcodeToString(enum IROpcode opcode);
+
+/**
+ * Returns the name Proto gives to the type of values of the given type.
+ */
+std::string irTypeToString(enum ValueType type);
+
+/**
+ * Returns the type of the values of the given Proto type.
+ */
+enum ValueType irTypeOf(std::string const& type_name);
+
+/**
+ * Returns a human readable listing of the given function.
+ */
+std::string printFunction(IRFunction const& function);
+
+/**
+ * Returns a human readable listing of the given module.
+ */
+std::string printModule(IRModule const& module);
+
+/**
+ * Returns whether running the instruction does more than compute its value:
+ * it ends the block, writes a global, calls a function or may abort.
+ */
+bool hasEffects(IRInstruction* instr);
+
+/**
+ * Returns the blocks reachable from the entry block in reverse postorder.
+ */
+std::vector<IRBlock*> reversePostorder(IRFunction& function);
+
+/**
+ * Returns the immediate dominator of every reachable block.
+ * The entry block is its own immediate dominator.
+ */
+std::map<IRBlock*, IRBlock*> immediateDominators(IRFunction& function);
+
+/**
+ * Makes the operands that refer to an instruction in the given map
+ * refer to the instruction it maps to instead.
+ * Chains of replacements are followed to their end.
+ */
+void replaceUses(
+    IRFunction& function,
+    std::map<IRInstruction*, IRInstruction*> const& replacements
+);
+
+/**
+ * Removes one edge from a block to another, along with
+ * the phi operands that flowed along that edge.
+ */
+void removeEdge(IRBlock* from, IRBlock* to);
+
+/**
+ * Removes the blocks that can't be reached from the entry block.
+ *
+ * @return      true if any block was removed.
+ */
+bool removeUnreachableBlocks(IRFunction& function);
+
+/**
+ * Puts an empty block on every edge from a block with many successors
+ * to a block with phis, so that phi operands can be copied at the end
+ * of a predecessor that only leads to the phis.
+ */
+void splitCriticalEdges(IRFunction& function);
+
+#endif
@@ -0,0 +1,170 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef PROTO_IR_PASSES_H
+#define PROTO_IR_PASSES_H
+
+#include <cstdbool>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <string>
+#include <map>
+
+#include "ir/ir.h"
+
+
+/**
+ * A transformation of a function in SSA form.
+ */
+class IRPass
+{
+    public:
+        virtual ~IRPass()
+        {}
+
+        /**
+         * Returns the name of the pass.
+         */
+        virtual std::string name() const = 0;
+
+        /**
+         * Transforms the given function.
+         *
+         * @return      true if the function changed.
+         */
+        virtual bool run(IRFunction& function) = 0;
+};
+
+class PassManager
+{
+    public:
+        PassManager();
+
+        /**
+         * Adds a pass to run after the ones already added.
+         */
+        void add(std::unique_ptr<IRPass> pass);
+
+        /**
+         * Runs the passes in order on every function of the module,
+         * again until a round changes nothing or enough rounds ran.
+         */
+        void run(IRModule& module);
+
+    private:
+        // What one pass uncovers is usually cleaned by the next round
+        static constexpr std::size_t max_rounds = 8;
+
+        std::vector<std::unique_ptr<IRPass>> passes;
+};
+
+/**
+ * Replaces operations on constants by their result,
+ * simplifies operations with a neutral operand
+ * and turns branches on a constant into jumps.
+ */
+class ConstantFolding : public IRPass
+{
+    public:
+        std::string name() const override;
+        bool run(IRFunction& function) override;
+
+    private:
+        bool simplify(IRInstruction* instr);
+};
+
+/**
+ * Replaces the uses of copies and of phis that merge
+ * a single value by the value they copy.
+ */
+class CopyPropagation : public IRPass
+{
+    public:
+        std::string name() const override;
+        bool run(IRFunction& function) override;
+};
+
+/**
+ * Replaces a computation by an identical one that dominates it.
+ *
+ * Constants, operations, phis and calls to pure intrinsics are numbered
+ * along the dominator tree, operands of commutative operations in order.
+ * Constants are moved to the entry block first so loops do not reload them.
+ */
+class ValueNumbering : public IRPass
+{
+    public:
+        std::string name() const override;
+        bool run(IRFunction& function) override;
+
+    private:
+        // Move constants to the entry block so one load serves the whole function
+        bool moveConstants(IRFunction& function);
+};
+
+/**
+ * Replaces the product of a loop induction variable and a value computed
+ * before the loop by a variable of its own stepped by an addition.
+ */
+class StrengthReduction : public IRPass
+{
+    public:
+        std::string name() const override;
+        bool run(IRFunction& function) override;
+
+    private:
+        /* A phi stepped by a constant each time the loop goes around. */
+        struct Induction
+        {
+            IRInstruction* phi;
+            IRInstruction* next;        /* The value flowing back into the phi. */
+            uint64_t step;
+            std::size_t entry;          /* Predecessor entering the loop. */
+            std::size_t back;           /* Predecessor closing the loop. */
+        };
+
+        std::map<IRBlock*, IRBlock*> idoms;
+
+        bool findInduction(IRInstruction* phi, IRInstruction* product, Induction& induction);
+        IRInstruction* reduce(
+            IRFunction& function,
+            Induction const& induction,
+            IRInstruction* product,
+            IRInstruction* factor
+        );
+
+        // Whether the value is computed before the loop of the induction variable starts
+        bool isInvariant(IRInstruction* value, Induction const& induction);
+
+        // Whether every path from the entry to the block goes through the dominator
+        bool dominates(IRBlock* dominator, IRBlock* block);
+};
+
+/**
+ * Removes unreachable blocks and the instructions
+ * whose value no instruction with effects depends on.
+ */
+class DeadCodeElimination : public IRPass
+{
+    public:
+        std::string name() const override;
+        bool run(IRFunction& function) override;
+};
+
+#endif
@@ -0,0 +1,140 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef PROTO_JIT_ASSEMBLER_H
+#define PROTO_JIT_ASSEMBLER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+
+/* General purpose registers, numbered as in the instruction encoding. */
+enum class Register : uint8_t {
+    Rax, Rcx, Rdx, Rbx, Rsp, Rbp, Rsi, Rdi,
+    R8, R9, R10, R11, R12, R13, R14, R15
+};
+
+/* SSE registers used for floating point operations. */
+enum class XmmRegister : uint8_t {
+    Xmm0, Xmm1
+};
+
+/* Condition codes, numbered as in the instruction encoding. */
+enum class Condition : uint8_t {
+    Overflow, NoOverflow, Below, AboveEqual, Equal, NotEqual, BelowEqual, Above,
+    Sign, NoSign, Parity, NoParity, Less, GreaterEqual, LessEqual, Greater
+};
+
+/* A position in the code that jumps and calls can refer to before it is known. */
+typedef std::size_t Label;
+
+/**
+ * Encodes x86-64 instructions into a buffer.
+ *
+ * Only the forms the JIT emits are provided: every memory operand
+ * is a base register with a 32 bits displacement.
+ */
+class Assembler
+{
+    public:
+        Assembler();
+
+        /**
+         * Returns the code emitted so far, with every jump resolved.
+         */
+        std::vector<uint8_t> const& finish();
+
+        /**
+         * Returns the offset of the next instruction in the code.
+         */
+        std::size_t size() const;
+
+        // Labels
+        Label newLabel();
+        void bind(Label label);
+        std::size_t offset(Label label) const;
+
+        // Moves
+        void mov(Register dst, Register src);
+        void mov(Register dst, uint64_t imm);
+        void load(Register dst, Register base, int32_t disp);
+        void store(Register base, int32_t disp, Register src);
+        void store32(Register base, int32_t disp, uint32_t imm);
+        void lea(Register dst, Register base, int32_t disp);
+        void movq(XmmRegister dst, Register src);
+        void movq(Register dst, XmmRegister src);
+
+        // Integer arithmetic
+        void add(Register dst, Register src);
+        void sub(Register dst, Register src);
+        void imul(Register dst, Register src);
+        void xorq(Register dst, Register src);
+        void neg(Register dst);
+        void notq(Register dst);
+        void cqo();
+        void idiv(Register src);
+        void div(Register src);
+        void sub(Register dst, int32_t imm);
+        void btc(Register dst, uint8_t bit);
+
+        // Comparisons
+        void cmp(Register left, Register right);
+        void test(Register left, Register right);
+        void test8(Register left, Register right);
+        void setcc(Condition condition, Register dst);
+        void and8(Register dst, Register src);
+        void or8(Register dst, Register src);
+        void movzx8(Register dst, Register src);
+
+        // Floating point arithmetic
+        void addsd(XmmRegister dst, XmmRegister src);
+        void subsd(XmmRegister dst, XmmRegister src);
+        void mulsd(XmmRegister dst, XmmRegister src);
+        void divsd(XmmRegister dst, XmmRegister src);
+        void ucomisd(XmmRegister left, XmmRegister right);
+
+        // Control flow
+        void jmp(Label label);
+        void jcc(Condition condition, Label label);
+        void call(Label label);
+        void call(Register target);
+        void push(Register src);
+        void pop(Register dst);
+        void leave();
+        void ret();
+
+    private:
+        std::vector<uint8_t> code;
+        std::vector<std::size_t> labels;                        /* Offset of each bound label. */
+        std::vector<std::pair<std::size_t, Label>> fixups;      /* Displacements to patch. */
+
+        // Encoding
+        void byte(uint8_t value);
+        void bytes32(uint32_t value);
+        void bytes64(uint64_t value);
+        void rex(bool wide, uint8_t reg, uint8_t rm);
+        void modrm(uint8_t reg, uint8_t rm);
+        void memory(uint8_t reg, Register base, int32_t disp);
+        void binary(uint8_t opcode, Register dst, Register src);
+        void unary(uint8_t extension, Register dst);
+        void sse(uint8_t prefix, uint8_t opcode, XmmRegister dst, XmmRegister src);
+        void displacement(Label label);
+};
+
+#endif
@@ -0,0 +1,135 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef PROTO_JIT_COMPILER_H
+#define PROTO_JIT_COMPILER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <map>
+#include <set>
+
+#include "cleaner/ast/definitions/function.h"
+#include "jit/assembler.h"
+#include "common/native.h"
+#include "ir/allocator.h"
+#include "jit/memory.h"
+#include "ir/ir.h"
+
+
+/**
+ * Machine code for the functions the JIT could compile.
+ *
+ * The program must outlive any run of the functions it installed.
+ */
+class JitProgram
+{
+    public:
+        JitProgram();
+        JitProgram(
+            std::vector<uint8_t> const& code,
+            std::map<CleanFunctionDefinition*, std::size_t> const& entries
+        );
+
+        /**
+         * Returns the machine code of the given function,
+         * null if the function is left to the interpreter.
+         */
+        CompiledFunction getFunction(CleanFunctionDefinition* fun_def) const;
+
+        /**
+         * Returns the number of functions compiled to machine code.
+         */
+        std::size_t size() const;
+
+        /**
+         * Makes the interpreter run the compiled functions as machine code.
+         */
+        void install() const;
+
+    private:
+        std::unique_ptr<ExecutableMemory> memory;
+        std::map<CleanFunctionDefinition*, CompiledFunction> functions;
+};
+
+class JitCompiler
+{
+    public:
+        JitCompiler(IRModule& module);
+
+        /**
+         * Returns whether machine code can be generated for this platform.
+         */
+        static bool isAvailable();
+
+        /**
+         * Compiles to x86-64 machine code the functions that only compute
+         * on booleans, integers and floats, and only call intrinsics or
+         * functions that are compiled as well. Other functions are left
+         * to the interpreter.
+         */
+        JitProgram compile();
+
+        /**
+         * Compiles the given function along with the functions it calls,
+         * nothing if the function is left to the interpreter.
+         */
+        JitProgram compile(CleanFunctionDefinition* fun_def);
+
+    private:
+        IRModule& module;                   /* The program in SSA form. */
+        Assembler assembler;                /* The machine code of all functions. */
+        RegisterAllocation allocation;      /* Stack slots of the function's values. */
+        std::size_t scratch;                /* Slot for copies that form a cycle. */
+        Label abort_label;                  /* Where division by zero goes. */
+        Label overflow_label;               /* Where stack overflow goes. */
+
+        /* Where the machine code of each compiled function starts. */
+        std::map<CleanFunctionDefinition*, Label> bodies;
+        std::map<CleanFunctionDefinition*, Label> entries;
+        std::map<IRBlock*, Label> block_labels;
+
+        // Support
+        std::set<CleanFunctionDefinition*> findSupported();
+        bool isSupported(IRFunction& function);
+
+        // Functions
+        JitProgram compileFunctions(std::set<CleanFunctionDefinition*> const& functions);
+        void compileEntry(IRFunction& function);
+        void compileFunction(IRFunction& function);
+
+        // Instructions
+        void compileInstruction(IRInstruction* instr, IRBlock* next);
+        void compileOperation(IRInstruction* instr);
+        void compileCall(IRInstruction* instr);
+        void compileNativeCall(IRInstruction* instr);
+
+        // Copy the values flowing into the phis of a block as if all at once
+        void compilePhiCopies(IRBlock* from, IRBlock* to);
+
+        // Jump to a block unless it comes next
+        void compileJump(IRBlock* target, IRBlock* next);
+
+        // Values
+        void load(Register dst, IRInstruction* value);
+        void store(IRInstruction* value, Register src);
+        int32_t slot(std::size_t reg);
+};
+
+#endif
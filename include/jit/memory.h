@@ -0,0 +1,51 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef PROTO_JIT_MEMORY_H
+#define PROTO_JIT_MEMORY_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+
+/**
+ * Pages holding machine code that can run but not be written.
+ *
+ * The code is copied into writable pages that are made executable
+ * afterwards, so pages are never writable and executable at once.
+ */
+class ExecutableMemory
+{
+    public:
+        ExecutableMemory(std::vector<uint8_t> const& code);
+        ~ExecutableMemory();
+
+        ExecutableMemory(ExecutableMemory const&) = delete;
+        ExecutableMemory& operator=(ExecutableMemory const&) = delete;
+
+        /**
+         * Returns the address of the code at the given offset.
+         */
+        void const* at(std::size_t offset) const;
+
+    private:
+        void* pages;
+        std::size_t size;
+};
+
+#endif
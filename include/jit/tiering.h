@@ -0,0 +1,55 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef PROTO_JIT_TIERING_H
+#define PROTO_JIT_TIERING_H
+
+#include <cstddef>
+#include <vector>
+
+#include "cleaner/ast/definitions/function.h"
+#include "interpreter/tiering.h"
+#include "jit/compiler.h"
+#include "ir/ir.h"
+
+
+/**
+ * Promotes hot functions from the interpreter to machine code.
+ *
+ * A hot function is compiled with the functions it calls, which then
+ * all run as machine code. Functions the JIT does not support stay interpreted.
+ */
+class JitTiering : public Tiering
+{
+    public:
+        JitTiering(IRModule& module, std::size_t threshold, bool trace);
+
+    protected:
+        /**
+         * Gives the given hot function machine code if the JIT supports it.
+         */
+        void promote(CleanFunctionDefinition* fun_def) override;
+
+    private:
+        IRModule& module;                   /* The program in SSA form. */
+        bool trace;                         /* Report promotions on stderr. */
+
+        /* Machine code of the promoted functions, which runs until the program ends. */
+        std::vector<JitProgram> programs;
+};
+
+#endif
@@ -19,20 +19,26 @@
 #ifndef PROTO_LEXER_H
 #define PROTO_LEXER_H
 
+#include <string_view>
 #include <stdexcept>
 #include <cstdbool>
-#include <memory>
+#include <cstddef>
 #include <string>
-#include <map>
 
 #include "common/token_type.h"
+#include "common/source.h"
+#include "lexer/scanner.h"
 #include "common/token.h"
 
 
 class Lexer
 {
     public:
-        Lexer(std::shared_ptr<std::string> const& source, std::string const& source_path);
+        /**
+         * Hands the source over to the source manager and lexes it from there.
+         */
+        Lexer(SourceBuffer source, std::string const& source_path);
+        Lexer(std::string source, std::string const& source_path);
 
         /**
          * Returns the next token in the stream with each call.
@@ -40,9 +46,9 @@ class Lexer
         Token lex();
 
         /**
-         * Returns the source code.
+         * Returns the identifier of the source in the source manager.
          */
-        std::shared_ptr<std::string>& getSource()
+        std::size_t getSource() const
         {
             return source;
         }
@@ -50,30 +56,20 @@ class Lexer
         /**
          * Returns the source path.
          */
-        std::string& getSourcePath()
-        {
-            return source_path;
-        }
-
-        /**
-         * Returns the iterator to the start of the source.
-         */
-        std::string::iterator& getStart()
+        std::string const& getSourcePath() const
         {
-            return start;
+            return SourceManager::getPath(source);
         }
 
     private:
-        std::shared_ptr<std::string>    source;         /* Source code to lex. */
-        std::string                     source_path;    /* Path to the source code for error message. */
-        std::string::iterator           start;          /* Start of the token currently being scanned. */
-        std::string::iterator           current;        /* Pointer to the current character in the source. */
+        std::size_t                     source;         /* Source code to lex, in the source manager. */
+        std::string_view                text;           /* Text of the source code, scanned in place. */
+        std::string_view::const_iterator start;         /* Start of the token currently being scanned. */
+        std::string_view::const_iterator current;       /* Pointer to the current character in the source. */
         std::string::size_type          line;           /* Line where the scanned token was found. */
         std::string::size_type          column;         /* Column where the scanned token was found. */
         std::size_t                     num_tokens;     /* Total number of tokens scanned in the source. */
-
-        std::map<std::string,
-            enum TokenType>             keywords;       /* All supported keywords */
+        Scanner                         scanner;        /* Skips runs of whitespace, comments and identifiers. */
 
         /**
          * Lex a number.
@@ -125,6 +121,13 @@ class Lexer
         // Returns the previous character in the stream.
         char peekBack();
 
+        // Skips the run of characters the scanner found, the run must not span lines.
+        void skip(std::size_t length);
+
+        // Returns pointers to the current character and past the end of the source, for the scanner.
+        char const* position();
+        char const* end();
+
         // Create a token.
         Token makeToken(enum TokenType type);
 };
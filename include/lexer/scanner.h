@@ -0,0 +1,89 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef PROTO_LEXER_SCANNER_H
+#define PROTO_LEXER_SCANNER_H
+
+#include <cstddef>
+
+
+/* Instructions the scanner skips runs of characters with. */
+enum class ScanLevel
+{
+    Scalar,     /* One character at a time. */
+    SSE2,       /* 16 characters at a time. */
+    AVX2        /* 32 characters at a time. */
+};
+
+/* A run of characters skipped at once. */
+struct ScanRun
+{
+    std::size_t length;         /* Number of characters in the run. */
+    std::size_t newlines;       /* Number of newlines in the run. */
+    std::size_t line_start;     /* Index of the character after the last newline, if any. */
+};
+
+
+class Scanner
+{
+    public:
+        /**
+         * Scans with the widest instructions the processor supports.
+         */
+        Scanner();
+
+        /**
+         * Scans with the given instructions if the processor supports them,
+         * with the widest it supports otherwise.
+         */
+        Scanner(ScanLevel level);
+
+        /**
+         * Returns the widest instructions the processor supports,
+         * checked once when first asked.
+         */
+        static ScanLevel supportedLevel();
+
+        /**
+         * Returns the instructions this scanner uses.
+         */
+        ScanLevel getLevel() const
+        {
+            return level;
+        }
+
+        /**
+         * Each returns the length of the run of characters starting at `begin`
+         * that the lexer skips the same way, never reading at or past `end`.
+         */
+        // Spaces, tabs and carriage returns
+        std::size_t skipBlanks(char const* begin, char const* end) const;
+
+        // Letters, digits and underscores
+        std::size_t skipIdentifier(char const* begin, char const* end) const;
+
+        // Anything up to a newline
+        std::size_t skipLine(char const* begin, char const* end) const;
+
+        // Anything up to a character that may open or close a comment, counting newlines
+        ScanRun skipCommentBody(char const* begin, char const* end) const;
+
+    private:
+        ScanLevel level;    /* Instructions used to scan. */
+};
+
+#endif
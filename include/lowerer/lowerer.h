@@ -0,0 +1,59 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef PROTO_LOWERER_H
+#define PROTO_LOWERER_H
+
+#include <memory>
+
+#include "cleaner/ast/expressions/expression.h"
+#include "cleaner/ast/definitions/function.h"
+#include "cleaner/ast/statements/statement.h"
+#include "cleaner/ast/statements/block.h"
+#include "cleaner/symbols/scope.h"
+
+
+class Lowerer
+{
+    public:
+        Lowerer(CleanScope* scope);
+
+        /**
+         * Replaces calls to reslib operators on primitive types
+         * by the typed operations they stand for.
+         * Logical and and or become conditional expressions
+         * so their right operand only runs when it decides the result.
+         */
+        void lower();
+
+    private:
+        CleanScope* scope;                  /* The global scope. */
+
+        // Statements
+        void lowerStatement(std::unique_ptr<CleanStatement>& stmt);
+
+        // Blocks
+        void lowerBlock(CleanBlockStatement* block_stmt);
+
+        // Expressions
+        void lowerExpression(std::unique_ptr<CleanExpression>& expr);
+
+        // Calls
+        void lowerCall(std::unique_ptr<CleanExpression>& expr);
+};
+
+#endif
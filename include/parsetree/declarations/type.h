@@ -19,6 +19,7 @@
 #define PROTO_AST_TYPE_DECLARATION_H
 
 #include <cstdbool>
+#include <memory>
 
 #include "common/token.h"
 #include "declaration.h"
@@ -0,0 +1,89 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef PROTO_PIPELINE_H
+#define PROTO_PIPELINE_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <string>
+
+#include "cleaner/cleaner_warning.h"
+#include "cleaner/symbols/scope.h"
+#include "ir/ir.h"
+
+
+/* The passes a cleaned program goes through, in the order they run. */
+enum class PipelineStage {
+    Inline,
+    Resolve,
+    Lower,
+    Load,
+    Fold,
+    Eliminate,
+    Link,
+    Purity,
+    Hoist
+};
+
+class Pipeline
+{
+    public:
+        /* Largest function inlined unless told otherwise. */
+        static std::size_t const default_inline_threshold = 24;
+
+        Pipeline(std::shared_ptr<CleanScope> scope, std::size_t inline_threshold);
+
+        /**
+         * Runs the passes that did not run yet, up to the given one included.
+         *
+         * Every backend expects all of them to have run, the C emitter
+         * translates the program right after calls are linked.
+         */
+        void runUntil(enum PipelineStage last);
+
+        /**
+         * Lowers the program to SSA form and optimizes it.
+         * All the passes must have run first.
+         */
+        IRModule buildModule();
+
+        /**
+         * Returns the global scope the passes work on.
+         */
+        std::shared_ptr<CleanScope> const& getScope() const;
+
+        /**
+         * Returns one line per call that was inlined.
+         */
+        std::vector<std::string> const& getInlineReport() const;
+
+        /* List of warnings to display once the passes finish. */
+        std::vector<CleanerWarning> warnings;
+
+    private:
+        std::shared_ptr<CleanScope> scope;          /* The global scope. */
+        std::size_t inline_threshold;               /* Largest function inlined, 0 disables inlining. */
+        std::size_t next;                           /* The first pass that did not run yet. */
+        std::vector<std::string> inline_report;     /* Calls that were inlined. */
+
+        // Run a single pass
+        void run(enum PipelineStage stage);
+};
+
+#endif
@@ -0,0 +1,54 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef PROTO_LINKER_H
+#define PROTO_LINKER_H
+
+#include "cleaner/ast/expressions/expression.h"
+#include "cleaner/ast/statements/statement.h"
+#include "cleaner/ast/statements/block.h"
+#include "cleaner/symbols/scope.h"
+
+
+class Linker
+{
+    public:
+        Linker(CleanScope* scope);
+
+        /**
+         * Binds every call expression to the function definition it calls.
+         *
+         * Intrinsics must be loaded in the global scope first.
+         * Calls to operators the checker accepts but no library implements
+         * are bound to a function that fails when it is called.
+         */
+        void link();
+
+    private:
+        CleanScope* scope;                  /* The global scope. */
+
+        // Statements
+        void linkStatement(CleanStatement* stmt);
+
+        // Blocks
+        void linkBlock(CleanBlockStatement* block_stmt);
+
+        // Expressions
+        void linkExpression(CleanExpression* expr);
+};
+
+#endif
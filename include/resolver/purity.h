@@ -0,0 +1,60 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef PROTO_PURITY_H
+#define PROTO_PURITY_H
+
+#include <cstdbool>
+#include <cstddef>
+#include <set>
+
+#include "cleaner/ast/expressions/expression.h"
+#include "cleaner/ast/definitions/function.h"
+#include "cleaner/ast/statements/statement.h"
+#include "cleaner/ast/statements/block.h"
+#include "cleaner/symbols/scope.h"
+
+
+class Purity
+{
+    public:
+        Purity(CleanScope* scope);
+
+        /**
+         * Marks the user functions whose result only depends on their arguments.
+         *
+         * A pure function doesn't write global variables, doesn't read global
+         * variables written anywhere in the program and only calls pure functions.
+         * The program must have gone through the resolver and the linker.
+         */
+        void analyze();
+
+    private:
+        CleanScope* scope;                  /* The global scope. */
+        std::set<std::size_t> written;      /* Slots of the globals the program writes. */
+
+        // Collect the globals written by statements and expressions
+        void collectStatement(CleanStatement* stmt);
+        void collectExpression(CleanExpression* expr);
+
+        // Check statements and expressions under the current assumptions
+        bool isPureStatement(CleanStatement* stmt);
+        bool isPureBlock(CleanBlockStatement* block_stmt);
+        bool isPureExpression(CleanExpression* expr);
+};
+
+#endif
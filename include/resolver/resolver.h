@@ -0,0 +1,76 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef PROTO_RESOLVER_H
+#define PROTO_RESOLVER_H
+
+#include <cstddef>
+#include <memory>
+#include <set>
+
+#include "cleaner/ast/expressions/expression.h"
+#include "cleaner/ast/definitions/function.h"
+#include "cleaner/ast/definitions/variable.h"
+#include "cleaner/ast/statements/statement.h"
+#include "cleaner/ast/statements/block.h"
+#include "cleaner/symbols/scope.h"
+
+
+class Resolver
+{
+    public:
+        Resolver(CleanScope* scope);
+
+        /**
+         * Assigns a frame slot to every global, parameter and local variable,
+         * and binds every variable expression to the slot it refers to.
+         */
+        void resolve();
+
+    private:
+        CleanScope* scope;                  /* The global scope. */
+        CleanFunctionDefinition* fun_def;   /* The function being resolved. */
+        std::size_t next_slot;              /* First free slot in the function frame. */
+
+        /* Local variables whose initialization point has been seen. */
+        std::set<CleanVariableDefinition*> initialized;
+
+        // Function definitions
+        void resolveFunction(CleanFunctionDefinition* fun_def);
+
+        // Statements
+        void resolveStatement(CleanStatement* stmt, CleanScope* scope);
+
+        // Blocks
+        void resolveBlock(CleanBlockStatement* block_stmt);
+
+        // Expressions
+        void resolveExpression(CleanExpression* expr, CleanScope* scope);
+
+        // Assignments
+        void resolveAssignment(
+            CleanAssignmentExpression* assign_expr, CleanScope* scope);
+
+        // Assign slots to all variables defined in the given scope
+        void allocateSlots(CleanScope* scope);
+
+        // Find the definition a variable expression refers to and bind it
+        CleanVariableDefinition* bind(
+            CleanVariableExpression* var_expr, CleanScope* scope);
+};
+
+#endif
@@ -18,6 +18,7 @@
 #ifndef PROTO_SYMBOLS_SCOPE_H
 #define PROTO_SYMBOLS_SCOPE_H
 
+#include <string_view>
 #include <cstdbool>
 #include <memory>
 #include <string>
@@ -44,8 +45,8 @@ class Scope
          * If `deep` is true, in case the symbol can't be found in the current scope,
          * the symbol will be searched for in the parent scope.
          */
-        std::unique_ptr<Definition>& getDefinition(std::string const& def_name, bool deep = false);
-        std::unique_ptr<VariableDeclaration>& getVariableDeclaration(std::string const& decl_name, bool deep = false);
+        std::unique_ptr<Definition>& getDefinition(std::string_view def_name, bool deep = false);
+        std::unique_ptr<VariableDeclaration>& getVariableDeclaration(std::string_view decl_name, bool deep = false);
 
         /**
          * Returns true if the given symbol exists in this scope's symtable.
@@ -53,8 +54,8 @@ class Scope
          * If `deep` is true, in case the symbol can't be found in the current scope,
          * the symbol will be searched for in the parent scope.
          */
-        bool hasDefinition(std::string const& def_name, bool deep = false);
-        bool hasVariableDeclaration(std::string const& decl_name, bool deep = false);
+        bool hasDefinition(std::string_view def_name, bool deep = false);
+        bool hasVariableDeclaration(std::string_view decl_name, bool deep = false);
 
         /**
          * Returns true if this scope has a parent.
@@ -18,6 +18,8 @@
 #ifndef PROTO_SYMBOLS_SYMTABLE_H
 #define PROTO_SYMBOLS_SYMTABLE_H
 
+#include <string_view>
+#include <functional>
 #include <cstdbool>
 #include <memory>
 #include <string>
@@ -42,20 +44,20 @@ class Symtable
          * Returns a symbol, given its name.
          * Throws std::out_of_range if no such symbol could be found.
          */
-        std::unique_ptr<Definition>& getDefinition(std::string const& def_name);
-        std::unique_ptr<VariableDeclaration>& getVariableDeclaration(std::string const& decl_name);
+        std::unique_ptr<Definition>& getDefinition(std::string_view def_name);
+        std::unique_ptr<VariableDeclaration>& getVariableDeclaration(std::string_view decl_name);
 
         /**
          * Returns true if the given symbol exists in this table.
          */
-        bool hasDefinition(std::string const& def_name);\
-        bool hasVariableDeclaration(std::string const& decl_name);
+        bool hasDefinition(std::string_view def_name);
+        bool hasVariableDeclaration(std::string_view decl_name);
 
         /**
          * Returns all the symbols present in this table.
          */
-        std::map<std::string, struct DefinitionSymbol>& getDefinitions();
-        std::map<std::string, struct VariableDeclarationSymbol>& getVariableDeclarations();
+        std::map<std::string, struct DefinitionSymbol, std::less<>>& getDefinitions();
+        std::map<std::string, struct VariableDeclarationSymbol, std::less<>>& getVariableDeclarations();
 
         /**
          * Deletes all the symbols in this table.
@@ -73,8 +75,9 @@ class Symtable
         void clearVariableDeclarations() noexcept;
 
     private:
-        std::map<std::string, struct DefinitionSymbol>  definitions;    /* Map between symbol name and symbol information. */
-        std::map<std::string, struct VariableDeclarationSymbol> declarations;   /* Map between symbol name and symbol information. */
+        /* Map between symbol name and symbol information, looked up by lexeme without copying it. */
+        std::map<std::string, struct DefinitionSymbol, std::less<>> definitions;
+        std::map<std::string, struct VariableDeclarationSymbol, std::less<>> declarations;
 };
 
 struct DefinitionSymbol
@@ -103,7 +106,7 @@ class BuiltinTypesSymtable
         /**
          * Returns true if the given type is a builtin type.
          */
-        static bool isBuiltinType(std::string const& type);
+        static bool isBuiltinType(std::string_view type);
 
     private:
         const static std::array<std::string, 6> builtin_types;
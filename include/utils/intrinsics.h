@@ -24,16 +24,19 @@
 
 #include "cleaner/ast/expressions/expression.h"
 #include "cleaner/ast/definitions/function.h"
+#include "common/native.h"
 
 
 /**
  * Generate an intrinsic function
+ *
+ * Intrinsics are pure unless the library marks them otherwise.
  */
 std::unique_ptr<CleanFunctionDefinition> intrinsicGenerator(
     std::string const& name,
     std::map<std::string, std::string>& params,
     std::string const& ret_type,
-    std::function<std::unique_ptr<CleanExpression>(CleanScope*)> callable
+    NativeFunction callable
 );
 
 #endif
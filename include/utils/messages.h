@@ -25,14 +25,14 @@
 
 /**
  * Given a token and an error message, display that error in a visually appealing way.
+ * The file and the line shown come from the source manager.
  */
 void
 printMessage(
     std::string const& title,
     Token const& token,
     std::string const& primary_message,
-    std::string const& secondary_message,
-    std::string const& source_path
+    std::string const& secondary_message
 );
 
 #endif
@@ -0,0 +1,190 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef PROTO_VM_BYTECODE_H
+#define PROTO_VM_BYTECODE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <string>
+
+#include "common/native.h"
+#include "common/value.h"
+#include "common/memo.h"
+
+
+enum class OpCode : uint8_t {
+    LoadConst,      /* R[a] = K[b] */
+    Move,           /* R[a] = R[b] */
+    LoadGlobal,     /* R[a] = G[b] */
+    StoreGlobal,    /* G[a] = R[b] */
+    Jump,           /* pc = a */
+    JumpIfFalse,    /* if not R[b] then pc = a */
+    Call,           /* R[a] = F[b](R[c], ...) */
+    TailCall,       /* return F[b](R[c], ...) in the current frame */
+    CallMemo,       /* R[a] = F[b](R[c], ...) through the function's cache */
+    CallNative,     /* R[a] = N[b](R[c], ...) */
+    Return,         /* return R[a] */
+    ReturnVoid,     /* return nothing */
+
+    // Typed operations, in the same order as Operation
+    AddI64,         /* R[a] = R[b] + R[c] */
+    SubI64,         /* R[a] = R[b] - R[c] */
+    MulI64,         /* R[a] = R[b] * R[c] */
+    DivI64,         /* R[a] = R[b] / R[c] */
+    RemI64,         /* R[a] = R[b] % R[c] */
+    NegI64,         /* R[a] = -R[b] */
+    BnotI64,        /* R[a] = ~R[b] */
+    EqI64,          /* R[a] = R[b] == R[c] */
+    NeI64,          /* R[a] = R[b] != R[c] */
+    GtI64,          /* R[a] = R[b] > R[c] */
+    GeI64,          /* R[a] = R[b] >= R[c] */
+    LtI64,          /* R[a] = R[b] < R[c] */
+    LeI64,          /* R[a] = R[b] <= R[c] */
+    AddU64,         /* R[a] = R[b] + R[c] */
+    SubU64,         /* R[a] = R[b] - R[c] */
+    MulU64,         /* R[a] = R[b] * R[c] */
+    DivU64,         /* R[a] = R[b] / R[c] */
+    RemU64,         /* R[a] = R[b] % R[c] */
+    NegU64,         /* R[a] = -R[b] */
+    BnotU64,        /* R[a] = ~R[b] */
+    EqU64,          /* R[a] = R[b] == R[c] */
+    NeU64,          /* R[a] = R[b] != R[c] */
+    GtU64,          /* R[a] = R[b] > R[c] */
+    GeU64,          /* R[a] = R[b] >= R[c] */
+    LtU64,          /* R[a] = R[b] < R[c] */
+    LeU64,          /* R[a] = R[b] <= R[c] */
+    AddF64,         /* R[a] = R[b] + R[c] */
+    SubF64,         /* R[a] = R[b] - R[c] */
+    MulF64,         /* R[a] = R[b] * R[c] */
+    DivF64,         /* R[a] = R[b] / R[c] */
+    NegF64,         /* R[a] = -R[b] */
+    EqF64,          /* R[a] = R[b] == R[c] */
+    NeF64,          /* R[a] = R[b] != R[c] */
+    GtF64,          /* R[a] = R[b] > R[c] */
+    GeF64,          /* R[a] = R[b] >= R[c] */
+    LtF64,          /* R[a] = R[b] < R[c] */
+    LeF64,          /* R[a] = R[b] <= R[c] */
+    NotBool,        /* R[a] = ! R[b] */
+    EqBool,         /* R[a] = R[b] == R[c] */
+    NeBool          /* R[a] = R[b] != R[c] */
+};
+
+/**
+ * A single register instruction.
+ *
+ * Registers are relative to the base of the running function's frame.
+ */
+struct Instruction
+{
+    Instruction(
+        enum OpCode op,
+        uint16_t a,
+        uint16_t b,
+        uint16_t c
+    ) : op(op),
+        a(a),
+        b(b),
+        c(c)
+    {}
+
+    enum OpCode op;
+    uint16_t a;
+    uint16_t b;
+    uint16_t c;
+};
+
+static_assert(sizeof(Instruction) == 8, "Instructions must fit in 8 bytes.");
+
+/**
+ * A user function compiled to bytecode.
+ *
+ * Parameters occupy the first registers, followed by the local variable
+ * slots assigned by the resolver and then by temporaries.
+ */
+struct BytecodeFunction
+{
+    BytecodeFunction(
+        std::string const& name,
+        std::size_t param_count
+    ) : name(name),
+        param_count(param_count),
+        register_count(0),
+        memo(nullptr)
+    {}
+
+    std::string name;
+    std::size_t param_count;
+    std::size_t register_count;
+    std::vector<Instruction> code;
+    std::vector<Value> constants;
+    MemoTable* memo;                    /* Cached results, null unless memoized. */
+};
+
+/**
+ * An intrinsic function called from bytecode.
+ */
+struct BytecodeNative
+{
+    BytecodeNative(
+        std::string const& name,
+        NativeFunction callable,
+        std::size_t arity
+    ) : name(name),
+        callable(callable),
+        arity(arity)
+    {}
+
+    std::string name;
+    NativeFunction callable;
+    std::size_t arity;
+};
+
+/**
+ * A whole program compiled to bytecode.
+ *
+ * Strings referenced by constants are owned by the AST
+ * so the AST must outlive the bytecode.
+ */
+struct Bytecode
+{
+    Bytecode(
+    ) : main_index(0)
+    {}
+
+    std::vector<BytecodeFunction> functions;
+    std::vector<BytecodeNative> natives;
+    std::vector<Value> globals;
+    std::size_t main_index;
+};
+
+/**
+ * Returns the string representation of an opcode.
+ *
+ * @param       op the opcode to get the string representation of.
+ *
+ * @return      the string representation of the opcode.
+ */
+std::string opCodeToString(enum OpCode op);
+
+/**
+ * Returns a human readable listing of the given function's instructions.
+ */
+std::string disassemble(BytecodeFunction const& fun);
+
+#endif
@@ -0,0 +1,93 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef PROTO_VM_GENERATOR_H
+#define PROTO_VM_GENERATOR_H
+
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include <map>
+
+#include "cleaner/ast/definitions/function.h"
+#include "ir/allocator.h"
+#include "common/value.h"
+#include "vm/bytecode.h"
+#include "ir/ir.h"
+
+
+class BytecodeGenerator
+{
+    public:
+        BytecodeGenerator(IRModule& module);
+
+        /**
+         * Generates register bytecode for every function of the module.
+         *
+         * Values live in the registers linear scan gave them, arguments
+         * are passed in registers above all of them so calls never
+         * overwrite a value of the caller.
+         */
+        Bytecode generate();
+
+    private:
+        IRModule& module;                   /* The program in SSA form. */
+        Bytecode bytecode;                  /* The program being generated. */
+        BytecodeFunction* fun;              /* The function being generated. */
+        RegisterAllocation allocation;      /* Registers of the function's values. */
+        std::size_t scratch;                /* Register for copies that form a cycle. */
+        std::size_t arg_base;               /* First register of call arguments. */
+
+        /* Jumps waiting for the position of the block they go to. */
+        std::vector<std::pair<std::size_t, IRBlock*>> jumps;
+        std::map<IRBlock*, std::size_t> block_positions;
+
+        /* Indices of user functions and intrinsics in the bytecode tables. */
+        std::map<CleanFunctionDefinition*, std::size_t> function_indices;
+        std::map<CleanFunctionDefinition*, std::size_t> native_indices;
+
+        // Functions
+        void generateFunction(IRFunction& function);
+
+        // Instructions
+        void generateInstruction(IRInstruction* instr, IRBlock* next);
+        void generateCall(IRInstruction* instr);
+
+        // Compute arguments used nowhere else directly in their argument register
+        void placeArguments(IRFunction& function);
+
+        // Copy the values flowing into the phis of a block as if all at once
+        void generatePhiCopies(IRBlock* from, IRBlock* to);
+
+        // Jump to a block unless it comes next
+        void generateJump(IRBlock* target, IRBlock* next);
+
+        // Register holding the given value
+        std::size_t reg(IRInstruction* value);
+
+        // Index of the given intrinsic in the natives table
+        std::size_t nativeIndex(CleanFunctionDefinition* fun_def);
+
+        // Append an instruction and return its position
+        std::size_t emit(enum OpCode op, std::size_t a, std::size_t b, std::size_t c);
+
+        // Add a constant to the function's constant table and return its index
+        std::size_t addConstant(Value value);
+};
+
+#endif
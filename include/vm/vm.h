@@ -0,0 +1,65 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#ifndef PROTO_VM_H
+#define PROTO_VM_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "common/value.h"
+#include "vm/bytecode.h"
+
+
+class VM
+{
+    public:
+        VM(Bytecode& bytecode);
+
+        /**
+         * Runs the program starting with its main function.
+         */
+        int run();
+
+        /**
+         * Runs the function at the given index with the given arguments.
+         */
+        Value call(std::size_t fun_index, std::vector<Value> const& arguments);
+
+    private:
+        // Number of registers available to activation records
+        static constexpr std::size_t stack_capacity = 1 << 20;
+
+        /* The state of a caller suspended by a call. */
+        struct CallInfo
+        {
+            BytecodeFunction* fun;
+            Instruction const* pc;
+            Value* base;
+            uint16_t dst;
+        };
+
+        Bytecode& bytecode;
+        std::vector<Value> registers;
+        std::vector<CallInfo> calls;
+
+        // Execute the function whose frame starts at the given register
+        Value execute(BytecodeFunction* fun, Value* base);
+};
+
+#endif
@@ -47,13 +47,11 @@ static void
 checkSimpleType(SimpleTypeDeclaration& simple_type_decl)
 {
     Token& decl_token = simple_type_decl.getToken();
-    std::string decl_lexeme = decl_token.getLexeme();
-
-    if (BuiltinTypesSymtable::isBuiltinType(decl_lexeme) == false)
+    if (BuiltinTypesSymtable::isBuiltinType(decl_token.getLexemeView()) == false)
         throw CheckerError(
             decl_token,
             "unknown type",
-            "type `" + decl_lexeme + "` does not exist",
+            "type `" + decl_token.getLexeme() + "` does not exist",
             true
         );
 }
@@ -50,7 +50,7 @@ void
 VariableDefinitionChecker::check()
 {
     // Check if this variable tries to shadow a function parameter
-    if (scope->hasVariableDeclaration(variable_def->getToken().getLexeme(), true)) {
+    if (scope->hasVariableDeclaration(variable_def->getToken().getLexemeView(), true)) {
         throw CheckerError(
             variable_def->getToken(),
             "variable shadows function parameter",
@@ -61,7 +61,7 @@ VariableDefinitionChecker::check()
     }
 
     // Check for redefinition
-    if (scope->hasDefinition(variable_def->getToken().getLexeme())) {
+    if (scope->hasDefinition(variable_def->getToken().getLexemeView())) {
         throw CheckerError(
             variable_def->getToken(),
             "variable redefinition",
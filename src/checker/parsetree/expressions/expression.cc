@@ -313,13 +313,13 @@ ExpressionChecker::checkAssignment(Expression* expr)
 
     // Make sure that if the LHS exists, it is not const
     VariableExpression* var_expr = static_cast<VariableExpression*>(lval.get());
-    bool decl_found = scope->hasVariableDeclaration(var_expr->getToken().getLexeme(), true);
-    bool def_found = scope->hasDefinition(var_expr->getToken().getLexeme(), true);
+    bool decl_found = scope->hasVariableDeclaration(var_expr->getToken().getLexemeView(), true);
+    bool def_found = scope->hasDefinition(var_expr->getToken().getLexemeView(), true);
 
     if (decl_found || def_found) {
         if (decl_found) {
             std::unique_ptr<VariableDeclaration>& decl = scope->getVariableDeclaration(
-                var_expr->getToken().getLexeme(),
+                var_expr->getToken().getLexemeView(),
                 true
             );
 
@@ -335,7 +335,7 @@ ExpressionChecker::checkAssignment(Expression* expr)
         }
         else {
             std::unique_ptr<Definition>& def = scope->getDefinition(
-                var_expr->getToken().getLexeme(),
+                var_expr->getToken().getLexemeView(),
                 true
             );
             
@@ -0,0 +1,138 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdexcept>
+#include <utility>
+#include <memory>
+
+#include "cleaner/ast/expressions/expression.h"
+
+
+/**
+ * Returns a deep copy of the given expression.
+ */
+std::unique_ptr<CleanExpression>
+copy(CleanExpression* expr)
+{
+    switch (expr->type) {
+        case CleanExpressionType::Boolean: {
+            return std::make_unique<CleanBoolExpression>(
+                static_cast<CleanBoolExpression*>(expr)
+            );
+        }
+
+        case CleanExpressionType::SignedInt: {
+            return std::make_unique<CleanSignedIntExpression>(
+                static_cast<CleanSignedIntExpression*>(expr)
+            );
+        }
+
+        case CleanExpressionType::UnsignedInt: {
+            return std::make_unique<CleanUnsignedIntExpression>(
+                static_cast<CleanUnsignedIntExpression*>(expr)
+            );
+        }
+
+        case CleanExpressionType::Float: {
+            return std::make_unique<CleanFloatExpression>(
+                static_cast<CleanFloatExpression*>(expr)
+            );
+        }
+
+        case CleanExpressionType::String: {
+            return std::make_unique<CleanStringExpression>(
+                static_cast<CleanStringExpression*>(expr)
+            );
+        }
+
+        case CleanExpressionType::Variable: {
+            CleanVariableExpression* var_expr =
+                static_cast<CleanVariableExpression*>(expr);
+            std::unique_ptr<CleanVariableExpression> var_copy =
+                std::make_unique<CleanVariableExpression>(var_expr->var_name);
+            var_copy->depth = var_expr->depth;
+            var_copy->slot = var_expr->slot;
+            return var_copy;
+        }
+
+        case CleanExpressionType::Group: {
+            CleanGroupExpression* gr_expr =
+                static_cast<CleanGroupExpression*>(expr);
+            return std::make_unique<CleanGroupExpression>(
+                copy(gr_expr->expression.get())
+            );
+        }
+
+        case CleanExpressionType::Call: {
+            CleanCallExpression* call_expr =
+                static_cast<CleanCallExpression*>(expr);
+            std::unique_ptr<CleanCallExpression> call_copy =
+                std::make_unique<CleanCallExpression>(call_expr->fun_name);
+            // Whether the copy is a tail call depends on where it goes
+            call_copy->fun_def = call_expr->fun_def;
+            for (auto& argument: call_expr->arguments)
+                call_copy->arguments.push_back(copy(argument.get()));
+            return call_copy;
+        }
+
+        case CleanExpressionType::TernaryIf: {
+            CleanTernaryIfExpression* ternif_expr =
+                static_cast<CleanTernaryIfExpression*>(expr);
+            return std::make_unique<CleanTernaryIfExpression>(
+                copy(ternif_expr->condition.get()),
+                copy(ternif_expr->then_branch.get()),
+                copy(ternif_expr->else_branch.get())
+            );
+        }
+
+        case CleanExpressionType::Assignment: {
+            CleanAssignmentExpression* assign_expr =
+                static_cast<CleanAssignmentExpression*>(expr);
+            std::unique_ptr<CleanAssignmentExpression> assign_copy =
+                std::make_unique<CleanAssignmentExpression>(
+                    copy(assign_expr->lvalue.get()),
+                    copy(assign_expr->rvalue.get())
+                );
+            assign_copy->is_initializer = assign_expr->is_initializer;
+            return assign_copy;
+        }
+
+        case CleanExpressionType::Intrinsic: {
+            CleanIntrinsicExpression* intr_expr =
+                static_cast<CleanIntrinsicExpression*>(expr);
+            return std::make_unique<CleanIntrinsicExpression>(
+                intr_expr->callable,
+                intr_expr->arity
+            );
+        }
+
+        case CleanExpressionType::Operation: {
+            CleanOperationExpression* op_expr =
+                static_cast<CleanOperationExpression*>(expr);
+            std::unique_ptr<CleanOperationExpression> op_copy =
+                std::make_unique<CleanOperationExpression>(op_expr->operation);
+            for (auto& operand: op_expr->operands)
+                op_copy->operands.push_back(copy(operand.get()));
+            return op_copy;
+        }
+
+        default:
+            throw std::runtime_error(
+                "Expression copy failed: unknow expression type."
+            );
+    }
+}
@@ -44,7 +44,7 @@ Cleaner::clean()
         program.getDefinitions();
 
     for (auto& definition: definitions) {
-        if (definition->getToken().getLexeme() != "main" && ! definition->isUsed()) {
+        if (definition->getToken().getLexemeView() != "main" && ! definition->isUsed()) {
             warnings.emplace_back(
                 definition->getToken(),
                 "unused definition",
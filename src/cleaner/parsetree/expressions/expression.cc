@@ -15,8 +15,11 @@
  *  limitations under the License.
  */
 
+#include <system_error>
+#include <string_view>
 #include <stdexcept>
 #include <cstdbool>
+#include <charconv>
 #include <cstdint>
 #include <utility>
 #include <memory>
@@ -39,6 +42,9 @@
 #include "cleaner/symbols/scope.h"
 
 
+template <typename Number>
+static Number parseNumber(Token const& token);
+
 ExpressionCleaner::ExpressionCleaner(
     std::shared_ptr<CleanScope> const& scope
 ) : scope(scope)
@@ -123,19 +129,19 @@ ExpressionCleaner::cleanLiteral(
     switch (lit_expr->getLiteralType()) {
         case LiteralType::Boolean: {
             return std::make_unique<CleanBoolExpression>(
-                lit_expr->getToken().getLexeme() == "true" ? true : false
+                lit_expr->getToken().getLexemeView() == "true" ? true : false
             );
         }
 
         case LiteralType::Integer: {
             return std::make_unique<CleanSignedIntExpression>(
-                (int64_t) std::stoll(lit_expr->getToken().getLexeme().c_str())
+                parseNumber<int64_t>(lit_expr->getToken())
             );
         }
 
         case LiteralType::Float: {
             return std::make_unique<CleanFloatExpression>(
-                (double) std::stod(lit_expr->getToken().getLexeme().c_str())
+                parseNumber<double>(lit_expr->getToken())
             );
         }
 
@@ -165,7 +171,7 @@ ExpressionCleaner::cleanCast(
             static_cast<LiteralExpression*>(expr);
         if (lit_expr->getLiteralType() == LiteralType::Integer)
             return std::make_unique<CleanUnsignedIntExpression>(
-                ((uint64_t) std::stoull(lit_expr->getToken().getLexeme().c_str()))
+                parseNumber<uint64_t>(lit_expr->getToken())
             );
     }
 
@@ -236,7 +242,7 @@ ExpressionCleaner::cleanUnary(
         if (lit_expr->getLiteralType() == LiteralType::Integer)
             return std::make_unique<CleanSignedIntExpression>(
                 // TODO: review this to be sure we are conformant
-                -((int64_t) std::stoll(lit_expr->getToken().getLexeme().c_str()))
+                -(parseNumber<int64_t>(lit_expr->getToken()))
             );
     }
 
@@ -320,8 +326,28 @@ ExpressionCleaner::cleanAssignment(
         VariableDefinitionCleaner(var_def, scope).clean();
     }
 
-    return std::make_unique<CleanAssignmentExpression>(
-        clean(lval_expr),
-        clean(rval_expr)
-    );
+    std::unique_ptr<CleanAssignmentExpression> clean_assign =
+        std::make_unique<CleanAssignmentExpression>(
+            clean(lval_expr),
+            clean(rval_expr)
+        );
+    clean_assign->is_initializer = def != nullptr;
+    return clean_assign;
+}
+
+
+// Parses a numeric literal straight from the source, out of range literals throw like std::stoll did
+template <typename Number>
+static Number
+parseNumber(Token const& token)
+{
+    std::string_view lexeme = token.getLexemeView();
+    Number number = 0;
+    auto [end, error] = std::from_chars(lexeme.data(), lexeme.data() + lexeme.size(), number);
+    if (error == std::errc::result_out_of_range)
+        throw std::out_of_range("Cleaning failed: literal `" + std::string(lexeme) + "` is out of range.");
+    if (error != std::errc())
+        throw std::invalid_argument("Cleaning failed: `" + std::string(lexeme) + "` is not a number.");
+
+    return number;
 }
@@ -118,12 +118,19 @@ StatementCleaner::cleanBlock(
             VariableDefinition* var_def =
                 static_cast<VariableDefinition*>(definition.get());
             VariableDefinitionCleaner(var_def, block_scope).clean();
+
+            // The variable is initialized where it is defined
+            clean_block->statements.push_back(
+                cleanInitializer(var_def, block_scope)
+            );
+            clean_block->statements.back()->token = var_def->getToken();
         }
         else if (definition->getType() == DefinitionType::Statement) {
             Statement* stmt_def = static_cast<Statement*>(definition.get());
             clean_block->statements.push_back(
                 clean(stmt_def, block_scope)
             );
+            clean_block->statements.back()->token = stmt_def->getToken();
         }
         else {
             throw std::invalid_argument("Unexpected definition inside a block.");
@@ -187,6 +194,7 @@ StatementCleaner::cleanFor(
         VariableDefinition* var_def =
             static_cast<VariableDefinition*>(init_clause.get());
         VariableDefinitionCleaner(var_def, for_scope).clean();
+        clean_init = cleanInitializer(var_def, for_scope);
     }
     else if (init_clause && init_clause->getType() == DefinitionType::Statement) {
         Expression* expr_def = static_cast<Expression*>(init_clause.get());
@@ -242,12 +250,44 @@ StatementCleaner::cleanReturn(
     std::shared_ptr<CleanScope> const& scope
 )
 {
+    std::unique_ptr<CleanExpression> expression =
+        cleanExpression(return_stmt->getExpression().get(), scope);
+    markTailCalls(expression.get());
+
     return std::make_unique<CleanReturnStatement>(
-        cleanExpression(return_stmt->getExpression().get(), scope)
+        std::move(expression)
     );
 }
 
 
+// Tail calls: marks calls whose result is returned as is
+void
+StatementCleaner::markTailCalls(CleanExpression* expr)
+{
+    switch (expr->type) {
+        case CleanExpressionType::Call:
+            static_cast<CleanCallExpression*>(expr)->is_tail_call = true;
+            break;
+
+        case CleanExpressionType::Group:
+            markTailCalls(static_cast<CleanGroupExpression*>(expr)->expression.get());
+            break;
+
+        // Only the branch taken is returned, the condition is not
+        case CleanExpressionType::TernaryIf: {
+            CleanTernaryIfExpression* ternif_expr =
+                static_cast<CleanTernaryIfExpression*>(expr);
+            markTailCalls(ternif_expr->then_branch.get());
+            markTailCalls(ternif_expr->else_branch.get());
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+
 // Expression
 std::unique_ptr<CleanExpression>
 StatementCleaner::cleanExpression(
@@ -257,3 +297,22 @@ StatementCleaner::cleanExpression(
 {
     return ExpressionCleaner(scope).clean(expression_stmt);
 }
+
+
+// Initializer
+std::unique_ptr<CleanExpression>
+StatementCleaner::cleanInitializer(
+    VariableDefinition* var_def,
+    std::shared_ptr<CleanScope> const& scope
+)
+{
+    std::unique_ptr<CleanAssignmentExpression> assign_expr =
+        std::make_unique<CleanAssignmentExpression>(
+            std::make_unique<CleanVariableExpression>(
+                var_def->getToken().getLexeme()
+            ),
+            cleanExpression(var_def->getInitializer().get(), scope)
+        );
+    assign_expr->is_initializer = true;
+    return assign_expr;
+}
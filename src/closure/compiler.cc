@@ -0,0 +1,526 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <functional>
+#include <stdexcept>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <memory>
+#include <string>
+#include <map>
+
+#include "cleaner/ast/expressions/expression.h"
+#include "cleaner/ast/definitions/function.h"
+#include "cleaner/ast/definitions/variable.h"
+#include "cleaner/ast/statements/statement.h"
+#include "cleaner/ast/statements/return.h"
+#include "cleaner/ast/statements/while.h"
+#include "cleaner/ast/statements/block.h"
+#include "cleaner/ast/statements/for.h"
+#include "cleaner/ast/statements/if.h"
+#include "cleaner/symbols/scope.h"
+#include "closure/compiler.h"
+#include "common/operation.h"
+#include "closure/node.h"
+#include "common/value.h"
+
+
+ClosureCompiler::ClosureCompiler(
+    CleanScope* scope
+) : scope(scope)
+{}
+
+/**
+ * Compiles every user function in the global scope to closure nodes.
+ *
+ * The program must have gone through the resolver and the linker.
+ */
+ClosureProgram
+ClosureCompiler::compile()
+{
+    std::map<std::string,std::unique_ptr<CleanVariableDefinition>>& var_defs =
+        scope->getSymbols<CleanVariableDefinition>();
+    program.globals.resize(var_defs.size());
+    for (auto& [name, var_def]: var_defs)
+        program.globals[var_def->slot] = compileExpression(var_def->initializer.get());
+
+    // Create user functions first so calls can refer to functions defined later
+    std::map<std::string,std::unique_ptr<CleanFunctionDefinition>>& fun_defs =
+        scope->getSymbols<CleanFunctionDefinition>();
+    for (auto& [name, fun_def]: fun_defs) {
+        if (fun_def->is_intrinsic)
+            continue;
+
+        program.functions.push_back(
+            std::make_unique<ClosureFunction>(
+                fun_def->frame_size,
+                fun_def->memo.get()
+            )
+        );
+        functions[fun_def.get()] = program.functions.back().get();
+        if (name == "main()")
+            program.main = program.functions.back().get();
+    }
+
+    for (auto& [name, fun_def]: fun_defs) {
+        if (! fun_def->is_intrinsic)
+            functions[fun_def.get()]->body = compileBlock(fun_def->body.get());
+    }
+
+    return std::move(program);
+}
+
+// Statements
+std::unique_ptr<StatementNode>
+ClosureCompiler::compileStatement(CleanStatement* stmt)
+{
+    switch (stmt->type) {
+        case CleanStatementType::Block:
+            return compileBlock(static_cast<CleanBlockStatement*>(stmt));
+
+        case CleanStatementType::If:
+            return compileIf(static_cast<CleanIfStatement*>(stmt));
+
+        case CleanStatementType::For:
+            return compileFor(static_cast<CleanForStatement*>(stmt));
+
+        case CleanStatementType::While:
+            return compileWhile(static_cast<CleanWhileStatement*>(stmt));
+
+        case CleanStatementType::Break:
+            return std::make_unique<BreakNode>();
+
+        case CleanStatementType::Continue:
+            return std::make_unique<ContinueNode>();
+
+        case CleanStatementType::Return:
+            return compileReturn(static_cast<CleanReturnStatement*>(stmt));
+
+        case CleanStatementType::Expression:
+            return std::make_unique<ExpressionStatementNode>(
+                compileExpression(static_cast<CleanExpression*>(stmt))
+            );
+
+        default:
+            throw std::runtime_error(
+                "Closure compilation failed: unknow statement type."
+            );
+    }
+}
+
+// Blocks
+std::unique_ptr<StatementNode>
+ClosureCompiler::compileBlock(CleanBlockStatement* block_stmt)
+{
+    // A block of one statement is that statement, without a node to go through
+    if (block_stmt->statements.size() == 1)
+        return compileStatement(block_stmt->statements.front().get());
+
+    std::unique_ptr<BlockNode> block = std::make_unique<BlockNode>();
+    for (auto& statement: block_stmt->statements)
+        block->statements.push_back(compileStatement(statement.get()));
+
+    return block;
+}
+
+// If
+std::unique_ptr<StatementNode>
+ClosureCompiler::compileIf(CleanIfStatement* if_stmt)
+{
+    std::unique_ptr<IfNode> if_node = std::make_unique<IfNode>();
+    if_node->conditions.push_back(compileExpression(if_stmt->condition.get()));
+    if_node->bodies.push_back(compileBlock(if_stmt->body.get()));
+
+    for (auto& elif_branch: if_stmt->elif_branches) {
+        if_node->conditions.push_back(compileExpression(elif_branch->condition.get()));
+        if_node->bodies.push_back(compileBlock(elif_branch->body.get()));
+    }
+
+    if (if_stmt->else_branch)
+        if_node->else_body = compileBlock(if_stmt->else_branch->body.get());
+
+    return if_node;
+}
+
+// For
+std::unique_ptr<StatementNode>
+ClosureCompiler::compileFor(CleanForStatement* for_stmt)
+{
+    if (for_stmt->is_counted) {
+        switch (for_stmt->counter_test) {
+            case Operation::LtI64:
+                return compileCountedFor<std::less<int64_t>>(for_stmt);
+
+            case Operation::LeI64:
+                return compileCountedFor<std::less_equal<int64_t>>(for_stmt);
+
+            case Operation::GtI64:
+                return compileCountedFor<std::greater<int64_t>>(for_stmt);
+
+            case Operation::GeI64:
+                return compileCountedFor<std::greater_equal<int64_t>>(for_stmt);
+
+            default:
+                return compileCountedFor<std::not_equal_to<int64_t>>(for_stmt);
+        }
+    }
+
+    std::unique_ptr<ForNode> for_node = std::make_unique<ForNode>();
+    if (for_stmt->init_clause)
+        for_node->init_clause = compileExpression(for_stmt->init_clause.get());
+    if (for_stmt->term_clause)
+        for_node->term_clause = compileExpression(for_stmt->term_clause.get());
+    if (for_stmt->incr_clause)
+        for_node->incr_clause = compileExpression(for_stmt->incr_clause.get());
+    for_node->body = compileBlock(for_stmt->body.get());
+
+    return for_node;
+}
+
+// Counted loops compare their counter without going through a node
+template <typename Test>
+std::unique_ptr<StatementNode>
+ClosureCompiler::compileCountedFor(CleanForStatement* for_stmt)
+{
+    std::unique_ptr<CountedForNode<Test>> for_node =
+        std::make_unique<CountedForNode<Test>>(
+            for_stmt->counter_slot,
+            for_stmt->counter_step,
+            for_stmt->is_bound_invariant
+        );
+    if (for_stmt->init_clause)
+        for_node->init_clause = compileExpression(for_stmt->init_clause.get());
+    for_node->bound = compileExpression(for_stmt->counter_bound);
+    for_node->body = compileBlock(for_stmt->body.get());
+
+    return for_node;
+}
+
+// While
+std::unique_ptr<StatementNode>
+ClosureCompiler::compileWhile(CleanWhileStatement* while_stmt)
+{
+    std::unique_ptr<WhileNode> while_node = std::make_unique<WhileNode>();
+    if (while_stmt->condition)
+        while_node->condition = compileExpression(while_stmt->condition.get());
+    while_node->body = compileBlock(while_stmt->body.get());
+
+    return while_node;
+}
+
+// Return
+std::unique_ptr<StatementNode>
+ClosureCompiler::compileReturn(CleanReturnStatement* ret_stmt)
+{
+    if (! ret_stmt->expression)
+        return std::make_unique<ReturnNode>(nullptr);
+
+    return compileReturnedExpression(ret_stmt->expression.get());
+}
+
+// Returned expressions: branches leading to tail calls become statements
+std::unique_ptr<StatementNode>
+ClosureCompiler::compileReturnedExpression(CleanExpression* expr)
+{
+    switch (expr->type) {
+        case CleanExpressionType::Group:
+            return compileReturnedExpression(
+                static_cast<CleanGroupExpression*>(expr)->expression.get()
+            );
+
+        case CleanExpressionType::TernaryIf: {
+            CleanTernaryIfExpression* ternif_expr =
+                static_cast<CleanTernaryIfExpression*>(expr);
+            std::unique_ptr<IfNode> if_node = std::make_unique<IfNode>();
+            if_node->conditions.push_back(compileExpression(ternif_expr->condition.get()));
+            if_node->bodies.push_back(
+                compileReturnedExpression(ternif_expr->then_branch.get())
+            );
+            if_node->else_body = compileReturnedExpression(ternif_expr->else_branch.get());
+            return if_node;
+        }
+
+        case CleanExpressionType::Call: {
+            CleanCallExpression* call_expr = static_cast<CleanCallExpression*>(expr);
+            if (! call_expr->is_tail_call || call_expr->fun_def->is_intrinsic)
+                break;
+
+            std::unique_ptr<TailCallNode> tail_call =
+                std::make_unique<TailCallNode>(functions[call_expr->fun_def]);
+            for (auto& argument: call_expr->arguments)
+                tail_call->arguments.push_back(compileExpression(argument.get()));
+
+            return tail_call;
+        }
+
+        default:
+            break;
+    }
+
+    return std::make_unique<ReturnNode>(compileExpression(expr));
+}
+
+// Expressions
+std::unique_ptr<ExpressionNode>
+ClosureCompiler::compileExpression(CleanExpression* expr)
+{
+    switch (expr->type) {
+        case CleanExpressionType::Boolean:
+            return std::make_unique<ConstantNode>(
+                Value(static_cast<CleanBoolExpression*>(expr)->value)
+            );
+
+        case CleanExpressionType::SignedInt:
+            return std::make_unique<ConstantNode>(
+                Value(static_cast<CleanSignedIntExpression*>(expr)->value)
+            );
+
+        case CleanExpressionType::UnsignedInt:
+            return std::make_unique<ConstantNode>(
+                Value(static_cast<CleanUnsignedIntExpression*>(expr)->value)
+            );
+
+        case CleanExpressionType::Float:
+            return std::make_unique<ConstantNode>(
+                Value(static_cast<CleanFloatExpression*>(expr)->value)
+            );
+
+        case CleanExpressionType::String:
+            return std::make_unique<ConstantNode>(
+                Value(&static_cast<CleanStringExpression*>(expr)->value)
+            );
+
+        case CleanExpressionType::Variable:
+            return compileVariable(static_cast<CleanVariableExpression*>(expr));
+
+        // Groups only matter to the parser
+        case CleanExpressionType::Group:
+            return compileExpression(
+                static_cast<CleanGroupExpression*>(expr)->expression.get()
+            );
+
+        case CleanExpressionType::Call:
+            return compileCall(static_cast<CleanCallExpression*>(expr));
+
+        case CleanExpressionType::TernaryIf:
+            return compileTernaryIf(static_cast<CleanTernaryIfExpression*>(expr));
+
+        case CleanExpressionType::Assignment:
+            return compileAssignment(static_cast<CleanAssignmentExpression*>(expr));
+
+        case CleanExpressionType::Operation:
+            return compileOperation(static_cast<CleanOperationExpression*>(expr));
+
+        default:
+            throw std::runtime_error(
+                "Closure compilation failed: unknow expression type."
+            );
+    }
+}
+
+// Variables
+std::unique_ptr<ExpressionNode>
+ClosureCompiler::compileVariable(CleanVariableExpression* var_expr)
+{
+    if (var_expr->depth == 0)
+        return std::make_unique<LocalNode>(var_expr->slot);
+
+    return std::make_unique<GlobalNode>(var_expr->slot);
+}
+
+// Calls
+std::unique_ptr<ExpressionNode>
+ClosureCompiler::compileCall(CleanCallExpression* call_expr)
+{
+    CleanFunctionDefinition* fun_def = call_expr->fun_def;
+
+    // Intrinsics are called directly with their arguments
+    if (fun_def->is_intrinsic) {
+        // The body of an intrinsic returns the intrinsic expression
+        CleanReturnStatement* ret_stmt = static_cast<CleanReturnStatement*>(
+            fun_def->body->statements[0].get()
+        );
+        std::unique_ptr<NativeCallNode> native_call =
+            std::make_unique<NativeCallNode>(
+                static_cast<CleanIntrinsicExpression*>(
+                    ret_stmt->expression.get()
+                )->callable
+            );
+        for (auto& argument: call_expr->arguments)
+            native_call->arguments.push_back(compileExpression(argument.get()));
+
+        return native_call;
+    }
+
+    std::unique_ptr<CallNode> call = std::make_unique<CallNode>(functions[fun_def]);
+    for (auto& argument: call_expr->arguments)
+        call->arguments.push_back(compileExpression(argument.get()));
+
+    return call;
+}
+
+// Ternary if
+std::unique_ptr<ExpressionNode>
+ClosureCompiler::compileTernaryIf(CleanTernaryIfExpression* ternif_expr)
+{
+    return std::make_unique<TernaryIfNode>(
+        compileExpression(ternif_expr->condition.get()),
+        compileExpression(ternif_expr->then_branch.get()),
+        compileExpression(ternif_expr->else_branch.get())
+    );
+}
+
+// Assignments
+std::unique_ptr<ExpressionNode>
+ClosureCompiler::compileAssignment(CleanAssignmentExpression* assign_expr)
+{
+    CleanVariableExpression* lvalue_expr =
+        static_cast<CleanVariableExpression*>(assign_expr->lvalue.get());
+
+    if (lvalue_expr->depth == 0)
+        return std::make_unique<AssignLocalNode>(
+            lvalue_expr->slot,
+            compileExpression(assign_expr->rvalue.get())
+        );
+
+    return std::make_unique<AssignGlobalNode>(
+        lvalue_expr->slot,
+        compileExpression(assign_expr->rvalue.get())
+    );
+}
+
+// Operations
+// Builds the node for the given operation on operands read the given ways
+template <enum Operation operation, typename Left, typename Right>
+static std::unique_ptr<ExpressionNode>
+makeFixedOperationNode(Left&& left, Right&& right)
+{
+    return std::make_unique<BinaryOperationNode<operation, Left, Right>>(
+        std::move(left),
+        std::move(right)
+    );
+}
+
+// Picks the node for the given operation from a table indexed by operation,
+// unary operations have an entry that is never picked
+template <typename Left, typename Right, std::size_t... operations>
+static std::unique_ptr<ExpressionNode>
+pickOperationNode(
+    enum Operation operation,
+    Left&& left,
+    Right&& right,
+    std::index_sequence<operations...>
+)
+{
+    static std::unique_ptr<ExpressionNode> (* const makers[])(Left&&, Right&&) = {
+        &makeFixedOperationNode<(enum Operation) operations, Left, Right>...
+    };
+
+    return makers[(std::size_t) operation](std::move(left), std::move(right));
+}
+
+// Builds the node for the given binary operation
+template <typename Left, typename Right>
+static std::unique_ptr<ExpressionNode>
+makeOperationNode(enum Operation operation, Left&& left, Right&& right)
+{
+    return pickOperationNode(
+        operation,
+        std::move(left),
+        std::move(right),
+        std::make_index_sequence<(std::size_t) Operation::NeBool + 1>()
+    );
+}
+
+// Groups only matter to the parser
+static CleanExpression*
+ungroup(CleanExpression* expr)
+{
+    while (expr->type == CleanExpressionType::Group)
+        expr = static_cast<CleanGroupExpression*>(expr)->expression.get();
+
+    return expr;
+}
+
+// Whether the operand compiles to a local node
+static bool
+isLocal(CleanExpression* expr)
+{
+    expr = ungroup(expr);
+    return expr->type == CleanExpressionType::Variable &&
+        static_cast<CleanVariableExpression*>(expr)->depth == 0;
+}
+
+// Whether the operand compiles to a constant node
+static bool
+isConstant(CleanExpression* expr)
+{
+    switch (ungroup(expr)->type) {
+        case CleanExpressionType::Boolean:
+        case CleanExpressionType::SignedInt:
+        case CleanExpressionType::UnsignedInt:
+        case CleanExpressionType::Float:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+std::unique_ptr<ExpressionNode>
+ClosureCompiler::compileOperation(CleanOperationExpression* op_expr)
+{
+    if (op_expr->operands.size() == 1)
+        return std::make_unique<UnaryOperationNode>(
+            op_expr->operation,
+            compileExpression(op_expr->operands[0].get())
+        );
+
+    CleanExpression* left_expr = op_expr->operands[0].get();
+    CleanExpression* right_expr = op_expr->operands[1].get();
+    std::unique_ptr<ExpressionNode> left = compileExpression(left_expr);
+    std::unique_ptr<ExpressionNode> right = compileExpression(right_expr);
+
+    // Locals and constants are read by the operation itself
+    if (isLocal(left_expr) && isConstant(right_expr))
+        return makeOperationNode(
+            op_expr->operation,
+            LocalOperand(static_cast<LocalNode*>(left.get())->slot),
+            ConstantOperand(static_cast<ConstantNode*>(right.get())->value)
+        );
+
+    if (isLocal(left_expr) && isLocal(right_expr))
+        return makeOperationNode(
+            op_expr->operation,
+            LocalOperand(static_cast<LocalNode*>(left.get())->slot),
+            LocalOperand(static_cast<LocalNode*>(right.get())->slot)
+        );
+
+    if (isConstant(right_expr))
+        return makeOperationNode(
+            op_expr->operation,
+            NodeOperand(std::move(left)),
+            ConstantOperand(static_cast<ConstantNode*>(right.get())->value)
+        );
+
+    return makeOperationNode(
+        op_expr->operation,
+        NodeOperand(std::move(left)),
+        NodeOperand(std::move(right))
+    );
+}
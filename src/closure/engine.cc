@@ -0,0 +1,55 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cstddef>
+
+#include "interpreter/frame.h"
+#include "closure/compiler.h"
+#include "closure/engine.h"
+#include "closure/node.h"
+#include "common/value.h"
+
+
+ClosureEngine::ClosureEngine(
+    ClosureProgram& program
+) : program(program)
+{}
+
+/**
+ * Runs the program starting with its main function.
+ */
+int
+ClosureEngine::run()
+{
+    // Global variables live in the outermost frame
+    CallStack stack(stack_segment, stack_limit);
+    Frame globals(&stack, program.globals.size(), nullptr);
+    for (std::size_t slot = 0; slot < program.globals.size(); ++slot)
+        globals.slots[slot] = program.globals[slot]->eval(globals);
+
+    Frame main_frame(&stack, program.main->frame_size, &globals);
+    Value ret_value = runFunction(program.main, main_frame);
+
+    if (ret_value.type == ValueType::SignedInt) {
+        // The value will be of type int64_t
+        // But since we are interpreting through C++, we convert to int
+        return (int) ret_value.as_int;
+    }
+
+    // If we got nothing from main, we have an error
+    return -1;
+}
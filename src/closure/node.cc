@@ -0,0 +1,237 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cstddef>
+#include <vector>
+
+#include "interpreter/frame.h"
+#include "common/operation.h"
+#include "common/native.h"
+#include "closure/node.h"
+#include "common/value.h"
+#include "common/memo.h"
+
+
+// Function frames have the frame holding global variables as parent
+static inline Frame*
+globalFrame(Frame& frame)
+{
+    return frame.parent ? frame.parent : &frame;
+}
+
+/**
+ * Runs the given function in the given frame, following its tail calls.
+ */
+Value
+runFunction(ClosureFunction* fun, Frame& frame)
+{
+    // Tail calls reuse the frame and run here instead of recursing
+    Result result;
+    while (fun->body->exec(frame, result) == Completion::TailCall)
+        fun = result.tail_callee;
+
+    return result.value;
+}
+
+/* Expressions */
+
+Value
+ConstantNode::eval(Frame& /* frame */)
+{
+    return value;
+}
+
+Value
+LocalNode::eval(Frame& frame)
+{
+    return frame.slots[slot];
+}
+
+Value
+GlobalNode::eval(Frame& frame)
+{
+    return globalFrame(frame)->slots[slot];
+}
+
+Value
+AssignLocalNode::eval(Frame& frame)
+{
+    Value value = rvalue->eval(frame);
+    frame.slots[slot] = value;
+    return value;
+}
+
+Value
+AssignGlobalNode::eval(Frame& frame)
+{
+    Value value = rvalue->eval(frame);
+    globalFrame(frame)->slots[slot] = value;
+    return value;
+}
+
+Value
+CallNode::eval(Frame& frame)
+{
+    // Arguments are evaluated in the caller's frame
+    // and written directly into the callee's frame
+    Frame callee_frame(frame.stack, callee->frame_size, globalFrame(frame));
+    for (std::size_t i = 0; i < arguments.size(); ++i)
+        callee_frame.slots[i] = arguments[i]->eval(frame);
+
+    // Memoized functions answer from their cache when they can
+    if (callee->memo) {
+        Value const* cached = callee->memo->find(callee_frame.slots);
+        if (cached)
+            return *cached;
+
+        // The callee may overwrite its parameters so we keep the key aside
+        std::vector<Value> key(callee_frame.slots, callee_frame.slots + arguments.size());
+        Value ret_value = runFunction(callee, callee_frame);
+        callee->memo->insert(key.data(), ret_value);
+        return ret_value;
+    }
+
+    return runFunction(callee, callee_frame);
+}
+
+Value
+NativeCallNode::eval(Frame& frame)
+{
+    // Arguments are laid out contiguously on the call stack
+    Frame args_frame(frame.stack, arguments.size(), nullptr);
+    for (std::size_t i = 0; i < arguments.size(); ++i)
+        args_frame.slots[i] = arguments[i]->eval(frame);
+
+    return callable(NativeArguments(args_frame.slots, arguments.size()));
+}
+
+Value
+TernaryIfNode::eval(Frame& frame)
+{
+    return condition->eval(frame).as_bool
+        ? then_branch->eval(frame)
+        : else_branch->eval(frame);
+}
+
+Value
+UnaryOperationNode::eval(Frame& frame)
+{
+    return applyOperation(operation, operand->eval(frame), Value());
+}
+
+/* Statements */
+
+Completion
+BlockNode::exec(Frame& frame, Result& result)
+{
+    for (auto& statement: statements) {
+        Completion completion = statement->exec(frame, result);
+        if (completion != Completion::Normal)
+            return completion;
+    }
+
+    return Completion::Normal;
+}
+
+Completion
+IfNode::exec(Frame& frame, Result& result)
+{
+    for (std::size_t i = 0; i < conditions.size(); ++i) {
+        if (conditions[i]->eval(frame).as_bool)
+            return bodies[i]->exec(frame, result);
+    }
+
+    if (else_body)
+        return else_body->exec(frame, result);
+
+    return Completion::Normal;
+}
+
+Completion
+ForNode::exec(Frame& frame, Result& result)
+{
+    if (init_clause)
+        init_clause->eval(frame);
+
+    while (! term_clause || term_clause->eval(frame).as_bool) {
+        Completion completion = body->exec(frame, result);
+        if (completion == Completion::Break)
+            break;
+        if (completion == Completion::Return || completion == Completion::TailCall)
+            return completion;
+
+        // Continue statements still run the increment clause
+        if (incr_clause)
+            incr_clause->eval(frame);
+    }
+
+    return Completion::Normal;
+}
+
+Completion
+WhileNode::exec(Frame& frame, Result& result)
+{
+    while (! condition || condition->eval(frame).as_bool) {
+        Completion completion = body->exec(frame, result);
+        if (completion == Completion::Break)
+            break;
+        if (completion == Completion::Return || completion == Completion::TailCall)
+            return completion;
+    }
+
+    return Completion::Normal;
+}
+
+Completion
+BreakNode::exec(Frame& /* frame */, Result& /* result */)
+{
+    return Completion::Break;
+}
+
+Completion
+ContinueNode::exec(Frame& /* frame */, Result& /* result */)
+{
+    return Completion::Continue;
+}
+
+Completion
+ReturnNode::exec(Frame& frame, Result& result)
+{
+    result.value = expression ? expression->eval(frame) : Value();
+    return Completion::Return;
+}
+
+Completion
+TailCallNode::exec(Frame& frame, Result& result)
+{
+    // The frame is at the top of the call stack so the arguments
+    // go right above it before the callee takes the frame over
+    Value* values = frame.stack->push(arguments.size());
+    for (std::size_t i = 0; i < arguments.size(); ++i)
+        values[i] = arguments[i]->eval(frame);
+
+    frame.reuse(callee->frame_size, arguments.size());
+    result.tail_callee = callee;
+    return Completion::TailCall;
+}
+
+Completion
+ExpressionStatementNode::exec(Frame& frame, Result& /* result */)
+{
+    expression->eval(frame);
+    return Completion::Normal;
+}
@@ -0,0 +1,106 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "common/value.h"
+#include "common/memo.h"
+
+
+MemoTable::MemoTable(
+    std::size_t arity,
+    std::size_t capacity
+) : arity(arity),
+    capacity(capacity),
+    keys(arity * capacity),
+    results(capacity),
+    used(capacity, false),
+    hits(0),
+    misses(0)
+{}
+
+/**
+ * Returns the cached result for the given arguments, null if there is none.
+ */
+Value const*
+MemoTable::find(Value const* arguments)
+{
+    std::size_t index = indexOf(arguments);
+    if (used[index]) {
+        uint64_t const* key = keys.data() + index * arity;
+        std::size_t i = 0;
+        while (i < arity && key[i] == arguments[i].as_uint)
+            i++;
+
+        if (i == arity) {
+            hits++;
+            return &results[index];
+        }
+    }
+
+    misses++;
+    return nullptr;
+}
+
+/**
+ * Caches the result of a call with the given arguments.
+ */
+void
+MemoTable::insert(Value const* arguments, Value result)
+{
+    std::size_t index = indexOf(arguments);
+    uint64_t* key = keys.data() + index * arity;
+    for (std::size_t i = 0; i < arity; ++i)
+        key[i] = arguments[i].as_uint;
+
+    results[index] = result;
+    used[index] = true;
+}
+
+/**
+ * Returns the number of lookups that found a cached result.
+ */
+std::size_t
+MemoTable::getHits() const
+{
+    return hits;
+}
+
+/**
+ * Returns the number of lookups that didn't find a cached result.
+ */
+std::size_t
+MemoTable::getMisses() const
+{
+    return misses;
+}
+
+// The entry the given arguments hash to
+std::size_t
+MemoTable::indexOf(Value const* arguments) const
+{
+    uint64_t hash = 0x9e3779b97f4a7c15u;
+    for (std::size_t i = 0; i < arity; ++i) {
+        hash ^= arguments[i].as_uint;
+        hash *= 0xbf58476d1ce4e5b9u;
+        hash ^= hash >> 31;
+    }
+
+    return hash % capacity;
+}
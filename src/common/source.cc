@@ -0,0 +1,378 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <string_view>
+#include <stdexcept>
+#include <iostream>
+#include <iterator>
+#include <fstream>
+#include <cstddef>
+#include <utility>
+#include <cstring>
+#include <memory>
+#include <vector>
+#include <string>
+#include <cerrno>
+#include <map>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define PROTO_SOURCE_MMAP
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <fcntl.h>
+#endif
+
+#include "common/source.h"
+
+
+// Source buffer
+SourceBuffer::SourceBuffer(
+) : mapping(nullptr),
+    mapping_size(0),
+    storage(3, '\0'),
+    size(0)
+{}
+
+SourceBuffer::SourceBuffer(
+    std::string text
+) : mapping(nullptr),
+    mapping_size(0),
+    size(text.size())
+{
+    storage.reserve(text.size() + 3);
+    storage += '\0';
+    storage += text;
+    storage.append(2, '\0');
+}
+
+SourceBuffer::SourceBuffer(
+    SourceBuffer&& buffer
+) noexcept : mapping(buffer.mapping),
+    mapping_size(buffer.mapping_size),
+    storage(std::move(buffer.storage)),
+    size(buffer.size)
+{
+    buffer.mapping = nullptr;
+    buffer.mapping_size = 0;
+    buffer.storage.assign(3, '\0');
+    buffer.size = 0;
+}
+
+SourceBuffer&
+SourceBuffer::operator=(SourceBuffer&& buffer) noexcept
+{
+    if (this != &buffer) {
+        std::swap(mapping, buffer.mapping);
+        std::swap(mapping_size, buffer.mapping_size);
+        std::swap(storage, buffer.storage);
+        std::swap(size, buffer.size);
+    }
+
+    return * this;
+}
+
+SourceBuffer::~SourceBuffer()
+{
+#ifdef PROTO_SOURCE_MMAP
+    if (mapping)
+        munmap(mapping, mapping_size);
+#endif
+}
+
+/**
+ * Opens the file at the given path once, then maps it or reads it.
+ * The path `-` stands for the standard input.
+ *
+ * Throws std::invalid_argument if there is no such file
+ * and std::runtime_error if it can't be read.
+ */
+SourceBuffer
+SourceBuffer::open(std::string const& path)
+{
+    SourceBuffer buffer;
+
+#ifdef PROTO_SOURCE_MMAP
+    int descriptor = path == "-" ? STDIN_FILENO : ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (descriptor < 0) {
+        if (errno == ENOENT)
+            throw std::invalid_argument("Source loading failed: file [" + path + "] was not found.");
+
+        throw std::runtime_error(
+            "Source loading failed: file [" + path + "] could not be opened: " + std::strerror(errno) + "."
+        );
+    }
+
+    // Only regular files have a size known upfront and can be mapped
+    struct stat status;
+    bool regular = fstat(descriptor, &status) == 0 && S_ISREG(status.st_mode);
+    if (regular && (unsigned long long) status.st_size > max_size) {
+        if (descriptor != STDIN_FILENO)
+            close(descriptor);
+        throw std::runtime_error("Source loading failed: file [" + path + "] is 4 GB or more.");
+    }
+
+    if (regular && status.st_size > 0)
+        buffer.map(descriptor, status.st_size);
+
+    try {
+        if (! buffer.isMapped())
+            buffer.read(descriptor, path);
+    } catch (std::runtime_error const& e) {
+        if (descriptor != STDIN_FILENO)
+            close(descriptor);
+        throw;
+    }
+
+    // The mapping stays valid once the file is closed
+    if (descriptor != STDIN_FILENO)
+        close(descriptor);
+#else
+    if (path == "-") {
+        buffer = SourceBuffer(std::string(std::istreambuf_iterator<char>(std::cin), {}));
+    }
+    else {
+        std::ifstream file(path, std::ios::binary);
+        if (! file.good())
+            throw std::invalid_argument("Source loading failed: file [" + path + "] was not found.");
+
+        buffer = SourceBuffer(std::string(std::istreambuf_iterator<char>(file), {}));
+    }
+
+    if (buffer.size > max_size)
+        throw std::runtime_error("Source loading failed: file [" + path + "] is 4 GB or more.");
+#endif
+
+    return buffer;
+}
+
+/**
+ * Returns the text of the source.
+ */
+std::string_view
+SourceBuffer::getText() const
+{
+#ifdef PROTO_SOURCE_MMAP
+    if (mapping)
+        return std::string_view(mapping + sysconf(_SC_PAGESIZE), size);
+#endif
+
+    return std::string_view(storage.data() + 1, size);
+}
+
+// Map a regular file, leaves the buffer unmapped if the system refuses
+void
+SourceBuffer::map(int descriptor, std::size_t file_size)
+{
+#ifdef PROTO_SOURCE_MMAP
+    // Reserve the file's pages between two zero pages, then map the file over
+    // the middle ones. The end of its last page past the file is zero as well.
+    std::size_t page_size = sysconf(_SC_PAGESIZE);
+    std::size_t region_size = ((file_size + page_size - 1) / page_size + 2) * page_size;
+
+    void* region = mmap(nullptr, region_size, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED)
+        return;
+
+    char* text = static_cast<char*>(region) + page_size;
+    if (mmap(text, file_size, PROT_READ, MAP_PRIVATE | MAP_FIXED, descriptor, 0) == MAP_FAILED) {
+        munmap(region, region_size);
+        return;
+    }
+
+    // The lexer goes through the text once from start to end
+    madvise(text, file_size, MADV_SEQUENTIAL);
+
+    mapping = static_cast<char*>(region);
+    mapping_size = region_size;
+    size = file_size;
+#endif
+}
+
+// Read everything there is to read from the given descriptor
+void
+SourceBuffer::read(int descriptor, std::string const& path)
+{
+#ifdef PROTO_SOURCE_MMAP
+    storage.assign(1, '\0');
+
+    char chunk[1 << 16];
+    for (;;) {
+        ssize_t count = ::read(descriptor, chunk, sizeof(chunk));
+        if (count == 0)
+            break;
+
+        if (count < 0) {
+            if (errno == EINTR)
+                continue;
+
+            throw std::runtime_error(
+                "Source loading failed: file [" + path + "] could not be read: " + std::strerror(errno) + "."
+            );
+        }
+
+        storage.append(chunk, count);
+        if (storage.size() - 1 > max_size)
+            throw std::runtime_error("Source loading failed: file [" + path + "] is 4 GB or more.");
+    }
+
+    size = storage.size() - 1;
+    storage.append(2, '\0');
+#endif
+}
+
+
+/* A source the manager owns. */
+struct Source
+{
+    Source(
+        SourceBuffer&& buffer,
+        std::string const& path
+    ) : buffer(std::move(buffer)),
+        text(this->buffer.getText()),
+        path(path)
+    {}
+
+    SourceBuffer buffer;
+    std::string_view text;
+    std::string path;
+};
+
+/* The manager sources are added to, the latest one created. */
+static SourceManager* active = nullptr;
+
+/* Builtin lexemes one per line, in storage that is never moved. */
+static std::size_t const builtin_capacity = 1 << 12;
+static char builtin_text[builtin_capacity];
+static std::size_t builtin_size = 0;
+
+static std::string const builtin_path = "__builtin__";
+static std::string const no_path = "";
+
+/**
+ * Makes this manager the one sources are added to and found in
+ * until it is destroyed, then the one active before it is again.
+ */
+SourceManager::SourceManager(
+) : previous(active)
+{
+    active = this;
+}
+
+SourceManager::~SourceManager()
+{
+    active = previous;
+}
+
+/**
+ * Takes the text of a source and returns its identifier.
+ *
+ * Throws std::runtime_error if no manager is active, if it holds
+ * as many sources as tokens can tell apart or if the text is 4 GB or more.
+ */
+std::size_t
+SourceManager::add(SourceBuffer buffer, std::string const& path)
+{
+    if (active == nullptr)
+        throw std::runtime_error("Source loading failed: no source manager is active.");
+
+    if (active->sources.size() + builtin >= max_sources)
+        throw std::runtime_error(
+            "Source loading failed: more than " + std::to_string(max_sources) + " sources."
+        );
+
+    if (buffer.getText().size() > SourceBuffer::max_size)
+        throw std::runtime_error("Source loading failed: file [" + path + "] is 4 GB or more.");
+
+    active->sources.push_back(std::make_unique<Source>(std::move(buffer), path));
+    return active->sources.size() + builtin;
+}
+
+std::size_t
+SourceManager::add(std::string text, std::string const& path)
+{
+    return add(SourceBuffer(std::move(text)), path);
+}
+
+/**
+ * Returns where the given lexeme starts in the builtin source,
+ * adding it the first time it is asked for.
+ *
+ * The builtin source is never moved so lexemes can be viewed
+ * in place for as long as the program runs.
+ */
+std::size_t
+SourceManager::addBuiltin(std::string const& lexeme)
+{
+    static std::map<std::string, std::size_t> offsets;
+    auto it = offsets.find(lexeme);
+    if (it != offsets.end())
+        return it->second;
+
+    if (lexeme.size() + 1 > builtin_capacity - builtin_size)
+        throw std::runtime_error(
+            "Source loading failed: builtin lexemes take more than " +
+            std::to_string(builtin_capacity) + " bytes."
+        );
+
+    std::size_t offset = builtin_size;
+    std::memcpy(builtin_text + offset, lexeme.data(), lexeme.size());
+    builtin_text[offset + lexeme.size()] = '\n';
+    builtin_size += lexeme.size() + 1;
+    offsets[lexeme] = offset;
+    return offset;
+}
+
+/**
+ * Returns the text of the given source.
+ */
+std::string_view
+SourceManager::getText(std::size_t source)
+{
+    if (source == none)
+        return std::string_view();
+
+    if (source == builtin)
+        return std::string_view(builtin_text, builtin_size);
+
+    return find(source).text;
+}
+
+/**
+ * Returns the path of the file the given source was read from.
+ */
+std::string const&
+SourceManager::getPath(std::size_t source)
+{
+    if (source == none)
+        return no_path;
+
+    if (source == builtin)
+        return builtin_path;
+
+    return find(source).path;
+}
+
+// Find a source added to the active manager
+Source&
+SourceManager::find(std::size_t source)
+{
+    if (active == nullptr)
+        throw std::runtime_error("Source lookup failed: no source manager is active.");
+
+    return * active->sources.at(source - builtin - 1);
+}
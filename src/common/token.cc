@@ -15,39 +15,43 @@
  *  limitations under the License.
  */
 
-#include <iterator>
+#include <string_view>
+#include <algorithm>
+#include <cstdint>
 #include <cstddef>
 #include <string>
 
+#include "common/source.h"
 #include "common/token.h"
 
 
+/* Largest line and column a token can hold. */
+static std::size_t const max_line = (1 << 24) - 1;
+static std::size_t const max_column = (1 << 16) - 1;
+
 Token::Token(
-) : type(PROTO_ERROR),
-    source(nullptr),
-    source_path(""),
-    start(source_path.end()), // ugly hack to make sure to have a valid iterator
+) : offset(0),
     length(0),
     line(1),
-    column(1)
+    type(PROTO_ERROR),
+    column(1),
+    source(SourceManager::none)
 {}
 
 
 Token::Token(
     enum TokenType type,
-    std::shared_ptr<std::string>& source,
-    std::string const& source_path,
-    std::string::iterator start,
-    std::string::size_type length,
-    std::string::size_type line,
-    std::string::size_type column
-) : type(type),
-    source(source),
-    source_path(source_path),
-    start(start),
+    std::size_t source,
+    std::size_t offset,
+    std::size_t length,
+    std::size_t line,
+    std::size_t column
+) : offset(offset),
     length(length),
-    line(line),
-    column(column)
+    line(std::min(line, max_line)),
+    type(type),
+    column(std::min(column, max_column)),
+    source(source)
 {}
 
 /**
@@ -56,10 +60,17 @@ Token::Token(
 std::string
 Token::getLexeme() const
 {
-    return source->substr(
-        std::distance(source->begin(), start),
-        length
-    );
+    return std::string(getLexemeView());
+}
+
+/**
+ * Returns the lexeme for the given token without copying it.
+ * The view stays valid for as long as the manager of its source is alive.
+ */
+std::string_view
+Token::getLexemeView() const
+{
+    return SourceManager::getText(source).substr(offset, length);
 }
 
 /**
@@ -71,6 +82,15 @@ Token::getLine() const
     return TokenLine(* this);
 }
 
+/**
+ * Returns the path of the file containing this token.
+ */
+std::string const&
+Token::getSourcePath() const
+{
+    return SourceManager::getPath(source);
+}
+
 
 /**
  * Returns the struct with the line where the given token was found.
@@ -82,31 +102,28 @@ TokenLine::TokenLine(
 ) : line(""),
     offset(0)
 {
-    std::string::size_type length = 0;
+    std::string_view text = SourceManager::getText(token.source);
+    if (text.empty())
+        return;
 
     // Find the start of the line this token is located at
-    auto line_start = token.start;
-    while (line_start != token.source->begin() && * line_start != '\n') {
+    std::string::size_type line_start = std::min<std::string::size_type>(token.offset, text.size());
+    while (line_start > 0 && text[line_start] != '\n') {
         line_start--;
         offset++;
     }
 
     // Renormalize in case we hit a newline before the current line
-    if (* line_start == '\n') {
+    if (text[line_start] == '\n') {
         line_start++;
         if (offset > 0)
             offset--;
     }
-    
+
     // Calculate the length of the line
-    auto line_end = line_start;
-    while (line_end != token.source->end() && * line_end != '\n') {
-        line_end++;
-        length++;
-    }
+    std::string::size_type line_end = text.find('\n', line_start);
+    if (line_end == std::string_view::npos)
+        line_end = text.size();
 
-    line = token.source->substr(
-        std::distance(token.source->begin(), line_start),
-        length
-    );
+    line = std::string(text.substr(line_start, line_end - line_start));
 }
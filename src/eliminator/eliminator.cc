@@ -0,0 +1,640 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdexcept>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <memory>
+#include <vector>
+#include <string>
+
+#include "cleaner/ast/expressions/expression.h"
+#include "cleaner/ast/definitions/function.h"
+#include "cleaner/ast/definitions/variable.h"
+#include "cleaner/ast/statements/statement.h"
+#include "cleaner/ast/declarations/type.h"
+#include "cleaner/ast/statements/return.h"
+#include "cleaner/ast/statements/while.h"
+#include "cleaner/ast/statements/block.h"
+#include "cleaner/ast/statements/for.h"
+#include "cleaner/ast/statements/if.h"
+#include "cleaner/cleaner_warning.h"
+#include "eliminator/eliminator.h"
+#include "cleaner/symbols/scope.h"
+#include "common/operation.h"
+
+
+static bool terminates(CleanStatement* stmt);
+static bool hasEffects(CleanExpression* expr);
+
+Eliminator::Eliminator(
+    CleanScope* scope
+) : scope(scope),
+    fun_def(nullptr),
+    block_scope(nullptr)
+{}
+
+/**
+ * Removes the statements that can never run and the assignments
+ * to local variables whose value is never read.
+ *
+ * Statements that follow a return, break or continue are removed,
+ * as are branches whose condition is always false and the branches
+ * that follow one whose condition is always true.
+ *
+ * An assignment is removed when no path from it reads the variable
+ * before the variable is assigned again or the function returns.
+ * The value assigned is still computed if computing it has effects.
+ */
+void
+Eliminator::eliminate()
+{
+    for (auto& [name, fun_def]: scope->getSymbols<CleanFunctionDefinition>()) {
+        if (fun_def->is_intrinsic)
+            continue;
+
+        pruneBlock(fun_def->body.get());
+
+        // Locals are dead once the function returns
+        this->fun_def = fun_def.get();
+        Liveness live(fun_def->frame_size, false);
+        break_live = live;
+        continue_live = live;
+        liveBlock(fun_def->body.get(), live, true);
+        this->fun_def = nullptr;
+    }
+}
+
+// Unreachable code
+void
+Eliminator::pruneBlock(CleanBlockStatement* block_stmt)
+{
+    std::vector<std::unique_ptr<CleanStatement>>& statements =
+        block_stmt->statements;
+
+    for (std::size_t i = 0; i < statements.size(); ++i) {
+        pruneStatement(statements[i]);
+
+        if (statements[i] && terminates(statements[i].get()) && i + 1 < statements.size()) {
+            warn(
+                statements[i + 1]->token,
+                "unreachable code",
+                "statement can never run since the one before it always exits"
+            );
+            statements.erase(statements.begin() + i + 1, statements.end());
+        }
+    }
+
+    statements.erase(
+        std::remove(statements.begin(), statements.end(), nullptr),
+        statements.end()
+    );
+}
+
+void
+Eliminator::pruneStatement(std::unique_ptr<CleanStatement>& stmt)
+{
+    switch (stmt->type) {
+        case CleanStatementType::Block: {
+            pruneBlock(static_cast<CleanBlockStatement*>(stmt.get()));
+            break;
+        }
+
+        case CleanStatementType::If: {
+            pruneIf(stmt);
+            break;
+        }
+
+        case CleanStatementType::For: {
+            CleanForStatement* for_stmt = static_cast<CleanForStatement*>(stmt.get());
+            if (
+                for_stmt->term_clause &&
+                for_stmt->term_clause->type == CleanExpressionType::Boolean &&
+                ! static_cast<CleanBoolExpression*>(for_stmt->term_clause.get())->value
+            ) {
+                warn(
+                    stmt->token,
+                    "condition is always false",
+                    "loop removed since its body can never run"
+                );
+
+                // Only the initialization remains
+                Token token = stmt->token;
+                stmt = std::move(for_stmt->init_clause);
+                if (stmt)
+                    stmt->token = token;
+                break;
+            }
+
+            pruneBlock(for_stmt->body.get());
+            break;
+        }
+
+        case CleanStatementType::While: {
+            CleanWhileStatement* while_stmt =
+                static_cast<CleanWhileStatement*>(stmt.get());
+            if (
+                while_stmt->condition &&
+                while_stmt->condition->type == CleanExpressionType::Boolean &&
+                ! static_cast<CleanBoolExpression*>(while_stmt->condition.get())->value
+            ) {
+                warn(
+                    stmt->token,
+                    "condition is always false",
+                    "loop removed since its body can never run"
+                );
+                stmt.reset();
+                break;
+            }
+
+            pruneBlock(while_stmt->body.get());
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+// Drop the branches that can never run from an if statement
+void
+Eliminator::pruneIf(std::unique_ptr<CleanStatement>& stmt)
+{
+    CleanIfStatement* if_stmt = static_cast<CleanIfStatement*>(stmt.get());
+
+    bool constant = if_stmt->condition->type == CleanExpressionType::Boolean;
+    for (auto& elif_branch: if_stmt->elif_branches)
+        constant = constant || elif_branch->condition->type == CleanExpressionType::Boolean;
+
+    if (! constant) {
+        pruneBlock(if_stmt->body.get());
+        for (auto& elif_branch: if_stmt->elif_branches)
+            pruneBlock(elif_branch->body.get());
+        if (if_stmt->else_branch)
+            pruneBlock(if_stmt->else_branch->body.get());
+        return;
+    }
+
+    std::vector<std::unique_ptr<CleanElifBranch>> branches;
+    branches.push_back(std::make_unique<CleanElifBranch>(
+        std::move(if_stmt->condition),
+        std::move(if_stmt->body)
+    ));
+    for (auto& elif_branch: if_stmt->elif_branches)
+        branches.push_back(std::move(elif_branch));
+    std::unique_ptr<CleanBlockStatement> else_body = if_stmt->else_branch
+        ? std::move(if_stmt->else_branch->body)
+        : nullptr;
+
+    // The first branch always taken becomes the else branch
+    std::vector<std::unique_ptr<CleanElifBranch>> kept;
+    for (std::size_t i = 0; i < branches.size(); ++i) {
+        std::unique_ptr<CleanElifBranch>& branch = branches[i];
+        if (branch->condition->type != CleanExpressionType::Boolean) {
+            kept.push_back(std::move(branch));
+            continue;
+        }
+
+        if (static_cast<CleanBoolExpression*>(branch->condition.get())->value) {
+            bool followed = i + 1 < branches.size() || else_body != nullptr;
+            warn(
+                stmt->token,
+                "condition is always true",
+                followed
+                    ? "the branches that follow can never run"
+                    : "the condition is redundant since the branch always runs"
+            );
+            else_body = std::move(branch->body);
+            break;
+        }
+
+        warn(
+            stmt->token,
+            "condition is always false",
+            "branch removed since it can never run"
+        );
+    }
+
+    Token token = stmt->token;
+    if (kept.empty()) {
+        stmt = std::move(else_body);
+        if (stmt) {
+            stmt->token = token;
+            pruneBlock(static_cast<CleanBlockStatement*>(stmt.get()));
+        }
+        return;
+    }
+
+    std::unique_ptr<CleanIfStatement> pruned_if = std::make_unique<CleanIfStatement>(
+        std::move(kept[0]->condition),
+        std::move(kept[0]->body)
+    );
+    for (std::size_t i = 1; i < kept.size(); ++i)
+        pruned_if->elif_branches.push_back(std::move(kept[i]));
+    if (else_body)
+        pruned_if->else_branch = std::make_unique<CleanElseBranch>(std::move(else_body));
+    pruned_if->token = token;
+    stmt = std::move(pruned_if);
+
+    pruneIf(stmt);
+}
+
+// Dead stores
+Eliminator::Liveness
+Eliminator::liveBlock(
+    CleanBlockStatement* block_stmt,
+    Liveness live,
+    bool remove
+)
+{
+    std::vector<std::unique_ptr<CleanStatement>>& statements =
+        block_stmt->statements;
+
+    CleanScope* saved_scope = block_scope;
+    block_scope = block_stmt->scope.get();
+    for (std::size_t i = statements.size(); i-- > 0;)
+        live = liveStatement(statements[i], live, remove);
+    block_scope = saved_scope;
+
+    if (remove)
+        statements.erase(
+            std::remove(statements.begin(), statements.end(), nullptr),
+            statements.end()
+        );
+
+    return live;
+}
+
+Eliminator::Liveness
+Eliminator::liveStatement(
+    std::unique_ptr<CleanStatement>& stmt,
+    Liveness live,
+    bool remove
+)
+{
+    switch (stmt->type) {
+        case CleanStatementType::Block: {
+            return liveBlock(
+                static_cast<CleanBlockStatement*>(stmt.get()), live, remove
+            );
+        }
+
+        case CleanStatementType::If: {
+            CleanIfStatement* if_stmt = static_cast<CleanIfStatement*>(stmt.get());
+            Liveness in = if_stmt->else_branch
+                ? liveBlock(if_stmt->else_branch->body.get(), live, remove)
+                : live;
+
+            for (auto& elif_branch: if_stmt->elif_branches) {
+                Liveness branch_in = liveBlock(elif_branch->body.get(), live, remove);
+                for (std::size_t i = 0; i < in.size(); ++i)
+                    in[i] = in[i] || branch_in[i];
+                read(elif_branch->condition.get(), in);
+            }
+
+            Liveness body_in = liveBlock(if_stmt->body.get(), live, remove);
+            for (std::size_t i = 0; i < in.size(); ++i)
+                in[i] = in[i] || body_in[i];
+            read(if_stmt->condition.get(), in);
+            return in;
+        }
+
+        case CleanStatementType::For: {
+            CleanForStatement* for_stmt = static_cast<CleanForStatement*>(stmt.get());
+            Liveness in = liveLoop(
+                for_stmt->body.get(),
+                for_stmt->term_clause.get(),
+                for_stmt->incr_clause.get(),
+                live,
+                remove
+            );
+            if (for_stmt->init_clause)
+                read(for_stmt->init_clause.get(), in);
+            return in;
+        }
+
+        case CleanStatementType::While: {
+            CleanWhileStatement* while_stmt =
+                static_cast<CleanWhileStatement*>(stmt.get());
+            return liveLoop(
+                while_stmt->body.get(),
+                while_stmt->condition.get(),
+                nullptr,
+                live,
+                remove
+            );
+        }
+
+        case CleanStatementType::Break:
+            return break_live;
+
+        case CleanStatementType::Continue:
+            return continue_live;
+
+        case CleanStatementType::Return: {
+            CleanReturnStatement* ret_stmt =
+                static_cast<CleanReturnStatement*>(stmt.get());
+            Liveness in(live.size(), false);
+            if (ret_stmt->expression)
+                read(ret_stmt->expression.get(), in);
+            return in;
+        }
+
+        case CleanStatementType::Expression: {
+            CleanExpression* expr = static_cast<CleanExpression*>(stmt.get());
+            if (expr->type != CleanExpressionType::Assignment) {
+                read(expr, live);
+                return live;
+            }
+
+            CleanAssignmentExpression* assign_expr =
+                static_cast<CleanAssignmentExpression*>(expr);
+            CleanVariableExpression* var_expr =
+                static_cast<CleanVariableExpression*>(assign_expr->lvalue.get());
+
+            // Globals may be read by any function
+            if (var_expr->depth != 0) {
+                read(assign_expr->rvalue.get(), live);
+                return live;
+            }
+
+            if (remove && ! live[var_expr->slot]) {
+                // Definitions must have an initializer, and constants are
+                // initialized for nothing once their uses are folded
+                if (! assign_expr->is_initializer && ! isConstant(var_expr))
+                    warn(
+                        stmt->token,
+                        "value never read",
+                        "the value assigned to `" + var_expr->var_name + "` "
+                        "is overwritten or discarded before it is read"
+                    );
+
+                if (! hasEffects(assign_expr->rvalue.get())) {
+                    stmt.reset();
+                    return live;
+                }
+
+                Token token = stmt->token;
+                stmt = std::move(assign_expr->rvalue);
+                stmt->token = token;
+                read(static_cast<CleanExpression*>(stmt.get()), live);
+                return live;
+            }
+
+            live[var_expr->slot] = false;
+            read(assign_expr->rvalue.get(), live);
+            return live;
+        }
+
+        default:
+            throw std::runtime_error(
+                "Dead code elimination failed: unknow statement type."
+            );
+    }
+}
+
+// Find the slots live at the head of a loop
+Eliminator::Liveness
+Eliminator::liveLoop(
+    CleanBlockStatement* body,
+    CleanExpression* condition,
+    CleanExpression* incr_clause,
+    Liveness const& live,
+    bool remove
+)
+{
+    Liveness saved_break = break_live;
+    Liveness saved_continue = continue_live;
+
+    // The head is reached before the first iteration and after every other,
+    // so we grow its live slots until the body adds no more
+    Liveness head = live;
+    if (condition)
+        read(condition, head);
+
+    Liveness next = head;
+    while (true) {
+        next = head;
+        if (incr_clause)
+            read(incr_clause, next);
+
+        break_live = live;
+        continue_live = next;
+        Liveness body_in = liveBlock(body, next, false);
+
+        Liveness grown = head;
+        for (std::size_t i = 0; i < grown.size(); ++i)
+            grown[i] = grown[i] || body_in[i];
+        if (grown == head)
+            break;
+        head = grown;
+    }
+
+    if (remove) {
+        break_live = live;
+        continue_live = next;
+        liveBlock(body, next, true);
+    }
+
+    break_live = saved_break;
+    continue_live = saved_continue;
+    return head;
+}
+
+// Mark the local variables the expression reads as live
+void
+Eliminator::read(CleanExpression* expr, Liveness& live)
+{
+    switch (expr->type) {
+        case CleanExpressionType::Variable: {
+            CleanVariableExpression* var_expr =
+                static_cast<CleanVariableExpression*>(expr);
+            if (var_expr->depth == 0)
+                live[var_expr->slot] = true;
+            break;
+        }
+
+        case CleanExpressionType::Group: {
+            read(static_cast<CleanGroupExpression*>(expr)->expression.get(), live);
+            break;
+        }
+
+        case CleanExpressionType::Call: {
+            for (auto& argument: static_cast<CleanCallExpression*>(expr)->arguments)
+                read(argument.get(), live);
+            break;
+        }
+
+        case CleanExpressionType::TernaryIf: {
+            CleanTernaryIfExpression* ternif_expr =
+                static_cast<CleanTernaryIfExpression*>(expr);
+            read(ternif_expr->condition.get(), live);
+            read(ternif_expr->then_branch.get(), live);
+            read(ternif_expr->else_branch.get(), live);
+            break;
+        }
+
+        case CleanExpressionType::Assignment: {
+            // Nested assignments are kept, only what they read matters
+            read(static_cast<CleanAssignmentExpression*>(expr)->rvalue.get(), live);
+            break;
+        }
+
+        case CleanExpressionType::Operation: {
+            for (auto& operand: static_cast<CleanOperationExpression*>(expr)->operands)
+                read(operand.get(), live);
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+// Statements made up by other passes have no position to report
+void
+Eliminator::warn(
+    Token& token,
+    std::string const& primary_message,
+    std::string const& secondary_message
+)
+{
+    if (token.source)
+        warnings.emplace_back(token, primary_message, secondary_message);
+}
+
+// Whether the local variable assigned to is qualified as const
+bool
+Eliminator::isConstant(CleanVariableExpression* var_expr)
+{
+    for (CleanScope* current = block_scope; current; current = current->parent.get()) {
+        // Parameters are only known to the function definition
+        if (current == fun_def->scope.get())
+            return false;
+
+        if (current->hasSymbol<CleanVariableDefinition>(var_expr->var_name)) {
+            std::unique_ptr<CleanVariableDefinition>& var_def =
+                current->getSymbol<CleanVariableDefinition>(var_expr->var_name);
+            return static_cast<CleanSimpleTypeDeclaration*>(var_def->type.get())->is_const;
+        }
+    }
+
+    return false;
+}
+
+// Whether a statement always leaves the block it is in
+static bool
+terminates(CleanStatement* stmt)
+{
+    switch (stmt->type) {
+        case CleanStatementType::Return:
+        case CleanStatementType::Break:
+        case CleanStatementType::Continue:
+            return true;
+
+        case CleanStatementType::Block: {
+            CleanBlockStatement* block_stmt = static_cast<CleanBlockStatement*>(stmt);
+            return block_stmt->statements.size() &&
+                terminates(block_stmt->statements.back().get());
+        }
+
+        case CleanStatementType::If: {
+            CleanIfStatement* if_stmt = static_cast<CleanIfStatement*>(stmt);
+            if (! if_stmt->else_branch || ! terminates(if_stmt->else_branch->body.get()))
+                return false;
+            for (auto& elif_branch: if_stmt->elif_branches) {
+                if (! terminates(elif_branch->body.get()))
+                    return false;
+            }
+            return terminates(if_stmt->body.get());
+        }
+
+        default:
+            return false;
+    }
+}
+
+// Whether evaluating an expression does more than compute its value
+static bool
+hasEffects(CleanExpression* expr)
+{
+    switch (expr->type) {
+        case CleanExpressionType::Call:
+        case CleanExpressionType::Assignment:
+            return true;
+
+        case CleanExpressionType::Group:
+            return hasEffects(static_cast<CleanGroupExpression*>(expr)->expression.get());
+
+        case CleanExpressionType::TernaryIf: {
+            CleanTernaryIfExpression* ternif_expr =
+                static_cast<CleanTernaryIfExpression*>(expr);
+            return hasEffects(ternif_expr->condition.get()) ||
+                hasEffects(ternif_expr->then_branch.get()) ||
+                hasEffects(ternif_expr->else_branch.get());
+        }
+
+        case CleanExpressionType::Operation: {
+            CleanOperationExpression* op_expr =
+                static_cast<CleanOperationExpression*>(expr);
+            switch (op_expr->operation) {
+                // Integer division aborts unless the divisor is known not to be zero,
+                // and signed division also when the smallest int is divided by -1
+                case Operation::DivI64:
+                case Operation::RemI64: {
+                    if (op_expr->operands[1]->type != CleanExpressionType::SignedInt)
+                        return true;
+                    int64_t divisor =
+                        static_cast<CleanSignedIntExpression*>(op_expr->operands[1].get())->value;
+                    if (divisor == 0)
+                        return true;
+                    if (
+                        divisor == -1 && (
+                            op_expr->operands[0]->type != CleanExpressionType::SignedInt ||
+                            static_cast<CleanSignedIntExpression*>(op_expr->operands[0].get())->value == INT64_MIN
+                        )
+                    )
+                        return true;
+                    break;
+                }
+
+                case Operation::DivU64:
+                case Operation::RemU64:
+                    if (
+                        op_expr->operands[1]->type != CleanExpressionType::UnsignedInt ||
+                        static_cast<CleanUnsignedIntExpression*>(op_expr->operands[1].get())->value == 0
+                    )
+                        return true;
+                    break;
+
+                default:
+                    break;
+            }
+
+            for (auto& operand: op_expr->operands) {
+                if (hasEffects(operand.get()))
+                    return true;
+            }
+            return false;
+        }
+
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,753 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdexcept>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <sstream>
+#include <cstdio>
+#include <utility>
+#include <string>
+#include <vector>
+#include <cctype>
+#include <map>
+
+#include "cleaner/ast/definitions/function.h"
+#include "cleaner/symbols/scope.h"
+#include "emitter/assembly.h"
+#include "common/operation.h"
+#include "ir/allocator.h"
+#include "common/value.h"
+#include "ir/ir.h"
+
+
+/* Registers values are allocated to, callee saved so calls leave them alone. */
+static std::vector<std::string> const value_registers = {
+    "%rbx", "%r12", "%r13", "%r14", "%r15"
+};
+
+/* Registers the first arguments are passed in. */
+static std::vector<std::string> const argument_registers = {
+    "%rdi", "%rsi", "%rdx", "%rcx", "%r8", "%r9"
+};
+
+/* Condition codes of integer and boolean comparisons. */
+static std::map<enum Operation, std::string> const conditions = {
+    {Operation::EqI64,  "e"},   {Operation::NeI64,  "ne"},
+    {Operation::GtI64,  "g"},   {Operation::GeI64,  "ge"},
+    {Operation::LtI64,  "l"},   {Operation::LeI64,  "le"},
+    {Operation::EqU64,  "e"},   {Operation::NeU64,  "ne"},
+    {Operation::GtU64,  "a"},   {Operation::GeU64,  "ae"},
+    {Operation::LtU64,  "b"},   {Operation::LeU64,  "be"},
+    {Operation::EqBool, "e"},   {Operation::NeBool, "ne"}
+};
+
+/* Print functions, by the stdio intrinsic they stand for. */
+static char const runtime[] =
+    "# Runtime\n"
+    "proto_print_bool:\n"
+    "    leaq .Lformat_string(%rip), %rax\n"
+    "    jmp .Lprint_bool\n"
+    "proto_println_bool:\n"
+    "    leaq .Lformat_string_line(%rip), %rax\n"
+    ".Lprint_bool:\n"
+    "    leaq .Ltrue(%rip), %rsi\n"
+    "    leaq .Lfalse(%rip), %rcx\n"
+    "    testb %dil, %dil\n"
+    "    cmove %rcx, %rsi\n"
+    "    movq %rax, %rdi\n"
+    "    xorl %eax, %eax\n"
+    "    jmp printf@PLT\n"
+    "proto_print_int:\n"
+    "    leaq .Lformat_int(%rip), %rax\n"
+    "    jmp .Lprint_value\n"
+    "proto_println_int:\n"
+    "    leaq .Lformat_int_line(%rip), %rax\n"
+    "    jmp .Lprint_value\n"
+    "proto_print_uint:\n"
+    "    leaq .Lformat_uint(%rip), %rax\n"
+    "    jmp .Lprint_value\n"
+    "proto_println_uint:\n"
+    "    leaq .Lformat_uint_line(%rip), %rax\n"
+    "    jmp .Lprint_value\n"
+    "proto_print_string:\n"
+    "    leaq .Lformat_string(%rip), %rax\n"
+    "    jmp .Lprint_value\n"
+    "proto_println_string:\n"
+    "    leaq .Lformat_string_line(%rip), %rax\n"
+    ".Lprint_value:\n"
+    "    movq %rdi, %rsi\n"
+    "    movq %rax, %rdi\n"
+    "    xorl %eax, %eax\n"
+    "    jmp printf@PLT\n"
+    "proto_print_float:\n"
+    "    leaq .Lformat_float(%rip), %rax\n"
+    "    jmp .Lprint_float\n"
+    "proto_println_float:\n"
+    "    leaq .Lformat_float_line(%rip), %rax\n"
+    ".Lprint_float:\n"
+    "    movq %rdi, %xmm0\n"
+    "    movq %rax, %rdi\n"
+    "    movl $1, %eax\n"
+    "    jmp printf@PLT\n"
+    "\n"
+    "    .section .rodata\n"
+    ".Ltrue:\n"
+    "    .string \"true\"\n"
+    ".Lfalse:\n"
+    "    .string \"false\"\n"
+    ".Lformat_string:\n"
+    "    .string \"%s\"\n"
+    ".Lformat_string_line:\n"
+    "    .string \"%s\\n\"\n"
+    ".Lformat_int:\n"
+    "    .string \"%ld\"\n"
+    ".Lformat_int_line:\n"
+    "    .string \"%ld\\n\"\n"
+    ".Lformat_uint:\n"
+    "    .string \"%lu\"\n"
+    ".Lformat_uint_line:\n"
+    "    .string \"%lu\\n\"\n"
+    ".Lformat_float:\n"
+    "    .string \"%f\"\n"
+    ".Lformat_float_line:\n"
+    "    .string \"%f\\n\"\n";
+
+static std::string functionSymbol(std::string const& name);
+static std::string globalSymbol(std::size_t slot);
+static std::string stringDirective(std::string const& value);
+static bool isMemory(std::string const& location);
+
+AssemblyEmitter::AssemblyEmitter(
+    IRModule& module,
+    CleanScope* scope
+) : module(module),
+    scope(scope),
+    saved_count(0),
+    function_index(0)
+{}
+
+/**
+ * Translates every function of the module to GNU assembler
+ * for x86-64 System V, along with a runtime that prints with printf.
+ *
+ * Values live in callee saved registers or in stack slots, as linear
+ * scan decides. The result assembles and links with `cc`.
+ */
+std::string
+AssemblyEmitter::emit()
+{
+    // Intrinsics are told apart by the name they were registered under
+    for (auto& [name, fun_def]: scope->getSymbols<CleanFunctionDefinition>())
+        names[fun_def.get()] = name;
+
+    out << "    .text\n";
+    for (auto& function: module.functions) {
+        emitFunction(*function);
+        function_index++;
+    }
+
+    // The program exits with the result of its main function, -1 without one
+    CleanFunctionDefinition* main_fun = scope->getSymbol<CleanFunctionDefinition>("main()").get();
+    out << "\n    .globl main\n"
+        << "    .type main, @function\n"
+        << "main:\n";
+    line() << "pushq %rbp\n";
+    line() << "movq %rsp, %rbp\n";
+    line() << "call " << functionSymbol(names.at(main_fun)) << "\n";
+    if (
+        main_fun->return_type == nullptr ||
+        static_cast<CleanSimpleTypeDeclaration*>(main_fun->return_type.get())->name != "int"
+    )
+        line() << "movl $-1, %eax\n";
+    line() << "popq %rbp\n";
+    line() << "ret\n\n";
+    out << runtime;
+
+    // Global variables start with the constants the module gives them
+    out << "\n    .data\n";
+    for (std::size_t slot = 0; slot < module.globals.size(); ++slot) {
+        Value const& value = module.globals[slot];
+        out << "    .p2align 3\n" << globalSymbol(slot) << ":\n";
+        if (value.type == ValueType::String)
+            line() << ".quad " << stringLabel(value.as_string) << "\n";
+        else
+            line() << ".quad " << value.as_uint << "\n";
+    }
+
+    out << "\n    .section .rodata\n";
+    for (auto& [value, label]: strings) {
+        out << label << ":\n";
+        line() << ".string " << stringDirective(*value) << "\n";
+    }
+
+    out << "\n    .section .note.GNU-stack,\"\",@progbits\n";
+    return out.str();
+}
+
+// Functions
+void
+AssemblyEmitter::emitFunction(IRFunction& function)
+{
+    splitCriticalEdges(function);
+    allocation = RegisterAllocator(function, value_registers.size()).allocate();
+    saved_count = allocation.register_count;
+
+    // Callee saved registers sit below the frame pointer, then the stack slots,
+    // the stack pointer stays aligned on 16 bytes for calls
+    std::size_t frame_size = 8 * allocation.spill_count;
+    if ((8 * saved_count + frame_size) % 16)
+        frame_size += 8;
+
+    out << "\n" << functionSymbol(function.name) << ":\n";
+    line() << "pushq %rbp\n";
+    line() << "movq %rsp, %rbp\n";
+    for (std::size_t i = 0; i < saved_count; ++i)
+        line() << "pushq " << value_registers[i] << "\n";
+    if (frame_size)
+        line() << "subq $" << frame_size << ", %rsp\n";
+
+    // Arguments past the sixth are above the return address
+    for (auto& instr: function.blocks.front()->instructions) {
+        if (instr->opcode != IROpcode::Param)
+            continue;
+        if (! allocation.registers.count(instr.get()) && ! allocation.spills.count(instr.get()))
+            continue;
+
+        std::size_t index = instr->index;
+        move(
+            location(instr.get()),
+            index < argument_registers.size()
+                ? argument_registers[index]
+                : std::to_string(16 + 8 * (index - argument_registers.size())) + "(%rbp)"
+        );
+    }
+
+    std::vector<IRBlock*>& order = allocation.order;
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        IRBlock* next = i + 1 < order.size() ? order[i + 1] : nullptr;
+        out << blockLabel(order[i]) << ":\n";
+        for (auto& instr: order[i]->instructions)
+            emitInstruction(instr.get(), next);
+    }
+
+    // Integer division by zero aborts, as it does when interpreted
+    out << ".L" << function_index << "_abort:\n";
+    line() << "call abort@PLT\n";
+}
+
+// Restore the callee saved registers and the caller's frame
+void
+AssemblyEmitter::emitEpilogue()
+{
+    if (saved_count)
+        line() << "leaq -" << 8 * saved_count << "(%rbp), %rsp\n";
+    else
+        line() << "movq %rbp, %rsp\n";
+    for (std::size_t i = saved_count; i > 0; --i)
+        line() << "popq " << value_registers[i - 1] << "\n";
+    line() << "popq %rbp\n";
+}
+
+// Instructions
+void
+AssemblyEmitter::emitInstruction(IRInstruction* instr, IRBlock* next)
+{
+    switch (instr->opcode) {
+        case IROpcode::Param:
+        case IROpcode::Phi:
+        case IROpcode::Const:
+            // Arguments are in place, phis are written by their predecessors
+            // and constants are immediates of the instructions using them
+            break;
+
+        case IROpcode::Copy:
+            load("%rax", instr->operands[0]);
+            store(instr, "%rax");
+            break;
+
+        case IROpcode::LoadGlobal:
+            line() << "movq " << globalSymbol(instr->index) << "(%rip), %rax\n";
+            store(instr, "%rax");
+            break;
+
+        case IROpcode::StoreGlobal:
+            load("%rax", instr->operands[0]);
+            line() << "movq %rax, " << globalSymbol(instr->index) << "(%rip)\n";
+            break;
+
+        case IROpcode::Operation:
+            emitOperation(instr);
+            break;
+
+        case IROpcode::Call:
+            emitCall(instr);
+            break;
+
+        case IROpcode::Jump:
+            emitPhiCopies(instr->block, instr->targets[0]);
+            emitJump(instr->targets[0], next);
+            break;
+
+        case IROpcode::Branch:
+            // Critical edges are split so neither target has phis
+            load("%rax", instr->operands[0]);
+            line() << "testb %al, %al\n";
+            line() << "je " << blockLabel(instr->targets[1]) << "\n";
+            emitJump(instr->targets[0], next);
+            break;
+
+        case IROpcode::Return:
+            if (instr->operands.size())
+                load("%rax", instr->operands[0]);
+            emitEpilogue();
+            line() << "ret\n";
+            break;
+
+        default:
+            throw std::runtime_error(
+                "Assembly emission failed: unknow instruction."
+            );
+    }
+}
+
+void
+AssemblyEmitter::emitOperation(IRInstruction* instr)
+{
+    load("%rax", instr->operands[0]);
+    if (instr->operands.size() > 1)
+        load("%rcx", instr->operands[1]);
+
+    // Floating point comparisons need the unordered case
+    auto compareFloat = [&](std::string const& condition, bool swap) {
+        line() << "movq %rax, %xmm0\n";
+        line() << "movq %rcx, %xmm1\n";
+        line() << (swap ? "ucomisd %xmm0, %xmm1\n" : "ucomisd %xmm1, %xmm0\n");
+        line() << "set" << condition << " %al\n";
+    };
+    auto arithmeticFloat = [&](std::string const& mnemonic) {
+        line() << "movq %rax, %xmm0\n";
+        line() << "movq %rcx, %xmm1\n";
+        line() << mnemonic << " %xmm1, %xmm0\n";
+        line() << "movq %xmm0, %rax\n";
+    };
+    auto divide = [&](bool is_signed, bool remainder) {
+        line() << "testq %rcx, %rcx\n";
+        line() << "je .L" << function_index << "_abort\n";
+        if (is_signed) {
+            line() << "cqto\n";
+            line() << "idivq %rcx\n";
+        }
+        else {
+            line() << "xorl %edx, %edx\n";
+            line() << "divq %rcx\n";
+        }
+        if (remainder)
+            line() << "movq %rdx, %rax\n";
+    };
+
+    auto condition = conditions.find(instr->operation);
+    if (condition != conditions.end()) {
+        line() << "cmpq %rcx, %rax\n";
+        line() << "set" << condition->second << " %al\n";
+        line() << "movzbl %al, %eax\n";
+        store(instr, "%rax");
+        return;
+    }
+
+    switch (instr->operation) {
+        case Operation::AddI64:
+        case Operation::AddU64:
+            line() << "addq %rcx, %rax\n";
+            break;
+
+        case Operation::SubI64:
+        case Operation::SubU64:
+            line() << "subq %rcx, %rax\n";
+            break;
+
+        case Operation::MulI64:
+        case Operation::MulU64:
+            line() << "imulq %rcx, %rax\n";
+            break;
+
+        case Operation::DivI64:
+            divide(true, false);
+            break;
+
+        case Operation::RemI64:
+            divide(true, true);
+            break;
+
+        case Operation::DivU64:
+            divide(false, false);
+            break;
+
+        case Operation::RemU64:
+            divide(false, true);
+            break;
+
+        case Operation::NegI64:
+        case Operation::NegU64:
+            line() << "negq %rax\n";
+            break;
+
+        case Operation::BnotI64:
+        case Operation::BnotU64:
+            line() << "notq %rax\n";
+            break;
+
+        case Operation::AddF64:
+            arithmeticFloat("addsd");
+            break;
+
+        case Operation::SubF64:
+            arithmeticFloat("subsd");
+            break;
+
+        case Operation::MulF64:
+            arithmeticFloat("mulsd");
+            break;
+
+        case Operation::DivF64:
+            arithmeticFloat("divsd");
+            break;
+
+        case Operation::NegF64:
+            line() << "btcq $63, %rax\n";
+            break;
+
+        // Unordered operands compare false, except for inequality
+        case Operation::EqF64:
+            compareFloat("e", false);
+            line() << "setnp %cl\n";
+            line() << "andb %cl, %al\n";
+            line() << "movzbl %al, %eax\n";
+            break;
+
+        case Operation::NeF64:
+            compareFloat("ne", false);
+            line() << "setp %cl\n";
+            line() << "orb %cl, %al\n";
+            line() << "movzbl %al, %eax\n";
+            break;
+
+        case Operation::GtF64:
+            compareFloat("a", false);
+            line() << "movzbl %al, %eax\n";
+            break;
+
+        case Operation::GeF64:
+            compareFloat("ae", false);
+            line() << "movzbl %al, %eax\n";
+            break;
+
+        case Operation::LtF64:
+            compareFloat("a", true);
+            line() << "movzbl %al, %eax\n";
+            break;
+
+        case Operation::LeF64:
+            compareFloat("ae", true);
+            line() << "movzbl %al, %eax\n";
+            break;
+
+        case Operation::NotBool:
+            line() << "xorq $1, %rax\n";
+            break;
+
+        default:
+            throw std::runtime_error(
+                "Assembly emission failed: unknow operation."
+            );
+    }
+
+    store(instr, "%rax");
+}
+
+void
+AssemblyEmitter::emitCall(IRInstruction* instr)
+{
+    CleanFunctionDefinition* callee = instr->callee;
+    if (callee->is_intrinsic) {
+        emitIntrinsicCall(instr);
+        return;
+    }
+
+    // A tail call leaves the frame and jumps, the callee returns to our caller,
+    // unless some arguments go on the stack which is still ours
+    std::size_t register_count = argument_registers.size();
+    std::string symbol = functionSymbol(names.at(callee));
+    if (instr->is_tail_call && instr->operands.size() <= register_count) {
+        for (std::size_t i = 0; i < instr->operands.size(); ++i)
+            load(argument_registers[i], instr->operands[i]);
+        emitEpilogue();
+        line() << "jmp " << symbol << "\n";
+        return;
+    }
+
+    // Arguments past the sixth are pushed last to first, keeping the stack aligned
+    std::size_t stack_count = instr->operands.size() > register_count
+        ? instr->operands.size() - register_count
+        : 0;
+    std::size_t padding = stack_count % 2 ? 8 : 0;
+    if (padding)
+        line() << "subq $" << padding << ", %rsp\n";
+    for (std::size_t i = instr->operands.size(); i > register_count; --i) {
+        load("%rax", instr->operands[i - 1]);
+        line() << "pushq %rax\n";
+    }
+
+    // Values are in callee saved registers or stack slots so loading
+    // an argument never overwrites another one
+    for (std::size_t i = 0; i < instr->operands.size() && i < register_count; ++i)
+        load(argument_registers[i], instr->operands[i]);
+    line() << "call " << symbol << "\n";
+    if (stack_count)
+        line() << "addq $" << 8 * stack_count + padding << ", %rsp\n";
+
+    if (instr->type != ValueType::Void)
+        store(instr, "%rax");
+}
+
+// Stdio calls the runtime, reslib functions left as calls are unary plus
+void
+AssemblyEmitter::emitIntrinsicCall(IRInstruction* instr)
+{
+    std::string const& name = names.at(instr->callee);
+    std::size_t open = name.find('(');
+    std::string callee = name.substr(0, open);
+    std::string type = name.substr(open + 1, name.size() - open - 2);
+
+    if (
+        (callee == "print" || callee == "println") &&
+        (type == "bool" || type == "int" || type == "uint" || type == "float" || type == "string")
+    ) {
+        load("%rdi", instr->operands[0]);
+        line() << "call proto_" << callee << "_" << type << "\n";
+        return;
+    }
+
+    if (callee == "__pos__") {
+        load("%rax", instr->operands[0]);
+        store(instr, "%rax");
+        return;
+    }
+
+    throw std::runtime_error(
+        "Assembly emission failed: intrinsic `" + name + "` has no native equivalent."
+    );
+}
+
+// Copy the values flowing into the phis of a block as if all at once
+void
+AssemblyEmitter::emitPhiCopies(IRBlock* from, IRBlock* to)
+{
+    std::size_t index = std::find(
+        to->predecessors.begin(),
+        to->predecessors.end(),
+        from
+    ) - to->predecessors.begin();
+
+    // Constants have no location, they are written once the copies are done
+    std::vector<std::pair<std::string, std::string>> moves;
+    std::vector<IRInstruction*> constants;
+    for (auto& instr: to->instructions) {
+        if (instr->opcode != IROpcode::Phi)
+            break;
+
+        IRInstruction* operand = instr->operands[index];
+        std::string dst = location(instr.get());
+        if (operand->opcode == IROpcode::Const)
+            constants.push_back(instr.get());
+        else if (dst != location(operand))
+            moves.emplace_back(dst, location(operand));
+    }
+
+    // A copy waits while another one still reads its destination,
+    // when they all wait on each other one destination is set aside
+    while (moves.size()) {
+        bool progress = false;
+        for (std::size_t i = 0; i < moves.size(); ++i) {
+            std::string const& dst = moves[i].first;
+            bool read = false;
+            for (auto& other: moves)
+                read = read || other.second == dst;
+            if (read)
+                continue;
+
+            move(dst, moves[i].second);
+            moves.erase(moves.begin() + i);
+            progress = true;
+            break;
+        }
+
+        if (progress)
+            continue;
+
+        std::string saved = moves[0].first;
+        move("%r11", saved);
+        for (auto& other: moves) {
+            if (other.second == saved)
+                other.second = "%r11";
+        }
+    }
+
+    for (IRInstruction* phi: constants) {
+        load("%rax", phi->operands[index]);
+        store(phi, "%rax");
+    }
+}
+
+// Jump to a block unless it comes next
+void
+AssemblyEmitter::emitJump(IRBlock* target, IRBlock* next)
+{
+    if (target != next)
+        line() << "jmp " << blockLabel(target) << "\n";
+}
+
+// Values
+void
+AssemblyEmitter::load(std::string const& dst, IRInstruction* value)
+{
+    if (value->opcode != IROpcode::Const) {
+        move(dst, location(value));
+        return;
+    }
+
+    if (value->value.type == ValueType::String)
+        line() << "leaq " << stringLabel(value->value.as_string) << "(%rip), " << dst << "\n";
+    else if (value->value.as_int == static_cast<int32_t>(value->value.as_int))
+        line() << "movq $" << value->value.as_int << ", " << dst << "\n";
+    else
+        line() << "movabsq $" << value->value.as_int << ", " << dst << "\n";
+}
+
+void
+AssemblyEmitter::store(IRInstruction* value, std::string const& src)
+{
+    move(location(value), src);
+}
+
+// Copy between registers and stack slots, going through a register between slots
+void
+AssemblyEmitter::move(std::string const& dst, std::string const& src)
+{
+    if (dst == src)
+        return;
+
+    if (isMemory(dst) && isMemory(src)) {
+        line() << "movq " << src << ", %rax\n";
+        line() << "movq %rax, " << dst << "\n";
+        return;
+    }
+
+    line() << "movq " << src << ", " << dst << "\n";
+}
+
+// Register or stack slot holding the given value
+std::string
+AssemblyEmitter::location(IRInstruction* value)
+{
+    auto reg = allocation.registers.find(value);
+    if (reg != allocation.registers.end())
+        return value_registers[reg->second];
+
+    // Stack slots are below the callee saved registers
+    std::size_t slot = allocation.spills.at(value);
+    return "-" + std::to_string(8 * (saved_count + slot + 1)) + "(%rbp)";
+}
+
+// Labels
+std::string
+AssemblyEmitter::blockLabel(IRBlock* block)
+{
+    return ".L" + std::to_string(function_index) + "_" + std::to_string(block->id);
+}
+
+std::string
+AssemblyEmitter::stringLabel(std::string const * value)
+{
+    auto it = strings.find(value);
+    if (it != strings.end())
+        return it->second;
+
+    std::string label = ".Lstring_" + std::to_string(strings.size());
+    strings[value] = label;
+    return label;
+}
+
+// Start a new instruction
+std::ostream&
+AssemblyEmitter::line()
+{
+    return out << "    ";
+}
+
+// Overloads get different symbols by spelling out their parameter types
+static std::string
+functionSymbol(std::string const& name)
+{
+    std::string symbol = "proto_";
+    for (char c: name) {
+        if (c == '(')
+            symbol += "__";
+        else if (c == ',')
+            symbol += "_";
+        else if (std::isalnum(static_cast<unsigned char>(c)) || c == '_')
+            symbol += c;
+    }
+    return symbol;
+}
+
+static std::string
+globalSymbol(std::size_t slot)
+{
+    return "proto_global_" + std::to_string(slot);
+}
+
+// Quotes and backslashes are escaped, other unprintable characters use octal
+static std::string
+stringDirective(std::string const& value)
+{
+    std::string directive = "\"";
+    for (char c: value) {
+        unsigned char byte = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\') {
+            directive += '\\';
+            directive += c;
+        }
+        else if (byte < 0x20 || byte >= 0x7F) {
+            char buffer[8];
+            std::snprintf(buffer, sizeof(buffer), "\\%03o", byte);
+            directive += buffer;
+        }
+        else {
+            directive += c;
+        }
+    }
+    return directive + "\"";
+}
+
+// Whether the location is a stack slot rather than a register
+static bool
+isMemory(std::string const& location)
+{
+    return location.find('(') != std::string::npos;
+}
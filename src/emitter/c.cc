@@ -0,0 +1,675 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdexcept>
+#include <cinttypes>
+#include <cstdint>
+#include <cstddef>
+#include <sstream>
+#include <cstdio>
+#include <string>
+#include <cctype>
+#include <memory>
+#include <vector>
+#include <cmath>
+#include <map>
+
+#include "cleaner/ast/expressions/expression.h"
+#include "cleaner/ast/definitions/function.h"
+#include "cleaner/ast/statements/statement.h"
+#include "cleaner/ast/declarations/type.h"
+#include "cleaner/ast/statements/return.h"
+#include "cleaner/ast/statements/while.h"
+#include "cleaner/ast/statements/block.h"
+#include "cleaner/ast/statements/for.h"
+#include "cleaner/ast/statements/if.h"
+#include "cleaner/symbols/scope.h"
+#include "common/operation.h"
+#include "emitter/c.h"
+
+
+/* Declarations every translated program starts with. */
+static char const prelude[] =
+    "#include <inttypes.h>\n"
+    "#include <stdbool.h>\n"
+    "#include <stdint.h>\n"
+    "#include <stdlib.h>\n"
+    "#include <signal.h>\n"
+    "#include <stdio.h>\n"
+    "#include <math.h>\n"
+    "\n"
+    "/* Signed integers wrap around and dividing by zero aborts, as in the interpreter.\n"
+    " * Dividing the smallest int by -1 raises the arithmetic trap the other backends get. */\n"
+    "static inline void proto_overflow(void) { raise(SIGFPE); abort(); }\n"
+    "static inline int64_t proto_add_i64(int64_t a, int64_t b) { return (int64_t) ((uint64_t) a + (uint64_t) b); }\n"
+    "static inline int64_t proto_sub_i64(int64_t a, int64_t b) { return (int64_t) ((uint64_t) a - (uint64_t) b); }\n"
+    "static inline int64_t proto_mul_i64(int64_t a, int64_t b) { return (int64_t) ((uint64_t) a * (uint64_t) b); }\n"
+    "static inline int64_t proto_neg_i64(int64_t a) { return (int64_t) (0 - (uint64_t) a); }\n"
+    "static inline int64_t proto_div_i64(int64_t a, int64_t b) { if (b == 0) abort(); if (a == INT64_MIN && b == -1) proto_overflow(); return a / b; }\n"
+    "static inline int64_t proto_rem_i64(int64_t a, int64_t b) { if (b == 0) abort(); if (a == INT64_MIN && b == -1) proto_overflow(); return a % b; }\n"
+    "static inline uint64_t proto_div_u64(uint64_t a, uint64_t b) { if (b == 0) abort(); return a / b; }\n"
+    "static inline uint64_t proto_rem_u64(uint64_t a, uint64_t b) { if (b == 0) abort(); return a % b; }\n";
+
+/* Operations that map to a C operator, by their number of operands. */
+static std::map<enum Operation, std::string> const unary_operators = {
+    {Operation::NegU64,     "-"},
+    {Operation::NegF64,     "-"},
+    {Operation::BnotI64,    "~"},
+    {Operation::BnotU64,    "~"},
+    {Operation::NotBool,    "!"}
+};
+
+static std::map<enum Operation, std::string> const binary_operators = {
+    {Operation::EqI64,      "=="},  {Operation::NeI64,      "!="},
+    {Operation::GtI64,      ">"},   {Operation::GeI64,      ">="},
+    {Operation::LtI64,      "<"},   {Operation::LeI64,      "<="},
+    {Operation::AddU64,     "+"},   {Operation::SubU64,     "-"},
+    {Operation::MulU64,     "*"},
+    {Operation::EqU64,      "=="},  {Operation::NeU64,      "!="},
+    {Operation::GtU64,      ">"},   {Operation::GeU64,      ">="},
+    {Operation::LtU64,      "<"},   {Operation::LeU64,      "<="},
+    {Operation::AddF64,     "+"},   {Operation::SubF64,     "-"},
+    {Operation::MulF64,     "*"},   {Operation::DivF64,     "/"},
+    {Operation::EqF64,      "=="},  {Operation::NeF64,      "!="},
+    {Operation::GtF64,      ">"},   {Operation::GeF64,      ">="},
+    {Operation::LtF64,      "<"},   {Operation::LeF64,      "<="},
+    {Operation::EqBool,     "=="},  {Operation::NeBool,     "!="}
+};
+
+/* Operations that go through a prelude function. */
+static std::map<enum Operation, std::string> const helpers = {
+    {Operation::AddI64,     "proto_add_i64"},
+    {Operation::SubI64,     "proto_sub_i64"},
+    {Operation::MulI64,     "proto_mul_i64"},
+    {Operation::NegI64,     "proto_neg_i64"},
+    {Operation::DivI64,     "proto_div_i64"},
+    {Operation::RemI64,     "proto_rem_i64"},
+    {Operation::DivU64,     "proto_div_u64"},
+    {Operation::RemU64,     "proto_rem_u64"}
+};
+
+/* Format and suffix stdio intrinsics print their argument with. */
+static std::map<std::string, std::string> const print_formats = {
+    {"int",     "\"%\" PRId64"},
+    {"uint",    "\"%\" PRIu64"},
+    {"float",   "\"%f\""},
+    {"string",  "\"%s\""},
+    {"bool",    "\"%s\""}
+};
+
+static std::string cType(CleanTypeDeclaration* type_decl);
+static std::string operandType(enum Operation operation);
+static bool hasCall(CleanExpression* expr);
+static std::string functionName(std::string const& name);
+static std::string localName(std::string const& name, std::size_t slot);
+static std::string globalName(std::string const& name);
+static std::string floatLiteral(double value);
+static std::string stringLiteral(std::string const& value);
+
+CEmitter::CEmitter(
+    CleanScope* scope
+) : scope(scope),
+    depth(0)
+{}
+
+/**
+ * Translates every user function in the global scope to C99.
+ *
+ * The program must have gone through the resolver, the lowerer
+ * and the linker. The result only needs the C standard library.
+ *
+ * C leaves the order operands are evaluated in unspecified, so when
+ * an operand calls a function the operands are first evaluated
+ * left to right into temporaries, as the interpreter does.
+ */
+std::string
+CEmitter::emit()
+{
+    out << prelude;
+
+    // Global variables are set when the program starts, as the interpreter does
+    std::map<std::string,std::unique_ptr<CleanVariableDefinition>>& var_defs =
+        scope->getSymbols<CleanVariableDefinition>();
+    if (var_defs.size())
+        out << "\n";
+    for (auto& [name, var_def]: var_defs)
+        out << "static " << cType(var_def->type.get()) << " " << globalName(name) << ";\n";
+
+    // Intrinsics are told apart by the name they were registered under
+    std::map<std::string,std::unique_ptr<CleanFunctionDefinition>>& fun_defs =
+        scope->getSymbols<CleanFunctionDefinition>();
+    for (auto& [name, fun_def]: fun_defs)
+        names[fun_def.get()] = name;
+
+    // Prototypes first so functions can call the ones defined after them
+    out << "\n";
+    for (auto& [name, fun_def]: fun_defs) {
+        if (fun_def->is_intrinsic)
+            continue;
+        emitPrototype(fun_def.get());
+        out << ";\n";
+    }
+
+    for (auto& [name, fun_def]: fun_defs) {
+        if (! fun_def->is_intrinsic)
+            emitFunction(fun_def.get());
+    }
+
+    // The exit status is the result of the program's main function, -1 without one
+    CleanFunctionDefinition* main_fun = scope->getSymbol<CleanFunctionDefinition>("main()").get();
+    temporaries.clear();
+    std::vector<std::string> initializers;
+    for (auto& [name, var_def]: var_defs)
+        initializers.push_back(globalName(name) + " = " + expression(var_def->initializer.get()));
+    out << "\nint main(void)\n{\n";
+    depth++;
+    emitTemporaries();
+    for (auto& initializer: initializers)
+        line() << initializer << ";\n";
+    depth--;
+    if (main_fun->return_type && cType(main_fun->return_type.get()) == "int64_t")
+        out << "    return (int) " << functionName(names.at(main_fun)) << "();\n";
+    else
+        out << "    " << functionName(names.at(main_fun)) << "();\n    return -1;\n";
+    out << "}\n";
+
+    return out.str();
+}
+
+// Functions
+void
+CEmitter::emitPrototype(CleanFunctionDefinition* fun_def)
+{
+    out << "static " << cType(fun_def->return_type.get()) << " "
+        << functionName(names.at(fun_def)) << "(";
+    if (fun_def->parameters.empty())
+        out << "void";
+    for (std::size_t i = 0; i < fun_def->parameters.size(); ++i) {
+        if (i)
+            out << ", ";
+        out << cType(fun_def->parameters[i]->type.get()) << " "
+            << localName(fun_def->parameters[i]->name, i);
+    }
+    out << ")";
+}
+
+void
+CEmitter::emitFunction(CleanFunctionDefinition* fun_def)
+{
+    out << "\n";
+    emitPrototype(fun_def);
+    out << "\n";
+
+    // The temporaries the body needs are only known once it is written
+    std::ostringstream function_out;
+    out.swap(function_out);
+    temporaries.clear();
+    emitBlock(fun_def->body.get());
+    out.swap(function_out);
+
+    std::string body = function_out.str();
+    std::size_t open = body.find('\n') + 1;
+    out << body.substr(0, open);
+    depth++;
+    emitTemporaries();
+    depth--;
+    out << body.substr(open);
+}
+
+// Declare the temporaries operands were evaluated into
+void
+CEmitter::emitTemporaries()
+{
+    for (std::size_t i = 0; i < temporaries.size(); ++i)
+        line() << temporaries[i] << " tmp" << i << ";\n";
+}
+
+// Statements
+void
+CEmitter::emitStatement(CleanStatement* stmt)
+{
+    switch (stmt->type) {
+        case CleanStatementType::Block:
+            emitBlock(static_cast<CleanBlockStatement*>(stmt));
+            break;
+
+        case CleanStatementType::If:
+            emitIf(static_cast<CleanIfStatement*>(stmt));
+            break;
+
+        case CleanStatementType::For:
+            emitFor(static_cast<CleanForStatement*>(stmt));
+            break;
+
+        case CleanStatementType::While:
+            emitWhile(static_cast<CleanWhileStatement*>(stmt));
+            break;
+
+        case CleanStatementType::Break:
+            line() << "break;\n";
+            break;
+
+        case CleanStatementType::Continue:
+            line() << "continue;\n";
+            break;
+
+        case CleanStatementType::Return:
+            emitReturn(static_cast<CleanReturnStatement*>(stmt));
+            break;
+
+        case CleanStatementType::Expression:
+            line() << expression(static_cast<CleanExpression*>(stmt)) << ";\n";
+            break;
+
+        default:
+            throw std::runtime_error(
+                "C emission failed: unknow statement type."
+            );
+    }
+}
+
+void
+CEmitter::emitBlock(CleanBlockStatement* block_stmt)
+{
+    line() << "{\n";
+    depth++;
+    emitLocals(block_stmt->scope.get());
+    for (auto& statement: block_stmt->statements)
+        emitStatement(statement.get());
+    depth--;
+    line() << "}\n";
+}
+
+void
+CEmitter::emitIf(CleanIfStatement* if_stmt)
+{
+    line() << "if (" << expression(if_stmt->condition.get()) << ")\n";
+    emitBlock(if_stmt->body.get());
+    for (auto& elif_branch: if_stmt->elif_branches) {
+        line() << "else if (" << expression(elif_branch->condition.get()) << ")\n";
+        emitBlock(elif_branch->body.get());
+    }
+    if (if_stmt->else_branch) {
+        line() << "else\n";
+        emitBlock(if_stmt->else_branch->body.get());
+    }
+}
+
+void
+CEmitter::emitFor(CleanForStatement* for_stmt)
+{
+    // The loop variables live in a scope around the loop
+    line() << "{\n";
+    depth++;
+    emitLocals(for_stmt->scope.get());
+    line() << "for ("
+           << (for_stmt->init_clause ? expression(for_stmt->init_clause.get()) : "") << "; "
+           << (for_stmt->term_clause ? expression(for_stmt->term_clause.get()) : "") << "; "
+           << (for_stmt->incr_clause ? expression(for_stmt->incr_clause.get()) : "") << ")\n";
+    emitBlock(for_stmt->body.get());
+    depth--;
+    line() << "}\n";
+}
+
+void
+CEmitter::emitWhile(CleanWhileStatement* while_stmt)
+{
+    line() << "while ("
+           << (while_stmt->condition ? expression(while_stmt->condition.get()) : "true")
+           << ")\n";
+    emitBlock(while_stmt->body.get());
+}
+
+void
+CEmitter::emitReturn(CleanReturnStatement* ret_stmt)
+{
+    if (ret_stmt->expression)
+        line() << "return " << expression(ret_stmt->expression.get()) << ";\n";
+    else
+        line() << "return;\n";
+}
+
+// Declare the variables of a scope, zeroed as frame slots start
+void
+CEmitter::emitLocals(CleanScope* scope)
+{
+    for (auto& [name, var_def]: scope->getSymbols<CleanVariableDefinition>())
+        line() << cType(var_def->type.get()) << " "
+               << localName(name, var_def->slot) << " = 0;\n";
+}
+
+// Expressions
+std::string
+CEmitter::expression(CleanExpression* expr)
+{
+    switch (expr->type) {
+        case CleanExpressionType::Boolean:
+            return static_cast<CleanBoolExpression*>(expr)->value ? "true" : "false";
+
+        case CleanExpressionType::SignedInt: {
+            int64_t value = static_cast<CleanSignedIntExpression*>(expr)->value;
+            if (value == INT64_MIN)
+                return "(-INT64_C(9223372036854775807) - 1)";
+            if (value < 0)
+                return "(-INT64_C(" + std::to_string(-value) + "))";
+            return "INT64_C(" + std::to_string(value) + ")";
+        }
+
+        case CleanExpressionType::UnsignedInt:
+            return "UINT64_C(" +
+                std::to_string(static_cast<CleanUnsignedIntExpression*>(expr)->value) + ")";
+
+        case CleanExpressionType::Float:
+            return floatLiteral(static_cast<CleanFloatExpression*>(expr)->value);
+
+        case CleanExpressionType::String:
+            return stringLiteral(static_cast<CleanStringExpression*>(expr)->value);
+
+        case CleanExpressionType::Variable: {
+            CleanVariableExpression* var_expr = static_cast<CleanVariableExpression*>(expr);
+            if (var_expr->depth == 0)
+                return localName(var_expr->var_name, var_expr->slot);
+            return globalName(var_expr->var_name);
+        }
+
+        case CleanExpressionType::Group:
+            return "(" + expression(static_cast<CleanGroupExpression*>(expr)->expression.get()) + ")";
+
+        case CleanExpressionType::Call:
+            return call(static_cast<CleanCallExpression*>(expr));
+
+        case CleanExpressionType::TernaryIf: {
+            CleanTernaryIfExpression* ternif_expr = static_cast<CleanTernaryIfExpression*>(expr);
+            return "(" + expression(ternif_expr->condition.get()) + " ? " +
+                expression(ternif_expr->then_branch.get()) + " : " +
+                expression(ternif_expr->else_branch.get()) + ")";
+        }
+
+        case CleanExpressionType::Assignment: {
+            CleanAssignmentExpression* assign_expr = static_cast<CleanAssignmentExpression*>(expr);
+            return expression(assign_expr->lvalue.get()) + " = " +
+                expression(assign_expr->rvalue.get());
+        }
+
+        case CleanExpressionType::Operation:
+            return operation(static_cast<CleanOperationExpression*>(expr));
+
+        default:
+            throw std::runtime_error(
+                "C emission failed: unknow expression type."
+            );
+    }
+}
+
+std::string
+CEmitter::call(CleanCallExpression* call_expr)
+{
+    if (call_expr->fun_def->is_intrinsic)
+        return intrinsicCall(call_expr);
+
+    std::vector<std::string> types;
+    for (auto& param: call_expr->fun_def->parameters)
+        types.push_back(cType(param->type.get()));
+    std::string sequence;
+    std::vector<std::string> arguments = sequenced(call_expr->arguments, types, sequence);
+
+    std::string code = functionName(names.at(call_expr->fun_def)) + "(";
+    for (std::size_t i = 0; i < arguments.size(); ++i) {
+        if (i)
+            code += ", ";
+        code += arguments[i];
+    }
+    code += ")";
+    return sequence.empty() ? code : "(" + sequence + code + ")";
+}
+
+// Stdio prints with printf, reslib operators left as calls are unary plus
+std::string
+CEmitter::intrinsicCall(CleanCallExpression* call_expr)
+{
+    std::string const& name = names.at(call_expr->fun_def);
+    std::size_t open = name.find('(');
+    std::string callee = name.substr(0, open);
+    std::string type = name.substr(open + 1, name.size() - open - 2);
+
+    if ((callee == "print" || callee == "println") && print_formats.count(type)) {
+        std::string argument = expression(call_expr->arguments[0].get());
+        if (type == "bool")
+            argument = "(" + argument + ") ? \"true\" : \"false\"";
+        return "printf(" + print_formats.at(type) +
+            (callee == "println" ? " \"\\n\", " : ", ") + argument + ")";
+    }
+
+    if (callee == "__pos__")
+        return "(+" + expression(call_expr->arguments[0].get()) + ")";
+
+    throw std::runtime_error(
+        "C emission failed: intrinsic `" + name + "` has no C equivalent."
+    );
+}
+
+std::string
+CEmitter::operation(CleanOperationExpression* op_expr)
+{
+    std::vector<std::string> types(
+        op_expr->operands.size(),
+        operandType(op_expr->operation)
+    );
+    std::string sequence;
+    std::vector<std::string> operands = sequenced(op_expr->operands, types, sequence);
+
+    auto helper = helpers.find(op_expr->operation);
+    if (helper != helpers.end()) {
+        std::string code = helper->second + "(" + operands[0];
+        if (operands.size() > 1)
+            code += ", " + operands[1];
+        code += ")";
+        return sequence.empty() ? code : "(" + sequence + code + ")";
+    }
+
+    auto unary = unary_operators.find(op_expr->operation);
+    if (unary != unary_operators.end())
+        return "(" + unary->second + operands[0] + ")";
+
+    return "(" + sequence + operands[0] + " " +
+        binary_operators.at(op_expr->operation) + " " + operands[1] + ")";
+}
+
+// Evaluate operands left to right into temporaries when one of them calls a function,
+// since a call may print or change a global the other operands read
+std::vector<std::string>
+CEmitter::sequenced(
+    std::vector<std::unique_ptr<CleanExpression>>& operands,
+    std::vector<std::string> const& types,
+    std::string& sequence
+)
+{
+    std::vector<std::string> codes;
+    bool calls = false;
+    for (auto& operand: operands) {
+        codes.push_back(expression(operand.get()));
+        calls = calls || hasCall(operand.get());
+    }
+    if (operands.size() < 2 || ! calls)
+        return codes;
+
+    for (std::size_t i = 0; i < codes.size(); ++i) {
+        std::string temporary = "tmp" + std::to_string(temporaries.size());
+        temporaries.push_back(types[i]);
+        sequence += temporary + " = " + codes[i] + ", ";
+        codes[i] = temporary;
+    }
+    return codes;
+}
+
+// Start a new line at the current indentation
+std::ostream&
+CEmitter::line()
+{
+    return out << std::string(4 * depth, ' ');
+}
+
+// The C type values of a Proto type are stored in
+static std::string
+cType(CleanTypeDeclaration* type_decl)
+{
+    if (type_decl == nullptr)
+        return "void";
+
+    std::string const& name = static_cast<CleanSimpleTypeDeclaration*>(type_decl)->name;
+    if (name == "bool")
+        return "bool";
+    if (name == "int")
+        return "int64_t";
+    if (name == "uint")
+        return "uint64_t";
+    if (name == "float")
+        return "double";
+    if (name == "string")
+        return "const char*";
+    if (name == "void")
+        return "void";
+
+    throw std::runtime_error(
+        "C emission failed: type `" + name + "` has no C equivalent."
+    );
+}
+
+// The C type of the operands of an operation, operations are grouped by type
+static std::string
+operandType(enum Operation operation)
+{
+    if (operation <= Operation::LeI64)
+        return "int64_t";
+    if (operation <= Operation::LeU64)
+        return "uint64_t";
+    if (operation <= Operation::LeF64)
+        return "double";
+    return "bool";
+}
+
+// Whether evaluating the expression calls a function
+static bool
+hasCall(CleanExpression* expr)
+{
+    switch (expr->type) {
+        case CleanExpressionType::Call:
+            return true;
+
+        case CleanExpressionType::Group:
+            return hasCall(static_cast<CleanGroupExpression*>(expr)->expression.get());
+
+        case CleanExpressionType::TernaryIf: {
+            CleanTernaryIfExpression* ternif_expr = static_cast<CleanTernaryIfExpression*>(expr);
+            return hasCall(ternif_expr->condition.get()) ||
+                hasCall(ternif_expr->then_branch.get()) ||
+                hasCall(ternif_expr->else_branch.get());
+        }
+
+        case CleanExpressionType::Assignment:
+            return hasCall(static_cast<CleanAssignmentExpression*>(expr)->rvalue.get());
+
+        case CleanExpressionType::Operation:
+            for (auto& operand: static_cast<CleanOperationExpression*>(expr)->operands) {
+                if (hasCall(operand.get()))
+                    return true;
+            }
+            return false;
+
+        default:
+            return false;
+    }
+}
+
+// Overloads get different names by spelling out their parameter types
+static std::string
+functionName(std::string const& name)
+{
+    std::string c_name = "proto_";
+    for (char c: name) {
+        if (c == '(')
+            c_name += "__";
+        else if (c == ',')
+            c_name += "_";
+        else if (std::isalnum(static_cast<unsigned char>(c)) || c == '_')
+            c_name += c;
+    }
+    return c_name;
+}
+
+// Variables of sibling scopes may share a name but not a slot while alive,
+// names the inliner gave its copies are not C identifiers as they are
+static std::string
+localName(std::string const& name, std::size_t slot)
+{
+    std::string c_name;
+    for (char c: name)
+        c_name += std::isalnum(static_cast<unsigned char>(c)) ? c : '_';
+    return c_name + "_" + std::to_string(slot);
+}
+
+static std::string
+globalName(std::string const& name)
+{
+    return "global_" + name;
+}
+
+// Doubles print with enough digits to be read back exactly
+static std::string
+floatLiteral(double value)
+{
+    if (std::isnan(value))
+        return "NAN";
+    if (std::isinf(value))
+        return value < 0 ? "(-INFINITY)" : "INFINITY";
+
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.17g", value);
+    std::string literal(buffer);
+    if (literal.find_first_of(".e") == std::string::npos)
+        literal += ".0";
+    return value < 0 ? "(" + literal + ")" : literal;
+}
+
+// Quotes and backslashes are escaped, other unprintable characters use octal
+static std::string
+stringLiteral(std::string const& value)
+{
+    std::string literal = "\"";
+    for (char c: value) {
+        unsigned char byte = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\') {
+            literal += '\\';
+            literal += c;
+        }
+        else if (c == '\n') {
+            literal += "\\n";
+        }
+        else if (c == '\t') {
+            literal += "\\t";
+        }
+        else if (byte < 0x20 || byte >= 0x7F) {
+            char buffer[8];
+            std::snprintf(buffer, sizeof(buffer), "\\%03o", byte);
+            literal += buffer;
+        }
+        else {
+            literal += c;
+        }
+    }
+    return literal + "\"";
+}
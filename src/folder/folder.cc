@@ -0,0 +1,473 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdexcept>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <string>
+#include <map>
+
+#include "cleaner/ast/expressions/expression.h"
+#include "cleaner/ast/declarations/variable.h"
+#include "cleaner/ast/definitions/function.h"
+#include "cleaner/ast/definitions/variable.h"
+#include "cleaner/ast/statements/statement.h"
+#include "cleaner/ast/declarations/type.h"
+#include "cleaner/ast/statements/return.h"
+#include "cleaner/ast/statements/while.h"
+#include "cleaner/ast/statements/block.h"
+#include "cleaner/ast/statements/for.h"
+#include "cleaner/ast/statements/if.h"
+#include "cleaner/symbols/scope.h"
+#include "common/operation.h"
+#include "folder/folder.h"
+#include "common/native.h"
+#include "common/value.h"
+
+
+/* Casts between primitive types, which have no intrinsic to call. */
+static std::map<std::string, Value (*)(Value)> const casts = {
+    {"__cast@int__(uint)",      [](Value v) { return Value((int64_t) v.as_uint); }},
+    {"__cast@float__(uint)",    [](Value v) { return Value((double) v.as_uint); }},
+    {"__cast@bool__(uint)",     [](Value v) { return Value(v.as_uint != 0); }},
+    {"__cast@uint__(int)",      [](Value v) { return Value((uint64_t) v.as_int); }},
+    {"__cast@float__(int)",     [](Value v) { return Value((double) v.as_int); }},
+    {"__cast@bool__(int)",      [](Value v) { return Value(v.as_int != 0); }},
+    {"__cast@uint__(float)",    [](Value v) { return Value((uint64_t) v.as_float); }},
+    {"__cast@int__(float)",     [](Value v) { return Value((int64_t) v.as_float); }}
+};
+
+static bool isLiteral(CleanExpression* expr);
+static Value literalValue(CleanExpression* expr);
+static std::unique_ptr<CleanExpression> makeLiteral(Value value);
+static bool divisionTraps(std::string const& fun_name, Value dividend, Value divisor);
+static bool castOverflows(std::string const& fun_name, Value value);
+
+Folder::Folder(
+    CleanScope* scope
+) : scope(scope),
+    fun_def(nullptr)
+{}
+
+/**
+ * Evaluates the expressions whose operands are all literals
+ * and replaces them by the literal they evaluate to.
+ *
+ * Uses of const variables initialized with a literal
+ * are replaced by that literal.
+ *
+ * Intrinsics must be loaded in the global scope first.
+ * Division by a literal zero or of the smallest int by -1
+ * is left for the program to fail on, as are casts of floats the integer type cannot represent.
+ */
+void
+Folder::fold()
+{
+    for (auto& [name, var_def]: scope->getSymbols<CleanVariableDefinition>())
+        foldInitializer(var_def.get(), scope);
+
+    for (auto& [name, fun_def]: scope->getSymbols<CleanFunctionDefinition>()) {
+        if (! fun_def->is_intrinsic)
+            foldFunction(fun_def.get());
+    }
+}
+
+// Function definitions
+void
+Folder::foldFunction(
+    CleanFunctionDefinition* fun_def
+)
+{
+    this->fun_def = fun_def;
+    foldBlock(fun_def->body.get());
+    this->fun_def = nullptr;
+}
+
+// Statements
+void
+Folder::foldStatement(
+    std::unique_ptr<CleanStatement>& stmt,
+    CleanScope* scope
+)
+{
+    switch (stmt->type) {
+        case CleanStatementType::Block: {
+            foldBlock(static_cast<CleanBlockStatement*>(stmt.get()));
+            break;
+        }
+
+        case CleanStatementType::If: {
+            CleanIfStatement* if_stmt = static_cast<CleanIfStatement*>(stmt.get());
+            foldExpression(if_stmt->condition, scope);
+            foldBlock(if_stmt->body.get());
+            for (auto& elif_branch: if_stmt->elif_branches) {
+                foldExpression(elif_branch->condition, scope);
+                foldBlock(elif_branch->body.get());
+            }
+            if (if_stmt->else_branch)
+                foldBlock(if_stmt->else_branch->body.get());
+            break;
+        }
+
+        case CleanStatementType::For: {
+            CleanForStatement* for_stmt = static_cast<CleanForStatement*>(stmt.get());
+            if (for_stmt->init_clause)
+                foldExpression(for_stmt->init_clause, for_stmt->scope.get());
+            if (for_stmt->term_clause)
+                foldExpression(for_stmt->term_clause, for_stmt->scope.get());
+            if (for_stmt->incr_clause)
+                foldExpression(for_stmt->incr_clause, for_stmt->scope.get());
+            foldBlock(for_stmt->body.get());
+            break;
+        }
+
+        case CleanStatementType::While: {
+            CleanWhileStatement* while_stmt =
+                static_cast<CleanWhileStatement*>(stmt.get());
+            if (while_stmt->condition)
+                foldExpression(while_stmt->condition, scope);
+            foldBlock(while_stmt->body.get());
+            break;
+        }
+
+        case CleanStatementType::Break:
+        case CleanStatementType::Continue:
+            break;
+
+        case CleanStatementType::Return: {
+            CleanReturnStatement* ret_stmt =
+                static_cast<CleanReturnStatement*>(stmt.get());
+            if (ret_stmt->expression)
+                foldExpression(ret_stmt->expression, scope);
+            break;
+        }
+
+        case CleanStatementType::Expression: {
+            // The statement itself may be replaced
+            std::unique_ptr<CleanExpression> expr(
+                static_cast<CleanExpression*>(stmt.release())
+            );
+            foldExpression(expr, scope);
+            stmt = std::move(expr);
+            break;
+        }
+
+        default:
+            throw std::runtime_error(
+                "Constant folding failed: unknow statement type."
+            );
+    }
+}
+
+// Blocks
+void
+Folder::foldBlock(CleanBlockStatement* block_stmt)
+{
+    for (auto& statement: block_stmt->statements)
+        foldStatement(statement, block_stmt->scope.get());
+}
+
+// Expressions
+void
+Folder::foldExpression(
+    std::unique_ptr<CleanExpression>& expr,
+    CleanScope* scope
+)
+{
+    switch (expr->type) {
+        case CleanExpressionType::Variable: {
+            foldVariable(expr, scope);
+            break;
+        }
+
+        case CleanExpressionType::Group: {
+            CleanGroupExpression* gr_expr =
+                static_cast<CleanGroupExpression*>(expr.get());
+            foldExpression(gr_expr->expression, scope);
+            if (isLiteral(gr_expr->expression.get()))
+                expr = std::move(gr_expr->expression);
+            break;
+        }
+
+        case CleanExpressionType::Call: {
+            foldCall(expr, scope);
+            break;
+        }
+
+        case CleanExpressionType::Operation: {
+            foldOperation(expr, scope);
+            break;
+        }
+
+        case CleanExpressionType::TernaryIf: {
+            CleanTernaryIfExpression* ternif_expr =
+                static_cast<CleanTernaryIfExpression*>(expr.get());
+            foldExpression(ternif_expr->condition, scope);
+            foldExpression(ternif_expr->then_branch, scope);
+            foldExpression(ternif_expr->else_branch, scope);
+
+            // Only the branch taken remains
+            if (ternif_expr->condition->type == CleanExpressionType::Boolean) {
+                if (static_cast<CleanBoolExpression*>(ternif_expr->condition.get())->value)
+                    expr = std::move(ternif_expr->then_branch);
+                else
+                    expr = std::move(ternif_expr->else_branch);
+            }
+            break;
+        }
+
+        case CleanExpressionType::Assignment: {
+            // The variable assigned to must stay a variable
+            foldExpression(
+                static_cast<CleanAssignmentExpression*>(expr.get())->rvalue,
+                scope
+            );
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+// Variables
+void
+Folder::foldVariable(
+    std::unique_ptr<CleanExpression>& expr,
+    CleanScope* scope
+)
+{
+    CleanVariableExpression* var_expr =
+        static_cast<CleanVariableExpression*>(expr.get());
+
+    for (CleanScope* current = scope; current; current = current->parent.get()) {
+        // Parameters are never constant
+        if (fun_def && current == fun_def->scope.get()) {
+            for (auto& param: fun_def->parameters) {
+                if (param->name == var_expr->var_name)
+                    return;
+            }
+        }
+
+        if (current->hasSymbol<CleanVariableDefinition>(var_expr->var_name)) {
+            CleanVariableDefinition* var_def = foldInitializer(
+                current->getSymbol<CleanVariableDefinition>(var_expr->var_name).get(),
+                current
+            );
+
+            CleanSimpleTypeDeclaration* type_decl =
+                static_cast<CleanSimpleTypeDeclaration*>(var_def->type.get());
+            if (type_decl->is_const && isLiteral(var_def->initializer.get()))
+                expr = copy(var_def->initializer.get());
+            return;
+        }
+    }
+}
+
+// Fold the initializer of a variable the first time the variable is met
+CleanVariableDefinition*
+Folder::foldInitializer(
+    CleanVariableDefinition* var_def,
+    CleanScope* scope
+)
+{
+    if (var_def->initializer && folded.insert(var_def).second)
+        foldExpression(var_def->initializer, scope);
+
+    return var_def;
+}
+
+// Calls
+void
+Folder::foldCall(
+    std::unique_ptr<CleanExpression>& expr,
+    CleanScope* scope
+)
+{
+    CleanCallExpression* call_expr = static_cast<CleanCallExpression*>(expr.get());
+    std::vector<Value> arguments;
+    for (auto& argument: call_expr->arguments) {
+        foldExpression(argument, scope);
+        if (isLiteral(argument.get()))
+            arguments.push_back(literalValue(argument.get()));
+    }
+
+    if (arguments.size() != call_expr->arguments.size())
+        return;
+
+    auto it = casts.find(call_expr->fun_name);
+    if (it != casts.end()) {
+        if (! castOverflows(call_expr->fun_name, arguments[0]))
+            expr = makeLiteral(it->second(arguments[0]));
+        return;
+    }
+
+    // Only intrinsics without side effects can run ahead of time
+    if (! this->scope->hasSymbol<CleanFunctionDefinition>(call_expr->fun_name))
+        return;
+
+    std::unique_ptr<CleanFunctionDefinition>& callee =
+        this->scope->getSymbol<CleanFunctionDefinition>(call_expr->fun_name);
+    if (! callee->is_intrinsic || ! callee->is_pure)
+        return;
+
+    if (arguments.size() == 2 && divisionTraps(call_expr->fun_name, arguments[0], arguments[1]))
+        return;
+
+    CleanReturnStatement* ret_stmt = static_cast<CleanReturnStatement*>(
+        callee->body->statements.front().get()
+    );
+    CleanIntrinsicExpression* intrinsic_expr =
+        static_cast<CleanIntrinsicExpression*>(ret_stmt->expression.get());
+    Value result = intrinsic_expr->callable(
+        NativeArguments(arguments.data(), arguments.size())
+    );
+    if (result.type != ValueType::Void && result.type != ValueType::String)
+        expr = makeLiteral(result);
+}
+
+// Operations
+void
+Folder::foldOperation(
+    std::unique_ptr<CleanExpression>& expr,
+    CleanScope* scope
+)
+{
+    CleanOperationExpression* op_expr =
+        static_cast<CleanOperationExpression*>(expr.get());
+    bool constant = true;
+    for (auto& operand: op_expr->operands) {
+        foldExpression(operand, scope);
+        constant = constant && isLiteral(operand.get());
+    }
+
+    if (! constant)
+        return;
+
+    Value left = literalValue(op_expr->operands[0].get());
+    Value right = op_expr->operands.size() > 1 ?
+        literalValue(op_expr->operands[1].get()) : Value();
+
+    switch (op_expr->operation) {
+        case Operation::DivI64:
+        case Operation::RemI64:
+            // The smallest int over -1 overflows and traps like a zero divisor
+            if (right.as_int == 0 || (left.as_int == INT64_MIN && right.as_int == -1))
+                return;
+            break;
+
+        case Operation::DivU64:
+        case Operation::RemU64:
+            if (right.as_uint == 0)
+                return;
+            break;
+
+        default:
+            break;
+    }
+
+    expr = makeLiteral(applyOperation(op_expr->operation, left, right));
+}
+
+// Whether the expression is a literal of a primitive type other than string
+static bool
+isLiteral(CleanExpression* expr)
+{
+    switch (expr->type) {
+        case CleanExpressionType::Boolean:
+        case CleanExpressionType::SignedInt:
+        case CleanExpressionType::UnsignedInt:
+        case CleanExpressionType::Float:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+// The value of a literal
+static Value
+literalValue(CleanExpression* expr)
+{
+    switch (expr->type) {
+        case CleanExpressionType::Boolean:
+            return Value(static_cast<CleanBoolExpression*>(expr)->value);
+
+        case CleanExpressionType::SignedInt:
+            return Value(static_cast<CleanSignedIntExpression*>(expr)->value);
+
+        case CleanExpressionType::UnsignedInt:
+            return Value(static_cast<CleanUnsignedIntExpression*>(expr)->value);
+
+        case CleanExpressionType::Float:
+            return Value(static_cast<CleanFloatExpression*>(expr)->value);
+
+        default:
+            throw std::runtime_error(
+                "Constant folding failed: expression is not a literal."
+            );
+    }
+}
+
+// The literal that has the given value
+static std::unique_ptr<CleanExpression>
+makeLiteral(Value value)
+{
+    switch (value.type) {
+        case ValueType::Boolean:
+            return std::make_unique<CleanBoolExpression>(value.as_bool);
+
+        case ValueType::SignedInt:
+            return std::make_unique<CleanSignedIntExpression>(value.as_int);
+
+        case ValueType::UnsignedInt:
+            return std::make_unique<CleanUnsignedIntExpression>(value.as_uint);
+
+        case ValueType::Float:
+            return std::make_unique<CleanFloatExpression>(value.as_float);
+
+        default:
+            throw std::runtime_error(
+                "Constant folding failed: value has no literal."
+            );
+    }
+}
+
+// Whether calling the given intrinsic would trap on a zero divisor or an overflowing quotient
+static bool
+divisionTraps(std::string const& fun_name, Value dividend, Value divisor)
+{
+    bool divides = fun_name.rfind("__div__", 0) == 0 ||
+        fun_name.rfind("__rem__", 0) == 0;
+    if (! divides || divisor.type == ValueType::Float)
+        return false;
+    if (divisor.type == ValueType::SignedInt && dividend.as_int == INT64_MIN && divisor.as_int == -1)
+        return true;
+    return divisor.as_uint == 0;
+}
+
+// Whether the given cast of a float is out of the integer type's range, NaN included
+static bool
+castOverflows(std::string const& fun_name, Value value)
+{
+    if (fun_name == "__cast@int__(float)")
+        return ! (value.as_float >= -9223372036854775808.0 && value.as_float < 9223372036854775808.0);
+    if (fun_name == "__cast@uint__(float)")
+        return ! (value.as_float > -1.0 && value.as_float < 18446744073709551616.0);
+    return false;
+}
@@ -0,0 +1,605 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdexcept>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <memory>
+#include <vector>
+#include <string>
+
+#include "cleaner/ast/expressions/expression.h"
+#include "cleaner/ast/definitions/function.h"
+#include "cleaner/ast/statements/statement.h"
+#include "cleaner/ast/statements/return.h"
+#include "cleaner/ast/statements/while.h"
+#include "cleaner/ast/statements/block.h"
+#include "cleaner/ast/statements/for.h"
+#include "cleaner/ast/statements/if.h"
+#include "cleaner/symbols/scope.h"
+#include "common/operation.h"
+#include "hoister/hoister.h"
+
+
+static bool isNonZero(CleanExpression* expr);
+static bool isLocal(CleanExpression* expr);
+static enum Operation mirrorTest(enum Operation test);
+
+Hoister::Hoister(
+    CleanScope* scope
+) : scope(scope),
+    fun_def(nullptr),
+    calls_impure(false)
+{}
+
+/**
+ * Moves the pure expressions that compute the same value at every
+ * iteration of a for or while loop into temporaries assigned right
+ * before the loop.
+ *
+ * An expression is moved when it reads no local variable the loop
+ * assigns, no global variable the loop may assign and only calls
+ * pure intrinsics, so that printing is never moved out of a loop.
+ * Integer divisions whose divisor may be zero are left in place
+ * since the loop may never get to run them.
+ *
+ * A for loop whose increment clause adds a constant to a local integer
+ * that its termination clause compares to a bound, and that nothing else
+ * assigns, is marked as counted so backends can keep the counter native.
+ */
+void
+Hoister::hoist()
+{
+    for (auto& [name, fun_def]: scope->getSymbols<CleanFunctionDefinition>()) {
+        if (fun_def->is_intrinsic)
+            continue;
+
+        this->fun_def = fun_def.get();
+        hoistBlock(fun_def->body.get());
+        this->fun_def = nullptr;
+    }
+}
+
+// Blocks
+void
+Hoister::hoistBlock(CleanBlockStatement* block_stmt)
+{
+    std::vector<std::unique_ptr<CleanStatement>>& statements =
+        block_stmt->statements;
+
+    for (std::size_t i = 0; i < statements.size(); ++i) {
+        CleanStatement* stmt = statements[i].get();
+        switch (stmt->type) {
+            case CleanStatementType::Block: {
+                hoistBlock(static_cast<CleanBlockStatement*>(stmt));
+                break;
+            }
+
+            case CleanStatementType::If: {
+                CleanIfStatement* if_stmt = static_cast<CleanIfStatement*>(stmt);
+                hoistBlock(if_stmt->body.get());
+                for (auto& elif_branch: if_stmt->elif_branches)
+                    hoistBlock(elif_branch->body.get());
+                if (if_stmt->else_branch)
+                    hoistBlock(if_stmt->else_branch->body.get());
+                break;
+            }
+
+            case CleanStatementType::For:
+            case CleanStatementType::While: {
+                // Inner loops first so what they hoist may leave the outer loop too
+                hoistBlock(stmt->type == CleanStatementType::For
+                    ? static_cast<CleanForStatement*>(stmt)->body.get()
+                    : static_cast<CleanWhileStatement*>(stmt)->body.get()
+                );
+
+                hoistLoop(stmt);
+                std::size_t count = hoisted.size();
+                statements.insert(
+                    statements.begin() + i,
+                    std::make_move_iterator(hoisted.begin()),
+                    std::make_move_iterator(hoisted.end())
+                );
+                hoisted.clear();
+                i += count;
+                break;
+            }
+
+            default:
+                break;
+        }
+    }
+}
+
+// Loops
+void
+Hoister::hoistLoop(CleanStatement* stmt)
+{
+    local_writes.clear();
+    global_writes.clear();
+    calls_impure = false;
+    findWrites(stmt);
+
+    if (stmt->type == CleanStatementType::For) {
+        // The initialization runs once already
+        CleanForStatement* for_stmt = static_cast<CleanForStatement*>(stmt);
+        if (for_stmt->term_clause)
+            hoistExpression(for_stmt->term_clause);
+        if (for_stmt->incr_clause)
+            hoistExpression(for_stmt->incr_clause);
+        hoistStatement(for_stmt->body.get());
+        findCounter(for_stmt);
+    }
+    else {
+        CleanWhileStatement* while_stmt = static_cast<CleanWhileStatement*>(stmt);
+        hoistExpression(while_stmt->condition);
+        hoistStatement(while_stmt->body.get());
+    }
+}
+
+// Counters
+void
+Hoister::findCounter(CleanForStatement* for_stmt)
+{
+    if (! for_stmt->term_clause || ! for_stmt->incr_clause)
+        return;
+
+    // The termination clause compares a local integer to a bound
+    if (for_stmt->term_clause->type != CleanExpressionType::Operation)
+        return;
+    CleanOperationExpression* test_expr =
+        static_cast<CleanOperationExpression*>(for_stmt->term_clause.get());
+    enum Operation test = test_expr->operation;
+    if (
+        test != Operation::LtI64 &&
+        test != Operation::LeI64 &&
+        test != Operation::GtI64 &&
+        test != Operation::GeI64 &&
+        test != Operation::NeI64
+    )
+        return;
+
+    CleanExpression* counter_expr = test_expr->operands[0].get();
+    CleanExpression* bound_expr = test_expr->operands[1].get();
+    if (! isLocal(counter_expr)) {
+        std::swap(counter_expr, bound_expr);
+        test = mirrorTest(test);
+    }
+    if (! isLocal(counter_expr))
+        return;
+    std::size_t slot = static_cast<CleanVariableExpression*>(counter_expr)->slot;
+
+    // The increment clause adds or subtracts a constant to the counter
+    if (for_stmt->incr_clause->type != CleanExpressionType::Assignment)
+        return;
+    CleanAssignmentExpression* assign_expr =
+        static_cast<CleanAssignmentExpression*>(for_stmt->incr_clause.get());
+    if (
+        ! isLocal(assign_expr->lvalue.get()) ||
+        static_cast<CleanVariableExpression*>(assign_expr->lvalue.get())->slot != slot ||
+        assign_expr->rvalue->type != CleanExpressionType::Operation
+    )
+        return;
+
+    CleanOperationExpression* step_expr =
+        static_cast<CleanOperationExpression*>(assign_expr->rvalue.get());
+    if (step_expr->operation != Operation::AddI64 && step_expr->operation != Operation::SubI64)
+        return;
+
+    CleanExpression* var_expr = step_expr->operands[0].get();
+    CleanExpression* lit_expr = step_expr->operands[1].get();
+    if (step_expr->operation == Operation::AddI64 && ! isLocal(var_expr))
+        std::swap(var_expr, lit_expr);
+    if (
+        ! isLocal(var_expr) ||
+        static_cast<CleanVariableExpression*>(var_expr)->slot != slot ||
+        lit_expr->type != CleanExpressionType::SignedInt
+    )
+        return;
+
+    int64_t step = static_cast<CleanSignedIntExpression*>(lit_expr)->value;
+    if (step_expr->operation == Operation::SubI64)
+        step = -step;
+    if (step == 0)
+        return;
+
+    // The counter writes make the bound variant if it reads the counter
+    bool is_bound_invariant = isInvariant(bound_expr);
+
+    // Only the increment clause may assign the counter
+    local_writes.clear();
+    global_writes.clear();
+    findWrites(for_stmt->body.get());
+    findExpressionWrites(for_stmt->term_clause.get());
+    if (local_writes.count(slot))
+        return;
+
+    for_stmt->is_counted = true;
+    for_stmt->counter_slot = slot;
+    for_stmt->counter_step = step;
+    for_stmt->counter_test = test;
+    for_stmt->counter_bound = bound_expr;
+    for_stmt->is_bound_invariant = is_bound_invariant;
+}
+
+void
+Hoister::hoistStatement(CleanStatement* stmt)
+{
+    switch (stmt->type) {
+        case CleanStatementType::Block: {
+            for (auto& statement: static_cast<CleanBlockStatement*>(stmt)->statements)
+                hoistStatement(statement.get());
+            break;
+        }
+
+        case CleanStatementType::If: {
+            CleanIfStatement* if_stmt = static_cast<CleanIfStatement*>(stmt);
+            hoistExpression(if_stmt->condition);
+            hoistStatement(if_stmt->body.get());
+            for (auto& elif_branch: if_stmt->elif_branches) {
+                hoistExpression(elif_branch->condition);
+                hoistStatement(elif_branch->body.get());
+            }
+            if (if_stmt->else_branch)
+                hoistStatement(if_stmt->else_branch->body.get());
+            break;
+        }
+
+        case CleanStatementType::For: {
+            CleanForStatement* for_stmt = static_cast<CleanForStatement*>(stmt);
+            if (for_stmt->init_clause)
+                hoistStatement(for_stmt->init_clause.get());
+            if (for_stmt->term_clause)
+                hoistExpression(for_stmt->term_clause);
+            if (for_stmt->incr_clause)
+                hoistExpression(for_stmt->incr_clause);
+            hoistStatement(for_stmt->body.get());
+            break;
+        }
+
+        case CleanStatementType::While: {
+            CleanWhileStatement* while_stmt = static_cast<CleanWhileStatement*>(stmt);
+            hoistExpression(while_stmt->condition);
+            hoistStatement(while_stmt->body.get());
+            break;
+        }
+
+        case CleanStatementType::Return: {
+            CleanReturnStatement* ret_stmt = static_cast<CleanReturnStatement*>(stmt);
+            if (ret_stmt->expression)
+                hoistExpression(ret_stmt->expression);
+            break;
+        }
+
+        case CleanStatementType::Expression: {
+            // The statement itself stays, only its operands may be hoisted
+            CleanExpression* expr = static_cast<CleanExpression*>(stmt);
+            if (expr->type == CleanExpressionType::Assignment)
+                hoistExpression(static_cast<CleanAssignmentExpression*>(expr)->rvalue);
+            else if (expr->type == CleanExpressionType::Call) {
+                for (auto& argument: static_cast<CleanCallExpression*>(expr)->arguments)
+                    hoistExpression(argument);
+            }
+            else if (expr->type == CleanExpressionType::Operation) {
+                for (auto& operand: static_cast<CleanOperationExpression*>(expr)->operands)
+                    hoistExpression(operand);
+            }
+            break;
+        }
+
+        case CleanStatementType::Break:
+        case CleanStatementType::Continue:
+            break;
+
+        default:
+            throw std::runtime_error(
+                "Loop invariant code motion failed: unknow statement type."
+            );
+    }
+}
+
+// Replace the largest invariant expressions by temporaries
+void
+Hoister::hoistExpression(std::unique_ptr<CleanExpression>& expr)
+{
+    switch (expr->type) {
+        case CleanExpressionType::Operation:
+        case CleanExpressionType::Call: {
+            if (isInvariant(expr.get())) {
+                if (expr->type == CleanExpressionType::Call)
+                    static_cast<CleanCallExpression*>(expr.get())->is_tail_call = false;
+
+                std::size_t slot = fun_def->frame_size++;
+                std::string name = "loop@" + std::to_string(slot);
+                std::unique_ptr<CleanVariableExpression> tmp_expr =
+                    std::make_unique<CleanVariableExpression>(name);
+                tmp_expr->slot = slot;
+
+                std::unique_ptr<CleanVariableExpression> lvalue =
+                    std::make_unique<CleanVariableExpression>(name);
+                lvalue->slot = slot;
+                hoisted.push_back(std::make_unique<CleanAssignmentExpression>(
+                    std::move(lvalue),
+                    std::move(expr)
+                ));
+
+                expr = std::move(tmp_expr);
+                return;
+            }
+
+            if (expr->type == CleanExpressionType::Call) {
+                for (auto& argument: static_cast<CleanCallExpression*>(expr.get())->arguments)
+                    hoistExpression(argument);
+            }
+            else {
+                for (auto& operand: static_cast<CleanOperationExpression*>(expr.get())->operands)
+                    hoistExpression(operand);
+            }
+            break;
+        }
+
+        case CleanExpressionType::Group: {
+            hoistExpression(static_cast<CleanGroupExpression*>(expr.get())->expression);
+            break;
+        }
+
+        case CleanExpressionType::TernaryIf: {
+            CleanTernaryIfExpression* ternif_expr =
+                static_cast<CleanTernaryIfExpression*>(expr.get());
+            hoistExpression(ternif_expr->condition);
+            hoistExpression(ternif_expr->then_branch);
+            hoistExpression(ternif_expr->else_branch);
+            break;
+        }
+
+        case CleanExpressionType::Assignment: {
+            hoistExpression(static_cast<CleanAssignmentExpression*>(expr.get())->rvalue);
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+// Writes
+void
+Hoister::findWrites(CleanStatement* stmt)
+{
+    switch (stmt->type) {
+        case CleanStatementType::Block: {
+            for (auto& statement: static_cast<CleanBlockStatement*>(stmt)->statements)
+                findWrites(statement.get());
+            break;
+        }
+
+        case CleanStatementType::If: {
+            CleanIfStatement* if_stmt = static_cast<CleanIfStatement*>(stmt);
+            findExpressionWrites(if_stmt->condition.get());
+            findWrites(if_stmt->body.get());
+            for (auto& elif_branch: if_stmt->elif_branches) {
+                findExpressionWrites(elif_branch->condition.get());
+                findWrites(elif_branch->body.get());
+            }
+            if (if_stmt->else_branch)
+                findWrites(if_stmt->else_branch->body.get());
+            break;
+        }
+
+        case CleanStatementType::For: {
+            CleanForStatement* for_stmt = static_cast<CleanForStatement*>(stmt);
+            if (for_stmt->init_clause)
+                findWrites(for_stmt->init_clause.get());
+            if (for_stmt->term_clause)
+                findExpressionWrites(for_stmt->term_clause.get());
+            if (for_stmt->incr_clause)
+                findExpressionWrites(for_stmt->incr_clause.get());
+            findWrites(for_stmt->body.get());
+            break;
+        }
+
+        case CleanStatementType::While: {
+            CleanWhileStatement* while_stmt = static_cast<CleanWhileStatement*>(stmt);
+            findExpressionWrites(while_stmt->condition.get());
+            findWrites(while_stmt->body.get());
+            break;
+        }
+
+        case CleanStatementType::Return: {
+            CleanReturnStatement* ret_stmt = static_cast<CleanReturnStatement*>(stmt);
+            if (ret_stmt->expression)
+                findExpressionWrites(ret_stmt->expression.get());
+            break;
+        }
+
+        case CleanStatementType::Expression: {
+            findExpressionWrites(static_cast<CleanExpression*>(stmt));
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+void
+Hoister::findExpressionWrites(CleanExpression* expr)
+{
+    switch (expr->type) {
+        case CleanExpressionType::Group: {
+            findExpressionWrites(static_cast<CleanGroupExpression*>(expr)->expression.get());
+            break;
+        }
+
+        case CleanExpressionType::Call: {
+            CleanCallExpression* call_expr = static_cast<CleanCallExpression*>(expr);
+            if (! call_expr->fun_def->is_intrinsic && ! call_expr->fun_def->is_pure)
+                calls_impure = true;
+            for (auto& argument: call_expr->arguments)
+                findExpressionWrites(argument.get());
+            break;
+        }
+
+        case CleanExpressionType::TernaryIf: {
+            CleanTernaryIfExpression* ternif_expr =
+                static_cast<CleanTernaryIfExpression*>(expr);
+            findExpressionWrites(ternif_expr->condition.get());
+            findExpressionWrites(ternif_expr->then_branch.get());
+            findExpressionWrites(ternif_expr->else_branch.get());
+            break;
+        }
+
+        case CleanExpressionType::Assignment: {
+            CleanAssignmentExpression* assign_expr =
+                static_cast<CleanAssignmentExpression*>(expr);
+            CleanVariableExpression* var_expr =
+                static_cast<CleanVariableExpression*>(assign_expr->lvalue.get());
+            if (var_expr->depth == 0)
+                local_writes.insert(var_expr->slot);
+            else
+                global_writes.insert(var_expr->slot);
+            findExpressionWrites(assign_expr->rvalue.get());
+            break;
+        }
+
+        case CleanExpressionType::Operation: {
+            for (auto& operand: static_cast<CleanOperationExpression*>(expr)->operands)
+                findExpressionWrites(operand.get());
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+// Invariants
+bool
+Hoister::isInvariant(CleanExpression* expr)
+{
+    switch (expr->type) {
+        case CleanExpressionType::Boolean:
+        case CleanExpressionType::SignedInt:
+        case CleanExpressionType::UnsignedInt:
+        case CleanExpressionType::Float:
+        case CleanExpressionType::String:
+            return true;
+
+        case CleanExpressionType::Variable: {
+            CleanVariableExpression* var_expr = static_cast<CleanVariableExpression*>(expr);
+            if (var_expr->depth == 0)
+                return local_writes.count(var_expr->slot) == 0;
+
+            // Impure functions may write any global
+            return ! calls_impure && global_writes.count(var_expr->slot) == 0;
+        }
+
+        case CleanExpressionType::Group:
+            return isInvariant(static_cast<CleanGroupExpression*>(expr)->expression.get());
+
+        case CleanExpressionType::Call: {
+            // User functions may not terminate on arguments the loop never passes them
+            CleanCallExpression* call_expr = static_cast<CleanCallExpression*>(expr);
+            if (! call_expr->fun_def->is_intrinsic || ! call_expr->fun_def->is_pure)
+                return false;
+
+            if (
+                (
+                    call_expr->fun_name.rfind("__div__", 0) == 0 ||
+                    call_expr->fun_name.rfind("__rem__", 0) == 0
+                ) &&
+                ! isNonZero(call_expr->arguments[1].get())
+            )
+                return false;
+
+            for (auto& argument: call_expr->arguments) {
+                if (! isInvariant(argument.get()))
+                    return false;
+            }
+            return true;
+        }
+
+        case CleanExpressionType::Operation: {
+            CleanOperationExpression* op_expr =
+                static_cast<CleanOperationExpression*>(expr);
+            switch (op_expr->operation) {
+                // Integer division aborts unless the divisor is known not to be zero
+                case Operation::DivI64:
+                case Operation::RemI64:
+                case Operation::DivU64:
+                case Operation::RemU64:
+                    if (! isNonZero(op_expr->operands[1].get()))
+                        return false;
+                    break;
+
+                default:
+                    break;
+            }
+
+            for (auto& operand: op_expr->operands) {
+                if (! isInvariant(operand.get()))
+                    return false;
+            }
+            return true;
+        }
+
+        default:
+            return false;
+    }
+}
+
+// Whether the expression is an integer literal other than zero
+static bool
+isNonZero(CleanExpression* expr)
+{
+    if (expr->type == CleanExpressionType::SignedInt)
+        return static_cast<CleanSignedIntExpression*>(expr)->value != 0;
+    if (expr->type == CleanExpressionType::UnsignedInt)
+        return static_cast<CleanUnsignedIntExpression*>(expr)->value != 0;
+    return false;
+}
+
+// Whether the expression reads a local variable
+static bool
+isLocal(CleanExpression* expr)
+{
+    return expr->type == CleanExpressionType::Variable &&
+        static_cast<CleanVariableExpression*>(expr)->depth == 0;
+}
+
+// The comparison that holds once its operands are swapped
+static enum Operation
+mirrorTest(enum Operation test)
+{
+    switch (test) {
+        case Operation::LtI64:
+            return Operation::GtI64;
+
+        case Operation::LeI64:
+            return Operation::GeI64;
+
+        case Operation::GtI64:
+            return Operation::LtI64;
+
+        case Operation::GeI64:
+            return Operation::LeI64;
+
+        default:
+            return test;
+    }
+}
@@ -160,8 +160,8 @@ Inference::inferVariableType()
 {
     VariableExpression* var_expr = static_cast<VariableExpression*>(expr);
 
-    bool decl_found = scope->hasVariableDeclaration(var_expr->getToken().getLexeme(), true);
-    bool def_found = scope->hasDefinition(var_expr->getToken().getLexeme(), true);
+    bool decl_found = scope->hasVariableDeclaration(var_expr->getToken().getLexemeView(), true);
+    bool def_found = scope->hasDefinition(var_expr->getToken().getLexemeView(), true);
     if (! decl_found && ! def_found) {
         throw InferenceError(
             var_expr->getToken(),
@@ -176,7 +176,7 @@ Inference::inferVariableType()
     // But also because we forbid parameters from being redefined inside a function.
     if (decl_found) {
         std::unique_ptr<VariableDeclaration>& decl = scope->getVariableDeclaration(
-            var_expr->getToken().getLexeme(),
+            var_expr->getToken().getLexemeView(),
             true
         );
 
@@ -186,7 +186,7 @@ Inference::inferVariableType()
     }
     else {
         std::unique_ptr<Definition>& def = scope->getDefinition(
-            var_expr->getToken().getLexeme(),
+            var_expr->getToken().getLexemeView(),
             true
         );
 
@@ -0,0 +1,656 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <functional>
+#include <stdexcept>
+#include <cstddef>
+#include <utility>
+#include <memory>
+#include <vector>
+#include <string>
+#include <set>
+#include <map>
+
+#include "cleaner/parsetree/statements/statement.h"
+#include "cleaner/ast/expressions/expression.h"
+#include "cleaner/ast/declarations/variable.h"
+#include "cleaner/ast/definitions/function.h"
+#include "cleaner/ast/definitions/variable.h"
+#include "cleaner/ast/statements/statement.h"
+#include "cleaner/ast/statements/continue.h"
+#include "cleaner/ast/declarations/type.h"
+#include "cleaner/ast/statements/return.h"
+#include "cleaner/ast/statements/while.h"
+#include "cleaner/ast/statements/block.h"
+#include "cleaner/ast/statements/break.h"
+#include "cleaner/ast/statements/for.h"
+#include "cleaner/ast/statements/if.h"
+#include "cleaner/symbols/scope.h"
+#include "inliner/inliner.h"
+
+
+static void visit(
+    CleanStatement* stmt,
+    std::function<void(CleanStatement*)> const& visitor
+);
+static std::size_t sizeOf(CleanStatement* stmt);
+static std::unique_ptr<CleanTypeDeclaration> copyType(CleanTypeDeclaration* type_decl);
+
+Inliner::Inliner(
+    CleanScope* scope,
+    std::size_t threshold
+) : scope(scope),
+    threshold(threshold),
+    sites(0),
+    caller(nullptr)
+{}
+
+/**
+ * Replaces calls to small non-recursive functions
+ * by the body of the function called.
+ *
+ * Only calls that make up a whole statement are inlined: a call on its own,
+ * the value assigned to a variable, or the value returned. The function called
+ * must not exceed the size threshold, must not reach itself through the calls
+ * it makes, and must only return at the end of its body.
+ *
+ * Parameters and locals of the inlined function are renamed
+ * so they cannot clash with the variables of the caller.
+ */
+void
+Inliner::inlineCalls()
+{
+    for (auto& [name, fun_def]: scope->getSymbols<CleanFunctionDefinition>()) {
+        if (fun_def->is_intrinsic)
+            continue;
+
+        std::set<std::string>& names = callees[name];
+        visit(fun_def->body.get(), [&names](CleanStatement* stmt) {
+            if (
+                stmt->type == CleanStatementType::Expression &&
+                static_cast<CleanExpression*>(stmt)->type == CleanExpressionType::Call
+            )
+                names.insert(static_cast<CleanCallExpression*>(stmt)->fun_name);
+        });
+    }
+
+    for (auto& [name, fun_def]: scope->getSymbols<CleanFunctionDefinition>()) {
+        if (! fun_def->is_intrinsic)
+            inlineFunction(fun_def.get());
+    }
+}
+
+/**
+ * Returns one line per call that was inlined.
+ */
+std::vector<std::string> const&
+Inliner::getReport() const
+{
+    return report;
+}
+
+// Function definitions
+void
+Inliner::inlineFunction(
+    CleanFunctionDefinition* fun_def
+)
+{
+    if (! done.insert(fun_def).second)
+        return;
+
+    // Callees are expanded first so what gets inlined is already inlined into
+    for (auto& callee_name: callees[fun_def->name]) {
+        if (scope->hasSymbol<CleanFunctionDefinition>(callee_name))
+            inlineFunction(scope->getSymbol<CleanFunctionDefinition>(callee_name).get());
+    }
+
+    caller = fun_def;
+    inlineBlock(fun_def->body.get());
+    caller = nullptr;
+}
+
+bool
+Inliner::isInlinable(
+    CleanFunctionDefinition* fun_def
+)
+{
+    if (fun_def->is_intrinsic || fun_def == caller || isRecursive(fun_def->name))
+        return false;
+
+    if (sizeOf(fun_def->body.get()) > threshold)
+        return false;
+
+    // The value returned replaces the call so there can be no early return
+    std::size_t returns = 0;
+    visit(fun_def->body.get(), [&returns](CleanStatement* stmt) {
+        if (stmt->type == CleanStatementType::Return)
+            returns++;
+    });
+
+    std::vector<std::unique_ptr<CleanStatement>>& statements =
+        fun_def->body->statements;
+    return returns == 0 || (
+        returns == 1 &&
+        statements.back()->type == CleanStatementType::Return
+    );
+}
+
+bool
+Inliner::isRecursive(
+    std::string const& fun_name
+)
+{
+    std::set<std::string> visited;
+    std::vector<std::string> pending(
+        callees[fun_name].begin(), callees[fun_name].end()
+    );
+
+    while (pending.size()) {
+        std::string name = pending.back();
+        pending.pop_back();
+        if (name == fun_name)
+            return true;
+
+        if (! visited.insert(name).second || ! callees.count(name))
+            continue;
+        pending.insert(pending.end(), callees[name].begin(), callees[name].end());
+    }
+
+    return false;
+}
+
+// Statements
+void
+Inliner::inlineBlock(CleanBlockStatement* block_stmt)
+{
+    for (auto& statement: block_stmt->statements)
+        inlineStatement(statement, block_stmt->scope);
+}
+
+void
+Inliner::inlineStatement(
+    std::unique_ptr<CleanStatement>& stmt,
+    std::shared_ptr<CleanScope> const& scope
+)
+{
+    std::unique_ptr<CleanStatement> inlined = nullptr;
+
+    switch (stmt->type) {
+        case CleanStatementType::Block: {
+            inlineBlock(static_cast<CleanBlockStatement*>(stmt.get()));
+            break;
+        }
+
+        case CleanStatementType::If: {
+            CleanIfStatement* if_stmt = static_cast<CleanIfStatement*>(stmt.get());
+            inlineBlock(if_stmt->body.get());
+            for (auto& elif_branch: if_stmt->elif_branches)
+                inlineBlock(elif_branch->body.get());
+            if (if_stmt->else_branch)
+                inlineBlock(if_stmt->else_branch->body.get());
+            break;
+        }
+
+        case CleanStatementType::For: {
+            inlineBlock(static_cast<CleanForStatement*>(stmt.get())->body.get());
+            break;
+        }
+
+        case CleanStatementType::While: {
+            inlineBlock(static_cast<CleanWhileStatement*>(stmt.get())->body.get());
+            break;
+        }
+
+        case CleanStatementType::Break:
+        case CleanStatementType::Continue:
+            break;
+
+        case CleanStatementType::Return: {
+            CleanReturnStatement* ret_stmt =
+                static_cast<CleanReturnStatement*>(stmt.get());
+            if (ret_stmt->expression && ret_stmt->expression->type == CleanExpressionType::Call)
+                inlined = expand(
+                    static_cast<CleanCallExpression*>(ret_stmt->expression.get()),
+                    stmt.get(),
+                    scope
+                );
+            break;
+        }
+
+        case CleanStatementType::Expression: {
+            CleanExpression* expr = static_cast<CleanExpression*>(stmt.get());
+            if (expr->type == CleanExpressionType::Call) {
+                inlined = expand(
+                    static_cast<CleanCallExpression*>(expr), stmt.get(), scope
+                );
+            }
+            else if (expr->type == CleanExpressionType::Assignment) {
+                CleanAssignmentExpression* assign_expr =
+                    static_cast<CleanAssignmentExpression*>(expr);
+                if (assign_expr->rvalue->type == CleanExpressionType::Call)
+                    inlined = expand(
+                        static_cast<CleanCallExpression*>(assign_expr->rvalue.get()),
+                        stmt.get(),
+                        scope
+                    );
+            }
+            break;
+        }
+
+        default:
+            throw std::runtime_error(
+                "Function inlining failed: unknow statement type."
+            );
+    }
+
+    if (inlined)
+        stmt = std::move(inlined);
+}
+
+// Build the block that replaces the statement making the given call
+std::unique_ptr<CleanStatement>
+Inliner::expand(
+    CleanCallExpression* call_expr,
+    CleanStatement* stmt,
+    std::shared_ptr<CleanScope> const& scope
+)
+{
+    if (! this->scope->hasSymbol<CleanFunctionDefinition>(call_expr->fun_name))
+        return nullptr;
+
+    CleanFunctionDefinition* callee =
+        this->scope->getSymbol<CleanFunctionDefinition>(call_expr->fun_name).get();
+    if (! isInlinable(callee))
+        return nullptr;
+
+    // Parameters become locals of the block that replaces the call
+    sites++;
+    free_names.clear();
+    renames.emplace_back();
+    for (auto& param: callee->parameters)
+        renames.back()[param->name] = renamed(param->name);
+
+    std::shared_ptr<CleanScope> inline_scope = std::make_shared<CleanScope>(scope);
+    std::unique_ptr<CleanBlockStatement> body =
+        cloneBlock(callee->body.get(), inline_scope);
+    renames.pop_back();
+
+    // Globals the callee uses must not be hidden by variables of the caller
+    for (auto& name: free_names) {
+        if (isShadowed(name, scope.get()))
+            return nullptr;
+    }
+
+    std::unique_ptr<CleanBlockStatement> inline_block =
+        std::make_unique<CleanBlockStatement>(inline_scope);
+    for (std::size_t i = 0; i < callee->parameters.size(); ++i) {
+        std::unique_ptr<CleanVariableDeclaration>& param = callee->parameters[i];
+        std::string name = renamed(param->name);
+        inline_scope->addSymbol<CleanVariableDefinition>(
+            name,
+            std::make_unique<CleanVariableDefinition>(
+                name,
+                copyType(param->type.get()),
+                copy(call_expr->arguments[i].get())
+            )
+        );
+        std::unique_ptr<CleanAssignmentExpression> assign_expr =
+            std::make_unique<CleanAssignmentExpression>(
+                std::make_unique<CleanVariableExpression>(name),
+                std::move(call_expr->arguments[i])
+            );
+        assign_expr->is_initializer = true;
+        inline_block->statements.push_back(std::move(assign_expr));
+    }
+
+    // The value returned goes where the call was
+    std::unique_ptr<CleanExpression> value = nullptr;
+    if (body->statements.size() && body->statements.back()->type == CleanStatementType::Return) {
+        value = std::move(
+            static_cast<CleanReturnStatement*>(body->statements.back().get())->expression
+        );
+        body->statements.pop_back();
+    }
+
+    if (stmt->type == CleanStatementType::Return) {
+        if (value)
+            StatementCleaner().markTailCalls(value.get());
+        body->statements.push_back(
+            std::make_unique<CleanReturnStatement>(std::move(value))
+        );
+    }
+    else if (static_cast<CleanExpression*>(stmt)->type == CleanExpressionType::Assignment) {
+        body->statements.push_back(
+            std::make_unique<CleanAssignmentExpression>(
+                std::move(static_cast<CleanAssignmentExpression*>(stmt)->lvalue),
+                std::move(value)
+            )
+        );
+    }
+    else if (value) {
+        body->statements.push_back(std::move(value));
+    }
+
+    inline_block->statements.push_back(std::move(body));
+    inline_block->token = stmt->token;
+
+    report.push_back(
+        caller->name + ": inlined " + callee->name +
+        " (size " + std::to_string(sizeOf(callee->body.get())) + ")"
+    );
+    return inline_block;
+}
+
+// Whether a global is hidden by a variable visible from the given scope
+bool
+Inliner::isShadowed(
+    std::string const& name,
+    CleanScope* scope
+)
+{
+    for (CleanScope* current = scope; current; current = current->parent.get()) {
+        if (current == caller->scope.get()) {
+            for (auto& param: caller->parameters) {
+                if (param->name == name)
+                    return true;
+            }
+        }
+
+        if (current->hasSymbol<CleanVariableDefinition>(name))
+            return current->parent != nullptr;
+    }
+
+    return false;
+}
+
+// Copies with the locals renamed
+std::unique_ptr<CleanBlockStatement>
+Inliner::cloneBlock(
+    CleanBlockStatement* block_stmt,
+    std::shared_ptr<CleanScope> const& scope
+)
+{
+    std::shared_ptr<CleanScope> block_scope = std::make_shared<CleanScope>(scope);
+    std::unique_ptr<CleanBlockStatement> block_clone =
+        std::make_unique<CleanBlockStatement>(block_scope);
+
+    cloneSymbols(block_stmt->scope.get(), block_scope.get());
+    for (auto& statement: block_stmt->statements)
+        block_clone->statements.push_back(cloneStatement(statement.get(), block_scope));
+    renames.pop_back();
+
+    return block_clone;
+}
+
+// Add the renamed variables of a scope to its clone
+void
+Inliner::cloneSymbols(
+    CleanScope* scope,
+    CleanScope* clone_scope
+)
+{
+    renames.emplace_back();
+    for (auto& [name, var_def]: scope->getSymbols<CleanVariableDefinition>())
+        renames.back()[name] = renamed(name);
+
+    for (auto& [name, var_def]: scope->getSymbols<CleanVariableDefinition>()) {
+        std::string clone_name = renames.back()[name];
+        clone_scope->addSymbol<CleanVariableDefinition>(
+            clone_name,
+            std::make_unique<CleanVariableDefinition>(
+                clone_name,
+                copyType(var_def->type.get()),
+                var_def->initializer ? cloneExpression(var_def->initializer.get()) : nullptr
+            )
+        );
+    }
+}
+
+std::unique_ptr<CleanStatement>
+Inliner::cloneStatement(
+    CleanStatement* stmt,
+    std::shared_ptr<CleanScope> const& scope
+)
+{
+    switch (stmt->type) {
+        case CleanStatementType::Block:
+            return cloneBlock(static_cast<CleanBlockStatement*>(stmt), scope);
+
+        case CleanStatementType::If: {
+            CleanIfStatement* if_stmt = static_cast<CleanIfStatement*>(stmt);
+            std::unique_ptr<CleanIfStatement> if_clone = std::make_unique<CleanIfStatement>(
+                cloneExpression(if_stmt->condition.get()),
+                cloneBlock(if_stmt->body.get(), scope)
+            );
+            for (auto& elif_branch: if_stmt->elif_branches)
+                if_clone->elif_branches.push_back(std::make_unique<CleanElifBranch>(
+                    cloneExpression(elif_branch->condition.get()),
+                    cloneBlock(elif_branch->body.get(), scope)
+                ));
+            if (if_stmt->else_branch)
+                if_clone->else_branch = std::make_unique<CleanElseBranch>(
+                    cloneBlock(if_stmt->else_branch->body.get(), scope)
+                );
+            return if_clone;
+        }
+
+        case CleanStatementType::For: {
+            CleanForStatement* for_stmt = static_cast<CleanForStatement*>(stmt);
+            std::shared_ptr<CleanScope> for_scope = std::make_shared<CleanScope>(scope);
+            cloneSymbols(for_stmt->scope.get(), for_scope.get());
+            std::unique_ptr<CleanForStatement> for_clone = std::make_unique<CleanForStatement>(
+                for_stmt->init_clause ? cloneExpression(for_stmt->init_clause.get()) : nullptr,
+                for_stmt->term_clause ? cloneExpression(for_stmt->term_clause.get()) : nullptr,
+                for_stmt->incr_clause ? cloneExpression(for_stmt->incr_clause.get()) : nullptr,
+                cloneBlock(for_stmt->body.get(), for_scope),
+                for_scope
+            );
+            renames.pop_back();
+            return for_clone;
+        }
+
+        case CleanStatementType::While: {
+            CleanWhileStatement* while_stmt = static_cast<CleanWhileStatement*>(stmt);
+            return std::make_unique<CleanWhileStatement>(
+                while_stmt->condition ? cloneExpression(while_stmt->condition.get()) : nullptr,
+                cloneBlock(while_stmt->body.get(), scope)
+            );
+        }
+
+        case CleanStatementType::Break:
+            return std::make_unique<CleanBreakStatement>();
+
+        case CleanStatementType::Continue:
+            return std::make_unique<CleanContinueStatement>();
+
+        case CleanStatementType::Return: {
+            CleanReturnStatement* ret_stmt = static_cast<CleanReturnStatement*>(stmt);
+            return std::make_unique<CleanReturnStatement>(
+                ret_stmt->expression ? cloneExpression(ret_stmt->expression.get()) : nullptr
+            );
+        }
+
+        case CleanStatementType::Expression:
+            return cloneExpression(static_cast<CleanExpression*>(stmt));
+
+        default:
+            throw std::runtime_error(
+                "Function inlining failed: unknow statement type."
+            );
+    }
+}
+
+std::unique_ptr<CleanExpression>
+Inliner::cloneExpression(CleanExpression* expr)
+{
+    std::unique_ptr<CleanExpression> expr_clone = copy(expr);
+    rename(expr_clone.get());
+    return expr_clone;
+}
+
+// Give variables the name of the local they refer to in the clone
+void
+Inliner::rename(CleanExpression* expr)
+{
+    visit(expr, [this](CleanStatement* stmt) {
+        CleanExpression* expr = static_cast<CleanExpression*>(stmt);
+        if (expr->type != CleanExpressionType::Variable)
+            return;
+
+        CleanVariableExpression* var_expr = static_cast<CleanVariableExpression*>(expr);
+        for (auto it = renames.rbegin(); it != renames.rend(); ++it) {
+            auto name = it->find(var_expr->var_name);
+            if (name != it->end()) {
+                var_expr->var_name = name->second;
+                return;
+            }
+        }
+
+        free_names.insert(var_expr->var_name);
+    });
+}
+
+// The name a local of the callee takes at the current call site
+std::string
+Inliner::renamed(std::string const& name)
+{
+    // Identifiers cannot contain @ so the name is unique
+    return name + "@" + std::to_string(sites);
+}
+
+// Call the visitor on a statement and everything it contains
+static void
+visit(
+    CleanStatement* stmt,
+    std::function<void(CleanStatement*)> const& visitor
+)
+{
+    visitor(stmt);
+
+    switch (stmt->type) {
+        case CleanStatementType::Block: {
+            for (auto& statement: static_cast<CleanBlockStatement*>(stmt)->statements)
+                visit(statement.get(), visitor);
+            break;
+        }
+
+        case CleanStatementType::If: {
+            CleanIfStatement* if_stmt = static_cast<CleanIfStatement*>(stmt);
+            visit(if_stmt->condition.get(), visitor);
+            visit(if_stmt->body.get(), visitor);
+            for (auto& elif_branch: if_stmt->elif_branches) {
+                visit(elif_branch->condition.get(), visitor);
+                visit(elif_branch->body.get(), visitor);
+            }
+            if (if_stmt->else_branch)
+                visit(if_stmt->else_branch->body.get(), visitor);
+            break;
+        }
+
+        case CleanStatementType::For: {
+            CleanForStatement* for_stmt = static_cast<CleanForStatement*>(stmt);
+            if (for_stmt->init_clause)
+                visit(for_stmt->init_clause.get(), visitor);
+            if (for_stmt->term_clause)
+                visit(for_stmt->term_clause.get(), visitor);
+            if (for_stmt->incr_clause)
+                visit(for_stmt->incr_clause.get(), visitor);
+            visit(for_stmt->body.get(), visitor);
+            break;
+        }
+
+        case CleanStatementType::While: {
+            CleanWhileStatement* while_stmt = static_cast<CleanWhileStatement*>(stmt);
+            if (while_stmt->condition)
+                visit(while_stmt->condition.get(), visitor);
+            visit(while_stmt->body.get(), visitor);
+            break;
+        }
+
+        case CleanStatementType::Return: {
+            CleanReturnStatement* ret_stmt = static_cast<CleanReturnStatement*>(stmt);
+            if (ret_stmt->expression)
+                visit(ret_stmt->expression.get(), visitor);
+            break;
+        }
+
+        case CleanStatementType::Expression: {
+            CleanExpression* expr = static_cast<CleanExpression*>(stmt);
+            switch (expr->type) {
+                case CleanExpressionType::Group:
+                    visit(static_cast<CleanGroupExpression*>(expr)->expression.get(), visitor);
+                    break;
+
+                case CleanExpressionType::Call:
+                    for (auto& argument: static_cast<CleanCallExpression*>(expr)->arguments)
+                        visit(argument.get(), visitor);
+                    break;
+
+                case CleanExpressionType::TernaryIf: {
+                    CleanTernaryIfExpression* ternif_expr =
+                        static_cast<CleanTernaryIfExpression*>(expr);
+                    visit(ternif_expr->condition.get(), visitor);
+                    visit(ternif_expr->then_branch.get(), visitor);
+                    visit(ternif_expr->else_branch.get(), visitor);
+                    break;
+                }
+
+                case CleanExpressionType::Assignment: {
+                    CleanAssignmentExpression* assign_expr =
+                        static_cast<CleanAssignmentExpression*>(expr);
+                    visit(assign_expr->lvalue.get(), visitor);
+                    visit(assign_expr->rvalue.get(), visitor);
+                    break;
+                }
+
+                case CleanExpressionType::Operation:
+                    for (auto& operand: static_cast<CleanOperationExpression*>(expr)->operands)
+                        visit(operand.get(), visitor);
+                    break;
+
+                default:
+                    break;
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+// The number of statements and expressions a statement is made of
+static std::size_t
+sizeOf(CleanStatement* stmt)
+{
+    std::size_t size = 0;
+    visit(stmt, [&size](CleanStatement*) {
+        size++;
+    });
+    return size;
+}
+
+static std::unique_ptr<CleanTypeDeclaration>
+copyType(CleanTypeDeclaration* type_decl)
+{
+    CleanSimpleTypeDeclaration* simple_type =
+        static_cast<CleanSimpleTypeDeclaration*>(type_decl);
+    return std::make_unique<CleanSimpleTypeDeclaration>(
+        simple_type->is_const,
+        simple_type->name
+    );
+}
@@ -16,81 +16,78 @@
  */
 
 #include <cstddef>
-#include <utility>
 #include <memory>
 #include <vector>
-#include <string>
-#include <map>
 
 #include "interpreter/ast/definitions/function.h"
 #include "interpreter/ast/statements/statement.h"
 #include "cleaner/ast/expressions/expression.h"
 #include "cleaner/ast/definitions/function.h"
-#include "cleaner/ast/declarations/type.h"
+#include "cleaner/ast/statements/return.h"
 #include "cleaner/symbols/scope.h"
+#include "interpreter/tiering.h"
+#include "interpreter/frame.h"
+#include "common/native.h"
+#include "common/value.h"
 
 
 /**
  * Interprets the given function definition.
+ *
+ * The caller pushes the function's frame on the call stack
+ * and writes the arguments into its first slots.
  */
-std::unique_ptr<CleanExpression>
+Value
 FunctionDefinitionInterpreter::interpret(
     CleanFunctionDefinition* fun_def,
-    std::vector<std::unique_ptr<CleanExpression>>& arguments
+    Frame* frame
 )
 {
-    // If the scope already contains variables,
-    // we probably have a recursive call, we save them on stack frame
-    std::map<std::string,std::unique_ptr<CleanVariableDefinition>>& var_defs =
-        fun_def->scope->getSymbols<CleanVariableDefinition>();
-    for (auto& [name, var_def]: var_defs) {
-        fun_def->stack_frame.push(std::move(var_def));
-    }
+    // Tail calls reuse the frame and run here instead of recursing
+    while (true) {
+        if (fun_def->is_intrinsic)
+            return interpretIntrinsic(fun_def, frame);
 
-    // Create temporary variables in the function's scope
-    // and bind passed arguments to them
-    for (
-        std::vector<std::unique_ptr<CleanExpression>>::size_type i = 0;
-        i < arguments.size();
-        ++i
-    ) {
-        fun_def->scope->addSymbol<CleanVariableDefinition>(
-            fun_def->parameters[i]->name,
-            std::make_unique<CleanVariableDefinition>(
-                fun_def->parameters[i]->name,
-                nullptr,
-                std::move(arguments[i])
-            )
-        );
-    }
+        // Hot functions may get compiled code, from this very invocation on
+        Tiering* tiering = frame->stack->tiering;
+        if (tiering)
+            tiering->countInvocation(fun_def);
 
-    std::unique_ptr<CleanExpression> ret_expr =
-        StatementInterpreter().interpret(
+        // Functions the JIT compiled run as machine code on the same arguments
+        if (fun_def->compiled)
+            return fun_def->compiled(frame->slots, frame->getRoot()->slots);
+
+        StatementInterpreter stmt_interpreter(frame, fun_def);
+        Value ret_value = stmt_interpreter.interpret(
             fun_def->body.get(),
             fun_def->scope.get()
         );
 
-    // We restore the scope after this function's body interpretation
-    if (fun_def->stack_frame.size() > 0) {
-        for (
-            std::vector<std::unique_ptr<CleanTypeDeclaration>>::size_type i = 0;
-            i < fun_def->parameters.size();
-            ++i
-        ) {
-            std::unique_ptr<CleanVariableDefinition>& var_def =
-                fun_def->stack_frame.top();
-            fun_def->scope->addSymbol<CleanVariableDefinition>(
-                var_def->name,
-                std::move(var_def)
-            );
-            fun_def->stack_frame.pop();
-        }
-    }
-    // If the stack frame is empty,
-    // there was no recursion (or we are at the end of recursion), we empty the scope
-    else {
-        fun_def->scope->clearSymbols<CleanVariableDefinition>();
+        CleanFunctionDefinition* callee = stmt_interpreter.getTailCallee();
+        if (! callee)
+            return ret_value;
+
+        frame->reuse(callee->frame_size, callee->parameters.size());
+        fun_def = callee;
     }
-    
-    return ret_expr;
+}
+
+// Intrinsics receive their arguments as a span over their frame
+Value
+FunctionDefinitionInterpreter::interpretIntrinsic(
+    CleanFunctionDefinition* fun_def,
+    Frame* frame
+)
+{
+    // The body of an intrinsic returns the intrinsic expression,
+    // we call the native function directly instead of walking the body
+    CleanReturnStatement* ret_stmt = static_cast<CleanReturnStatement*>(
+        fun_def->body->statements[0].get()
+    );
+    CleanIntrinsicExpression* intr_expr =
+        static_cast<CleanIntrinsicExpression*>(ret_stmt->expression.get());
+
+    return intr_expr->callable(
+        NativeArguments(frame->slots, fun_def->parameters.size())
+    );
 }
@@ -22,16 +22,18 @@
 #include "cleaner/ast/expressions/expression.h"
 #include "cleaner/ast/definitions/variable.h"
 #include "cleaner/symbols/scope.h"
+#include "interpreter/frame.h"
 
 
 /**
  * Interprets the given variable definition.
  */
-std::unique_ptr<CleanExpression>
+Value
 VariableDefinitionInterpreter::interpret(
     CleanVariableDefinition* var_def,
-    CleanScope* scope
+    CleanScope* scope,
+    Frame* frame
 )
 {
-    return ExpressionInterpreter(scope).interpret(var_def->initializer.get());
+    return ExpressionInterpreter(scope, frame).interpret(var_def->initializer.get());
 }
@@ -16,25 +16,33 @@
  */
 
 #include <stdexcept>
+#include <cstddef>
 #include <utility>
 #include <memory>
+#include <vector>
 
 #include "interpreter/ast/expressions/expression.h"
 #include "interpreter/ast/definitions/function.h"
-#include "interpreter/ast/definitions/variable.h"
 #include "cleaner/ast/expressions/expression.h"
 #include "cleaner/symbols/scope.h"
+#include "interpreter/frame.h"
+#include "common/operation.h"
+#include "common/native.h"
+#include "common/memo.h"
+#include "common/value.h"
 
 
 ExpressionInterpreter::ExpressionInterpreter(
-    CleanScope* scope
-) : scope(scope)
+    CleanScope* scope,
+    Frame* frame
+) : scope(scope),
+    frame(frame)
 {}
 
 /**
  * Interprets the given expression.
  */
-std::unique_ptr<CleanExpression>
+Value
 ExpressionInterpreter::interpret(CleanExpression* expr)
 {
     switch (expr->type) {
@@ -98,10 +106,15 @@ ExpressionInterpreter::interpret(CleanExpression* expr)
             );
         }
 
+        case CleanExpressionType::Operation: {
+            return interpretOperation(
+                static_cast<CleanOperationExpression*>(expr)
+            );
+        }
+
         case CleanExpressionType::Intrinsic: {
             return interpretIntrinsic(
-                static_cast<CleanIntrinsicExpression*>(expr),
-                scope
+                static_cast<CleanIntrinsicExpression*>(expr)
             );
         }
 
@@ -117,67 +130,61 @@ ExpressionInterpreter::interpret(CleanExpression* expr)
 }
 
 // Bool
-std::unique_ptr<CleanBoolExpression>
+Value
 ExpressionInterpreter::interpretBool(
     CleanBoolExpression* bool_expr
 )
 {
-    return std::make_unique<CleanBoolExpression>(bool_expr);
+    return Value(bool_expr->value);
 }
 
 // Signed int
-std::unique_ptr<CleanSignedIntExpression>
+Value
 ExpressionInterpreter::interpretSignedInt(
     CleanSignedIntExpression* int_expr
 )
 {
-    return std::make_unique<CleanSignedIntExpression>(int_expr);
+    return Value(int_expr->value);
 }
 
 // Unsigned int
-std::unique_ptr<CleanUnsignedIntExpression>
+Value
 ExpressionInterpreter::interpretUnsignedInt(
     CleanUnsignedIntExpression* uint_expr
 )
 {
-    return std::make_unique<CleanUnsignedIntExpression>(uint_expr);
+    return Value(uint_expr->value);
 }
 
 // Float
-std::unique_ptr<CleanFloatExpression>
+Value
 ExpressionInterpreter::interpretFloat(
     CleanFloatExpression* float_expr
 )
 {
-    return std::make_unique<CleanFloatExpression>(float_expr);
+    return Value(float_expr->value);
 }
 
 // String
-std::unique_ptr<CleanStringExpression>
+Value
 ExpressionInterpreter::interpretString(
     CleanStringExpression* string_expr
 )
 {
-    return std::make_unique<CleanStringExpression>(string_expr);
+    return Value(&string_expr->value);
 }
 
 // Variable
-std::unique_ptr<CleanExpression>
+Value
 ExpressionInterpreter::interpretVariable(
     CleanVariableExpression* var_expr
 )
 {
-    std::unique_ptr<CleanVariableDefinition>& var_def =
-        scope->getSymbol<CleanVariableDefinition>(var_expr->var_name, true);
-    
-    return VariableDefinitionInterpreter().interpret(
-        var_def.get(),
-        scope
-    );
+    return frame->getSlot(var_expr->depth, var_expr->slot);
 }
 
 // Group
-std::unique_ptr<CleanExpression>
+Value
 ExpressionInterpreter::interpretGroup(
     CleanGroupExpression* gr_expr
 )
@@ -186,45 +193,61 @@ ExpressionInterpreter::interpretGroup(
 }
 
 // Call
-std::unique_ptr<CleanExpression>
+Value
 ExpressionInterpreter::interpretCall(
     CleanCallExpression* call_expr
 )
 {
-    // Construct new arguments from the call expression
-    // These should essentially amount to literals only
-    std::vector<std::unique_ptr<CleanExpression>> arguments;
-    for (auto& argument: call_expr->arguments)
-        arguments.push_back(interpret(argument.get()));
-
-    // Find the function in the scope and interpret it based on new arguments
-    std::unique_ptr<CleanFunctionDefinition>& fun_def =
-        scope->getSymbol<CleanFunctionDefinition>(call_expr->fun_name, true);
+    // The linker bound the call to its function
+    CleanFunctionDefinition* fun_def = call_expr->fun_def;
+
+    // Arguments are evaluated in the caller's frame
+    // and written directly into the callee's frame
+    Frame callee_frame(frame->stack, fun_def->frame_size, frame->getRoot());
+    for (std::size_t i = 0; i < call_expr->arguments.size(); ++i)
+        callee_frame.slots[i] = interpret(call_expr->arguments[i].get());
+
+    // Memoized functions answer from their cache when they can
+    MemoTable* memo = fun_def->memo.get();
+    if (memo) {
+        Value const* cached = memo->find(callee_frame.slots);
+        if (cached)
+            return *cached;
+
+        // The callee may overwrite its parameters so we keep the key aside
+        std::vector<Value> key(
+            callee_frame.slots,
+            callee_frame.slots + call_expr->arguments.size()
+        );
+        Value ret_value = FunctionDefinitionInterpreter().interpret(
+            fun_def,
+            &callee_frame
+        );
+        memo->insert(key.data(), ret_value);
+        return ret_value;
+    }
     
     return FunctionDefinitionInterpreter().interpret(
-        fun_def.get(),
-        arguments
+        fun_def,
+        &callee_frame
     );
 }
 
 // Ternary if
-std::unique_ptr<CleanExpression>
+Value
 ExpressionInterpreter::interpretTernaryIf(
     CleanTernaryIfExpression* ternif_expr
 )
 {
-    std::unique_ptr<CleanExpression> eval_condition =
-        interpret(ternif_expr->condition.get());
-    CleanBoolExpression* bool_condition =
-        static_cast<CleanBoolExpression*>(eval_condition.get());
-    if (bool_condition->value == true)
+    Value eval_condition = interpret(ternif_expr->condition.get());
+    if (eval_condition.as_bool == true)
         return interpret(ternif_expr->then_branch.get());
     else
         return interpret(ternif_expr->else_branch.get());
 }
 
 // Assignment
-std::unique_ptr<CleanExpression>
+Value
 ExpressionInterpreter::interpretAssignment(
     CleanAssignmentExpression* assign_expr
 )
@@ -232,36 +255,36 @@ ExpressionInterpreter::interpretAssignment(
     CleanVariableExpression* lvalue_expr =
         static_cast<CleanVariableExpression*>(assign_expr->lvalue.get());
 
-    // Pull the variable definition to update
-    std::unique_ptr<CleanVariableDefinition>& var_def =
-        scope->getSymbol<CleanVariableDefinition>(lvalue_expr->var_name, true);
-
-    // If the rvalue is the same variable on the lvalue,
-    // we just return the content of the corresponding variable definition
-    bool interpret_rvalue = true;
-    if (assign_expr->rvalue->type == CleanExpressionType::Variable) {
-        CleanVariableExpression* rvalue_expr =
-            static_cast<CleanVariableExpression*>(assign_expr->rvalue.get());
-        if (lvalue_expr->var_name == rvalue_expr->var_name)
-            interpret_rvalue = false;
-    }
-
-    // Update the variable definition initializer
-    if (interpret_rvalue)
-        var_def->initializer = interpret(assign_expr->rvalue.get());
+    // Update the slot bound to the variable
+    Value& value = frame->getSlot(lvalue_expr->depth, lvalue_expr->slot);
+    value = interpret(assign_expr->rvalue.get());
     
-    return VariableDefinitionInterpreter().interpret(
-        var_def.get(),
-        scope
+    return value;
+}
+
+// Operation
+Value
+ExpressionInterpreter::interpretOperation(
+    CleanOperationExpression* op_expr
+)
+{
+    Value left = interpret(op_expr->operands[0].get());
+    if (op_expr->operands.size() == 1)
+        return applyOperation(op_expr->operation, left, Value());
+
+    return applyOperation(
+        op_expr->operation,
+        left,
+        interpret(op_expr->operands[1].get())
     );
 }
 
 // Intrinsic
-std::unique_ptr<CleanExpression>
+Value
 ExpressionInterpreter::interpretIntrinsic(
-    CleanIntrinsicExpression* intr_expr,
-    CleanScope* scope
+    CleanIntrinsicExpression* intr_expr
 )
 {
-    return intr_expr->callable(scope);
+    // The arguments are the first slots of the intrinsic's frame
+    return intr_expr->callable(NativeArguments(frame->slots, intr_expr->arity));
 }
@@ -17,11 +17,14 @@
 
 #include <stdexcept>
 #include <cstdbool>
+#include <cstdint>
+#include <cstddef>
 #include <memory>
 
 #include "interpreter/ast/expressions/expression.h"
 #include "interpreter/ast/statements/statement.h"
 #include "cleaner/ast/expressions/expression.h"
+#include "cleaner/ast/definitions/function.h"
 #include "cleaner/ast/statements/statement.h"
 #include "cleaner/ast/statements/continue.h"
 #include "cleaner/ast/statements/return.h"
@@ -31,18 +34,34 @@
 #include "cleaner/ast/statements/for.h"
 #include "cleaner/ast/statements/if.h"
 #include "cleaner/symbols/scope.h"
+#include "interpreter/tiering.h"
+#include "common/operation.h"
+#include "interpreter/frame.h"
+#include "common/value.h"
 
 
+static bool testCounter(enum Operation test, int64_t counter, int64_t bound);
+
+StatementInterpreter::StatementInterpreter(
+    Frame* frame
+) : StatementInterpreter(frame, nullptr)
+{}
+
 StatementInterpreter::StatementInterpreter(
-) : returned(false),
+    Frame* frame,
+    CleanFunctionDefinition* fun_def
+) : frame(frame),
+    fun_def(fun_def),
+    returned(false),
     broke(false),
-    continued(false)
+    continued(false),
+    tail_callee(nullptr)
 {}
 
 /**
  * Interprets the given statement.
  */
-std::unique_ptr<CleanExpression>
+Value
 StatementInterpreter::interpret(
     CleanStatement* stmt,
     CleanScope* scope
@@ -109,13 +128,13 @@ StatementInterpreter::interpret(
 }
 
 // Block
-std::unique_ptr<CleanExpression>
+Value
 StatementInterpreter::interpretBlock(
     CleanBlockStatement* block_stmt
 )
 {
     for (auto& statement: block_stmt->statements) {
-        std::unique_ptr<CleanExpression> ret_expr =
+        Value ret_value =
             interpret(statement.get(), block_stmt->scope.get());
         
         if (
@@ -123,41 +142,36 @@ StatementInterpreter::interpretBlock(
             broke       ||
             continued
         )
-            return ret_expr;
+            return ret_value;
     }
 
-    return nullptr;
+    return Value();
 }
 
 // If
-std::unique_ptr<CleanExpression>
+Value
 StatementInterpreter::interpretIf(
     CleanIfStatement* if_stmt,
     CleanScope* scope
 )
 {
-    std::unique_ptr<CleanExpression> ret_expr = nullptr;
+    Value ret_value;
 
-    std::unique_ptr<CleanExpression> cond_expr =
-        interpret(if_stmt->condition.get(), scope);
-    CleanBoolExpression* cond_bool =
-        static_cast<CleanBoolExpression*>(cond_expr.get());
+    Value cond_value = interpret(if_stmt->condition.get(), scope);
 
     bool interpret_else = true;
-    if (cond_bool->value) {
+    if (cond_value.as_bool) {
         interpret_else = false;
-        ret_expr = interpretBlock(if_stmt->body.get());
+        ret_value = interpretBlock(if_stmt->body.get());
     }
     else {
         for (auto& elif_branch: if_stmt->elif_branches) {
-            std::unique_ptr<CleanExpression> elif_cond_expr =
+            Value elif_cond_value =
                 interpret(elif_branch->condition.get(), scope);
-            CleanBoolExpression* elif_cond_bool =
-                static_cast<CleanBoolExpression*>(elif_cond_expr.get());
             
-            if (elif_cond_bool->value) {
+            if (elif_cond_value.as_bool) {
                 interpret_else = false;
-                ret_expr = interpretBlock(elif_branch->body.get());
+                ret_value = interpretBlock(elif_branch->body.get());
                 break;
             }
         }
@@ -165,19 +179,22 @@ StatementInterpreter::interpretIf(
 
     // If the main branch and elif branches failed, interpret else branch
     if (interpret_else && if_stmt->else_branch)
-        ret_expr = interpretBlock(if_stmt->else_branch->body.get());
+        ret_value = interpretBlock(if_stmt->else_branch->body.get());
 
-    return ret_expr;
+    return ret_value;
 }
 
 // For
-std::unique_ptr<CleanExpression>
+Value
 StatementInterpreter::interpretFor(
     CleanForStatement* for_stmt,
     CleanScope* scope
 )
 {
-    std::unique_ptr<CleanExpression> ret_expr = nullptr;
+    if (for_stmt->is_counted)
+        return interpretCountedFor(for_stmt);
+
+    Value ret_value;
 
     // Initialize the init_clause first
     if (for_stmt->init_clause)
@@ -187,21 +204,20 @@ StatementInterpreter::interpretFor(
     while(true) {
         // If the termination clause doesn't hold, we are done
         if (for_stmt->term_clause) {
-            std::unique_ptr<CleanExpression> term_expr =
+            Value term_value =
                 interpret(for_stmt->term_clause.get(), for_stmt->scope.get());
-            CleanBoolExpression* term_bool =
-                static_cast<CleanBoolExpression*>(term_expr.get());
 
-            if (! term_bool->value)
+            if (! term_value.as_bool)
                 break;
         }
 
         // Execute the body
-        ret_expr = interpretBlock(for_stmt->body.get());
+        countBackEdge();
+        ret_value = interpretBlock(for_stmt->body.get());
 
         // If the body returned, we are done
         if (returned)
-            return ret_expr;
+            return ret_value;
         
         // If a continue statement was encountered
         // we just keep chugging along
@@ -224,36 +240,76 @@ StatementInterpreter::interpretFor(
             interpret(for_stmt->incr_clause.get(), for_stmt->scope.get());
     }
 
-    return ret_expr;
+    return ret_value;
+}
+
+// Counted loops step their counter in place and only compute
+// the bound once when it does not change while the loop runs
+Value
+StatementInterpreter::interpretCountedFor(
+    CleanForStatement* for_stmt
+)
+{
+    Value ret_value;
+    CleanScope* scope = for_stmt->scope.get();
+
+    if (for_stmt->init_clause)
+        interpret(for_stmt->init_clause.get(), scope);
+
+    Value& counter = frame->getSlot(0, for_stmt->counter_slot);
+    int64_t bound = 0;
+    if (for_stmt->is_bound_invariant)
+        bound = interpret(for_stmt->counter_bound, scope).as_int;
+
+    while (true) {
+        if (! for_stmt->is_bound_invariant)
+            bound = interpret(for_stmt->counter_bound, scope).as_int;
+        if (! testCounter(for_stmt->counter_test, counter.as_int, bound))
+            break;
+
+        countBackEdge();
+        ret_value = interpretBlock(for_stmt->body.get());
+        if (returned)
+            return ret_value;
+        if (broke) {
+            broke = false;
+            break;
+        }
+
+        // Continue statements still step the counter
+        continued = false;
+        counter.as_int += for_stmt->counter_step;
+    }
+
+    return ret_value;
 }
 
 // While
-std::unique_ptr<CleanExpression>
+Value
 StatementInterpreter::interpretWhile(
     CleanWhileStatement* while_stmt,
     CleanScope* scope
 )
 {
-    std::unique_ptr<CleanExpression> ret_expr = nullptr;
+    Value ret_value;
 
     while (true) {
         // If the condition doesn't hold, we are done
         if (while_stmt->condition) {
-            std::unique_ptr<CleanExpression> cond_expr =
+            Value cond_value =
                 interpret(while_stmt->condition.get(), scope);
-            CleanBoolExpression* cond_bool =
-                static_cast<CleanBoolExpression*>(cond_expr.get());
 
-            if (! cond_bool->value)
+            if (! cond_value.as_bool)
                 break;
         }
 
         // Execute the body
-        ret_expr = interpretBlock(while_stmt->body.get());
+        countBackEdge();
+        ret_value = interpretBlock(while_stmt->body.get());
 
         // If the body returned, we are done
         if (returned)
-            return ret_expr;
+            return ret_value;
         
         // If a continue statement was encountered
         // we just keep chugging along
@@ -270,31 +326,31 @@ StatementInterpreter::interpretWhile(
         }
     }
 
-    return ret_expr;
+    return ret_value;
 }
 
 // Break
-std::unique_ptr<CleanExpression>
+Value
 StatementInterpreter::interpretBreak(
     CleanBreakStatement* br_stmt
 )
 {
     broke = true;
-    return nullptr;
+    return Value();
 }
 
 // Continue
-std::unique_ptr<CleanExpression>
+Value
 StatementInterpreter::interpretContinue(
     CleanContinueStatement* cont_stmt
 )
 {
     continued = true;
-    return nullptr;
+    return Value();
 }
 
 // Return
-std::unique_ptr<CleanExpression>
+Value
 StatementInterpreter::interpretReturn(
     CleanReturnStatement* ret_stmt,
     CleanScope* scope
@@ -302,17 +358,93 @@ StatementInterpreter::interpretReturn(
 {
     returned = true;
 
-    return ret_stmt->expression
-           ? interpretExpression(ret_stmt->expression.get(), scope)
-           : nullptr;
+    if (! ret_stmt->expression)
+        return Value();
+
+    // Find the expression whose value is returned
+    CleanExpression* expr = ret_stmt->expression.get();
+    while (true) {
+        if (expr->type == CleanExpressionType::Group) {
+            expr = static_cast<CleanGroupExpression*>(expr)->expression.get();
+        }
+        else if (expr->type == CleanExpressionType::TernaryIf) {
+            CleanTernaryIfExpression* ternif_expr =
+                static_cast<CleanTernaryIfExpression*>(expr);
+            expr = interpretExpression(ternif_expr->condition.get(), scope).as_bool
+                ? ternif_expr->then_branch.get()
+                : ternif_expr->else_branch.get();
+        }
+        else {
+            break;
+        }
+    }
+
+    // Tail calls leave their arguments right above the frame
+    // so the function interpreter can reuse the frame for the callee
+    if (expr->type == CleanExpressionType::Call) {
+        CleanCallExpression* call_expr = static_cast<CleanCallExpression*>(expr);
+        if (call_expr->is_tail_call && ! call_expr->fun_def->is_intrinsic) {
+            Value* arguments = frame->stack->push(call_expr->arguments.size());
+            ExpressionInterpreter expr_interpreter(scope, frame);
+            for (std::size_t i = 0; i < call_expr->arguments.size(); ++i)
+                arguments[i] = expr_interpreter.interpret(call_expr->arguments[i].get());
+
+            tail_callee = call_expr->fun_def;
+            return Value();
+        }
+    }
+
+    return interpretExpression(expr, scope);
 }
 
 // Expression
-std::unique_ptr<CleanExpression>
+Value
 StatementInterpreter::interpretExpression(
     CleanExpression* expr_stmt,
     CleanScope* scope
 )
 {
-    return ExpressionInterpreter(scope).interpret(expr_stmt);
+    return ExpressionInterpreter(scope, frame).interpret(expr_stmt);
+}
+
+/**
+ * Returns the function tail called by the last return statement, if any.
+ *
+ * Its arguments sit on the call stack right above the frame.
+ */
+CleanFunctionDefinition*
+StatementInterpreter::getTailCallee()
+{
+    return tail_callee;
+}
+
+// Loop iterations count toward the hotness of the running function
+void
+StatementInterpreter::countBackEdge()
+{
+    Tiering* tiering = frame->stack->tiering;
+    if (tiering && fun_def)
+        tiering->countBackEdge(fun_def);
+}
+
+// Whether a counted loop runs another iteration
+static bool
+testCounter(enum Operation test, int64_t counter, int64_t bound)
+{
+    switch (test) {
+        case Operation::LtI64:
+            return counter < bound;
+
+        case Operation::LeI64:
+            return counter <= bound;
+
+        case Operation::GtI64:
+            return counter > bound;
+
+        case Operation::GeI64:
+            return counter >= bound;
+
+        default:
+            return counter != bound;
+    }
 }
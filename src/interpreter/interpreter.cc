@@ -16,42 +16,64 @@
  */
 
 #include <memory>
+#include <string>
+#include <map>
 
 #include "interpreter/ast/definitions/function.h"
+#include "interpreter/ast/definitions/variable.h"
 #include "cleaner/ast/expressions/expression.h"
 #include "cleaner/ast/definitions/function.h"
 #include "interpreter/interpreter.h"
 #include "cleaner/symbols/scope.h"
+#include "interpreter/frame.h"
+#include "common/value.h"
 
 
 Interpreter::Interpreter(
     CleanScope* scope
-) : scope(scope)
+) : scope(scope),
+    tiering(nullptr)
+{}
+
+Interpreter::Interpreter(
+    CleanScope* scope,
+    Tiering* tiering
+) : scope(scope),
+    tiering(tiering)
 {}
 
 /**
  * Interprets the program starting with the main function found in the global scope.
+ *
+ * The program must have gone through the resolver so variables are bound to frame slots.
  */
 int
 Interpreter::interpret()
 {
+    // Global variables live in the outermost frame
+    std::map<std::string,std::unique_ptr<CleanVariableDefinition>>& var_defs =
+        scope->getSymbols<CleanVariableDefinition>();
+    CallStack stack(stack_segment, stack_limit);
+    stack.tiering = tiering;
+    Frame globals(&stack, var_defs.size(), nullptr);
+    for (auto& [name, var_def]: var_defs) {
+        globals.slots[var_def->slot] =
+            VariableDefinitionInterpreter().interpret(var_def.get(), scope, &globals);
+    }
+
     std::unique_ptr<CleanFunctionDefinition>& main_fun =
         scope->getSymbol<CleanFunctionDefinition>("main()");
     
-    std::vector<std::unique_ptr<CleanExpression>> args{};
-    
-    std::unique_ptr<CleanExpression> ret_expr =
-        FunctionDefinitionInterpreter().interpret(main_fun.get(), args);
+    Frame main_frame(&stack, main_fun->frame_size, &globals);
+    Value ret_value =
+        FunctionDefinitionInterpreter().interpret(main_fun.get(), &main_frame);
 
-    if (ret_expr && ret_expr->type == CleanExpressionType::SignedInt) {
-        CleanSignedIntExpression* int_expr =
-            static_cast<CleanSignedIntExpression*>(ret_expr.get());
-        
+    if (ret_value.type == ValueType::SignedInt) {
         // The value will be of type int64_t
         // But since we are interpreting through C++, we convert to int
-        return (int) int_expr->value;
+        return (int) ret_value.as_int;
     }
 
-    // If we got a nullptr from main, we have an error
+    // If we got nothing from main, we have an error
     return -1;
 }
@@ -27,11 +27,12 @@
 #include <map>
 
 #include "cleaner/ast/expressions/expression.h"
-#include "cleaner/ast/declarations/variable.h"
 #include "cleaner/ast/definitions/function.h"
 #include "intrinsics/reslib/resint.h"
 #include "cleaner/symbols/scope.h"
 #include "utils/intrinsics.h"
+#include "common/native.h"
+#include "common/value.h"
 
 
 // Unary positive
@@ -45,14 +46,11 @@ static std::unique_ptr<CleanFunctionDefinition> pos()
         "__pos__(int)",
         params,
         "void",
-        [](CleanScope* scope)->std::unique_ptr<CleanExpression> {
-            CleanSignedIntExpression* int_expr = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param__", true)
-                    ->initializer.get()
-            );
+        [](NativeArguments args)->Value {
+            Value const& int_expr = args[0];
 
-            return std::make_unique<CleanSignedIntExpression>(
-                int_expr->value
+            return Value(
+                int_expr.as_int
             );
         }
     );
@@ -69,14 +67,11 @@ static std::unique_ptr<CleanFunctionDefinition> neg()
         "__neg__(int)",
         params,
         "void",
-        [](CleanScope* scope)->std::unique_ptr<CleanExpression> {
-            CleanSignedIntExpression* int_expr = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param__", true)
-                    ->initializer.get()
-            );
+        [](NativeArguments args)->Value {
+            Value const& int_expr = args[0];
             
-            return std::make_unique<CleanSignedIntExpression>(
-                -int_expr->value
+            return Value(
+                -int_expr.as_int
             );
         }
     );
@@ -94,18 +89,12 @@ static std::unique_ptr<CleanFunctionDefinition> add()
         "__add__(int,int)",
         params,
         "int",
-        [](CleanScope* scope)->std::unique_ptr<CleanExpression> {
-            CleanSignedIntExpression* int_expr_1 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param1__", true)
-                    ->initializer.get()
-            );
-            CleanSignedIntExpression* int_expr_2 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param2__", true)
-                    ->initializer.get()
-            );
+        [](NativeArguments args)->Value {
+            Value const& int_expr_1 = args[0];
+            Value const& int_expr_2 = args[1];
             
-            return std::make_unique<CleanSignedIntExpression>(
-                int_expr_1->value + int_expr_2->value
+            return Value(
+                int_expr_1.as_int + int_expr_2.as_int
             );
         }
     );
@@ -123,18 +112,12 @@ static std::unique_ptr<CleanFunctionDefinition> sub()
         "__sub__(int,int)",
         params,
         "int",
-        [](CleanScope* scope)->std::unique_ptr<CleanExpression> {
-            CleanSignedIntExpression* int_expr_1 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param1__", true)
-                    ->initializer.get()
-            );
-            CleanSignedIntExpression* int_expr_2 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param2__", true)
-                    ->initializer.get()
-            );
+        [](NativeArguments args)->Value {
+            Value const& int_expr_1 = args[0];
+            Value const& int_expr_2 = args[1];
             
-            return std::make_unique<CleanSignedIntExpression>(
-                int_expr_1->value - int_expr_2->value
+            return Value(
+                int_expr_1.as_int - int_expr_2.as_int
             );
         }
     );
@@ -152,18 +135,12 @@ static std::unique_ptr<CleanFunctionDefinition> mul()
         "__mul__(int,int)",
         params,
         "int",
-        [](CleanScope* scope)->std::unique_ptr<CleanExpression> {
-            CleanSignedIntExpression* int_expr_1 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param1__", true)
-                    ->initializer.get()
-            );
-            CleanSignedIntExpression* int_expr_2 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param2__", true)
-                    ->initializer.get()
-            );
+        [](NativeArguments args)->Value {
+            Value const& int_expr_1 = args[0];
+            Value const& int_expr_2 = args[1];
             
-            return std::make_unique<CleanSignedIntExpression>(
-                int_expr_1->value * int_expr_2->value
+            return Value(
+                int_expr_1.as_int * int_expr_2.as_int
             );
         }
     );
@@ -181,21 +158,15 @@ static std::unique_ptr<CleanFunctionDefinition> div()
         "__div__(int,int)",
         params,
         "int",
-        [](CleanScope* scope)->std::unique_ptr<CleanExpression> {
-            CleanSignedIntExpression* int_expr_1 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param1__", true)
-                    ->initializer.get()
-            );
-            CleanSignedIntExpression* int_expr_2 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param2__", true)
-                    ->initializer.get()
-            );
+        [](NativeArguments args)->Value {
+            Value const& int_expr_1 = args[0];
+            Value const& int_expr_2 = args[1];
 
-            if (int_expr_2->value == 0)
+            if (int_expr_2.as_int == 0)
                 std::abort();
             
-            return std::make_unique<CleanSignedIntExpression>(
-                int_expr_1->value / int_expr_2->value
+            return Value(
+                int_expr_1.as_int / int_expr_2.as_int
             );
         }
     );
@@ -213,21 +184,15 @@ static std::unique_ptr<CleanFunctionDefinition> rem()
         "__rem__(int,int)",
         params,
         "int",
-        [](CleanScope* scope)->std::unique_ptr<CleanExpression> {
-            CleanSignedIntExpression* int_expr_1 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param1__", true)
-                    ->initializer.get()
-            );
-            CleanSignedIntExpression* int_expr_2 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param2__", true)
-                    ->initializer.get()
-            );
+        [](NativeArguments args)->Value {
+            Value const& int_expr_1 = args[0];
+            Value const& int_expr_2 = args[1];
 
-            if (int_expr_2->value == 0)
+            if (int_expr_2.as_int == 0)
                 std::abort();
             
-            return std::make_unique<CleanSignedIntExpression>(
-                int_expr_1->value % int_expr_2->value
+            return Value(
+                int_expr_1.as_int % int_expr_2.as_int
             );
         }
     );
@@ -245,18 +210,12 @@ static std::unique_ptr<CleanFunctionDefinition> eq()
         "__eq__(int,int)",
         params,
         "bool",
-        [](CleanScope* scope)->std::unique_ptr<CleanExpression> {
-            CleanSignedIntExpression* int_expr_1 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param1__", true)
-                    ->initializer.get()
-            );
-            CleanSignedIntExpression* int_expr_2 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param2__", true)
-                    ->initializer.get()
-            );
+        [](NativeArguments args)->Value {
+            Value const& int_expr_1 = args[0];
+            Value const& int_expr_2 = args[1];
             
-            return std::make_unique<CleanBoolExpression>(
-                int_expr_1->value == int_expr_2->value
+            return Value(
+                int_expr_1.as_int == int_expr_2.as_int
             );
         }
     );
@@ -274,18 +233,12 @@ static std::unique_ptr<CleanFunctionDefinition> ne()
         "__ne__(int,int)",
         params,
         "bool",
-        [](CleanScope* scope)->std::unique_ptr<CleanExpression> {
-            CleanSignedIntExpression* int_expr_1 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param1__", true)
-                    ->initializer.get()
-            );
-            CleanSignedIntExpression* int_expr_2 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param2__", true)
-                    ->initializer.get()
-            );
+        [](NativeArguments args)->Value {
+            Value const& int_expr_1 = args[0];
+            Value const& int_expr_2 = args[1];
             
-            return std::make_unique<CleanBoolExpression>(
-                int_expr_1->value != int_expr_2->value
+            return Value(
+                int_expr_1.as_int != int_expr_2.as_int
             );
         }
     );
@@ -303,18 +256,12 @@ static std::unique_ptr<CleanFunctionDefinition> gt()
         "__gt__(int,int)",
         params,
         "bool",
-        [](CleanScope* scope)->std::unique_ptr<CleanExpression> {
-            CleanSignedIntExpression* int_expr_1 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param1__", true)
-                    ->initializer.get()
-            );
-            CleanSignedIntExpression* int_expr_2 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param2__", true)
-                    ->initializer.get()
-            );
+        [](NativeArguments args)->Value {
+            Value const& int_expr_1 = args[0];
+            Value const& int_expr_2 = args[1];
             
-            return std::make_unique<CleanBoolExpression>(
-                int_expr_1->value > int_expr_2->value
+            return Value(
+                int_expr_1.as_int > int_expr_2.as_int
             );
         }
     );
@@ -332,18 +279,12 @@ static std::unique_ptr<CleanFunctionDefinition> ge()
         "__ge__(int,int)",
         params,
         "bool",
-        [](CleanScope* scope)->std::unique_ptr<CleanExpression> {
-            CleanSignedIntExpression* int_expr_1 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param1__", true)
-                    ->initializer.get()
-            );
-            CleanSignedIntExpression* int_expr_2 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param2__", true)
-                    ->initializer.get()
-            );
+        [](NativeArguments args)->Value {
+            Value const& int_expr_1 = args[0];
+            Value const& int_expr_2 = args[1];
             
-            return std::make_unique<CleanBoolExpression>(
-                int_expr_1->value >= int_expr_2->value
+            return Value(
+                int_expr_1.as_int >= int_expr_2.as_int
             );
         }
     );
@@ -361,18 +302,12 @@ static std::unique_ptr<CleanFunctionDefinition> lt()
         "__lt__(int,int)",
         params,
         "bool",
-        [](CleanScope* scope)->std::unique_ptr<CleanExpression> {
-            CleanSignedIntExpression* int_expr_1 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param1__", true)
-                    ->initializer.get()
-            );
-            CleanSignedIntExpression* int_expr_2 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param2__", true)
-                    ->initializer.get()
-            );
+        [](NativeArguments args)->Value {
+            Value const& int_expr_1 = args[0];
+            Value const& int_expr_2 = args[1];
             
-            return std::make_unique<CleanBoolExpression>(
-                int_expr_1->value < int_expr_2->value
+            return Value(
+                int_expr_1.as_int < int_expr_2.as_int
             );
         }
     );
@@ -390,18 +325,12 @@ static std::unique_ptr<CleanFunctionDefinition> le()
         "__le__(int,int)",
         params,
         "bool",
-        [](CleanScope* scope)->std::unique_ptr<CleanExpression> {
-            CleanSignedIntExpression* int_expr_1 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param1__", true)
-                    ->initializer.get()
-            );
-            CleanSignedIntExpression* int_expr_2 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param2__", true)
-                    ->initializer.get()
-            );
+        [](NativeArguments args)->Value {
+            Value const& int_expr_1 = args[0];
+            Value const& int_expr_2 = args[1];
             
-            return std::make_unique<CleanBoolExpression>(
-                int_expr_1->value <= int_expr_2->value
+            return Value(
+                int_expr_1.as_int <= int_expr_2.as_int
             );
         }
     );
@@ -418,14 +347,11 @@ static std::unique_ptr<CleanFunctionDefinition> bnot()
         "__bnot__(int)",
         params,
         "void",
-        [](CleanScope* scope)->std::unique_ptr<CleanExpression> {
-            CleanSignedIntExpression* int_expr = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param__", true)
-                    ->initializer.get()
-            );
+        [](NativeArguments args)->Value {
+            Value const& int_expr = args[0];
             
-            return std::make_unique<CleanSignedIntExpression>(
-                ~int_expr->value
+            return Value(
+                ~int_expr.as_int
             );
         }
     );
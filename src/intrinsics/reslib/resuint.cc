@@ -27,11 +27,12 @@
 #include <map>
 
 #include "cleaner/ast/expressions/expression.h"
-#include "cleaner/ast/declarations/variable.h"
 #include "cleaner/ast/definitions/function.h"
 #include "intrinsics/reslib/resuint.h"
 #include "cleaner/symbols/scope.h"
 #include "utils/intrinsics.h"
+#include "common/native.h"
+#include "common/value.h"
 
 
 // Unary positive
@@ -45,14 +46,11 @@ static std::unique_ptr<CleanFunctionDefinition> pos()
         "__pos__(uint)",
         params,
         "void",
-        [](CleanScope* scope)->std::unique_ptr<CleanExpression> {
-            CleanSignedIntExpression* uint_expr = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param__", true)
-                    ->initializer.get()
-            );
+        [](NativeArguments args)->Value {
+            Value const& uint_expr = args[0];
 
-            return std::make_unique<CleanSignedIntExpression>(
-                uint_expr->value
+            return Value(
+                uint_expr.as_uint
             );
         }
     );
@@ -69,14 +67,11 @@ static std::unique_ptr<CleanFunctionDefinition> neg()
         "__neg__(uint)",
         params,
         "void",
-        [](CleanScope* scope)->std::unique_ptr<CleanExpression> {
-            CleanSignedIntExpression* uint_expr = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param__", true)
-                    ->initializer.get()
-            );
+        [](NativeArguments args)->Value {
+            Value const& uint_expr = args[0];
             
-            return std::make_unique<CleanSignedIntExpression>(
-               (uint64_t) -uint_expr->value
+            return Value(
+               (uint64_t) -uint_expr.as_uint
             );
         }
     );
@@ -94,18 +89,12 @@ static std::unique_ptr<CleanFunctionDefinition> add()
         "__add__(uint,uint)",
         params,
         "uint",
-        [](CleanScope* scope)->std::unique_ptr<CleanExpression> {
-            CleanSignedIntExpression* uint_expr_1 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param1__", true)
-                    ->initializer.get()
-            );
-            CleanSignedIntExpression* uint_expr_2 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param2__", true)
-                    ->initializer.get()
-            );
+        [](NativeArguments args)->Value {
+            Value const& uint_expr_1 = args[0];
+            Value const& uint_expr_2 = args[1];
             
-            return std::make_unique<CleanSignedIntExpression>(
-                uint_expr_1->value + uint_expr_2->value
+            return Value(
+                uint_expr_1.as_uint + uint_expr_2.as_uint
             );
         }
     );
@@ -123,18 +112,12 @@ static std::unique_ptr<CleanFunctionDefinition> sub()
         "__sub__(uint,uint)",
         params,
         "uint",
-        [](CleanScope* scope)->std::unique_ptr<CleanExpression> {
-            CleanSignedIntExpression* uint_expr_1 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param1__", true)
-                    ->initializer.get()
-            );
-            CleanSignedIntExpression* uint_expr_2 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param2__", true)
-                    ->initializer.get()
-            );
+        [](NativeArguments args)->Value {
+            Value const& uint_expr_1 = args[0];
+            Value const& uint_expr_2 = args[1];
             
-            return std::make_unique<CleanSignedIntExpression>(
-                (uint64_t) (uint_expr_1->value - uint_expr_2->value)
+            return Value(
+                (uint64_t) (uint_expr_1.as_uint - uint_expr_2.as_uint)
             );
         }
     );
@@ -152,18 +135,12 @@ static std::unique_ptr<CleanFunctionDefinition> mul()
         "__mul__(uint,uint)",
         params,
         "uint",
-        [](CleanScope* scope)->std::unique_ptr<CleanExpression> {
-            CleanSignedIntExpression* uint_expr_1 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param1__", true)
-                    ->initializer.get()
-            );
-            CleanSignedIntExpression* uint_expr_2 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param2__", true)
-                    ->initializer.get()
-            );
+        [](NativeArguments args)->Value {
+            Value const& uint_expr_1 = args[0];
+            Value const& uint_expr_2 = args[1];
             
-            return std::make_unique<CleanSignedIntExpression>(
-                uint_expr_1->value * uint_expr_2->value
+            return Value(
+                uint_expr_1.as_uint * uint_expr_2.as_uint
             );
         }
     );
@@ -181,21 +158,15 @@ static std::unique_ptr<CleanFunctionDefinition> div()
         "__div__(uint,uint)",
         params,
         "uint",
-        [](CleanScope* scope)->std::unique_ptr<CleanExpression> {
-            CleanSignedIntExpression* uint_expr_1 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param1__", true)
-                    ->initializer.get()
-            );
-            CleanSignedIntExpression* uint_expr_2 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param2__", true)
-                    ->initializer.get()
-            );
+        [](NativeArguments args)->Value {
+            Value const& uint_expr_1 = args[0];
+            Value const& uint_expr_2 = args[1];
 
-            if (uint_expr_2->value == 0)
+            if (uint_expr_2.as_uint == 0)
                 std::abort();
             
-            return std::make_unique<CleanSignedIntExpression>(
-                uint_expr_1->value / uint_expr_2->value
+            return Value(
+                uint_expr_1.as_uint / uint_expr_2.as_uint
             );
         }
     );
@@ -213,21 +184,15 @@ static std::unique_ptr<CleanFunctionDefinition> rem()
         "__rem__(uint,uint)",
         params,
         "uint",
-        [](CleanScope* scope)->std::unique_ptr<CleanExpression> {
-            CleanSignedIntExpression* uint_expr_1 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param1__", true)
-                    ->initializer.get()
-            );
-            CleanSignedIntExpression* uint_expr_2 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param2__", true)
-                    ->initializer.get()
-            );
+        [](NativeArguments args)->Value {
+            Value const& uint_expr_1 = args[0];
+            Value const& uint_expr_2 = args[1];
 
-            if (uint_expr_2->value == 0)
+            if (uint_expr_2.as_uint == 0)
                 std::abort();
             
-            return std::make_unique<CleanSignedIntExpression>(
-                uint_expr_1->value % uint_expr_2->value
+            return Value(
+                uint_expr_1.as_uint % uint_expr_2.as_uint
             );
         }
     );
@@ -245,18 +210,12 @@ static std::unique_ptr<CleanFunctionDefinition> eq()
         "__eq__(uint,uint)",
         params,
         "bool",
-        [](CleanScope* scope)->std::unique_ptr<CleanExpression> {
-            CleanSignedIntExpression* uint_expr_1 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param1__", true)
-                    ->initializer.get()
-            );
-            CleanSignedIntExpression* uint_expr_2 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param2__", true)
-                    ->initializer.get()
-            );
+        [](NativeArguments args)->Value {
+            Value const& uint_expr_1 = args[0];
+            Value const& uint_expr_2 = args[1];
             
-            return std::make_unique<CleanBoolExpression>(
-                uint_expr_1->value == uint_expr_2->value
+            return Value(
+                uint_expr_1.as_uint == uint_expr_2.as_uint
             );
         }
     );
@@ -274,18 +233,12 @@ static std::unique_ptr<CleanFunctionDefinition> ne()
         "__ne__(uint,uint)",
         params,
         "bool",
-        [](CleanScope* scope)->std::unique_ptr<CleanExpression> {
-            CleanSignedIntExpression* uint_expr_1 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param1__", true)
-                    ->initializer.get()
-            );
-            CleanSignedIntExpression* uint_expr_2 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param2__", true)
-                    ->initializer.get()
-            );
+        [](NativeArguments args)->Value {
+            Value const& uint_expr_1 = args[0];
+            Value const& uint_expr_2 = args[1];
             
-            return std::make_unique<CleanBoolExpression>(
-                uint_expr_1->value != uint_expr_2->value
+            return Value(
+                uint_expr_1.as_uint != uint_expr_2.as_uint
             );
         }
     );
@@ -303,18 +256,12 @@ static std::unique_ptr<CleanFunctionDefinition> gt()
         "__gt__(uint,uint)",
         params,
         "bool",
-        [](CleanScope* scope)->std::unique_ptr<CleanExpression> {
-            CleanSignedIntExpression* uint_expr_1 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param1__", true)
-                    ->initializer.get()
-            );
-            CleanSignedIntExpression* uint_expr_2 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param2__", true)
-                    ->initializer.get()
-            );
+        [](NativeArguments args)->Value {
+            Value const& uint_expr_1 = args[0];
+            Value const& uint_expr_2 = args[1];
             
-            return std::make_unique<CleanBoolExpression>(
-                uint_expr_1->value > uint_expr_2->value
+            return Value(
+                uint_expr_1.as_uint > uint_expr_2.as_uint
             );
         }
     );
@@ -332,18 +279,12 @@ static std::unique_ptr<CleanFunctionDefinition> ge()
         "__ge__(uint,uint)",
         params,
         "bool",
-        [](CleanScope* scope)->std::unique_ptr<CleanExpression> {
-            CleanSignedIntExpression* uint_expr_1 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param1__", true)
-                    ->initializer.get()
-            );
-            CleanSignedIntExpression* uint_expr_2 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param2__", true)
-                    ->initializer.get()
-            );
+        [](NativeArguments args)->Value {
+            Value const& uint_expr_1 = args[0];
+            Value const& uint_expr_2 = args[1];
             
-            return std::make_unique<CleanBoolExpression>(
-                uint_expr_1->value >= uint_expr_2->value
+            return Value(
+                uint_expr_1.as_uint >= uint_expr_2.as_uint
             );
         }
     );
@@ -361,18 +302,12 @@ static std::unique_ptr<CleanFunctionDefinition> lt()
         "__lt__(uint,uint)",
         params,
         "bool",
-        [](CleanScope* scope)->std::unique_ptr<CleanExpression> {
-            CleanSignedIntExpression* uint_expr_1 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param1__", true)
-                    ->initializer.get()
-            );
-            CleanSignedIntExpression* uint_expr_2 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param2__", true)
-                    ->initializer.get()
-            );
+        [](NativeArguments args)->Value {
+            Value const& uint_expr_1 = args[0];
+            Value const& uint_expr_2 = args[1];
             
-            return std::make_unique<CleanBoolExpression>(
-                uint_expr_1->value < uint_expr_2->value
+            return Value(
+                uint_expr_1.as_uint < uint_expr_2.as_uint
             );
         }
     );
@@ -390,18 +325,12 @@ static std::unique_ptr<CleanFunctionDefinition> le()
         "__le__(uint,uint)",
         params,
         "bool",
-        [](CleanScope* scope)->std::unique_ptr<CleanExpression> {
-            CleanSignedIntExpression* uint_expr_1 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param1__", true)
-                    ->initializer.get()
-            );
-            CleanSignedIntExpression* uint_expr_2 = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param2__", true)
-                    ->initializer.get()
-            );
+        [](NativeArguments args)->Value {
+            Value const& uint_expr_1 = args[0];
+            Value const& uint_expr_2 = args[1];
             
-            return std::make_unique<CleanBoolExpression>(
-                uint_expr_1->value <= uint_expr_2->value
+            return Value(
+                uint_expr_1.as_uint <= uint_expr_2.as_uint
             );
         }
     );
@@ -418,14 +347,11 @@ static std::unique_ptr<CleanFunctionDefinition> bnot()
         "__bnot__(uint)",
         params,
         "void",
-        [](CleanScope* scope)->std::unique_ptr<CleanExpression> {
-            CleanSignedIntExpression* uint_expr = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param__", true)
-                    ->initializer.get()
-            );
+        [](NativeArguments args)->Value {
+            Value const& uint_expr = args[0];
             
-            return std::make_unique<CleanSignedIntExpression>(
-                ~uint_expr->value
+            return Value(
+                ~uint_expr.as_uint
             );
         }
     );
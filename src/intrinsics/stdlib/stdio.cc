@@ -26,135 +26,146 @@
 #include <map>
 
 #include "cleaner/ast/expressions/expression.h"
-#include "cleaner/ast/declarations/variable.h"
 #include "cleaner/ast/definitions/function.h"
 #include "intrinsics/stdlib/stdio.h"
 #include "cleaner/symbols/scope.h"
 #include "utils/intrinsics.h"
+#include "common/native.h"
+#include "common/value.h"
 
 // Print booleans
-static std::unique_ptr<CleanFunctionDefinition> printBool(bool newline)
+template<bool newline>
+static std::unique_ptr<CleanFunctionDefinition> printBool()
 {
     std::map<std::string, std::string> params{
         {"__param__", "bool"}
     };
 
-    return intrinsicGenerator(
+    std::unique_ptr<CleanFunctionDefinition> print = intrinsicGenerator(
         "println(bool)",
         params,
         "void",
-        [newline](CleanScope* scope)->std::unique_ptr<CleanExpression> {
-            CleanBoolExpression* bool_expr = static_cast<CleanBoolExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param__", true)
-                    ->initializer.get()
-            );
+        [](NativeArguments args)->Value {
+            Value const& bool_expr = args[0];
             if (newline)
-                printf("%s\n", bool_expr->value ? "true" : "false");
+                printf("%s\n", bool_expr.as_bool ? "true" : "false");
             else
-                printf("%s", bool_expr->value ? "true" : "false");
-            return nullptr;
+                printf("%s", bool_expr.as_bool ? "true" : "false");
+            return Value();
         }
     );
+
+    // Printing is observable so it can't be cached or moved
+    print->is_pure = false;
+    return print;
 }
 
 // Print signed int
-static std::unique_ptr<CleanFunctionDefinition> printInt(bool newline)
+template<bool newline>
+static std::unique_ptr<CleanFunctionDefinition> printInt()
 {
     std::map<std::string, std::string> params{
         {"__param__", "int"}
     };
 
-    return intrinsicGenerator(
+    std::unique_ptr<CleanFunctionDefinition> print = intrinsicGenerator(
         "print(int)",
         params,
         "void",
-        [newline](CleanScope* scope)->std::unique_ptr<CleanExpression> {
-            CleanSignedIntExpression* int_expr = static_cast<CleanSignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param__", true)
-                        ->initializer.get()
-            );
+        [](NativeArguments args)->Value {
+            Value const& int_expr = args[0];
             if (newline)
-                printf("%" PRIi64 "\n", int_expr->value);
+                printf("%" PRIi64 "\n", int_expr.as_int);
             else
-                printf("%" PRIi64, int_expr->value);
-            return nullptr;
+                printf("%" PRIi64, int_expr.as_int);
+            return Value();
         }
     );
+
+    // Printing is observable so it can't be cached or moved
+    print->is_pure = false;
+    return print;
 }
 
 // Print unsigned int
-static std::unique_ptr<CleanFunctionDefinition> printUint(bool newline)
+template<bool newline>
+static std::unique_ptr<CleanFunctionDefinition> printUint()
 {
     std::map<std::string, std::string> params{
         {"__param__", "uint"}
     };
 
-    return intrinsicGenerator(
+    std::unique_ptr<CleanFunctionDefinition> print = intrinsicGenerator(
         "println(uint)",
         params,
         "void",
-        [newline](CleanScope* scope)->std::unique_ptr<CleanExpression> {
-            CleanUnsignedIntExpression* uint_expr = static_cast<CleanUnsignedIntExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param__", true)
-                    ->initializer.get()
-            );
+        [](NativeArguments args)->Value {
+            Value const& uint_expr = args[0];
             if (newline)
-                printf("%" PRIu64 "\n", uint_expr->value);
+                printf("%" PRIu64 "\n", uint_expr.as_uint);
             else
-                printf("%" PRIu64, uint_expr->value);
-            return nullptr;
+                printf("%" PRIu64, uint_expr.as_uint);
+            return Value();
         }
     );
+
+    // Printing is observable so it can't be cached or moved
+    print->is_pure = false;
+    return print;
 }
 
 // Print float
-static std::unique_ptr<CleanFunctionDefinition> printFloat(bool newline)
+template<bool newline>
+static std::unique_ptr<CleanFunctionDefinition> printFloat()
 {
     std::map<std::string, std::string> params{
         {"__param__", "float"}
     };
 
-    return intrinsicGenerator(
+    std::unique_ptr<CleanFunctionDefinition> print = intrinsicGenerator(
         "println(float)",
         params,
         "void",
-        [newline](CleanScope* scope)->std::unique_ptr<CleanExpression> {
-            CleanFloatExpression* float_expr = static_cast<CleanFloatExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param__", true)
-                    ->initializer.get()
-            );
+        [](NativeArguments args)->Value {
+            Value const& float_expr = args[0];
             if (newline)
-                printf("%f\n",float_expr->value);
+                printf("%f\n",float_expr.as_float);
             else
-                printf("%f",float_expr->value);
-            return nullptr;
+                printf("%f",float_expr.as_float);
+            return Value();
         }
     );
+
+    // Printing is observable so it can't be cached or moved
+    print->is_pure = false;
+    return print;
 }
 
 // Print string
-static std::unique_ptr<CleanFunctionDefinition> printString(bool newline)
+template<bool newline>
+static std::unique_ptr<CleanFunctionDefinition> printString()
 {
     std::map<std::string, std::string> params{
         {"__param__", "string"}
     };
 
-    return intrinsicGenerator(
+    std::unique_ptr<CleanFunctionDefinition> print = intrinsicGenerator(
         "println(string)",
         params,
         "void",
-        [newline](CleanScope* scope)->std::unique_ptr<CleanExpression> {
-            CleanStringExpression* string_expr = static_cast<CleanStringExpression*>(
-                scope->getSymbol<CleanVariableDefinition>("__param__", true)
-                    ->initializer.get()
-            );
+        [](NativeArguments args)->Value {
+            Value const& string_expr = args[0];
             if (newline)
-                printf("%s\n", string_expr->value.c_str());
+                printf("%s\n", string_expr.as_string->c_str());
             else
-                printf("%s", string_expr->value.c_str());
-            return nullptr;
+                printf("%s", string_expr.as_string->c_str());
+            return Value();
         }
     );
+
+    // Printing is observable so it can't be cached or moved
+    print->is_pure = false;
+    return print;
 }
 
 /**
@@ -165,42 +176,42 @@ Stdio::load(CleanScope* scope)
 {
     scope->addSymbol<CleanFunctionDefinition>(
         "print(bool)",
-        printBool(false)
+        printBool<false>()
     );
     scope->addSymbol<CleanFunctionDefinition>(
         "println(bool)",
-        printBool(true)
+        printBool<true>()
     );
     scope->addSymbol<CleanFunctionDefinition>(
         "print(int)",
-        printInt(false)
+        printInt<false>()
     );
     scope->addSymbol<CleanFunctionDefinition>(
         "println(int)",
-        printInt(true)
+        printInt<true>()
     );
     scope->addSymbol<CleanFunctionDefinition>(
         "print(uint)",
-        printUint(false)
+        printUint<false>()
     );
     scope->addSymbol<CleanFunctionDefinition>(
         "println(uint)",
-        printUint(true)
+        printUint<true>()
     );
     scope->addSymbol<CleanFunctionDefinition>(
         "print(float)",
-        printFloat(false)
+        printFloat<false>()
     );
     scope->addSymbol<CleanFunctionDefinition>(
         "println(float)",
-        printFloat(true)
+        printFloat<true>()
     );
     scope->addSymbol<CleanFunctionDefinition>(
         "print(string)",
-        printString(false)
+        printString<false>()
     );
     scope->addSymbol<CleanFunctionDefinition>(
         "println(string)",
-        printString(true)
+        printString<true>()
     );
 }
@@ -0,0 +1,288 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <algorithm>
+#include <iterator>
+#include <cstddef>
+#include <vector>
+#include <map>
+#include <set>
+
+#include "ir/allocator.h"
+#include "ir/ir.h"
+
+
+static bool definesValue(IRInstruction* instr);
+
+RegisterAllocator::RegisterAllocator(
+    IRFunction& function
+) : function(function),
+    register_limit(0)
+{}
+
+RegisterAllocator::RegisterAllocator(
+    IRFunction& function,
+    std::size_t register_limit
+) : function(function),
+    register_limit(register_limit)
+{}
+
+/**
+ * Gives every instruction that produces a value a register,
+ * values live at the same time getting different registers.
+ *
+ * Parameters keep the register of their index. Phis are expected
+ * to be copied at the end of their predecessors, so critical edges
+ * must have been split first. The copies into the phis of a block
+ * happen all at once, so a phi only lives until its last use.
+ *
+ * This is linear scan over the span from the first definition to the
+ * last use of each value. Without a limit there are as many registers as
+ * needed, with one the value whose span ends last goes to the stack
+ * when they are all taken.
+ */
+RegisterAllocation
+RegisterAllocator::allocate()
+{
+    numberInstructions();
+    buildIntervals();
+
+    RegisterAllocation allocation;
+    allocation.order = order;
+
+    std::vector<Interval> sorted;
+    for (auto& [value, interval]: intervals)
+        sorted.push_back(interval);
+    std::sort(
+        sorted.begin(),
+        sorted.end(),
+        [](Interval const& left, Interval const& right) {
+            if (left.start != right.start)
+                return left.start < right.start;
+            return left.value->id < right.value->id;
+        }
+    );
+
+    // Parameters already sit in the first registers unless registers are limited
+    bool pin_params = register_limit == 0;
+    std::size_t param_count = pin_params ? function.fun_def->parameters.size() : 0;
+    std::size_t next_register = param_count;
+    std::set<std::size_t> free_registers;
+    std::multimap<std::size_t, std::size_t> active;     /* End of the interval to its register. */
+    std::map<std::size_t, IRInstruction*> holders;      /* Value each active register holds. */
+    for (Interval& interval: sorted) {
+        if (interval.value->opcode != IROpcode::Param || ! pin_params)
+            continue;
+        allocation.registers[interval.value] = interval.value->index;
+        active.emplace(interval.end, interval.value->index);
+    }
+
+    for (Interval& interval: sorted) {
+        if (interval.value->opcode == IROpcode::Param && pin_params)
+            continue;
+        if (interval.value->opcode == IROpcode::Const && register_limit)
+            continue;
+
+        // Registers of values whose span ended are free again,
+        // operands are read before the result is written
+        while (active.size() && active.begin()->first <= interval.start) {
+            free_registers.insert(active.begin()->second);
+            active.erase(active.begin());
+        }
+
+        // A phi and the values flowing into it share a register if they can,
+        // which saves the copy at the end of the predecessor
+        std::size_t reg = next_register;
+        auto hint = std::find_if(
+            hints[interval.value].begin(),
+            hints[interval.value].end(),
+            [&](IRInstruction* value) {
+                return allocation.registers.count(value) &&
+                    free_registers.count(allocation.registers[value]);
+            }
+        );
+        if (hint != hints[interval.value].end()) {
+            reg = allocation.registers[*hint];
+            free_registers.erase(reg);
+        }
+        else if (free_registers.size()) {
+            reg = *free_registers.begin();
+            free_registers.erase(free_registers.begin());
+        }
+        else if (register_limit == 0 || next_register < register_limit) {
+            next_register++;
+        }
+        else {
+            // All registers are taken, the value used last goes to the stack
+            auto last = std::prev(active.end());
+            if (last->first <= interval.end) {
+                allocation.spills[interval.value] = allocation.spill_count++;
+                continue;
+            }
+
+            reg = last->second;
+            IRInstruction* spilled = holders[reg];
+            allocation.registers.erase(spilled);
+            allocation.spills[spilled] = allocation.spill_count++;
+            active.erase(last);
+        }
+
+        allocation.registers[interval.value] = reg;
+        active.emplace(interval.end, reg);
+        holders[reg] = interval.value;
+    }
+
+    allocation.register_count = next_register;
+    return allocation;
+}
+
+// Positions
+void
+RegisterAllocator::numberInstructions()
+{
+    // Phis are defined where their block starts,
+    // the terminator is where values leave the block
+    order = reversePostorder(function);
+    std::size_t next = 0;
+    for (IRBlock* block: order) {
+        block_start[block] = next++;
+        for (auto& instr: block->instructions) {
+            if (instr->opcode == IROpcode::Phi)
+                position[instr.get()] = block_start[block];
+            else
+                position[instr.get()] = next++;
+        }
+        block_end[block] = block->terminator()
+            ? position[block->terminator()]
+            : next++;
+    }
+}
+
+// Liveness
+void
+RegisterAllocator::buildIntervals()
+{
+    // Upward exposed uses and definitions of every block
+    std::map<IRBlock*, std::set<IRInstruction*>> uses;
+    std::map<IRBlock*, std::set<IRInstruction*>> defs;
+    for (IRBlock* block: order) {
+        for (auto& instr: block->instructions) {
+            if (instr->opcode != IROpcode::Phi) {
+                for (IRInstruction* operand: instr->operands) {
+                    if (defs[block].count(operand) == 0)
+                        uses[block].insert(operand);
+                }
+            }
+            defs[block].insert(instr.get());
+        }
+    }
+
+    // Values live out of a block are live into its successors
+    // or flow into the phis of its successors
+    std::map<IRBlock*, std::set<IRInstruction*>> live_in;
+    std::map<IRBlock*, std::set<IRInstruction*>> live_out;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (auto it = order.rbegin(); it != order.rend(); ++it) {
+            IRBlock* block = *it;
+            std::set<IRInstruction*> out;
+            for (IRBlock* successor: block->successors()) {
+                out.insert(live_in[successor].begin(), live_in[successor].end());
+
+                std::size_t index = std::find(
+                    successor->predecessors.begin(),
+                    successor->predecessors.end(),
+                    block
+                ) - successor->predecessors.begin();
+                for (auto& instr: successor->instructions) {
+                    if (instr->opcode != IROpcode::Phi)
+                        break;
+                    out.insert(instr->operands[index]);
+                }
+            }
+
+            std::set<IRInstruction*> in = uses[block];
+            for (IRInstruction* value: out) {
+                if (defs[block].count(value) == 0)
+                    in.insert(value);
+            }
+
+            if (in != live_in[block] || out != live_out[block]) {
+                live_in[block] = std::move(in);
+                live_out[block] = std::move(out);
+                changed = true;
+            }
+        }
+    }
+
+    for (IRBlock* block: order) {
+        for (IRInstruction* value: live_in[block])
+            extend(value, block_start[block]);
+        for (IRInstruction* value: live_out[block])
+            extend(value, block_end[block]);
+
+        for (auto& instr: block->instructions) {
+            if (definesValue(instr.get()))
+                extend(instr.get(), position[instr.get()]);
+            if (instr->opcode == IROpcode::Phi) {
+                for (IRInstruction* operand: instr->operands) {
+                    hints[operand].push_back(instr.get());
+                    hints[instr.get()].push_back(operand);
+                }
+                continue;
+            }
+            for (IRInstruction* operand: instr->operands)
+                extend(operand, position[instr.get()]);
+        }
+    }
+
+    // Parameters hold their argument from the start
+    for (auto& [value, interval]: intervals) {
+        if (value->opcode == IROpcode::Param)
+            interval.start = 0;
+    }
+}
+
+void
+RegisterAllocator::extend(IRInstruction* value, std::size_t at)
+{
+    auto it = intervals.find(value);
+    if (it == intervals.end()) {
+        intervals.emplace(value, Interval{value, at, at});
+        return;
+    }
+
+    it->second.start = std::min(it->second.start, at);
+    it->second.end = std::max(it->second.end, at);
+}
+
+// Whether the instruction computes a value that needs a register
+static bool
+definesValue(IRInstruction* instr)
+{
+    switch (instr->opcode) {
+        case IROpcode::StoreGlobal:
+        case IROpcode::Jump:
+        case IROpcode::Branch:
+        case IROpcode::Return:
+            return false;
+
+        default:
+            return true;
+    }
+}
@@ -0,0 +1,729 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdexcept>
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <memory>
+#include <vector>
+#include <string>
+#include <map>
+#include <set>
+
+#include "cleaner/ast/expressions/expression.h"
+#include "cleaner/ast/definitions/function.h"
+#include "cleaner/ast/definitions/variable.h"
+#include "cleaner/ast/statements/statement.h"
+#include "cleaner/ast/declarations/type.h"
+#include "cleaner/ast/statements/return.h"
+#include "cleaner/ast/statements/while.h"
+#include "cleaner/ast/statements/block.h"
+#include "cleaner/ast/statements/for.h"
+#include "cleaner/ast/statements/if.h"
+#include "cleaner/symbols/scope.h"
+#include "common/operation.h"
+#include "common/value.h"
+#include "ir/builder.h"
+#include "ir/ir.h"
+
+
+static Value literalValue(CleanExpression* expr);
+static enum ValueType operationType(enum Operation operation);
+static enum ValueType typeOf(CleanTypeDeclaration* type_decl);
+
+IRBuilder::IRBuilder(
+    CleanScope* scope
+) : scope(scope),
+    function(nullptr),
+    current(nullptr),
+    undefined(nullptr)
+{}
+
+/**
+ * Lowers every user function in the global scope to SSA form.
+ *
+ * The program must have gone through the resolver and the linker.
+ * Local variable slots become SSA values, global variables stay in memory.
+ *
+ * Phis are placed while the control flow graph is built, following
+ * "Simple and Efficient Construction of Static Single Assignment Form"
+ * by Braun et al: a block is sealed once all its predecessors are known
+ * and the phis that turn out to merge a single value are removed.
+ */
+IRModule
+IRBuilder::build()
+{
+    // Global variables are initialized with literals
+    std::map<std::string,std::unique_ptr<CleanVariableDefinition>>& var_defs =
+        scope->getSymbols<CleanVariableDefinition>();
+    module.globals.resize(var_defs.size());
+    global_types.resize(var_defs.size());
+    for (auto& [name, var_def]: var_defs) {
+        module.globals[var_def->slot] = literalValue(var_def->initializer.get());
+        global_types[var_def->slot] = typeOf(var_def->type.get());
+    }
+
+    for (auto& [name, fun_def]: scope->getSymbols<CleanFunctionDefinition>()) {
+        if (! fun_def->is_intrinsic)
+            buildFunction(fun_def.get());
+    }
+
+    return std::move(module);
+}
+
+// Function definitions
+void
+IRBuilder::buildFunction(CleanFunctionDefinition* fun_def)
+{
+    module.functions.push_back(std::make_unique<IRFunction>(fun_def->name, fun_def));
+    function = module.functions.back().get();
+    undefined = nullptr;
+    definitions.clear();
+    incomplete_phis.clear();
+    sealed.clear();
+    replaced.clear();
+
+    // Parameters occupy the first slots
+    current = function->addBlock();
+    sealBlock(current);
+    for (std::size_t i = 0; i < fun_def->parameters.size(); ++i) {
+        std::unique_ptr<IRInstruction> param = std::make_unique<IRInstruction>(
+            IROpcode::Param,
+            typeOf(fun_def->parameters[i]->type.get())
+        );
+        param->index = i;
+        writeVariable(i, current, emit(std::move(param)));
+    }
+
+    buildBlock(fun_def->body.get());
+
+    // Functions that don't return a value may run off their body
+    if (current->terminator() == nullptr)
+        emit(std::make_unique<IRInstruction>(IROpcode::Return, ValueType::Void));
+
+    removeUnreachableBlocks(*function);
+    inferPhiTypes();
+    graveyard.clear();
+    function = nullptr;
+}
+
+// Statements
+void
+IRBuilder::buildStatement(CleanStatement* stmt)
+{
+    switch (stmt->type) {
+        case CleanStatementType::Block:
+            buildBlock(static_cast<CleanBlockStatement*>(stmt));
+            break;
+
+        case CleanStatementType::If:
+            buildIf(static_cast<CleanIfStatement*>(stmt));
+            break;
+
+        case CleanStatementType::For:
+            buildFor(static_cast<CleanForStatement*>(stmt));
+            break;
+
+        case CleanStatementType::While:
+            buildWhile(static_cast<CleanWhileStatement*>(stmt));
+            break;
+
+        case CleanStatementType::Break:
+            jump(loops.back().break_target);
+            startUnreachableBlock();
+            break;
+
+        case CleanStatementType::Continue:
+            jump(loops.back().continue_target);
+            startUnreachableBlock();
+            break;
+
+        case CleanStatementType::Return:
+            buildReturn(static_cast<CleanReturnStatement*>(stmt));
+            startUnreachableBlock();
+            break;
+
+        case CleanStatementType::Expression:
+            buildExpression(static_cast<CleanExpression*>(stmt));
+            break;
+
+        default:
+            throw std::runtime_error(
+                "IR construction failed: unknow statement type."
+            );
+    }
+}
+
+// Blocks
+void
+IRBuilder::buildBlock(CleanBlockStatement* block_stmt)
+{
+    for (auto& statement: block_stmt->statements)
+        buildStatement(statement.get());
+}
+
+// If
+void
+IRBuilder::buildIf(CleanIfStatement* if_stmt)
+{
+    IRInstruction* condition = buildExpression(if_stmt->condition.get());
+    IRBlock* body = function->addBlock();
+    IRBlock* next = function->addBlock();
+    IRBlock* end = function->addBlock();
+    branch(condition, body, next);
+    sealBlock(body);
+    sealBlock(next);
+    current = body;
+    buildBlock(if_stmt->body.get());
+    jump(end);
+    current = next;
+
+    for (auto& elif_branch: if_stmt->elif_branches) {
+        condition = buildExpression(elif_branch->condition.get());
+        body = function->addBlock();
+        next = function->addBlock();
+        branch(condition, body, next);
+        sealBlock(body);
+        sealBlock(next);
+        current = body;
+        buildBlock(elif_branch->body.get());
+        jump(end);
+        current = next;
+    }
+
+    if (if_stmt->else_branch)
+        buildBlock(if_stmt->else_branch->body.get());
+    jump(end);
+
+    sealBlock(end);
+    current = end;
+}
+
+// For
+void
+IRBuilder::buildFor(CleanForStatement* for_stmt)
+{
+    if (for_stmt->init_clause)
+        buildExpression(for_stmt->init_clause.get());
+
+    // The header stays open until the back edge is known
+    IRBlock* header = function->addBlock();
+    IRBlock* body = function->addBlock();
+    IRBlock* incr = function->addBlock();
+    IRBlock* exit = function->addBlock();
+    jump(header);
+    current = header;
+    if (for_stmt->term_clause)
+        branch(buildExpression(for_stmt->term_clause.get()), body, exit);
+    else
+        jump(body);
+    sealBlock(body);
+
+    loops.push_back(Loop{exit, incr});
+    current = body;
+    buildBlock(for_stmt->body.get());
+    jump(incr);
+    loops.pop_back();
+
+    // Continue statements resume at the increment clause
+    sealBlock(incr);
+    current = incr;
+    if (for_stmt->incr_clause)
+        buildExpression(for_stmt->incr_clause.get());
+    jump(header);
+    sealBlock(header);
+
+    sealBlock(exit);
+    current = exit;
+}
+
+// While
+void
+IRBuilder::buildWhile(CleanWhileStatement* while_stmt)
+{
+    IRBlock* header = function->addBlock();
+    IRBlock* body = function->addBlock();
+    IRBlock* exit = function->addBlock();
+    jump(header);
+    current = header;
+    if (while_stmt->condition)
+        branch(buildExpression(while_stmt->condition.get()), body, exit);
+    else
+        jump(body);
+    sealBlock(body);
+
+    // Continue statements go back to the condition
+    loops.push_back(Loop{exit, header});
+    current = body;
+    buildBlock(while_stmt->body.get());
+    jump(header);
+    loops.pop_back();
+    sealBlock(header);
+
+    sealBlock(exit);
+    current = exit;
+}
+
+// Return
+void
+IRBuilder::buildReturn(CleanReturnStatement* ret_stmt)
+{
+    std::unique_ptr<IRInstruction> ret =
+        std::make_unique<IRInstruction>(IROpcode::Return, ValueType::Void);
+    if (ret_stmt->expression)
+        ret->operands.push_back(buildExpression(ret_stmt->expression.get()));
+    emit(std::move(ret));
+}
+
+// Expressions
+IRInstruction*
+IRBuilder::buildExpression(CleanExpression* expr)
+{
+    switch (expr->type) {
+        case CleanExpressionType::Boolean:
+        case CleanExpressionType::SignedInt:
+        case CleanExpressionType::UnsignedInt:
+        case CleanExpressionType::Float:
+        case CleanExpressionType::String:
+            return buildConstant(literalValue(expr));
+
+        case CleanExpressionType::Variable: {
+            CleanVariableExpression* var_expr =
+                static_cast<CleanVariableExpression*>(expr);
+            if (var_expr->depth == 0)
+                return readVariable(var_expr->slot, current);
+
+            std::unique_ptr<IRInstruction> load = std::make_unique<IRInstruction>(
+                IROpcode::LoadGlobal,
+                global_types[var_expr->slot]
+            );
+            load->index = var_expr->slot;
+            return emit(std::move(load));
+        }
+
+        case CleanExpressionType::Group:
+            return buildExpression(
+                static_cast<CleanGroupExpression*>(expr)->expression.get()
+            );
+
+        case CleanExpressionType::Call:
+            return buildCall(static_cast<CleanCallExpression*>(expr));
+
+        case CleanExpressionType::TernaryIf:
+            return buildTernaryIf(static_cast<CleanTernaryIfExpression*>(expr));
+
+        case CleanExpressionType::Operation:
+            return buildOperation(static_cast<CleanOperationExpression*>(expr));
+
+        case CleanExpressionType::Assignment:
+            return buildAssignment(static_cast<CleanAssignmentExpression*>(expr));
+
+        default:
+            throw std::runtime_error(
+                "IR construction failed: unknow expression type."
+            );
+    }
+}
+
+IRInstruction*
+IRBuilder::buildCall(CleanCallExpression* call_expr)
+{
+    std::vector<IRInstruction*> arguments;
+    for (auto& argument: call_expr->arguments)
+        arguments.push_back(buildExpression(argument.get()));
+
+    std::unique_ptr<IRInstruction> call = std::make_unique<IRInstruction>(
+        IROpcode::Call,
+        typeOf(call_expr->fun_def->return_type.get())
+    );
+    call->operands = std::move(arguments);
+    call->callee = call_expr->fun_def;
+    call->is_tail_call = call_expr->is_tail_call;
+    return emit(std::move(call));
+}
+
+IRInstruction*
+IRBuilder::buildTernaryIf(CleanTernaryIfExpression* ternif_expr)
+{
+    IRInstruction* condition = buildExpression(ternif_expr->condition.get());
+    IRBlock* then_block = function->addBlock();
+    IRBlock* else_block = function->addBlock();
+    IRBlock* end = function->addBlock();
+    branch(condition, then_block, else_block);
+    sealBlock(then_block);
+    sealBlock(else_block);
+
+    current = then_block;
+    IRInstruction* then_value = buildExpression(ternif_expr->then_branch.get());
+    jump(end);
+    current = else_block;
+    IRInstruction* else_value = buildExpression(ternif_expr->else_branch.get());
+    jump(end);
+    sealBlock(end);
+    current = end;
+
+    // The predecessors of the end block are the ends of both branches, in order
+    IRInstruction* phi = createPhi(end);
+    phi->type = then_value->type;
+    phi->operands.push_back(then_value);
+    phi->operands.push_back(else_value);
+    for (IRInstruction*& operand: phi->operands) {
+        while (replaced.count(operand))
+            operand = replaced[operand];
+    }
+    return phi;
+}
+
+IRInstruction*
+IRBuilder::buildOperation(CleanOperationExpression* op_expr)
+{
+    std::unique_ptr<IRInstruction> operation = std::make_unique<IRInstruction>(
+        IROpcode::Operation,
+        operationType(op_expr->operation)
+    );
+    operation->operation = op_expr->operation;
+    for (auto& operand: op_expr->operands)
+        operation->operands.push_back(buildExpression(operand.get()));
+    return emit(std::move(operation));
+}
+
+IRInstruction*
+IRBuilder::buildAssignment(CleanAssignmentExpression* assign_expr)
+{
+    CleanVariableExpression* lvalue_expr =
+        static_cast<CleanVariableExpression*>(assign_expr->lvalue.get());
+    IRInstruction* value = buildExpression(assign_expr->rvalue.get());
+
+    if (lvalue_expr->depth == 0) {
+        writeVariable(lvalue_expr->slot, current, value);
+        return value;
+    }
+
+    std::unique_ptr<IRInstruction> store =
+        std::make_unique<IRInstruction>(IROpcode::StoreGlobal, ValueType::Void);
+    store->index = lvalue_expr->slot;
+    store->operands.push_back(value);
+    emit(std::move(store));
+    return value;
+}
+
+IRInstruction*
+IRBuilder::buildConstant(Value value)
+{
+    std::unique_ptr<IRInstruction> constant =
+        std::make_unique<IRInstruction>(IROpcode::Const, value.type);
+    constant->value = value;
+    return emit(std::move(constant));
+}
+
+// Control flow
+IRInstruction*
+IRBuilder::emit(std::unique_ptr<IRInstruction> instr)
+{
+    // Operands built earlier may be phis removed since
+    for (IRInstruction*& operand: instr->operands) {
+        while (replaced.count(operand))
+            operand = replaced[operand];
+    }
+
+    return function->append(current, std::move(instr));
+}
+
+void
+IRBuilder::jump(IRBlock* target)
+{
+    std::unique_ptr<IRInstruction> jump =
+        std::make_unique<IRInstruction>(IROpcode::Jump, ValueType::Void);
+    jump->targets.push_back(target);
+    emit(std::move(jump));
+    target->predecessors.push_back(current);
+}
+
+void
+IRBuilder::branch(
+    IRInstruction* condition,
+    IRBlock* then_target,
+    IRBlock* else_target
+)
+{
+    std::unique_ptr<IRInstruction> branch =
+        std::make_unique<IRInstruction>(IROpcode::Branch, ValueType::Void);
+    branch->operands.push_back(condition);
+    branch->targets.push_back(then_target);
+    branch->targets.push_back(else_target);
+    emit(std::move(branch));
+    then_target->predecessors.push_back(current);
+    else_target->predecessors.push_back(current);
+}
+
+// Statements after a return, break or continue go in a block nothing jumps to
+void
+IRBuilder::startUnreachableBlock()
+{
+    current = function->addBlock();
+    sealBlock(current);
+}
+
+// SSA construction
+void
+IRBuilder::writeVariable(
+    std::size_t slot,
+    IRBlock* block,
+    IRInstruction* value
+)
+{
+    definitions[block][slot] = value;
+}
+
+IRInstruction*
+IRBuilder::readVariable(std::size_t slot, IRBlock* block)
+{
+    Definitions& block_definitions = definitions[block];
+    auto it = block_definitions.find(slot);
+    if (it != block_definitions.end())
+        return it->second;
+
+    return readVariableRecursive(slot, block);
+}
+
+// Find the value of a slot in the predecessors of a block
+IRInstruction*
+IRBuilder::readVariableRecursive(std::size_t slot, IRBlock* block)
+{
+    IRInstruction* value = nullptr;
+    if (sealed.count(block) == 0) {
+        // Operands are added once all predecessors are known
+        value = createPhi(block);
+        incomplete_phis[block][slot] = value;
+    }
+    else if (block->predecessors.size() == 1) {
+        value = readVariable(slot, block->predecessors[0]);
+    }
+    else {
+        // The phi is recorded first to stop the search around loops
+        IRInstruction* phi = createPhi(block);
+        writeVariable(slot, block, phi);
+        value = addPhiOperands(slot, phi);
+    }
+
+    writeVariable(slot, block, value);
+    return value;
+}
+
+IRInstruction*
+IRBuilder::addPhiOperands(std::size_t slot, IRInstruction* phi)
+{
+    for (IRBlock* predecessor: phi->block->predecessors)
+        phi->operands.push_back(readVariable(slot, predecessor));
+
+    return tryRemoveTrivialPhi(phi);
+}
+
+// Replace a phi whose operands are all the same value, or itself, by that value
+IRInstruction*
+IRBuilder::tryRemoveTrivialPhi(IRInstruction* phi)
+{
+    IRInstruction* same = nullptr;
+    for (IRInstruction* operand: phi->operands) {
+        if (operand == same || operand == phi)
+            continue;
+        if (same != nullptr)
+            return phi;
+        same = operand;
+    }
+
+    // Only an unreachable path or the phi itself leads here
+    if (same == nullptr)
+        same = undefinedValue();
+
+    std::vector<IRInstruction*> users;
+    for (auto& block: function->blocks) {
+        for (auto& instr: block->instructions) {
+            if (instr.get() == phi)
+                continue;
+
+            bool uses = false;
+            for (IRInstruction*& operand: instr->operands) {
+                if (operand == phi) {
+                    operand = same;
+                    uses = true;
+                }
+            }
+            if (uses && instr->opcode == IROpcode::Phi)
+                users.push_back(instr.get());
+        }
+    }
+
+    for (auto& [block, block_definitions]: definitions) {
+        for (auto& [slot, value]: block_definitions) {
+            if (value == phi)
+                value = same;
+        }
+    }
+
+    // Keep the phi alive until the function is built in case a caller still holds it
+    std::vector<std::unique_ptr<IRInstruction>>& instructions = phi->block->instructions;
+    for (auto it = instructions.begin(); it != instructions.end(); ++it) {
+        if (it->get() == phi) {
+            graveyard.push_back(std::move(*it));
+            instructions.erase(it);
+            break;
+        }
+    }
+    replaced[phi] = same;
+
+    // Phis that used this one may have become trivial
+    for (IRInstruction* user: users) {
+        if (replaced.count(user) == 0)
+            tryRemoveTrivialPhi(user);
+    }
+
+    while (replaced.count(same))
+        same = replaced[same];
+    return same;
+}
+
+IRInstruction*
+IRBuilder::createPhi(IRBlock* block)
+{
+    return function->insert(
+        block,
+        0,
+        std::make_unique<IRInstruction>(IROpcode::Phi, ValueType::Void)
+    );
+}
+
+// Slots read on a path that never assigned them get a value no one looks at
+IRInstruction*
+IRBuilder::undefinedValue()
+{
+    if (undefined)
+        return undefined;
+
+    IRBlock* entry = function->blocks.front().get();
+    undefined = function->insert(
+        entry,
+        function->fun_def->parameters.size(),
+        std::make_unique<IRInstruction>(IROpcode::Const, ValueType::Void)
+    );
+    return undefined;
+}
+
+void
+IRBuilder::sealBlock(IRBlock* block)
+{
+    // Reading a slot in a predecessor may open phis for it in this block again
+    while (incomplete_phis[block].size()) {
+        Definitions phis = std::move(incomplete_phis[block]);
+        incomplete_phis[block].clear();
+        for (auto& [slot, phi]: phis)
+            addPhiOperands(slot, phi);
+    }
+
+    sealed.insert(block);
+}
+
+// Phis take the type of the values they merge
+void
+IRBuilder::inferPhiTypes()
+{
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (auto& block: function->blocks) {
+            for (auto& instr: block->instructions) {
+                if (instr->opcode != IROpcode::Phi || instr->type != ValueType::Void)
+                    continue;
+
+                for (IRInstruction* operand: instr->operands) {
+                    if (operand->type != ValueType::Void) {
+                        instr->type = operand->type;
+                        changed = true;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Returns the value of a literal expression
+static Value
+literalValue(CleanExpression* expr)
+{
+    switch (expr->type) {
+        case CleanExpressionType::Boolean:
+            return Value(static_cast<CleanBoolExpression*>(expr)->value);
+
+        case CleanExpressionType::SignedInt:
+            return Value(static_cast<CleanSignedIntExpression*>(expr)->value);
+
+        case CleanExpressionType::UnsignedInt:
+            return Value(static_cast<CleanUnsignedIntExpression*>(expr)->value);
+
+        case CleanExpressionType::Float:
+            return Value(static_cast<CleanFloatExpression*>(expr)->value);
+
+        case CleanExpressionType::String:
+            return Value(&static_cast<CleanStringExpression*>(expr)->value);
+
+        default:
+            throw std::runtime_error(
+                "IR construction failed: expected a literal expression."
+            );
+    }
+}
+
+// Returns the type of the result of an operation
+static enum ValueType
+operationType(enum Operation operation)
+{
+    switch (operation) {
+        case Operation::EqI64: case Operation::NeI64: case Operation::GtI64:
+        case Operation::GeI64: case Operation::LtI64: case Operation::LeI64:
+        case Operation::EqU64: case Operation::NeU64: case Operation::GtU64:
+        case Operation::GeU64: case Operation::LtU64: case Operation::LeU64:
+        case Operation::EqF64: case Operation::NeF64: case Operation::GtF64:
+        case Operation::GeF64: case Operation::LtF64: case Operation::LeF64:
+        case Operation::NotBool:
+        case Operation::EqBool: case Operation::NeBool:
+            return ValueType::Boolean;
+
+        case Operation::AddU64: case Operation::SubU64: case Operation::MulU64:
+        case Operation::DivU64: case Operation::RemU64: case Operation::NegU64:
+        case Operation::BnotU64:
+            return ValueType::UnsignedInt;
+
+        case Operation::AddF64: case Operation::SubF64: case Operation::MulF64:
+        case Operation::DivF64: case Operation::NegF64:
+            return ValueType::Float;
+
+        default:
+            return ValueType::SignedInt;
+    }
+}
+
+// Returns the type of the values of a declared type, void if there is none
+static enum ValueType
+typeOf(CleanTypeDeclaration* type_decl)
+{
+    if (type_decl == nullptr)
+        return ValueType::Void;
+
+    return irTypeOf(static_cast<CleanSimpleTypeDeclaration*>(type_decl)->name);
+}
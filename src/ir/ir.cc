@@ -0,0 +1,567 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <utility>
+#include <memory>
+#include <vector>
+#include <string>
+#include <map>
+#include <set>
+
+#include "cleaner/ast/definitions/function.h"
+#include "common/operation.h"
+#include "common/value.h"
+#include "ir/ir.h"
+
+
+static std::string valueToString(Value const& value);
+
+// Blocks
+/**
+ * Returns the last instruction if it ends the block, null otherwise.
+ */
+IRInstruction*
+IRBlock::terminator() const
+{
+    if (instructions.empty())
+        return nullptr;
+
+    IRInstruction* last = instructions.back().get();
+    if (
+        last->opcode == IROpcode::Jump      ||
+        last->opcode == IROpcode::Branch    ||
+        last->opcode == IROpcode::Return
+    )
+        return last;
+
+    return nullptr;
+}
+
+/**
+ * Returns the blocks control may go to after this one.
+ */
+std::vector<IRBlock*>
+IRBlock::successors() const
+{
+    IRInstruction* last = terminator();
+    if (last == nullptr)
+        return {};
+
+    return last->targets;
+}
+
+// Functions
+/**
+ * Appends a new empty block.
+ */
+IRBlock*
+IRFunction::addBlock()
+{
+    blocks.push_back(std::make_unique<IRBlock>(next_block++));
+    return blocks.back().get();
+}
+
+/**
+ * Inserts the given instruction at the given position of the block.
+ */
+IRInstruction*
+IRFunction::insert(
+    IRBlock* block,
+    std::size_t position,
+    std::unique_ptr<IRInstruction> instr
+)
+{
+    instr->id = next_id++;
+    instr->block = block;
+    return block->instructions.insert(
+        block->instructions.begin() + position,
+        std::move(instr)
+    )->get();
+}
+
+/**
+ * Appends the given instruction to the block.
+ */
+IRInstruction*
+IRFunction::append(IRBlock* block, std::unique_ptr<IRInstruction> instr)
+{
+    return insert(block, block->instructions.size(), std::move(instr));
+}
+
+// Printing
+/**
+ * Returns the string representation of an opcode.
+ *
+ * @param       opcode the opcode to get the string representation of.
+ *
+ * @return      the string representation of the opcode.
+ */
+std::string
+irOpcodeToString(enum IROpcode opcode)
+{
+    char const * opcodes[] = {
+        "CONST",
+        "PARAM",
+        "LOAD_GLOBAL",
+        "STORE_GLOBAL",
+        "OPERATION",
+        "CALL",
+        "PHI",
+        "COPY",
+        "JUMP",
+        "BRANCH",
+        "RETURN"
+    };
+
+    return std::string(opcodes[(int) opcode]);
+}
+
+/**
+ * Returns the name Proto gives to the type of values of the given type.
+ */
+std::string
+irTypeToString(enum ValueType type)
+{
+    switch (type) {
+        case ValueType::Boolean:
+            return "bool";
+
+        case ValueType::SignedInt:
+            return "int";
+
+        case ValueType::UnsignedInt:
+            return "uint";
+
+        case ValueType::Float:
+            return "float";
+
+        case ValueType::String:
+            return "string";
+
+        default:
+            return "void";
+    }
+}
+
+/**
+ * Returns the type of the values of the given Proto type.
+ */
+enum ValueType
+irTypeOf(std::string const& type_name)
+{
+    if (type_name == "bool")
+        return ValueType::Boolean;
+    if (type_name == "int")
+        return ValueType::SignedInt;
+    if (type_name == "uint")
+        return ValueType::UnsignedInt;
+    if (type_name == "float")
+        return ValueType::Float;
+    if (type_name == "string")
+        return ValueType::String;
+    return ValueType::Void;
+}
+
+/**
+ * Returns a human readable listing of the given function.
+ */
+std::string
+printFunction(IRFunction const& function)
+{
+    std::ostringstream listing;
+    listing << "function " << function.name << " {\n";
+
+    for (auto& block: function.blocks) {
+        listing << "b" << block->id << ":";
+        if (block->predecessors.size()) {
+            listing << " ; from";
+            for (IRBlock* predecessor: block->predecessors)
+                listing << " b" << predecessor->id;
+        }
+        listing << "\n";
+
+        for (auto& instr: block->instructions) {
+            listing << "    ";
+            if (instr->type != ValueType::Void)
+                listing << "%" << instr->id << " = ";
+
+            switch (instr->opcode) {
+                case IROpcode::Operation:
+                    listing << operationToString(instr->operation);
+                    break;
+
+                default:
+                    listing << irOpcodeToString(instr->opcode);
+                    break;
+            }
+
+            if (instr->type != ValueType::Void)
+                listing << " " << irTypeToString(instr->type);
+
+            switch (instr->opcode) {
+                case IROpcode::Const:
+                    listing << " " << valueToString(instr->value);
+                    break;
+
+                case IROpcode::Param:
+                case IROpcode::LoadGlobal:
+                case IROpcode::StoreGlobal:
+                    listing << " " << instr->index;
+                    break;
+
+                case IROpcode::Call:
+                    listing << (instr->is_tail_call ? " tail " : " ") << instr->callee->name;
+                    break;
+
+                default:
+                    break;
+            }
+
+            for (std::size_t i = 0; i < instr->operands.size(); ++i) {
+                listing << (i ? ", " : " ");
+                if (instr->opcode == IROpcode::Phi)
+                    listing << "[%" << instr->operands[i]->id
+                            << ", b" << block->predecessors[i]->id << "]";
+                else
+                    listing << "%" << instr->operands[i]->id;
+            }
+
+            for (std::size_t i = 0; i < instr->targets.size(); ++i)
+                listing << (i || instr->operands.size() ? ", " : " ") << "b" << instr->targets[i]->id;
+
+            listing << "\n";
+        }
+    }
+
+    listing << "}\n";
+    return listing.str();
+}
+
+/**
+ * Returns a human readable listing of the given module.
+ */
+std::string
+printModule(IRModule const& module)
+{
+    std::ostringstream listing;
+    for (std::size_t slot = 0; slot < module.globals.size(); ++slot)
+        listing << "global " << slot << " = " << irTypeToString(module.globals[slot].type)
+                << " " << valueToString(module.globals[slot]) << "\n";
+    if (module.globals.size())
+        listing << "\n";
+
+    for (std::size_t i = 0; i < module.functions.size(); ++i) {
+        if (i)
+            listing << "\n";
+        listing << printFunction(*module.functions[i]);
+    }
+
+    return listing.str();
+}
+
+// Analyses
+/**
+ * Returns whether running the instruction does more than compute its value:
+ * it ends the block, writes a global, calls a function or may abort.
+ */
+bool
+hasEffects(IRInstruction* instr)
+{
+    switch (instr->opcode) {
+        case IROpcode::Param:
+        case IROpcode::StoreGlobal:
+        case IROpcode::Jump:
+        case IROpcode::Branch:
+        case IROpcode::Return:
+            return true;
+
+        case IROpcode::Call:
+            // Intrinsic division aborts on a zero divisor
+            return ! instr->callee->is_intrinsic ||
+                ! instr->callee->is_pure ||
+                instr->callee->name.rfind("__div__", 0) == 0 ||
+                instr->callee->name.rfind("__rem__", 0) == 0;
+
+        case IROpcode::Operation: {
+            // Integer division aborts unless the divisor is known not to be zero,
+            // and signed division also when the smallest int is divided by -1
+            switch (instr->operation) {
+                case Operation::DivI64:
+                case Operation::RemI64: {
+                    IRInstruction* dividend = instr->operands[0];
+                    IRInstruction* divisor = instr->operands[1];
+                    if (divisor->opcode != IROpcode::Const || divisor->value.as_int == 0)
+                        return true;
+                    return divisor->value.as_int == -1 && (
+                        dividend->opcode != IROpcode::Const || dividend->value.as_int == INT64_MIN
+                    );
+                }
+
+                case Operation::DivU64:
+                case Operation::RemU64: {
+                    IRInstruction* divisor = instr->operands[1];
+                    return divisor->opcode != IROpcode::Const || divisor->value.as_uint == 0;
+                }
+
+                default:
+                    return false;
+            }
+        }
+
+        default:
+            return false;
+    }
+}
+
+/**
+ * Returns the blocks reachable from the entry block in reverse postorder.
+ */
+std::vector<IRBlock*>
+reversePostorder(IRFunction& function)
+{
+    std::vector<IRBlock*> order;
+    if (function.blocks.empty())
+        return order;
+
+    // Depth first, each block remembers the next successor to visit,
+    // the last successor is visited first so the first one comes next in the order
+    std::set<IRBlock*> visited;
+    std::vector<std::pair<IRBlock*, std::size_t>> stack;
+    IRBlock* entry = function.blocks.front().get();
+    visited.insert(entry);
+    stack.emplace_back(entry, 0);
+    while (stack.size()) {
+        IRBlock* block = stack.back().first;
+        std::vector<IRBlock*> successors = block->successors();
+        if (stack.back().second < successors.size()) {
+            IRBlock* successor = successors[successors.size() - ++stack.back().second];
+            if (visited.insert(successor).second)
+                stack.emplace_back(successor, 0);
+            continue;
+        }
+
+        order.push_back(block);
+        stack.pop_back();
+    }
+
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+/**
+ * Returns the immediate dominator of every reachable block.
+ * The entry block is its own immediate dominator.
+ *
+ * This is the iterative algorithm of Cooper, Harvey and Kennedy.
+ */
+std::map<IRBlock*, IRBlock*>
+immediateDominators(IRFunction& function)
+{
+    std::vector<IRBlock*> order = reversePostorder(function);
+    std::map<IRBlock*, std::size_t> position;
+    for (std::size_t i = 0; i < order.size(); ++i)
+        position[order[i]] = i;
+
+    std::map<IRBlock*, IRBlock*> idoms;
+    if (order.empty())
+        return idoms;
+    idoms[order[0]] = order[0];
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (std::size_t i = 1; i < order.size(); ++i) {
+            IRBlock* new_idom = nullptr;
+            for (IRBlock* predecessor: order[i]->predecessors) {
+                if (idoms.count(predecessor) == 0)
+                    continue;
+
+                if (new_idom == nullptr) {
+                    new_idom = predecessor;
+                    continue;
+                }
+
+                // Walk both up the tree until they meet
+                IRBlock* left = predecessor;
+                IRBlock* right = new_idom;
+                while (left != right) {
+                    while (position[left] > position[right])
+                        left = idoms[left];
+                    while (position[right] > position[left])
+                        right = idoms[right];
+                }
+                new_idom = left;
+            }
+
+            if (idoms[order[i]] != new_idom) {
+                idoms[order[i]] = new_idom;
+                changed = true;
+            }
+        }
+    }
+
+    return idoms;
+}
+
+// Transformations
+/**
+ * Makes the operands that refer to an instruction in the given map
+ * refer to the instruction it maps to instead.
+ * Chains of replacements are followed to their end.
+ */
+void
+replaceUses(
+    IRFunction& function,
+    std::map<IRInstruction*, IRInstruction*> const& replacements
+)
+{
+    if (replacements.empty())
+        return;
+
+    for (auto& block: function.blocks) {
+        for (auto& instr: block->instructions) {
+            for (IRInstruction*& operand: instr->operands) {
+                auto it = replacements.find(operand);
+                while (it != replacements.end()) {
+                    operand = it->second;
+                    it = replacements.find(operand);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Removes one edge from a block to another, along with
+ * the phi operands that flowed along that edge.
+ */
+void
+removeEdge(IRBlock* from, IRBlock* to)
+{
+    auto it = std::find(to->predecessors.begin(), to->predecessors.end(), from);
+    if (it == to->predecessors.end())
+        return;
+
+    std::size_t index = it - to->predecessors.begin();
+    to->predecessors.erase(it);
+    for (auto& instr: to->instructions) {
+        if (instr->opcode != IROpcode::Phi)
+            break;
+        instr->operands.erase(instr->operands.begin() + index);
+    }
+}
+
+/**
+ * Removes the blocks that can't be reached from the entry block.
+ *
+ * @return      true if any block was removed.
+ */
+bool
+removeUnreachableBlocks(IRFunction& function)
+{
+    std::vector<IRBlock*> order = reversePostorder(function);
+    std::set<IRBlock*> reachable(order.begin(), order.end());
+    if (reachable.size() == function.blocks.size())
+        return false;
+
+    for (auto& block: function.blocks) {
+        if (reachable.count(block.get()))
+            continue;
+
+        for (IRBlock* successor: block->successors()) {
+            if (reachable.count(successor))
+                removeEdge(block.get(), successor);
+        }
+    }
+
+    function.blocks.erase(
+        std::remove_if(
+            function.blocks.begin(),
+            function.blocks.end(),
+            [&reachable](std::unique_ptr<IRBlock> const& block) {
+                return reachable.count(block.get()) == 0;
+            }
+        ),
+        function.blocks.end()
+    );
+    return true;
+}
+
+/**
+ * Puts an empty block on every edge from a block with many successors
+ * to a block with phis, so that phi operands can be copied at the end
+ * of a predecessor that only leads to the phis.
+ */
+void
+splitCriticalEdges(IRFunction& function)
+{
+    std::size_t block_count = function.blocks.size();
+    for (std::size_t i = 0; i < block_count; ++i) {
+        IRBlock* block = function.blocks[i].get();
+        IRInstruction* last = block->terminator();
+        if (last == nullptr || last->targets.size() < 2)
+            continue;
+
+        for (IRBlock*& target: last->targets) {
+            if (target->instructions.empty() || target->instructions[0]->opcode != IROpcode::Phi)
+                continue;
+
+            IRBlock* split = function.addBlock();
+            std::unique_ptr<IRInstruction> jump =
+                std::make_unique<IRInstruction>(IROpcode::Jump, ValueType::Void);
+            jump->targets.push_back(target);
+            function.append(split, std::move(jump));
+
+            // Phi operands stay in place, only the block they come from changes
+            *std::find(target->predecessors.begin(), target->predecessors.end(), block) = split;
+            split->predecessors.push_back(block);
+            target = split;
+        }
+    }
+}
+
+// Returns a constant the way it is written in Proto
+static std::string
+valueToString(Value const& value)
+{
+    switch (value.type) {
+        case ValueType::Boolean:
+            return value.as_bool ? "true" : "false";
+
+        case ValueType::SignedInt:
+            return std::to_string(value.as_int);
+
+        case ValueType::UnsignedInt:
+            return std::to_string(value.as_uint);
+
+        case ValueType::Float: {
+            std::ostringstream stream;
+            stream << value.as_float;
+            return stream.str();
+        }
+
+        case ValueType::String:
+            return "\"" + *value.as_string + "\"";
+
+        default:
+            return "undefined";
+    }
+}
@@ -0,0 +1,713 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <memory>
+#include <vector>
+#include <string>
+#include <map>
+#include <set>
+
+#include "common/operation.h"
+#include "common/value.h"
+#include "ir/passes.h"
+#include "ir/ir.h"
+
+
+static bool isInteger(IRInstruction* instr, uint64_t bits);
+static bool isCommutative(enum Operation operation);
+static std::size_t firstPosition(IRBlock* block);
+static void eraseInstructions(
+    IRFunction& function,
+    std::map<IRInstruction*, IRInstruction*> const& replacements
+);
+
+// Pass manager
+PassManager::PassManager()
+{}
+
+/**
+ * Adds a pass to run after the ones already added.
+ */
+void
+PassManager::add(std::unique_ptr<IRPass> pass)
+{
+    passes.push_back(std::move(pass));
+}
+
+/**
+ * Runs the passes in order on every function of the module,
+ * again until a round changes nothing or enough rounds ran.
+ */
+void
+PassManager::run(IRModule& module)
+{
+    for (auto& function: module.functions) {
+        for (std::size_t round = 0; round < max_rounds; ++round) {
+            bool changed = false;
+            for (auto& pass: passes)
+                changed = pass->run(*function) || changed;
+
+            if (! changed)
+                break;
+        }
+    }
+}
+
+// Constant folding
+std::string
+ConstantFolding::name() const
+{
+    return "constant-folding";
+}
+
+bool
+ConstantFolding::run(IRFunction& function)
+{
+    bool changed = false;
+    bool branches_folded = false;
+
+    for (auto& block: function.blocks) {
+        for (auto& instr: block->instructions) {
+            if (instr->opcode == IROpcode::Operation) {
+                changed = simplify(instr.get()) || changed;
+                continue;
+            }
+
+            if (
+                instr->opcode != IROpcode::Branch                   ||
+                instr->operands[0]->opcode != IROpcode::Const       ||
+                instr->operands[0]->type != ValueType::Boolean
+            )
+                continue;
+
+            // Only the branch taken remains
+            bool condition = instr->operands[0]->value.as_bool;
+            IRBlock* taken = instr->targets[condition ? 0 : 1];
+            IRBlock* skipped = instr->targets[condition ? 1 : 0];
+            instr->opcode = IROpcode::Jump;
+            instr->operands.clear();
+            instr->targets = {taken};
+            removeEdge(block.get(), skipped);
+            branches_folded = true;
+        }
+    }
+
+    if (branches_folded)
+        removeUnreachableBlocks(function);
+
+    return changed || branches_folded;
+}
+
+// Fold or simplify an operation, returns true if it changed
+bool
+ConstantFolding::simplify(IRInstruction* instr)
+{
+    std::vector<IRInstruction*>& operands = instr->operands;
+
+    bool constant = true;
+    for (IRInstruction* operand: operands)
+        constant = constant && operand->opcode == IROpcode::Const && operand->type != ValueType::Void;
+
+    // Division that traps, by zero or of the smallest int by -1, is left for the program to fail on
+    if (constant && ! hasEffects(instr)) {
+        instr->value = applyOperation(
+            instr->operation,
+            operands[0]->value,
+            operands.size() > 1 ? operands[1]->value : Value()
+        );
+        instr->opcode = IROpcode::Const;
+        operands.clear();
+        return true;
+    }
+
+    // Operations with a neutral operand copy the other operand
+    IRInstruction* copied = nullptr;
+    switch (instr->operation) {
+        case Operation::AddI64:
+        case Operation::AddU64:
+            if (isInteger(operands[1], 0))
+                copied = operands[0];
+            else if (isInteger(operands[0], 0))
+                copied = operands[1];
+            break;
+
+        case Operation::SubI64:
+        case Operation::SubU64:
+            if (isInteger(operands[1], 0))
+                copied = operands[0];
+            break;
+
+        case Operation::MulI64:
+        case Operation::MulU64:
+            if (isInteger(operands[1], 1))
+                copied = operands[0];
+            else if (isInteger(operands[0], 1))
+                copied = operands[1];
+            break;
+
+        case Operation::DivI64:
+        case Operation::DivU64:
+            if (isInteger(operands[1], 1))
+                copied = operands[0];
+            break;
+
+        default:
+            break;
+    }
+
+    if (copied == nullptr)
+        return false;
+
+    instr->opcode = IROpcode::Copy;
+    operands = {copied};
+    return true;
+}
+
+// Copy propagation
+std::string
+CopyPropagation::name() const
+{
+    return "copy-propagation";
+}
+
+bool
+CopyPropagation::run(IRFunction& function)
+{
+    bool changed = false;
+
+    while (true) {
+        std::map<IRInstruction*, IRInstruction*> replacements;
+        auto resolve = [&replacements](IRInstruction* value) {
+            auto it = replacements.find(value);
+            while (it != replacements.end()) {
+                value = it->second;
+                it = replacements.find(value);
+            }
+            return value;
+        };
+
+        for (auto& block: function.blocks) {
+            for (auto& instr: block->instructions) {
+                IRInstruction* same = nullptr;
+                if (instr->opcode == IROpcode::Copy) {
+                    same = resolve(instr->operands[0]);
+                }
+                else if (instr->opcode == IROpcode::Phi) {
+                    // Phis that merge one value besides themselves
+                    bool trivial = true;
+                    for (IRInstruction* operand: instr->operands) {
+                        IRInstruction* value = resolve(operand);
+                        if (value == instr.get() || value == same)
+                            continue;
+                        if (same != nullptr) {
+                            trivial = false;
+                            break;
+                        }
+                        same = value;
+                    }
+                    if (! trivial)
+                        same = nullptr;
+                }
+
+                if (same != nullptr && same != instr.get())
+                    replacements[instr.get()] = same;
+            }
+        }
+
+        if (replacements.empty())
+            break;
+
+        replaceUses(function, replacements);
+        eraseInstructions(function, replacements);
+        changed = true;
+    }
+
+    return changed;
+}
+
+// Global value numbering
+std::string
+ValueNumbering::name() const
+{
+    return "value-numbering";
+}
+
+bool
+ValueNumbering::run(IRFunction& function)
+{
+    bool moved = moveConstants(function);
+
+    // Visit children in reverse postorder so numbering is deterministic
+    std::map<IRBlock*, IRBlock*> idoms = immediateDominators(function);
+    std::map<IRBlock*, std::vector<IRBlock*>> children;
+    for (IRBlock* block: reversePostorder(function)) {
+        if (idoms[block] != block)
+            children[idoms[block]].push_back(block);
+    }
+
+    std::map<std::vector<uint64_t>, IRInstruction*> table;
+    std::map<IRInstruction*, IRInstruction*> replacements;
+    auto resolve = [&replacements](IRInstruction* value) {
+        auto it = replacements.find(value);
+        return it == replacements.end() ? value : it->second;
+    };
+
+    // A computation is available in the blocks its own block dominates
+    std::vector<std::pair<IRBlock*, std::vector<std::vector<uint64_t>>>> stack;
+    stack.emplace_back(function.blocks.front().get(), std::vector<std::vector<uint64_t>>());
+    std::vector<std::size_t> next_child(1, 0);
+    bool entering = true;
+    while (stack.size()) {
+        IRBlock* block = stack.back().first;
+
+        if (entering) {
+            for (auto& instr: block->instructions) {
+                std::vector<uint64_t> key;
+                switch (instr->opcode) {
+                    case IROpcode::Const:
+                        key = {0, (uint64_t) instr->type, instr->value.as_uint};
+                        break;
+
+                    case IROpcode::Operation: {
+                        key = {1, (uint64_t) instr->operation};
+                        std::vector<uint64_t> ids;
+                        for (IRInstruction* operand: instr->operands)
+                            ids.push_back(resolve(operand)->id);
+                        if (isCommutative(instr->operation))
+                            std::sort(ids.begin(), ids.end());
+                        key.insert(key.end(), ids.begin(), ids.end());
+                        break;
+                    }
+
+                    case IROpcode::Phi:
+                        key = {2, block->id};
+                        for (IRInstruction* operand: instr->operands)
+                            key.push_back(resolve(operand)->id);
+                        break;
+
+                    case IROpcode::Call:
+                        if (! instr->callee->is_intrinsic || ! instr->callee->is_pure)
+                            break;
+                        key = {3, (uint64_t) (uintptr_t) instr->callee};
+                        for (IRInstruction* operand: instr->operands)
+                            key.push_back(resolve(operand)->id);
+                        break;
+
+                    default:
+                        break;
+                }
+
+                if (key.empty())
+                    continue;
+
+                auto it = table.find(key);
+                if (it != table.end()) {
+                    replacements[instr.get()] = it->second;
+                    continue;
+                }
+
+                table[key] = instr.get();
+                stack.back().second.push_back(key);
+            }
+            entering = false;
+        }
+
+        std::vector<IRBlock*>& block_children = children[block];
+        if (next_child.back() < block_children.size()) {
+            IRBlock* child = block_children[next_child.back()++];
+            stack.emplace_back(child, std::vector<std::vector<uint64_t>>());
+            next_child.push_back(0);
+            entering = true;
+            continue;
+        }
+
+        // Leaving the block, its computations are no longer available
+        for (auto& key: stack.back().second)
+            table.erase(key);
+        stack.pop_back();
+        next_child.pop_back();
+    }
+
+    if (replacements.empty())
+        return moved;
+
+    replaceUses(function, replacements);
+    eraseInstructions(function, replacements);
+    return true;
+}
+
+// Move constants to the entry block so one load serves the whole function
+bool
+ValueNumbering::moveConstants(IRFunction& function)
+{
+    IRBlock* entry = function.blocks.front().get();
+    std::size_t position = firstPosition(entry);
+
+    bool moved = false;
+    for (auto& block: function.blocks) {
+        if (block.get() == entry)
+            continue;
+
+        auto& instructions = block->instructions;
+        for (auto it = instructions.begin(); it != instructions.end();) {
+            if ((*it)->opcode != IROpcode::Const) {
+                ++it;
+                continue;
+            }
+
+            (*it)->block = entry;
+            entry->instructions.insert(
+                entry->instructions.begin() + position,
+                std::move(*it)
+            );
+            it = instructions.erase(it);
+            position++;
+            moved = true;
+        }
+    }
+
+    return moved;
+}
+
+// Strength reduction
+std::string
+StrengthReduction::name() const
+{
+    return "strength-reduction";
+}
+
+bool
+StrengthReduction::run(IRFunction& function)
+{
+    idoms = immediateDominators(function);
+
+    // Products of an induction variable and a constant
+    std::vector<std::pair<IRInstruction*, Induction>> products;
+    for (auto& block: function.blocks) {
+        for (auto& instr: block->instructions) {
+            if (
+                instr->opcode != IROpcode::Operation || (
+                    instr->operation != Operation::MulI64 &&
+                    instr->operation != Operation::MulU64
+                )
+            )
+                continue;
+
+            Induction induction;
+            IRInstruction* left = instr->operands[0];
+            IRInstruction* right = instr->operands[1];
+            if (findInduction(left, instr.get(), induction) && isInvariant(right, induction))
+                products.emplace_back(instr.get(), induction);
+            else if (findInduction(right, instr.get(), induction) && isInvariant(left, induction))
+                products.emplace_back(instr.get(), induction);
+        }
+    }
+
+    // Each product becomes a variable of its own, stepped by the
+    // product of the step and the factor at the same time as the original
+    std::map<std::pair<IRInstruction*, IRInstruction*>, IRInstruction*> reduced;
+    std::map<IRInstruction*, IRInstruction*> replacements;
+    for (auto& [product, induction]: products) {
+        IRInstruction* factor = product->operands[0] == induction.phi
+            ? product->operands[1]
+            : product->operands[0];
+        std::pair<IRInstruction*, IRInstruction*> key(induction.phi, factor);
+        if (reduced.count(key) == 0)
+            reduced[key] = reduce(function, induction, product, factor);
+        replacements[product] = reduced[key];
+    }
+
+    if (replacements.empty())
+        return false;
+
+    replaceUses(function, replacements);
+    eraseInstructions(function, replacements);
+    return true;
+}
+
+// Whether the value is a phi of a loop header stepped by a constant on the back edge
+bool
+StrengthReduction::findInduction(
+    IRInstruction* phi,
+    IRInstruction* product,
+    Induction& induction
+)
+{
+    if (phi->opcode != IROpcode::Phi || phi->block->predecessors.size() != 2)
+        return false;
+
+    IRBlock* header = phi->block;
+    std::size_t back = dominates(header, header->predecessors[0]) ? 0 : 1;
+    std::size_t entry = 1 - back;
+    if (
+        ! dominates(header, header->predecessors[back]) ||
+        dominates(header, header->predecessors[entry])
+    )
+        return false;
+
+    // The step is added with the operation matching the product
+    enum Operation add = product->operation == Operation::MulI64
+        ? Operation::AddI64
+        : Operation::AddU64;
+    enum Operation sub = product->operation == Operation::MulI64
+        ? Operation::SubI64
+        : Operation::SubU64;
+    IRInstruction* next = phi->operands[back];
+    if (next->opcode != IROpcode::Operation)
+        return false;
+
+    IRInstruction* left = next->operands[0];
+    IRInstruction* right = next->operands[1];
+    if (next->operation == add && left == phi && right->opcode == IROpcode::Const)
+        induction.step = right->value.as_uint;
+    else if (next->operation == add && right == phi && left->opcode == IROpcode::Const)
+        induction.step = left->value.as_uint;
+    else if (next->operation == sub && left == phi && right->opcode == IROpcode::Const)
+        induction.step = 0 - right->value.as_uint;
+    else
+        return false;
+
+    induction.phi = phi;
+    induction.next = next;
+    induction.entry = entry;
+    induction.back = back;
+    return true;
+}
+
+IRInstruction*
+StrengthReduction::reduce(
+    IRFunction& function,
+    Induction const& induction,
+    IRInstruction* product,
+    IRInstruction* factor
+)
+{
+    IRBlock* header = induction.phi->block;
+    IRBlock* preheader = header->predecessors[induction.entry];
+    enum Operation add = product->operation == Operation::MulI64
+        ? Operation::AddI64
+        : Operation::AddU64;
+
+    // The step of the product is known when the factor is a constant,
+    // otherwise it is computed before the loop like the start
+    std::unique_ptr<IRInstruction> step =
+        std::make_unique<IRInstruction>(IROpcode::Const, product->type);
+    step->value = product->type == ValueType::SignedInt
+        ? Value((int64_t) induction.step)
+        : Value(induction.step);
+    if (factor->opcode == IROpcode::Const)
+        step->value.as_uint = induction.step * factor->value.as_uint;
+    IRBlock* entry = function.blocks.front().get();
+    IRInstruction* step_value = function.insert(
+        entry,
+        firstPosition(entry),
+        std::move(step)
+    );
+    if (factor->opcode != IROpcode::Const) {
+        std::unique_ptr<IRInstruction> scaled =
+            std::make_unique<IRInstruction>(IROpcode::Operation, product->type);
+        scaled->operation = product->operation;
+        scaled->operands = {step_value, factor};
+        step_value = function.insert(
+            preheader,
+            preheader->instructions.size() - 1,
+            std::move(scaled)
+        );
+    }
+
+    // The product starts as the initial value times the factor
+    std::unique_ptr<IRInstruction> start =
+        std::make_unique<IRInstruction>(IROpcode::Operation, product->type);
+    start->operation = product->operation;
+    start->operands = {induction.phi->operands[induction.entry], factor};
+    IRInstruction* start_value = function.insert(
+        preheader,
+        preheader->instructions.size() - 1,
+        std::move(start)
+    );
+
+    std::unique_ptr<IRInstruction> phi =
+        std::make_unique<IRInstruction>(IROpcode::Phi, product->type);
+    phi->operands.resize(2);
+    IRInstruction* phi_value = function.insert(header, 0, std::move(phi));
+
+    // Stepped right where the induction variable is
+    IRBlock* block = induction.next->block;
+    std::size_t position = 0;
+    while (block->instructions[position].get() != induction.next)
+        position++;
+    std::unique_ptr<IRInstruction> next =
+        std::make_unique<IRInstruction>(IROpcode::Operation, product->type);
+    next->operation = add;
+    next->operands = {phi_value, step_value};
+    IRInstruction* next_value = function.insert(block, position + 1, std::move(next));
+
+    phi_value->operands[induction.entry] = start_value;
+    phi_value->operands[induction.back] = next_value;
+    return phi_value;
+}
+
+// Whether the value is computed before the loop of the induction variable starts
+bool
+StrengthReduction::isInvariant(IRInstruction* value, Induction const& induction)
+{
+    if (value->opcode == IROpcode::Const)
+        return true;
+
+    IRBlock* header = induction.phi->block;
+    return value->block != header && dominates(
+        value->block,
+        header->predecessors[induction.entry]
+    );
+}
+
+// Whether every path from the entry to the block goes through the dominator
+bool
+StrengthReduction::dominates(IRBlock* dominator, IRBlock* block)
+{
+    if (idoms.count(block) == 0)
+        return false;
+
+    while (block != dominator) {
+        if (idoms[block] == block)
+            return false;
+        block = idoms[block];
+    }
+    return true;
+}
+
+// Dead code elimination
+std::string
+DeadCodeElimination::name() const
+{
+    return "dead-code-elimination";
+}
+
+bool
+DeadCodeElimination::run(IRFunction& function)
+{
+    bool changed = removeUnreachableBlocks(function);
+
+    // Everything instructions with effects depend on is live
+    std::set<IRInstruction*> live;
+    std::vector<IRInstruction*> worklist;
+    for (auto& block: function.blocks) {
+        for (auto& instr: block->instructions) {
+            if (hasEffects(instr.get())) {
+                live.insert(instr.get());
+                worklist.push_back(instr.get());
+            }
+        }
+    }
+
+    while (worklist.size()) {
+        IRInstruction* instr = worklist.back();
+        worklist.pop_back();
+        for (IRInstruction* operand: instr->operands) {
+            if (live.insert(operand).second)
+                worklist.push_back(operand);
+        }
+    }
+
+    for (auto& block: function.blocks) {
+        std::vector<std::unique_ptr<IRInstruction>>& instructions = block->instructions;
+        std::size_t size = instructions.size();
+        instructions.erase(
+            std::remove_if(
+                instructions.begin(),
+                instructions.end(),
+                [&live](std::unique_ptr<IRInstruction> const& instr) {
+                    return live.count(instr.get()) == 0;
+                }
+            ),
+            instructions.end()
+        );
+        changed = changed || instructions.size() != size;
+    }
+
+    return changed;
+}
+
+// Whether the instruction is an integer constant with the given bits
+static bool
+isInteger(IRInstruction* instr, uint64_t bits)
+{
+    return instr->opcode == IROpcode::Const && (
+        instr->type == ValueType::SignedInt ||
+        instr->type == ValueType::UnsignedInt
+    ) && instr->value.as_uint == bits;
+}
+
+// Whether the order of the operands doesn't matter
+static bool
+isCommutative(enum Operation operation)
+{
+    switch (operation) {
+        case Operation::AddI64: case Operation::MulI64:
+        case Operation::EqI64: case Operation::NeI64:
+        case Operation::AddU64: case Operation::MulU64:
+        case Operation::EqU64: case Operation::NeU64:
+        case Operation::AddF64: case Operation::MulF64:
+        case Operation::EqF64: case Operation::NeF64:
+        case Operation::EqBool: case Operation::NeBool:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+// Position of the first instruction that is neither a parameter nor a phi
+static std::size_t
+firstPosition(IRBlock* block)
+{
+    std::size_t position = 0;
+    while (
+        position < block->instructions.size() && (
+            block->instructions[position]->opcode == IROpcode::Param ||
+            block->instructions[position]->opcode == IROpcode::Phi
+        )
+    )
+        position++;
+    return position;
+}
+
+// Remove the instructions that were replaced
+static void
+eraseInstructions(
+    IRFunction& function,
+    std::map<IRInstruction*, IRInstruction*> const& replacements
+)
+{
+    for (auto& block: function.blocks) {
+        std::vector<std::unique_ptr<IRInstruction>>& instructions = block->instructions;
+        instructions.erase(
+            std::remove_if(
+                instructions.begin(),
+                instructions.end(),
+                [&replacements](std::unique_ptr<IRInstruction> const& instr) {
+                    return replacements.count(instr.get()) != 0;
+                }
+            ),
+            instructions.end()
+        );
+    }
+}
@@ -0,0 +1,453 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "jit/assembler.h"
+
+
+Assembler::Assembler()
+{}
+
+/**
+ * Returns the code emitted so far, with every jump resolved.
+ */
+std::vector<uint8_t> const&
+Assembler::finish()
+{
+    // Displacements are relative to the end of the 4 bytes holding them
+    for (auto& [at, label]: fixups) {
+        uint32_t rel = static_cast<uint32_t>(labels[label] - (at + 4));
+        for (std::size_t i = 0; i < 4; ++i)
+            code[at + i] = static_cast<uint8_t>(rel >> (8 * i));
+    }
+    fixups.clear();
+
+    return code;
+}
+
+/**
+ * Returns the offset of the next instruction in the code.
+ */
+std::size_t
+Assembler::size() const
+{
+    return code.size();
+}
+
+// Labels
+Label
+Assembler::newLabel()
+{
+    labels.push_back(0);
+    return labels.size() - 1;
+}
+
+void
+Assembler::bind(Label label)
+{
+    labels[label] = code.size();
+}
+
+std::size_t
+Assembler::offset(Label label) const
+{
+    return labels[label];
+}
+
+// Moves
+void
+Assembler::mov(Register dst, Register src)
+{
+    binary(0x89, dst, src);
+}
+
+void
+Assembler::mov(Register dst, uint64_t imm)
+{
+    uint8_t reg = static_cast<uint8_t>(dst);
+
+    // Writing the low half clears the high half
+    if (imm <= UINT32_MAX) {
+        if (reg >= 8)
+            byte(0x41);
+        byte(0xB8 + (reg & 7));
+        bytes32(static_cast<uint32_t>(imm));
+        return;
+    }
+
+    rex(true, 0, reg);
+    byte(0xB8 + (reg & 7));
+    bytes64(imm);
+}
+
+void
+Assembler::load(Register dst, Register base, int32_t disp)
+{
+    rex(true, static_cast<uint8_t>(dst), static_cast<uint8_t>(base));
+    byte(0x8B);
+    memory(static_cast<uint8_t>(dst), base, disp);
+}
+
+void
+Assembler::store(Register base, int32_t disp, Register src)
+{
+    rex(true, static_cast<uint8_t>(src), static_cast<uint8_t>(base));
+    byte(0x89);
+    memory(static_cast<uint8_t>(src), base, disp);
+}
+
+void
+Assembler::store32(Register base, int32_t disp, uint32_t imm)
+{
+    if (static_cast<uint8_t>(base) >= 8)
+        byte(0x41);
+    byte(0xC7);
+    memory(0, base, disp);
+    bytes32(imm);
+}
+
+void
+Assembler::lea(Register dst, Register base, int32_t disp)
+{
+    rex(true, static_cast<uint8_t>(dst), static_cast<uint8_t>(base));
+    byte(0x8D);
+    memory(static_cast<uint8_t>(dst), base, disp);
+}
+
+void
+Assembler::movq(XmmRegister dst, Register src)
+{
+    byte(0x66);
+    rex(true, static_cast<uint8_t>(dst), static_cast<uint8_t>(src));
+    byte(0x0F);
+    byte(0x6E);
+    modrm(static_cast<uint8_t>(dst), static_cast<uint8_t>(src));
+}
+
+void
+Assembler::movq(Register dst, XmmRegister src)
+{
+    byte(0x66);
+    rex(true, static_cast<uint8_t>(src), static_cast<uint8_t>(dst));
+    byte(0x0F);
+    byte(0x7E);
+    modrm(static_cast<uint8_t>(src), static_cast<uint8_t>(dst));
+}
+
+// Integer arithmetic
+void
+Assembler::add(Register dst, Register src)
+{
+    binary(0x01, dst, src);
+}
+
+void
+Assembler::sub(Register dst, Register src)
+{
+    binary(0x29, dst, src);
+}
+
+void
+Assembler::imul(Register dst, Register src)
+{
+    rex(true, static_cast<uint8_t>(dst), static_cast<uint8_t>(src));
+    byte(0x0F);
+    byte(0xAF);
+    modrm(static_cast<uint8_t>(dst), static_cast<uint8_t>(src));
+}
+
+void
+Assembler::xorq(Register dst, Register src)
+{
+    binary(0x31, dst, src);
+}
+
+void
+Assembler::neg(Register dst)
+{
+    unary(3, dst);
+}
+
+void
+Assembler::notq(Register dst)
+{
+    unary(2, dst);
+}
+
+void
+Assembler::cqo()
+{
+    byte(0x48);
+    byte(0x99);
+}
+
+void
+Assembler::idiv(Register src)
+{
+    unary(7, src);
+}
+
+void
+Assembler::div(Register src)
+{
+    unary(6, src);
+}
+
+void
+Assembler::sub(Register dst, int32_t imm)
+{
+    rex(true, 0, static_cast<uint8_t>(dst));
+    byte(0x81);
+    modrm(5, static_cast<uint8_t>(dst));
+    bytes32(static_cast<uint32_t>(imm));
+}
+
+void
+Assembler::btc(Register dst, uint8_t bit)
+{
+    rex(true, 0, static_cast<uint8_t>(dst));
+    byte(0x0F);
+    byte(0xBA);
+    modrm(7, static_cast<uint8_t>(dst));
+    byte(bit);
+}
+
+// Comparisons
+void
+Assembler::cmp(Register left, Register right)
+{
+    binary(0x39, left, right);
+}
+
+void
+Assembler::test(Register left, Register right)
+{
+    binary(0x85, left, right);
+}
+
+/* The byte forms only take the four first registers, which need no prefix. */
+void
+Assembler::test8(Register left, Register right)
+{
+    byte(0x84);
+    modrm(static_cast<uint8_t>(right), static_cast<uint8_t>(left));
+}
+
+void
+Assembler::setcc(Condition condition, Register dst)
+{
+    byte(0x0F);
+    byte(0x90 + static_cast<uint8_t>(condition));
+    modrm(0, static_cast<uint8_t>(dst));
+}
+
+void
+Assembler::and8(Register dst, Register src)
+{
+    byte(0x20);
+    modrm(static_cast<uint8_t>(src), static_cast<uint8_t>(dst));
+}
+
+void
+Assembler::or8(Register dst, Register src)
+{
+    byte(0x08);
+    modrm(static_cast<uint8_t>(src), static_cast<uint8_t>(dst));
+}
+
+void
+Assembler::movzx8(Register dst, Register src)
+{
+    byte(0x0F);
+    byte(0xB6);
+    modrm(static_cast<uint8_t>(dst), static_cast<uint8_t>(src));
+}
+
+// Floating point arithmetic
+void
+Assembler::addsd(XmmRegister dst, XmmRegister src)
+{
+    sse(0xF2, 0x58, dst, src);
+}
+
+void
+Assembler::subsd(XmmRegister dst, XmmRegister src)
+{
+    sse(0xF2, 0x5C, dst, src);
+}
+
+void
+Assembler::mulsd(XmmRegister dst, XmmRegister src)
+{
+    sse(0xF2, 0x59, dst, src);
+}
+
+void
+Assembler::divsd(XmmRegister dst, XmmRegister src)
+{
+    sse(0xF2, 0x5E, dst, src);
+}
+
+void
+Assembler::ucomisd(XmmRegister left, XmmRegister right)
+{
+    sse(0x66, 0x2E, left, right);
+}
+
+// Control flow
+void
+Assembler::jmp(Label label)
+{
+    byte(0xE9);
+    displacement(label);
+}
+
+void
+Assembler::jcc(Condition condition, Label label)
+{
+    byte(0x0F);
+    byte(0x80 + static_cast<uint8_t>(condition));
+    displacement(label);
+}
+
+void
+Assembler::call(Label label)
+{
+    byte(0xE8);
+    displacement(label);
+}
+
+void
+Assembler::call(Register target)
+{
+    if (static_cast<uint8_t>(target) >= 8)
+        byte(0x41);
+    byte(0xFF);
+    modrm(2, static_cast<uint8_t>(target));
+}
+
+void
+Assembler::push(Register src)
+{
+    if (static_cast<uint8_t>(src) >= 8)
+        byte(0x41);
+    byte(0x50 + (static_cast<uint8_t>(src) & 7));
+}
+
+void
+Assembler::pop(Register dst)
+{
+    if (static_cast<uint8_t>(dst) >= 8)
+        byte(0x41);
+    byte(0x58 + (static_cast<uint8_t>(dst) & 7));
+}
+
+void
+Assembler::leave()
+{
+    byte(0xC9);
+}
+
+void
+Assembler::ret()
+{
+    byte(0xC3);
+}
+
+// Encoding
+void
+Assembler::byte(uint8_t value)
+{
+    code.push_back(value);
+}
+
+void
+Assembler::bytes32(uint32_t value)
+{
+    for (std::size_t i = 0; i < 4; ++i)
+        byte(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+void
+Assembler::bytes64(uint64_t value)
+{
+    for (std::size_t i = 0; i < 8; ++i)
+        byte(static_cast<uint8_t>(value >> (8 * i)));
+}
+
+/* The prefix is left out when it would say nothing. */
+void
+Assembler::rex(bool wide, uint8_t reg, uint8_t rm)
+{
+    uint8_t prefix = 0x40 | (wide << 3) | ((reg >> 3) << 2) | (rm >> 3);
+    if (prefix != 0x40)
+        byte(prefix);
+}
+
+/* Register to register form. */
+void
+Assembler::modrm(uint8_t reg, uint8_t rm)
+{
+    byte(0xC0 | ((reg & 7) << 3) | (rm & 7));
+}
+
+/* Base register with a 32 bits displacement, rsp and r12 need an index byte. */
+void
+Assembler::memory(uint8_t reg, Register base, int32_t disp)
+{
+    uint8_t rm = static_cast<uint8_t>(base) & 7;
+    byte(0x80 | ((reg & 7) << 3) | rm);
+    if (rm == 4)
+        byte(0x24);
+    bytes32(static_cast<uint32_t>(disp));
+}
+
+void
+Assembler::binary(uint8_t opcode, Register dst, Register src)
+{
+    rex(true, static_cast<uint8_t>(src), static_cast<uint8_t>(dst));
+    byte(opcode);
+    modrm(static_cast<uint8_t>(src), static_cast<uint8_t>(dst));
+}
+
+void
+Assembler::unary(uint8_t extension, Register dst)
+{
+    rex(true, 0, static_cast<uint8_t>(dst));
+    byte(0xF7);
+    modrm(extension, static_cast<uint8_t>(dst));
+}
+
+void
+Assembler::sse(uint8_t prefix, uint8_t opcode, XmmRegister dst, XmmRegister src)
+{
+    byte(prefix);
+    byte(0x0F);
+    byte(opcode);
+    modrm(static_cast<uint8_t>(dst), static_cast<uint8_t>(src));
+}
+
+void
+Assembler::displacement(Label label)
+{
+    fixups.emplace_back(code.size(), label);
+    bytes32(0);
+}
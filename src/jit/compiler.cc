@@ -0,0 +1,829 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <algorithm>
+#include <iostream>
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+#include <map>
+#include <set>
+
+#include <sys/resource.h>
+#include <pthread.h>
+
+#include "cleaner/ast/definitions/function.h"
+#include "cleaner/ast/declarations/type.h"
+#include "cleaner/ast/statements/return.h"
+#include "common/operation.h"
+#include "jit/assembler.h"
+#include "common/native.h"
+#include "ir/allocator.h"
+#include "jit/compiler.h"
+#include "common/value.h"
+#include "jit/memory.h"
+#include "ir/ir.h"
+
+
+/* Registers arguments are passed in, as in the System V calling convention. */
+static const Register argument_registers[] = {
+    Register::Rdi, Register::Rsi, Register::Rdx,
+    Register::Rcx, Register::R8, Register::R9
+};
+static const std::size_t max_parameters = 6;
+
+/* Compiled code keeps the globals in r15 and the lowest stack address it may use in r14. */
+static const Register globals_register = Register::R15;
+static const Register limit_register = Register::R14;
+
+/* Lowest stack address compiled code may use, set when compiling. */
+static uintptr_t stack_limit = 0;
+
+static uintptr_t findStackLimit();
+static bool isMachineType(enum ValueType type);
+static NativeFunction nativeOf(CleanFunctionDefinition* fun_def);
+[[noreturn]] static void divisionByZero();
+[[noreturn]] static void stackOverflow();
+
+JitProgram::JitProgram()
+{}
+
+JitProgram::JitProgram(
+    std::vector<uint8_t> const& code,
+    std::map<CleanFunctionDefinition*, std::size_t> const& entries
+) : memory(std::make_unique<ExecutableMemory>(code))
+{
+    for (auto& [fun_def, offset]: entries)
+        functions[fun_def] = reinterpret_cast<CompiledFunction>(
+            const_cast<void*>(memory->at(offset))
+        );
+}
+
+/**
+ * Returns the machine code of the given function,
+ * null if the function is left to the interpreter.
+ */
+CompiledFunction
+JitProgram::getFunction(CleanFunctionDefinition* fun_def) const
+{
+    auto it = functions.find(fun_def);
+    return it == functions.end() ? nullptr : it->second;
+}
+
+/**
+ * Returns the number of functions compiled to machine code.
+ */
+std::size_t
+JitProgram::size() const
+{
+    return functions.size();
+}
+
+/**
+ * Makes the interpreter run the compiled functions as machine code.
+ */
+void
+JitProgram::install() const
+{
+    for (auto& [fun_def, function]: functions)
+        fun_def->compiled = function;
+}
+
+JitCompiler::JitCompiler(
+    IRModule& module
+) : module(module),
+    scratch(0),
+    abort_label(0),
+    overflow_label(0)
+{}
+
+/**
+ * Returns whether machine code can be generated for this platform.
+ */
+bool
+JitCompiler::isAvailable()
+{
+#if defined(__x86_64__) && defined(__linux__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * Compiles to x86-64 machine code the functions that only compute
+ * on booleans, integers and floats, and only call intrinsics or
+ * functions that are compiled as well. Other functions are left
+ * to the interpreter.
+ *
+ * Every value lives in a stack slot of its function's frame and
+ * instructions are templates that go through a few fixed registers.
+ * Compiled functions call each other directly with their arguments
+ * in registers, the interpreter enters them through a stub per function.
+ */
+JitProgram
+JitCompiler::compile()
+{
+    if (! isAvailable())
+        return JitProgram();
+
+    return compileFunctions(findSupported());
+}
+
+/**
+ * Compiles the given function along with the functions it calls,
+ * nothing if the function is left to the interpreter.
+ */
+JitProgram
+JitCompiler::compile(CleanFunctionDefinition* fun_def)
+{
+    if (! isAvailable())
+        return JitProgram();
+
+    std::set<CleanFunctionDefinition*> supported = findSupported();
+    if (supported.count(fun_def) == 0)
+        return JitProgram();
+
+    // Callees of supported functions are supported as well
+    std::map<CleanFunctionDefinition*, IRFunction*> functions;
+    for (auto& function: module.functions)
+        functions[function->fun_def] = function.get();
+
+    std::set<CleanFunctionDefinition*> reached = {fun_def};
+    std::vector<CleanFunctionDefinition*> pending = {fun_def};
+    while (pending.size()) {
+        IRFunction* function = functions[pending.back()];
+        pending.pop_back();
+        for (auto& block: function->blocks) {
+            for (auto& instr: block->instructions) {
+                if (
+                    instr->opcode == IROpcode::Call &&
+                    ! instr->callee->is_intrinsic   &&
+                    reached.insert(instr->callee).second
+                )
+                    pending.push_back(instr->callee);
+            }
+        }
+    }
+
+    return compileFunctions(reached);
+}
+
+// Support
+std::set<CleanFunctionDefinition*>
+JitCompiler::findSupported()
+{
+    std::set<CleanFunctionDefinition*> supported;
+    for (auto& function: module.functions) {
+        if (isSupported(*function))
+            supported.insert(function->fun_def);
+    }
+
+    // A function calling one that is left to the interpreter is left as well
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (auto& function: module.functions) {
+            if (supported.count(function->fun_def) == 0)
+                continue;
+
+            for (auto& block: function->blocks) {
+                for (auto& instr: block->instructions) {
+                    if (
+                        instr->opcode == IROpcode::Call     &&
+                        ! instr->callee->is_intrinsic       &&
+                        supported.count(instr->callee) == 0
+                    ) {
+                        supported.erase(function->fun_def);
+                        changed = true;
+                        break;
+                    }
+                }
+                if (supported.count(function->fun_def) == 0)
+                    break;
+            }
+        }
+    }
+
+    return supported;
+}
+
+bool
+JitCompiler::isSupported(IRFunction& function)
+{
+    // Arguments must fit in registers and memoized calls need the interpreter's table
+    if (function.fun_def->parameters.size() > max_parameters || function.fun_def->memo)
+        return false;
+
+    for (auto& block: function.blocks) {
+        for (auto& instr: block->instructions) {
+            if (! isMachineType(instr->type))
+                return false;
+
+            for (IRInstruction* operand: instr->operands) {
+                if (! isMachineType(operand->type))
+                    return false;
+            }
+
+            if (
+                instr->opcode == IROpcode::Call &&
+                ! instr->callee->is_intrinsic   &&
+                (
+                    instr->callee->memo ||
+                    instr->operands.size() > max_parameters
+                )
+            )
+                return false;
+        }
+    }
+
+    return true;
+}
+
+// Functions
+JitProgram
+JitCompiler::compileFunctions(std::set<CleanFunctionDefinition*> const& functions)
+{
+    if (functions.empty())
+        return JitProgram();
+
+    if (stack_limit == 0)
+        stack_limit = findStackLimit();
+
+    // Label functions first so calls can refer to functions compiled later
+    for (auto& function: module.functions) {
+        if (functions.count(function->fun_def) == 0)
+            continue;
+        bodies[function->fun_def] = assembler.newLabel();
+        entries[function->fun_def] = assembler.newLabel();
+    }
+
+    for (auto& function: module.functions) {
+        if (functions.count(function->fun_def) == 0)
+            continue;
+        compileEntry(*function);
+        compileFunction(*function);
+    }
+
+    std::vector<uint8_t> const& code = assembler.finish();
+    std::map<CleanFunctionDefinition*, std::size_t> offsets;
+    for (auto& [fun_def, label]: entries)
+        offsets[fun_def] = assembler.offset(label);
+
+    return JitProgram(code, offsets);
+}
+
+void
+JitCompiler::compileEntry(IRFunction& function)
+{
+    // Value (*)(Value const * args, Value* globals)
+    CleanFunctionDefinition* fun_def = function.fun_def;
+    assembler.bind(entries[fun_def]);
+    assembler.push(Register::Rbp);
+    assembler.mov(Register::Rbp, Register::Rsp);
+    assembler.push(limit_register);
+    assembler.push(globals_register);
+    assembler.mov(globals_register, Register::Rsi);
+    assembler.mov(Register::Rax, reinterpret_cast<uint64_t>(&stack_limit));
+    assembler.load(limit_register, Register::Rax, 0);
+
+    // The first argument register holds the arguments so it is filled last
+    for (std::size_t i = fun_def->parameters.size(); i-- > 0;)
+        assembler.load(argument_registers[i], Register::Rdi, 16 * i + 8);
+    assembler.call(bodies[fun_def]);
+
+    // The value comes back in two registers, its type first
+    enum ValueType return_type = fun_def->return_type
+        ? irTypeOf(static_cast<CleanSimpleTypeDeclaration*>(fun_def->return_type.get())->name)
+        : ValueType::Void;
+    assembler.mov(Register::Rdx, Register::Rax);
+    assembler.mov(Register::Rax, static_cast<uint64_t>(return_type));
+    assembler.pop(globals_register);
+    assembler.pop(limit_register);
+    assembler.pop(Register::Rbp);
+    assembler.ret();
+}
+
+void
+JitCompiler::compileFunction(IRFunction& function)
+{
+    block_labels.clear();
+    abort_label = assembler.newLabel();
+    overflow_label = assembler.newLabel();
+
+    splitCriticalEdges(function);
+    allocation = RegisterAllocator(function).allocate();
+    scratch = allocation.register_count;
+
+    // Slots sit below the frame pointer, native arguments at the bottom of the frame
+    std::size_t max_native_arguments = 0;
+    for (auto& block: function.blocks) {
+        for (auto& instr: block->instructions) {
+            if (instr->opcode == IROpcode::Call && instr->callee->is_intrinsic)
+                max_native_arguments = std::max(max_native_arguments, instr->operands.size());
+        }
+    }
+    std::size_t frame_size = 8 * (scratch + 1) + 16 * max_native_arguments;
+    frame_size = (frame_size + 15) / 16 * 16;
+
+    assembler.bind(bodies[function.fun_def]);
+    assembler.push(Register::Rbp);
+    assembler.mov(Register::Rbp, Register::Rsp);
+    assembler.sub(Register::Rsp, static_cast<int32_t>(frame_size));
+    assembler.cmp(Register::Rsp, limit_register);
+    assembler.jcc(Condition::Below, overflow_label);
+
+    // Parameters keep the slot of their index
+    for (std::size_t i = 0; i < function.fun_def->parameters.size(); ++i)
+        assembler.store(Register::Rbp, slot(i), argument_registers[i]);
+
+    std::vector<IRBlock*>& order = allocation.order;
+    for (IRBlock* block: order)
+        block_labels[block] = assembler.newLabel();
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        IRBlock* next = i + 1 < order.size() ? order[i + 1] : nullptr;
+        assembler.bind(block_labels[order[i]]);
+        for (auto& instr: order[i]->instructions)
+            compileInstruction(instr.get(), next);
+    }
+
+    // Integer division by zero aborts, as it does when interpreted
+    assembler.bind(abort_label);
+    assembler.mov(Register::Rax, reinterpret_cast<uint64_t>(&divisionByZero));
+    assembler.call(Register::Rax);
+
+    assembler.bind(overflow_label);
+    assembler.mov(Register::Rax, reinterpret_cast<uint64_t>(&stackOverflow));
+    assembler.call(Register::Rax);
+}
+
+// Instructions
+void
+JitCompiler::compileInstruction(IRInstruction* instr, IRBlock* next)
+{
+    switch (instr->opcode) {
+        case IROpcode::Param:
+        case IROpcode::Phi:
+        case IROpcode::Const:
+            // Arguments are in place, phis are written by their predecessors
+            // and constants are immediates of the instructions using them
+            break;
+
+        case IROpcode::Copy:
+            load(Register::Rax, instr->operands[0]);
+            store(instr, Register::Rax);
+            break;
+
+        case IROpcode::LoadGlobal:
+            assembler.load(Register::Rax, globals_register, 16 * instr->index + 8);
+            store(instr, Register::Rax);
+            break;
+
+        case IROpcode::StoreGlobal:
+            load(Register::Rax, instr->operands[0]);
+            assembler.store(globals_register, 16 * instr->index + 8, Register::Rax);
+            assembler.store32(
+                globals_register,
+                16 * instr->index,
+                static_cast<uint32_t>(instr->operands[0]->type)
+            );
+            break;
+
+        case IROpcode::Operation:
+            compileOperation(instr);
+            break;
+
+        case IROpcode::Call:
+            compileCall(instr);
+            break;
+
+        case IROpcode::Jump:
+            compilePhiCopies(instr->block, instr->targets[0]);
+            compileJump(instr->targets[0], next);
+            break;
+
+        case IROpcode::Branch:
+            // Critical edges are split so neither target has phis
+            load(Register::Rax, instr->operands[0]);
+            assembler.test8(Register::Rax, Register::Rax);
+            assembler.jcc(Condition::Equal, block_labels[instr->targets[1]]);
+            compileJump(instr->targets[0], next);
+            break;
+
+        case IROpcode::Return:
+            if (instr->operands.size())
+                load(Register::Rax, instr->operands[0]);
+            assembler.leave();
+            assembler.ret();
+            break;
+    }
+}
+
+void
+JitCompiler::compileOperation(IRInstruction* instr)
+{
+    load(Register::Rax, instr->operands[0]);
+    if (instr->operands.size() > 1)
+        load(Register::Rcx, instr->operands[1]);
+
+    // Integer comparisons, then floating point ones which need the unordered case
+    auto compare = [&](enum Condition condition) {
+        assembler.cmp(Register::Rax, Register::Rcx);
+        assembler.setcc(condition, Register::Rax);
+        assembler.movzx8(Register::Rax, Register::Rax);
+    };
+    auto compareFloat = [&](enum Condition condition, bool swap) {
+        assembler.movq(XmmRegister::Xmm0, Register::Rax);
+        assembler.movq(XmmRegister::Xmm1, Register::Rcx);
+        if (swap)
+            assembler.ucomisd(XmmRegister::Xmm1, XmmRegister::Xmm0);
+        else
+            assembler.ucomisd(XmmRegister::Xmm0, XmmRegister::Xmm1);
+        assembler.setcc(condition, Register::Rax);
+        assembler.movzx8(Register::Rax, Register::Rax);
+    };
+    auto arithmeticFloat = [&](void (Assembler::*op)(XmmRegister, XmmRegister)) {
+        assembler.movq(XmmRegister::Xmm0, Register::Rax);
+        assembler.movq(XmmRegister::Xmm1, Register::Rcx);
+        (assembler.*op)(XmmRegister::Xmm0, XmmRegister::Xmm1);
+        assembler.movq(Register::Rax, XmmRegister::Xmm0);
+    };
+    auto divide = [&](bool is_signed, bool remainder) {
+        assembler.test(Register::Rcx, Register::Rcx);
+        assembler.jcc(Condition::Equal, abort_label);
+        if (is_signed) {
+            assembler.cqo();
+            assembler.idiv(Register::Rcx);
+        }
+        else {
+            assembler.xorq(Register::Rdx, Register::Rdx);
+            assembler.div(Register::Rcx);
+        }
+        if (remainder)
+            assembler.mov(Register::Rax, Register::Rdx);
+    };
+
+    switch (instr->operation) {
+        case Operation::AddI64:
+        case Operation::AddU64:
+            assembler.add(Register::Rax, Register::Rcx);
+            break;
+
+        case Operation::SubI64:
+        case Operation::SubU64:
+            assembler.sub(Register::Rax, Register::Rcx);
+            break;
+
+        case Operation::MulI64:
+        case Operation::MulU64:
+            assembler.imul(Register::Rax, Register::Rcx);
+            break;
+
+        case Operation::DivI64:
+            divide(true, false);
+            break;
+
+        case Operation::RemI64:
+            divide(true, true);
+            break;
+
+        case Operation::DivU64:
+            divide(false, false);
+            break;
+
+        case Operation::RemU64:
+            divide(false, true);
+            break;
+
+        case Operation::NegI64:
+        case Operation::NegU64:
+            assembler.neg(Register::Rax);
+            break;
+
+        case Operation::BnotI64:
+        case Operation::BnotU64:
+            assembler.notq(Register::Rax);
+            break;
+
+        case Operation::EqI64:
+        case Operation::EqU64:
+        case Operation::EqBool:
+            compare(Condition::Equal);
+            break;
+
+        case Operation::NeI64:
+        case Operation::NeU64:
+        case Operation::NeBool:
+            compare(Condition::NotEqual);
+            break;
+
+        case Operation::GtI64:
+            compare(Condition::Greater);
+            break;
+
+        case Operation::GeI64:
+            compare(Condition::GreaterEqual);
+            break;
+
+        case Operation::LtI64:
+            compare(Condition::Less);
+            break;
+
+        case Operation::LeI64:
+            compare(Condition::LessEqual);
+            break;
+
+        case Operation::GtU64:
+            compare(Condition::Above);
+            break;
+
+        case Operation::GeU64:
+            compare(Condition::AboveEqual);
+            break;
+
+        case Operation::LtU64:
+            compare(Condition::Below);
+            break;
+
+        case Operation::LeU64:
+            compare(Condition::BelowEqual);
+            break;
+
+        case Operation::AddF64:
+            arithmeticFloat(&Assembler::addsd);
+            break;
+
+        case Operation::SubF64:
+            arithmeticFloat(&Assembler::subsd);
+            break;
+
+        case Operation::MulF64:
+            arithmeticFloat(&Assembler::mulsd);
+            break;
+
+        case Operation::DivF64:
+            arithmeticFloat(&Assembler::divsd);
+            break;
+
+        case Operation::NegF64:
+            assembler.btc(Register::Rax, 63);
+            break;
+
+        // Unordered operands compare false, except for inequality
+        case Operation::EqF64:
+            compareFloat(Condition::Equal, false);
+            assembler.setcc(Condition::NoParity, Register::Rcx);
+            assembler.and8(Register::Rax, Register::Rcx);
+            break;
+
+        case Operation::NeF64:
+            compareFloat(Condition::NotEqual, false);
+            assembler.setcc(Condition::Parity, Register::Rcx);
+            assembler.or8(Register::Rax, Register::Rcx);
+            break;
+
+        case Operation::GtF64:
+            compareFloat(Condition::Above, false);
+            break;
+
+        case Operation::GeF64:
+            compareFloat(Condition::AboveEqual, false);
+            break;
+
+        case Operation::LtF64:
+            compareFloat(Condition::Above, true);
+            break;
+
+        case Operation::LeF64:
+            compareFloat(Condition::AboveEqual, true);
+            break;
+
+        case Operation::NotBool:
+            assembler.mov(Register::Rcx, static_cast<uint64_t>(1));
+            assembler.xorq(Register::Rax, Register::Rcx);
+            break;
+    }
+
+    store(instr, Register::Rax);
+}
+
+void
+JitCompiler::compileCall(IRInstruction* instr)
+{
+    CleanFunctionDefinition* callee = instr->callee;
+    if (callee->is_intrinsic) {
+        compileNativeCall(instr);
+        return;
+    }
+
+    // Arguments come from slots or immediates so loading them never overwrites one
+    for (std::size_t i = 0; i < instr->operands.size(); ++i)
+        load(argument_registers[i], instr->operands[i]);
+
+    // A tail call leaves the frame and jumps, the callee returns to our caller
+    if (instr->is_tail_call) {
+        assembler.leave();
+        assembler.jmp(bodies[callee]);
+        return;
+    }
+
+    assembler.call(bodies[callee]);
+    if (instr->type != ValueType::Void)
+        store(instr, Register::Rax);
+}
+
+void
+JitCompiler::compileNativeCall(IRInstruction* instr)
+{
+    // Natives read their arguments as values at the bottom of the frame
+    for (std::size_t i = 0; i < instr->operands.size(); ++i) {
+        load(Register::Rax, instr->operands[i]);
+        assembler.store(Register::Rsp, 16 * i + 8, Register::Rax);
+        assembler.store32(
+            Register::Rsp,
+            16 * i,
+            static_cast<uint32_t>(instr->operands[i]->type)
+        );
+    }
+
+    assembler.lea(Register::Rdi, Register::Rsp, 0);
+    assembler.mov(Register::Rsi, static_cast<uint64_t>(instr->operands.size()));
+    assembler.mov(Register::Rax, reinterpret_cast<uint64_t>(nativeOf(instr->callee)));
+    assembler.call(Register::Rax);
+
+    // The payload of the value comes back in the second register
+    if (instr->type != ValueType::Void)
+        store(instr, Register::Rdx);
+}
+
+// Copy the values flowing into the phis of a block as if all at once
+void
+JitCompiler::compilePhiCopies(IRBlock* from, IRBlock* to)
+{
+    std::size_t index = std::find(
+        to->predecessors.begin(),
+        to->predecessors.end(),
+        from
+    ) - to->predecessors.begin();
+
+    // Constants have no slot, they are written before anything else could overwrite them
+    struct Move {
+        std::size_t dst;
+        std::size_t src;
+    };
+    std::vector<Move> moves;
+    std::vector<IRInstruction*> constants;
+    for (auto& instr: to->instructions) {
+        if (instr->opcode != IROpcode::Phi)
+            break;
+
+        IRInstruction* operand = instr->operands[index];
+        std::size_t dst = allocation.registers.at(instr.get());
+        if (operand->opcode == IROpcode::Const)
+            constants.push_back(instr.get());
+        else if (dst != allocation.registers.at(operand))
+            moves.push_back({dst, allocation.registers.at(operand)});
+    }
+
+    // A copy waits while another one still reads its destination,
+    // when they all wait on each other one destination is set aside
+    while (moves.size()) {
+        bool progress = false;
+        for (std::size_t i = 0; i < moves.size(); ++i) {
+            std::size_t dst = moves[i].dst;
+            bool read = false;
+            for (auto& move: moves)
+                read = read || move.src == dst;
+            if (read)
+                continue;
+
+            assembler.load(Register::Rax, Register::Rbp, slot(moves[i].src));
+            assembler.store(Register::Rbp, slot(dst), Register::Rax);
+            moves.erase(moves.begin() + i);
+            progress = true;
+            break;
+        }
+
+        if (progress)
+            continue;
+
+        std::size_t saved = moves[0].dst;
+        assembler.load(Register::Rax, Register::Rbp, slot(saved));
+        assembler.store(Register::Rbp, slot(scratch), Register::Rax);
+        for (auto& move: moves) {
+            if (move.src == saved)
+                move.src = scratch;
+        }
+    }
+
+    for (IRInstruction* phi: constants) {
+        load(Register::Rax, phi->operands[index]);
+        store(phi, Register::Rax);
+    }
+}
+
+// Jump to a block unless it comes next
+void
+JitCompiler::compileJump(IRBlock* target, IRBlock* next)
+{
+    if (target != next)
+        assembler.jmp(block_labels[target]);
+}
+
+// Values
+void
+JitCompiler::load(Register dst, IRInstruction* value)
+{
+    if (value->opcode == IROpcode::Const)
+        assembler.mov(dst, value->value.as_uint);
+    else
+        assembler.load(dst, Register::Rbp, slot(allocation.registers.at(value)));
+}
+
+void
+JitCompiler::store(IRInstruction* value, Register src)
+{
+    assembler.store(Register::Rbp, slot(allocation.registers.at(value)), src);
+}
+
+int32_t
+JitCompiler::slot(std::size_t reg)
+{
+    return -8 * static_cast<int32_t>(reg + 1);
+}
+
+// The lowest address of the thread's stack, less a margin for the natives compiled code calls
+static uintptr_t
+findStackLimit()
+{
+    void* base = nullptr;
+    std::size_t size = 0;
+    pthread_attr_t attributes;
+    if (pthread_getattr_np(pthread_self(), &attributes) == 0) {
+        pthread_attr_getstack(&attributes, &base, &size);
+        pthread_attr_destroy(&attributes);
+    }
+
+    // Without the bounds of the stack, assume it goes as far as its limit from here
+    if (base == nullptr) {
+        size = 8 << 20;
+        struct rlimit limit;
+        if (getrlimit(RLIMIT_STACK, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY)
+            size = limit.rlim_cur;
+        base = static_cast<char*>(__builtin_frame_address(0)) - size;
+    }
+
+    return reinterpret_cast<uintptr_t>(base) + std::min<std::size_t>(size / 8, 1 << 20);
+}
+
+// Whether values of the type fit in a machine register
+static bool
+isMachineType(enum ValueType type)
+{
+    return type != ValueType::String;
+}
+
+// The native function an intrinsic calls
+static NativeFunction
+nativeOf(CleanFunctionDefinition* fun_def)
+{
+    // The body of an intrinsic returns the intrinsic expression
+    CleanReturnStatement* ret_stmt = static_cast<CleanReturnStatement*>(
+        fun_def->body->statements[0].get()
+    );
+    CleanIntrinsicExpression* intr_expr =
+        static_cast<CleanIntrinsicExpression*>(ret_stmt->expression.get());
+    return intr_expr->callable;
+}
+
+// Compiled code divided an integer by zero
+[[noreturn]] static void
+divisionByZero()
+{
+    std::abort();
+}
+
+// Compiled code ran out of stack
+[[noreturn]] static void
+stackOverflow()
+{
+    std::cout.flush();
+    std::cerr << "JIT execution failed: stack overflow." << std::endl;
+    std::abort();
+}
@@ -0,0 +1,78 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdexcept>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "jit/memory.h"
+
+
+ExecutableMemory::ExecutableMemory(
+    std::vector<uint8_t> const& code
+) : pages(nullptr),
+    size(0)
+{
+    std::size_t page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    size = (code.size() + page_size - 1) / page_size * page_size;
+    if (size == 0)
+        return;
+
+    pages = mmap(
+        nullptr,
+        size,
+        PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS,
+        -1,
+        0
+    );
+    if (pages == MAP_FAILED) {
+        pages = nullptr;
+        throw std::runtime_error(
+            "JIT compilation failed: could not allocate code memory."
+        );
+    }
+
+    std::memcpy(pages, code.data(), code.size());
+    if (mprotect(pages, size, PROT_READ | PROT_EXEC) != 0) {
+        munmap(pages, size);
+        pages = nullptr;
+        throw std::runtime_error(
+            "JIT compilation failed: could not make code memory executable."
+        );
+    }
+}
+
+ExecutableMemory::~ExecutableMemory()
+{
+    if (pages)
+        munmap(pages, size);
+}
+
+/**
+ * Returns the address of the code at the given offset.
+ */
+void const*
+ExecutableMemory::at(std::size_t offset) const
+{
+    return static_cast<uint8_t const*>(pages) + offset;
+}
@@ -0,0 +1,71 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdexcept>
+#include <iostream>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include <string>
+
+#include "cleaner/ast/definitions/function.h"
+#include "interpreter/tiering.h"
+#include "jit/compiler.h"
+#include "jit/tiering.h"
+#include "ir/ir.h"
+
+
+JitTiering::JitTiering(
+    IRModule& module,
+    std::size_t threshold,
+    bool trace
+) : Tiering(threshold),
+    module(module),
+    trace(trace)
+{}
+
+/**
+ * Gives the given hot function machine code if the JIT supports it.
+ */
+void
+JitTiering::promote(CleanFunctionDefinition* fun_def)
+{
+    // Calling a hot function may have compiled this one already
+    if (fun_def->compiled)
+        return;
+
+    std::string outcome;
+    try {
+        JitProgram program = JitCompiler(module).compile(fun_def);
+        if (program.size()) {
+            program.install();
+            outcome = "compiled with " + std::to_string(program.size()) + " function(s)";
+            programs.push_back(std::move(program));
+        }
+        else {
+            outcome = "not supported, stays interpreted";
+        }
+    } catch (std::runtime_error& e) {
+        outcome = e.what();
+    }
+
+    if (trace)
+        std::cerr << "tier-up " << fun_def->name << " after "
+                  << fun_def->invocations << " calls and "
+                  << fun_def->back_edges << " loop iterations: "
+                  << outcome << std::endl;
+}
@@ -15,11 +15,17 @@
  *  limitations under the License.
  */
 
+#include <string_view>
 #include <stdexcept>
 #include <iterator>
+#include <cstddef>
+#include <utility>
 #include <string>
+#include <array>
 
 #include "common/token_type.h"
+#include "common/source.h"
+#include "lexer/scanner.h"
 #include "common/token.h"
 #include "lexer/lexer.h"
 
@@ -29,34 +35,28 @@ isDigit(char c);
 static bool
 isAlpha(char c);
 
-static bool
-isAlphaNumeric(char c);
+static enum TokenType
+keywordType(std::string_view lexeme);
 
 
 Lexer::Lexer(
-    std::shared_ptr<std::string> const& source,
+    SourceBuffer source,
     std::string const& source_path
-) : source(source),
-    source_path(source_path),
-    start(source->begin()),
-    current(source->begin()),
+) : source(SourceManager::add(std::move(source), source_path)),
+    text(SourceManager::getText(this->source)),
+    start(text.begin()),
+    current(text.begin()),
     line(1),
     column(1),
-    num_tokens(0)
-{
-    keywords["true"]        = PROTO_TRUE;
-    keywords["false"]       = PROTO_FALSE;
-    keywords["function"]    = PROTO_FUNCTION;
-    keywords["const"]       = PROTO_CONST;
-    keywords["if"]          = PROTO_IF;
-    keywords["elif"]        = PROTO_ELIF;
-    keywords["else"]        = PROTO_ELSE;
-    keywords["for"]         = PROTO_FOR;
-    keywords["while"]       = PROTO_WHILE;
-    keywords["continue"]    = PROTO_CONTINUE;
-    keywords["break"]       = PROTO_BREAK;
-    keywords["return"]      = PROTO_RETURN;
-}
+    num_tokens(0),
+    scanner()
+{}
+
+Lexer::Lexer(
+    std::string source,
+    std::string const& source_path
+) : Lexer(SourceBuffer(std::move(source)), source_path)
+{}
 
 
 /**
@@ -283,7 +283,7 @@ Lexer::string()
     Token string_token = makeToken(PROTO_STRING);
     
     // trim the surrounding quotes around the string
-    string_token.start++;
+    string_token.offset++;
     string_token.length -= 2;
 
     return string_token;
@@ -296,20 +296,14 @@ Lexer::string()
 Token
 Lexer::identifier()
 {
-    while(isAlphaNumeric(peek()))
-        advance();
-    
-    std::string identifier = source->substr(
-        std::distance(source->begin(), start),
+    skip(scanner.skipIdentifier(position(), end()));
+
+    std::string_view identifier(
+        text.data() + (start - text.begin()),
         current - start
     );
 
-    try {
-        enum TokenType type = keywords.at(identifier);
-        return makeToken(type);
-    } catch (std::out_of_range e) {
-        return makeToken(PROTO_IDENTIFIER);
-    }
+    return makeToken(keywordType(identifier));
 }
 
 
@@ -326,7 +320,7 @@ Lexer::skipWhitespace()
             case '\r':
             case '\t':
             case ' ':
-                advance();
+                skip(scanner.skipBlanks(position(), end()));
                 break;
 
             // We treat comments as whitespace and handle them here
@@ -368,9 +362,8 @@ continue_skipping:
 void
 Lexer::skipSingleComment(bool issue_new_line)
 {
-    while (peek() != '\n' && atEnd() == false)
-        advance();
-    
+    skip(scanner.skipLine(position(), end()));
+
     if (! issue_new_line) {
         advance();
         line++;
@@ -386,6 +379,21 @@ Lexer::skipMultiComment(bool issue_new_line)
     bool terminated = false;
 
     while (atEnd() == false) {
+        // Skip at once what can neither open nor close a comment
+        ScanRun run = scanner.skipCommentBody(position(), end());
+        current += run.length;
+        if (run.newlines) {
+            // As below, a newline sets the column to 1 before advancing past it
+            line += run.newlines;
+            column = run.length - run.line_start + 2;
+        }
+        else {
+            column += run.length;
+        }
+
+        if (atEnd())
+            break;
+
         // if we have nested comments
         if (peek() == '/' && peekFront() == '*') {
             levels++;
@@ -436,14 +444,14 @@ Lexer::skipMultiComment(bool issue_new_line)
 bool
 Lexer::atStart()
 {
-    return current == source->begin();
+    return current == text.begin();
 }
 
 // Returns true if we are at the end of the source.
 bool
 Lexer::atEnd()
 {
-    return current == source->end();
+    return current == text.end();
 }
 
 // Returns current char in the stream and advance to the next.
@@ -502,6 +510,27 @@ Lexer::peekBack()
     return * (current - 1);
 }
 
+// Skips the run of characters the scanner found, the run must not span lines.
+void
+Lexer::skip(std::size_t length)
+{
+    current += length;
+    column += length;
+}
+
+// Returns pointers to the current character and past the end of the source, for the scanner.
+char const*
+Lexer::position()
+{
+    return text.data() + (current - text.begin());
+}
+
+char const*
+Lexer::end()
+{
+    return text.data() + text.size();
+}
+
 // Create a token.
 Token
 Lexer::makeToken(enum TokenType type)
@@ -509,9 +538,8 @@ Lexer::makeToken(enum TokenType type)
     return Token(
         type,
         source,
-        source_path,
-        start,
-        static_cast<std::string::size_type>(current - start),
+        static_cast<std::size_t>(start - text.begin()),
+        static_cast<std::size_t>(current - start),
         line,
         column
     );
@@ -538,11 +566,75 @@ isAlpha(char c)
 }
 
 
+/* Keywords are hashed into a table with one keyword per slot. */
+static constexpr std::size_t keyword_slots = 32;
+
 /**
- * Returns true if we have a digit or a letter or an underscore.
+ * Hashes a lexeme from its length, first and last characters.
  */
-static bool
-isAlphaNumeric(char c)
+static constexpr std::size_t
+keywordHash(std::string_view lexeme, std::size_t seed)
+{
+    return (
+        lexeme.size() +
+        static_cast<unsigned char>(lexeme.front()) * seed +
+        static_cast<unsigned char>(lexeme.back())
+    ) % keyword_slots;
+}
+
+/**
+ * Returns the smallest seed that gives every keyword its own slot.
+ */
+static constexpr std::size_t
+findKeywordSeed()
+{
+    for (std::size_t seed = 1; seed < 1024; ++seed) {
+        bool taken[keyword_slots] = {};
+        bool perfect = true;
+
+        for (Keyword const& keyword: keywords) {
+            std::size_t slot = keywordHash(keyword.lexeme, seed);
+            perfect = perfect && ! taken[slot];
+            taken[slot] = true;
+        }
+
+        if (perfect)
+            return seed;
+    }
+
+    return 0;
+}
+
+static constexpr std::size_t keyword_seed = findKeywordSeed();
+static_assert(keyword_seed != 0, "Lexer failed: the keywords have no perfect hash.");
+
+/**
+ * Places every keyword in the slot its hash gives,
+ * the slots left over hold an empty lexeme no identifier matches.
+ */
+static constexpr std::array<Keyword, keyword_slots>
+buildKeywordTable()
+{
+    std::array<Keyword, keyword_slots> table = {};
+    for (std::size_t i = 0; i < keyword_slots; ++i)
+        table[i] = {"", PROTO_IDENTIFIER};
+
+    for (Keyword const& keyword: keywords)
+        table[keywordHash(keyword.lexeme, keyword_seed)] = keyword;
+
+    return table;
+}
+
+static constexpr std::array<Keyword, keyword_slots> keyword_table = buildKeywordTable();
+
+
+/**
+ * Returns the type of the keyword with the given lexeme,
+ * or that of an identifier if no keyword has that lexeme.
+ */
+static enum TokenType
+keywordType(std::string_view lexeme)
 {
-    return isAlpha(c) || isDigit(c);
+    Keyword const& keyword = keyword_table[keywordHash(lexeme, keyword_seed)];
+    return keyword.lexeme == lexeme ? keyword.type : PROTO_IDENTIFIER;
 }
@@ -0,0 +1,364 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define PROTO_SCANNER_SIMD
+#include <immintrin.h>
+#endif
+
+#include "lexer/scanner.h"
+
+
+/* Kinds of runs, each ends on a different set of characters. */
+enum class RunClass
+{
+    Blanks,
+    Identifier,
+    Line,
+    CommentBody
+};
+
+template <RunClass run_class>
+static ScanRun scan(ScanLevel level, char const* begin, char const* end);
+
+
+/**
+ * Scans with the widest instructions the processor supports.
+ */
+Scanner::Scanner(
+) : level(supportedLevel())
+{}
+
+/**
+ * Scans with the given instructions if the processor supports them,
+ * with the widest it supports otherwise.
+ */
+Scanner::Scanner(
+    ScanLevel level
+) : level(std::min(level, supportedLevel()))
+{}
+
+/**
+ * Returns the widest instructions the processor supports,
+ * checked once when first asked.
+ */
+ScanLevel
+Scanner::supportedLevel()
+{
+#ifdef PROTO_SCANNER_SIMD
+    // SSE2 is part of x86-64, AVX2 also needs the system to save its registers
+    static ScanLevel const level = __builtin_cpu_supports("avx2")
+        ? ScanLevel::AVX2
+        : ScanLevel::SSE2;
+    return level;
+#else
+    return ScanLevel::Scalar;
+#endif
+}
+
+/**
+ * Each returns the length of the run of characters starting at `begin`
+ * that the lexer skips the same way, never reading at or past `end`.
+ */
+// Spaces, tabs and carriage returns
+std::size_t
+Scanner::skipBlanks(char const* begin, char const* end) const
+{
+    return scan<RunClass::Blanks>(level, begin, end).length;
+}
+
+// Letters, digits and underscores
+std::size_t
+Scanner::skipIdentifier(char const* begin, char const* end) const
+{
+    return scan<RunClass::Identifier>(level, begin, end).length;
+}
+
+// Anything up to a newline
+std::size_t
+Scanner::skipLine(char const* begin, char const* end) const
+{
+    return scan<RunClass::Line>(level, begin, end).length;
+}
+
+// Anything up to a character that may open or close a comment, counting newlines
+ScanRun
+Scanner::skipCommentBody(char const* begin, char const* end) const
+{
+    return scan<RunClass::CommentBody>(level, begin, end);
+}
+
+
+/**
+ * Returns true if the given character ends a run of the given class.
+ */
+template <RunClass run_class>
+static inline bool
+endsRun(char c)
+{
+    switch (run_class) {
+        case RunClass::Blanks:
+            return c != ' ' && c != '\t' && c != '\r';
+
+        case RunClass::Identifier: {
+            // Setting the case bit turns upper case letters into lower case ones
+            char lower = c | 0x20;
+            return ! (
+                (lower >= 'a' && lower <= 'z') ||
+                (c >= '0' && c <= '9')         ||
+                c == '_'
+            );
+        }
+
+        case RunClass::Line:
+            return c == '\n';
+
+        case RunClass::CommentBody:
+            return c == '/' || c == '*';
+    }
+
+    return true;
+}
+
+/**
+ * Scans one character at a time from `current` to the end of a run
+ * that started at `begin`, adding to what was found so far.
+ */
+template <RunClass run_class>
+static ScanRun
+scanScalar(char const* begin, char const* current, char const* end, ScanRun run)
+{
+    for (; current < end && ! endsRun<run_class>(* current); ++current) {
+        if (run_class == RunClass::CommentBody && * current == '\n') {
+            run.newlines++;
+            run.line_start = current - begin + 1;
+        }
+    }
+
+    run.length = current - begin;
+    return run;
+}
+
+#ifdef PROTO_SCANNER_SIMD
+/**
+ * Adds to a run the newlines at the set bits of the mask
+ * of a block that starts at the given index in the run.
+ */
+static inline void
+countNewlines(ScanRun& run, uint32_t newlines, std::size_t index)
+{
+    if (newlines == 0)
+        return;
+
+    run.newlines += __builtin_popcount(newlines);
+    run.line_start = index + (31 - __builtin_clz(newlines)) + 1;
+}
+
+/**
+ * Returns a mask with a bit set for each of the 16 characters
+ * of the block that ends a run of the given class.
+ */
+template <RunClass run_class>
+static inline uint32_t
+runEndsSSE2(__m128i block)
+{
+    __m128i in_run = _mm_setzero_si128();
+    switch (run_class) {
+        case RunClass::Blanks:
+            in_run = _mm_or_si128(
+                _mm_or_si128(
+                    _mm_cmpeq_epi8(block, _mm_set1_epi8(' ')),
+                    _mm_cmpeq_epi8(block, _mm_set1_epi8('\t'))
+                ),
+                _mm_cmpeq_epi8(block, _mm_set1_epi8('\r'))
+            );
+            break;
+
+        case RunClass::Identifier: {
+            // Characters past ASCII are negative and fail both signed ranges
+            __m128i lower = _mm_or_si128(block, _mm_set1_epi8(0x20));
+            __m128i letters = _mm_and_si128(
+                _mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                _mm_cmpgt_epi8(_mm_set1_epi8('z' + 1), lower)
+            );
+            __m128i digits = _mm_and_si128(
+                _mm_cmpgt_epi8(block, _mm_set1_epi8('0' - 1)),
+                _mm_cmpgt_epi8(_mm_set1_epi8('9' + 1), block)
+            );
+            in_run = _mm_or_si128(
+                _mm_or_si128(letters, digits),
+                _mm_cmpeq_epi8(block, _mm_set1_epi8('_'))
+            );
+            break;
+        }
+
+        case RunClass::Line:
+            return _mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8('\n')));
+
+        case RunClass::CommentBody:
+            return _mm_movemask_epi8(
+                _mm_or_si128(
+                    _mm_cmpeq_epi8(block, _mm_set1_epi8('/')),
+                    _mm_cmpeq_epi8(block, _mm_set1_epi8('*'))
+                )
+            );
+    }
+
+    return ~static_cast<uint32_t>(_mm_movemask_epi8(in_run)) & 0xFFFF;
+}
+
+/**
+ * Scans 16 characters at a time while they all belong to the run,
+ * the characters left past the last full block are scanned one at a time.
+ */
+template <RunClass run_class>
+static ScanRun
+scanSSE2(char const* begin, char const* end)
+{
+    ScanRun run = {0, 0, 0};
+    char const* current = begin;
+
+    while (end - current >= 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<__m128i const*>(current));
+        uint32_t ends = runEndsSSE2<run_class>(block);
+
+        uint32_t newlines = 0;
+        if (run_class == RunClass::CommentBody)
+            newlines = _mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8('\n')));
+
+        if (ends) {
+            std::size_t length = __builtin_ctz(ends);
+            countNewlines(run, newlines & ((1u << length) - 1), current - begin);
+            run.length = current - begin + length;
+            return run;
+        }
+
+        countNewlines(run, newlines, current - begin);
+        current += 16;
+    }
+
+    return scanScalar<run_class>(begin, current, end, run);
+}
+
+/**
+ * Returns a mask with a bit set for each of the 32 characters
+ * of the block that ends a run of the given class.
+ */
+template <RunClass run_class>
+static inline __attribute__((target("avx2"))) uint32_t
+runEndsAVX2(__m256i block)
+{
+    __m256i in_run = _mm256_setzero_si256();
+    switch (run_class) {
+        case RunClass::Blanks:
+            in_run = _mm256_or_si256(
+                _mm256_or_si256(
+                    _mm256_cmpeq_epi8(block, _mm256_set1_epi8(' ')),
+                    _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\t'))
+                ),
+                _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\r'))
+            );
+            break;
+
+        case RunClass::Identifier: {
+            // Characters past ASCII are negative and fail both signed ranges
+            __m256i lower = _mm256_or_si256(block, _mm256_set1_epi8(0x20));
+            __m256i letters = _mm256_and_si256(
+                _mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+                _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), lower)
+            );
+            __m256i digits = _mm256_and_si256(
+                _mm256_cmpgt_epi8(block, _mm256_set1_epi8('0' - 1)),
+                _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), block)
+            );
+            in_run = _mm256_or_si256(
+                _mm256_or_si256(letters, digits),
+                _mm256_cmpeq_epi8(block, _mm256_set1_epi8('_'))
+            );
+            break;
+        }
+
+        case RunClass::Line:
+            return _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('\n')));
+
+        case RunClass::CommentBody:
+            return _mm256_movemask_epi8(
+                _mm256_or_si256(
+                    _mm256_cmpeq_epi8(block, _mm256_set1_epi8('/')),
+                    _mm256_cmpeq_epi8(block, _mm256_set1_epi8('*'))
+                )
+            );
+    }
+
+    return ~static_cast<uint32_t>(_mm256_movemask_epi8(in_run));
+}
+
+/**
+ * Scans 32 characters at a time while they all belong to the run,
+ * the characters left past the last full block are scanned one at a time.
+ */
+template <RunClass run_class>
+static __attribute__((target("avx2"))) ScanRun
+scanAVX2(char const* begin, char const* end)
+{
+    ScanRun run = {0, 0, 0};
+    char const* current = begin;
+
+    while (end - current >= 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(current));
+        uint32_t ends = runEndsAVX2<run_class>(block);
+
+        uint32_t newlines = 0;
+        if (run_class == RunClass::CommentBody)
+            newlines = _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('\n')));
+
+        if (ends) {
+            std::size_t length = __builtin_ctz(ends);
+            countNewlines(run, newlines & ((1u << length) - 1), current - begin);
+            run.length = current - begin + length;
+            return run;
+        }
+
+        countNewlines(run, newlines, current - begin);
+        current += 32;
+    }
+
+    return scanScalar<run_class>(begin, current, end, run);
+}
+#endif
+
+/**
+ * Scans a run of the given class with the given instructions.
+ */
+template <RunClass run_class>
+static ScanRun
+scan(ScanLevel level, char const* begin, char const* end)
+{
+#ifdef PROTO_SCANNER_SIMD
+    if (level == ScanLevel::AVX2)
+        return scanAVX2<run_class>(begin, end);
+
+    if (level == ScanLevel::SSE2)
+        return scanSSE2<run_class>(begin, end);
+#endif
+
+    return scanScalar<run_class>(begin, begin, end, ScanRun{0, 0, 0});
+}
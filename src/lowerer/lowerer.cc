@@ -0,0 +1,275 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdexcept>
+#include <memory>
+#include <string>
+#include <map>
+
+#include "cleaner/ast/expressions/expression.h"
+#include "cleaner/ast/definitions/function.h"
+#include "cleaner/ast/statements/statement.h"
+#include "cleaner/ast/statements/return.h"
+#include "cleaner/ast/statements/while.h"
+#include "cleaner/ast/statements/block.h"
+#include "cleaner/ast/statements/for.h"
+#include "cleaner/ast/statements/if.h"
+#include "cleaner/symbols/scope.h"
+#include "common/operation.h"
+#include "lowerer/lowerer.h"
+
+
+/* Reslib operators that have a typed operation. */
+static std::map<std::string, enum Operation> const operations = {
+    // Signed integers
+    {"__add__(int,int)",        Operation::AddI64},
+    {"__sub__(int,int)",        Operation::SubI64},
+    {"__mul__(int,int)",        Operation::MulI64},
+    {"__div__(int,int)",        Operation::DivI64},
+    {"__rem__(int,int)",        Operation::RemI64},
+    {"__neg__(int)",            Operation::NegI64},
+    {"__bnot__(int)",           Operation::BnotI64},
+    {"__eq__(int,int)",         Operation::EqI64},
+    {"__ne__(int,int)",         Operation::NeI64},
+    {"__gt__(int,int)",         Operation::GtI64},
+    {"__ge__(int,int)",         Operation::GeI64},
+    {"__lt__(int,int)",         Operation::LtI64},
+    {"__le__(int,int)",         Operation::LeI64},
+
+    // Unsigned integers
+    {"__add__(uint,uint)",      Operation::AddU64},
+    {"__sub__(uint,uint)",      Operation::SubU64},
+    {"__mul__(uint,uint)",      Operation::MulU64},
+    {"__div__(uint,uint)",      Operation::DivU64},
+    {"__rem__(uint,uint)",      Operation::RemU64},
+    {"__neg__(uint)",           Operation::NegU64},
+    {"__bnot__(uint)",          Operation::BnotU64},
+    {"__eq__(uint,uint)",       Operation::EqU64},
+    {"__ne__(uint,uint)",       Operation::NeU64},
+    {"__gt__(uint,uint)",       Operation::GtU64},
+    {"__ge__(uint,uint)",       Operation::GeU64},
+    {"__lt__(uint,uint)",       Operation::LtU64},
+    {"__le__(uint,uint)",       Operation::LeU64},
+
+    // Floats
+    {"__add__(float,float)",    Operation::AddF64},
+    {"__sub__(float,float)",    Operation::SubF64},
+    {"__mul__(float,float)",    Operation::MulF64},
+    {"__div__(float,float)",    Operation::DivF64},
+    {"__neg__(float)",          Operation::NegF64},
+    {"__eq__(float,float)",     Operation::EqF64},
+    {"__ne__(float,float)",     Operation::NeF64},
+    {"__gt__(float,float)",     Operation::GtF64},
+    {"__ge__(float,float)",     Operation::GeF64},
+    {"__lt__(float,float)",     Operation::LtF64},
+    {"__le__(float,float)",     Operation::LeF64},
+
+    // Booleans
+    {"__not__(bool)",           Operation::NotBool},
+    {"__eq__(bool,bool)",       Operation::EqBool},
+    {"__ne__(bool,bool)",       Operation::NeBool}
+};
+
+Lowerer::Lowerer(
+    CleanScope* scope
+) : scope(scope)
+{}
+
+/**
+ * Replaces calls to reslib operators on primitive types
+ * by the typed operations they stand for.
+ * Logical and and or become conditional expressions
+ * so their right operand only runs when it decides the result.
+ *
+ * Operators the program defines itself are left as calls
+ * so they keep going through the functions that overload them.
+ */
+void
+Lowerer::lower()
+{
+    for (auto& [name, fun_def]: scope->getSymbols<CleanFunctionDefinition>()) {
+        if (! fun_def->is_intrinsic)
+            lowerBlock(fun_def->body.get());
+    }
+}
+
+// Statements
+void
+Lowerer::lowerStatement(std::unique_ptr<CleanStatement>& stmt)
+{
+    switch (stmt->type) {
+        case CleanStatementType::Block: {
+            lowerBlock(static_cast<CleanBlockStatement*>(stmt.get()));
+            break;
+        }
+
+        case CleanStatementType::If: {
+            CleanIfStatement* if_stmt = static_cast<CleanIfStatement*>(stmt.get());
+            lowerExpression(if_stmt->condition);
+            lowerBlock(if_stmt->body.get());
+            for (auto& elif_branch: if_stmt->elif_branches) {
+                lowerExpression(elif_branch->condition);
+                lowerBlock(elif_branch->body.get());
+            }
+            if (if_stmt->else_branch)
+                lowerBlock(if_stmt->else_branch->body.get());
+            break;
+        }
+
+        case CleanStatementType::For: {
+            CleanForStatement* for_stmt = static_cast<CleanForStatement*>(stmt.get());
+            if (for_stmt->init_clause)
+                lowerExpression(for_stmt->init_clause);
+            if (for_stmt->term_clause)
+                lowerExpression(for_stmt->term_clause);
+            if (for_stmt->incr_clause)
+                lowerExpression(for_stmt->incr_clause);
+            lowerBlock(for_stmt->body.get());
+            break;
+        }
+
+        case CleanStatementType::While: {
+            CleanWhileStatement* while_stmt =
+                static_cast<CleanWhileStatement*>(stmt.get());
+            if (while_stmt->condition)
+                lowerExpression(while_stmt->condition);
+            lowerBlock(while_stmt->body.get());
+            break;
+        }
+
+        case CleanStatementType::Break:
+        case CleanStatementType::Continue:
+            break;
+
+        case CleanStatementType::Return: {
+            CleanReturnStatement* ret_stmt =
+                static_cast<CleanReturnStatement*>(stmt.get());
+            if (ret_stmt->expression)
+                lowerExpression(ret_stmt->expression);
+            break;
+        }
+
+        case CleanStatementType::Expression: {
+            // The statement itself may be replaced
+            std::unique_ptr<CleanExpression> expr(
+                static_cast<CleanExpression*>(stmt.release())
+            );
+            lowerExpression(expr);
+            stmt = std::move(expr);
+            break;
+        }
+
+        default:
+            throw std::runtime_error(
+                "Operator lowering failed: unknow statement type."
+            );
+    }
+}
+
+// Blocks
+void
+Lowerer::lowerBlock(CleanBlockStatement* block_stmt)
+{
+    for (auto& statement: block_stmt->statements)
+        lowerStatement(statement);
+}
+
+// Expressions
+void
+Lowerer::lowerExpression(std::unique_ptr<CleanExpression>& expr)
+{
+    switch (expr->type) {
+        case CleanExpressionType::Group: {
+            lowerExpression(
+                static_cast<CleanGroupExpression*>(expr.get())->expression
+            );
+            break;
+        }
+
+        case CleanExpressionType::Call: {
+            lowerCall(expr);
+            break;
+        }
+
+        case CleanExpressionType::TernaryIf: {
+            CleanTernaryIfExpression* ternif_expr =
+                static_cast<CleanTernaryIfExpression*>(expr.get());
+            lowerExpression(ternif_expr->condition);
+            lowerExpression(ternif_expr->then_branch);
+            lowerExpression(ternif_expr->else_branch);
+            break;
+        }
+
+        case CleanExpressionType::Assignment: {
+            lowerExpression(
+                static_cast<CleanAssignmentExpression*>(expr.get())->rvalue
+            );
+            break;
+        }
+
+        case CleanExpressionType::Operation: {
+            for (auto& operand:
+                static_cast<CleanOperationExpression*>(expr.get())->operands
+            )
+                lowerExpression(operand);
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+// Calls
+void
+Lowerer::lowerCall(std::unique_ptr<CleanExpression>& expr)
+{
+    CleanCallExpression* call_expr = static_cast<CleanCallExpression*>(expr.get());
+    for (auto& argument: call_expr->arguments)
+        lowerExpression(argument);
+
+    bool is_and = call_expr->fun_name == "__and__(bool,bool)";
+    bool is_or = call_expr->fun_name == "__or__(bool,bool)";
+    auto it = operations.find(call_expr->fun_name);
+    if (it == operations.end() && ! is_and && ! is_or)
+        return;
+
+    // A function defined by the program overloads the operator
+    if (
+        scope->hasSymbol<CleanFunctionDefinition>(call_expr->fun_name) &&
+        ! scope->getSymbol<CleanFunctionDefinition>(call_expr->fun_name)->is_intrinsic
+    )
+        return;
+
+    // The right operand of a logical operator only runs when
+    // the left one does not decide the result on its own
+    if (is_and || is_or) {
+        std::unique_ptr<CleanExpression> left = std::move(call_expr->arguments[0]);
+        std::unique_ptr<CleanExpression> right = std::move(call_expr->arguments[1]);
+        expr = std::make_unique<CleanTernaryIfExpression>(
+            std::move(left),
+            is_and ? std::move(right) : std::make_unique<CleanBoolExpression>(true),
+            is_and ? std::make_unique<CleanBoolExpression>(false) : std::move(right)
+        );
+        return;
+    }
+
+    std::unique_ptr<CleanOperationExpression> op_expr =
+        std::make_unique<CleanOperationExpression>(it->second);
+    op_expr->operands = std::move(call_expr->arguments);
+    expr = std::move(op_expr);
+}
@@ -16,53 +16,223 @@
  */
 
 
+#include <stdexcept>
 #include <iostream>
+#include <fstream>
 #include <cstddef>
+#include <utility>
 #include <memory>
+#include <vector>
 #include <string>
 
-#include "intrinsics/reslib/resuint.h"
-#include "intrinsics/reslib/resint.h"
-#include "intrinsics/stdlib/stdio.h"
+#include "cleaner/ast/definitions/function.h"
 #include "interpreter/interpreter.h"
 #include "cleaner/symbols/scope.h"
 #include "parsetree/program.h"
+#include "pipeline/pipeline.h"
+#include "closure/compiler.h"
+#include "emitter/assembly.h"
 #include "cleaner/cleaner.h"
 #include "checker/checker.h"
 #include "utils/messages.h"
+#include "closure/engine.h"
 #include "parser/parser.h"
+#include "common/source.h"
+#include "vm/generator.h"
+#include "jit/compiler.h"
+#include "jit/tiering.h"
 #include "ansi_colors.h"
 #include "lexer/lexer.h"
 #include "utils/lexer.h"
-#include "utils/file.h"
+#include "common/memo.h"
+#include "emitter/c.h"
+#include "ir/ir.h"
+#include "vm/vm.h"
 
 
+/* Options given on the command line. */
+struct Options
+{
+    Options(
+    ) : backend("interpreter"),
+        memoize_pure(false),
+        memo_size(4096),
+        inline_threshold(Pipeline::default_inline_threshold),
+        dump_inlining(false),
+        emit_ir(false),
+        jit(false),
+        tiered(false),
+        tier_threshold(1000),
+        trace_tiering(false),
+        emit_c(false),
+        emit_asm(false)
+    {}
+
+    std::string backend;
+    bool memoize_pure;                  /* Cache the results of pure functions. */
+    std::size_t memo_size;              /* Entries in the cache of each function. */
+    std::size_t inline_threshold;       /* Largest function inlined, 0 disables inlining. */
+    bool dump_inlining;                 /* Report the calls that were inlined. */
+    bool emit_ir;                       /* Print the optimized IR instead of running. */
+    bool jit;                           /* Run what can be compiled as machine code. */
+    bool tiered;                        /* Compile functions once they are hot. */
+    std::size_t tier_threshold;         /* Calls and loop iterations that make a function hot. */
+    bool trace_tiering;                 /* Report the functions that were promoted. */
+    bool emit_c;                        /* Translate the program to C instead of running. */
+    bool emit_asm;                      /* Translate the program to x86-64 assembly instead of running. */
+    std::string output_path;            /* Where to write the translation, standard output if empty. */
+};
+
 int
-compile(std::string const& source_path);
+compile(std::string const& source_path, Options const& options);
+
+int
+emitC(CleanScope* scope, std::string const& output_path);
+
+int
+emitAssembly(IRModule& module, CleanScope* scope, std::string const& output_path);
+
+int
+writeOutput(std::string const& source, std::string const& output_path);
+
+void
+printMemoStats(CleanScope* scope);
+
+void
+printInlineReport(std::vector<std::string> const& report);
 
 
 int
 main(int argc, char const * argv[])
 {
-    if (argc != 2) {
-        std::cout << "Usage: proto program" << std::endl;
+    std::string source_path;
+    Options options;
+    bool valid_arguments = true;
+    for (int i = 1; i < argc; i++) {
+        std::string argument(argv[i]);
+        if (argument.rfind("--backend=", 0) == 0) {
+            options.backend = argument.substr(std::string("--backend=").size());
+        }
+        else if (argument == "--memoize-pure") {
+            options.memoize_pure = true;
+        }
+        else if (argument.rfind("--memo-size=", 0) == 0) {
+            std::string size = argument.substr(std::string("--memo-size=").size());
+            if (size.empty() || size.find_first_not_of("0123456789") != std::string::npos)
+                valid_arguments = false;
+            else
+                options.memo_size = std::stoull(size);
+        }
+        else if (argument.rfind("--inline-threshold=", 0) == 0) {
+            std::string size = argument.substr(std::string("--inline-threshold=").size());
+            if (size.empty() || size.find_first_not_of("0123456789") != std::string::npos)
+                valid_arguments = false;
+            else
+                options.inline_threshold = std::stoull(size);
+        }
+        else if (argument == "--dump-inlining") {
+            options.dump_inlining = true;
+        }
+        else if (argument == "--emit-ir") {
+            options.emit_ir = true;
+        }
+        else if (argument == "--jit") {
+            options.jit = true;
+        }
+        else if (argument == "--tiered") {
+            options.tiered = true;
+        }
+        else if (argument.rfind("--tier-threshold=", 0) == 0) {
+            std::string size = argument.substr(std::string("--tier-threshold=").size());
+            if (size.empty() || size.find_first_not_of("0123456789") != std::string::npos)
+                valid_arguments = false;
+            else
+                options.tier_threshold = std::stoull(size);
+        }
+        else if (argument == "--trace-tiering") {
+            options.tiered = true;
+            options.trace_tiering = true;
+        }
+        else if (argument == "--emit-c") {
+            options.emit_c = true;
+        }
+        else if (argument == "--emit-asm") {
+            options.emit_asm = true;
+        }
+        else if (argument == "-o") {
+            if (i + 1 < argc)
+                options.output_path = argv[++i];
+            else
+                valid_arguments = false;
+        }
+        else if (source_path.empty()) {
+            source_path = argument;
+        }
+        else {
+            valid_arguments = false;
+        }
+    }
+
+    if (
+        options.backend != "interpreter"    &&
+        options.backend != "vm"             &&
+        options.backend != "closure"
+    )
+        valid_arguments = false;
+
+    if (options.memo_size == 0)
+        valid_arguments = false;
+
+    // Compiled functions are entered from the interpreter
+    if ((options.jit || options.tiered) && options.backend != "interpreter")
+        valid_arguments = false;
+
+    if (options.jit && options.tiered)
+        valid_arguments = false;
+
+    if (options.tier_threshold == 0)
+        valid_arguments = false;
+
+    // Only translated programs are written to a file
+    if (! options.output_path.empty() && ! options.emit_c && ! options.emit_asm)
+        valid_arguments = false;
+
+    if (options.emit_c && options.emit_asm)
+        valid_arguments = false;
+
+    if (! valid_arguments || source_path.empty()) {
+        std::cout << "Usage: proto [--backend=interpreter|vm|closure] "
+                     "[--memoize-pure] [--memo-size=entries] "
+                     "[--inline-threshold=size] [--dump-inlining] [--emit-ir] [--jit] "
+                     "[--tiered] [--tier-threshold=count] [--trace-tiering] "
+                     "[--emit-c|--emit-asm [-o output]] program" << std::endl;
     }
     else {
-        return compile(std::string(argv[1]));
+        return compile(source_path, options);
     }
 
     return 0;
 }
 
 int
-compile(std::string const& source_path)
+compile(std::string const& source_path, Options const& options)
 {
-    /* We begin by making sure the given source path exists */
-    if (fileExists(source_path) == false) {
+    /* The text of the sources lives as long as the compilation */
+    SourceManager sources;
+
+    /* We begin by opening the source, mapping it when it is a regular file */
+    SourceBuffer source;
+    try {
+        source = SourceBuffer::open(source_path);
+    } catch (std::invalid_argument& e) {
         std::cerr << ANSI_BRIGHT_BOLD_RED "error" ANSI_COLOR_RESET
                 ": file [" ANSI_RED << source_path << ANSI_COLOR_RESET
                 "] was not found." << std::endl;
         return 1;
+    } catch (std::runtime_error& e) {
+        std::cerr << ANSI_BRIGHT_BOLD_RED "error" ANSI_COLOR_RESET
+                  ": " << e.what() << std::endl;
+        return 1;
     }
 
     /* 
@@ -75,8 +245,7 @@ compile(std::string const& source_path)
      */
     std::shared_ptr<CleanScope> scope = nullptr;
     {
-        std::string source = readFile(source_path);
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(std::move(source), source_path);
 
         Program program;
         Parser parser(lexer);
@@ -87,7 +256,7 @@ compile(std::string const& source_path)
                     printMessage(
                         "error",
                         e.getToken(), e.getPrimaryMessage(),
-                        e.getSecondaryMessage(), e.getToken().source_path
+                        e.getSecondaryMessage()
                     );
                 }
 
@@ -98,7 +267,7 @@ compile(std::string const& source_path)
                 printMessage(
                     "error",
                     e.getToken(), e.getPrimaryMessage(),
-                    e.getSecondaryMessage(), e.getToken().source_path
+                    e.getSecondaryMessage()
                 );
             }
 
@@ -108,7 +277,7 @@ compile(std::string const& source_path)
                 printMessage(
                     "error",
                     e.getToken(), e.getPrimaryMessage(),
-                    e.getSecondaryMessage(), e.getToken().source_path
+                    e.getSecondaryMessage()
                 );
 
             return 1;
@@ -122,7 +291,7 @@ compile(std::string const& source_path)
                     printMessage(
                         "error",
                         e.getToken(), e.getPrimaryMessage(),
-                        e.getSecondaryMessage(), e.getToken().source_path
+                        e.getSecondaryMessage()
                     );
                 }
 
@@ -133,7 +302,7 @@ compile(std::string const& source_path)
                 printMessage(
                     "error",
                     e.getToken(), e.getPrimaryMessage(),
-                    e.getSecondaryMessage(), e.getToken().source_path
+                    e.getSecondaryMessage()
                 );
             }
             
@@ -141,7 +310,7 @@ compile(std::string const& source_path)
                 printMessage(
                     "error",
                     e.getToken(), e.getPrimaryMessage(),
-                    e.getSecondaryMessage(), e.getToken().source_path
+                    e.getSecondaryMessage()
                 );
 
             return 1;
@@ -153,7 +322,7 @@ compile(std::string const& source_path)
             printMessage(
                 "warning",
                 w.getToken(), w.getPrimaryMessage(),
-                w.getSecondaryMessage(), w.getToken().source_path
+                w.getSecondaryMessage()
             );
         }
     }
@@ -163,18 +332,188 @@ compile(std::string const& source_path)
      *
      * We process the AST found in the scope.
      *
-     * In this PoC, we just invoke the interpreter.
+     * The tree walking interpreter runs by default,
+     * the virtual machine and the closure engine run when asked for.
      */
     {
-        // Register resident and standard functions
-        Resuint().load(scope.get());
-        Resint().load(scope.get());
-        Stdio().load(scope.get());
-
-        // Run the interpreter and return the result of the program's main function
-        Interpreter interpreter(scope.get());
-        return interpreter.interpret();
+        Pipeline pipeline(scope, options.inline_threshold);
+
+        // Run the passes every backend needs, the C emitter takes the program once it is linked
+        pipeline.runUntil(PipelineStage::Link);
+        if (options.dump_inlining)
+            printInlineReport(pipeline.getInlineReport());
+        for (auto& w : pipeline.warnings) {
+            printMessage(
+                "warning",
+                w.getToken(), w.getPrimaryMessage(),
+                w.getSecondaryMessage()
+            );
+        }
+
+        // Translate the program to C if asked for instead of running it
+        if (options.emit_c)
+            return emitC(scope.get(), options.output_path);
+
+        pipeline.runUntil(PipelineStage::Hoist);
+
+        // Give pure functions a cache of their results if asked for
+        if (options.memoize_pure) {
+            for (auto& [name, fun_def]: scope->getSymbols<CleanFunctionDefinition>()) {
+                if (fun_def->is_pure && ! fun_def->is_intrinsic)
+                    fun_def->memo = std::make_unique<MemoTable>(
+                        fun_def->parameters.size(),
+                        options.memo_size
+                    );
+            }
+        }
+
+        // Lower to SSA form and optimize it for the virtual machine, the JIT,
+        // the assembly emitter or to show it
+        IRModule module;
+        if (
+            options.emit_ir             ||
+            options.emit_asm            ||
+            options.backend == "vm"     ||
+            options.jit                 ||
+            options.tiered
+        )
+            module = pipeline.buildModule();
+        if (options.emit_ir) {
+            std::cout << printModule(module);
+            return 0;
+        }
+        if (options.emit_asm)
+            return emitAssembly(module, scope.get(), options.output_path);
+
+        int result = 0;
+        if (options.backend == "vm") {
+            // Generate bytecode from the IR and get the result of the program's main function
+            Bytecode bytecode = BytecodeGenerator(module).generate();
+            VM vm(bytecode);
+            try {
+                result = vm.run();
+            } catch (std::runtime_error& e) {
+                std::cerr << ANSI_BRIGHT_BOLD_RED "error" ANSI_COLOR_RESET
+                          ": " << e.what() << std::endl;
+                return 1;
+            }
+        }
+        else if (options.backend == "closure") {
+            // Compile to closure nodes and get the result of the program's main function
+            ClosureProgram program = ClosureCompiler(scope.get()).compile();
+            ClosureEngine engine(program);
+            try {
+                result = engine.run();
+            } catch (std::runtime_error& e) {
+                std::cerr << ANSI_BRIGHT_BOLD_RED "error" ANSI_COLOR_RESET
+                          ": " << e.what() << std::endl;
+                return 1;
+            }
+        }
+        else {
+            // Compile what the JIT supports to machine code, the interpreter runs the rest
+            JitProgram jit;
+            if (options.jit) {
+                try {
+                    jit = JitCompiler(module).compile();
+                    jit.install();
+                } catch (std::runtime_error& e) {
+                    std::cerr << ANSI_BRIGHT_BOLD_MAGNETA "warning" ANSI_COLOR_RESET
+                              ": " << e.what() << std::endl;
+                }
+            }
+
+            // Run the interpreter and get the result of the program's main function,
+            // when tiered the functions it runs often are compiled as they get hot
+            JitTiering tiering(module, options.tier_threshold, options.trace_tiering);
+            Interpreter interpreter(scope.get(), options.tiered ? &tiering : nullptr);
+            try {
+                result = interpreter.interpret();
+            } catch (std::runtime_error& e) {
+                std::cerr << ANSI_BRIGHT_BOLD_RED "error" ANSI_COLOR_RESET
+                          ": " << e.what() << std::endl;
+                return 1;
+            }
+        }
+
+        if (options.memoize_pure)
+            printMemoStats(scope.get());
+
+        return result;
     }
 
     return 0;
 }
+
+int
+emitC(CleanScope* scope, std::string const& output_path)
+{
+    std::string source;
+    try {
+        source = CEmitter(scope).emit();
+    } catch (std::runtime_error& e) {
+        std::cerr << ANSI_BRIGHT_BOLD_RED "error" ANSI_COLOR_RESET
+                  ": " << e.what() << std::endl;
+        return 1;
+    }
+
+    return writeOutput(source, output_path);
+}
+
+int
+emitAssembly(IRModule& module, CleanScope* scope, std::string const& output_path)
+{
+    std::string source;
+    try {
+        source = AssemblyEmitter(module, scope).emit();
+    } catch (std::runtime_error& e) {
+        std::cerr << ANSI_BRIGHT_BOLD_RED "error" ANSI_COLOR_RESET
+                  ": " << e.what() << std::endl;
+        return 1;
+    }
+
+    return writeOutput(source, output_path);
+}
+
+// Write a translated program to the given file, standard output without one
+int
+writeOutput(std::string const& source, std::string const& output_path)
+{
+    if (output_path.empty()) {
+        std::cout << source;
+        return 0;
+    }
+
+    std::ofstream output(output_path);
+    output << source;
+    if (! output) {
+        std::cerr << ANSI_BRIGHT_BOLD_RED "error" ANSI_COLOR_RESET
+                ": file [" ANSI_RED << output_path << ANSI_COLOR_RESET
+                "] could not be written." << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+void
+printMemoStats(CleanScope* scope)
+{
+    std::cerr << "memoization statistics:" << std::endl;
+    for (auto& [name, fun_def]: scope->getSymbols<CleanFunctionDefinition>()) {
+        if (! fun_def->memo)
+            continue;
+
+        std::cerr << "    " << name << ": "
+                  << fun_def->memo->getHits() << " hits, "
+                  << fun_def->memo->getMisses() << " misses" << std::endl;
+    }
+}
+
+void
+printInlineReport(std::vector<std::string> const& report)
+{
+    std::cerr << "inlined calls:" << std::endl;
+    for (auto& line: report)
+        std::cerr << "    " << line << std::endl;
+}
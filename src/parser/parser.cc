@@ -57,8 +57,7 @@ Parser::Parser(
     previous(
         PROTO_ERROR,
         lexer.getSource(),
-        lexer.getSourcePath(),
-        lexer.getStart(),
+        0,
         0,
         0,
         0
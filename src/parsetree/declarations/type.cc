@@ -16,6 +16,7 @@
  */
 
 #include <cstdbool>
+#include <memory>
 #include <string>
 
 #include "parsetree/declarations/type.h"
@@ -72,7 +73,7 @@ SimpleTypeDeclaration::getToken()
 bool
 SimpleTypeDeclaration::operator==(SimpleTypeDeclaration& type_decl)
 {
-    return token.getLexeme() == type_decl.getToken().getLexeme();
+    return token.getLexemeView() == type_decl.getToken().getLexemeView();
 }
 
 bool
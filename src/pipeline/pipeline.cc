@@ -0,0 +1,170 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdexcept>
+#include <cstddef>
+#include <utility>
+#include <memory>
+#include <vector>
+#include <string>
+
+#include "intrinsics/reslib/resuint.h"
+#include "intrinsics/reslib/resint.h"
+#include "intrinsics/stdlib/stdio.h"
+#include "cleaner/cleaner_warning.h"
+#include "eliminator/eliminator.h"
+#include "cleaner/symbols/scope.h"
+#include "resolver/resolver.h"
+#include "pipeline/pipeline.h"
+#include "resolver/linker.h"
+#include "resolver/purity.h"
+#include "lowerer/lowerer.h"
+#include "inliner/inliner.h"
+#include "hoister/hoister.h"
+#include "folder/folder.h"
+#include "ir/builder.h"
+#include "ir/passes.h"
+#include "ir/ir.h"
+
+
+Pipeline::Pipeline(
+    std::shared_ptr<CleanScope> scope,
+    std::size_t inline_threshold
+) : scope(std::move(scope)),
+    inline_threshold(inline_threshold),
+    next(0)
+{}
+
+/**
+ * Runs the passes that did not run yet, up to the given one included.
+ *
+ * Every backend expects all of them to have run, the C emitter
+ * translates the program right after calls are linked.
+ */
+void
+Pipeline::runUntil(enum PipelineStage last)
+{
+    for (; next <= static_cast<std::size_t>(last); ++next)
+        run(static_cast<enum PipelineStage>(next));
+}
+
+/**
+ * Lowers the program to SSA form and optimizes it.
+ * All the passes must have run first.
+ */
+IRModule
+Pipeline::buildModule()
+{
+    IRModule module = IRBuilder(scope.get()).build();
+
+    PassManager passes;
+    passes.add(std::make_unique<ConstantFolding>());
+    passes.add(std::make_unique<CopyPropagation>());
+    passes.add(std::make_unique<ValueNumbering>());
+    passes.add(std::make_unique<StrengthReduction>());
+    passes.add(std::make_unique<DeadCodeElimination>());
+    passes.run(module);
+
+    return module;
+}
+
+/**
+ * Returns the global scope the passes work on.
+ */
+std::shared_ptr<CleanScope> const&
+Pipeline::getScope() const
+{
+    return scope;
+}
+
+/**
+ * Returns one line per call that was inlined.
+ */
+std::vector<std::string> const&
+Pipeline::getInlineReport() const
+{
+    return inline_report;
+}
+
+// Run a single pass
+void
+Pipeline::run(enum PipelineStage stage)
+{
+    switch (stage) {
+        case PipelineStage::Inline: {
+            // Replace calls to small functions by their body
+            Inliner inliner(scope.get(), inline_threshold);
+            inliner.inlineCalls();
+            inline_report = inliner.getReport();
+            break;
+        }
+
+        case PipelineStage::Resolve:
+            // Bind variables to frame slots
+            Resolver(scope.get()).resolve();
+            break;
+
+        case PipelineStage::Lower:
+            // Turn operators on primitive types into typed operations
+            Lowerer(scope.get()).lower();
+            break;
+
+        case PipelineStage::Load:
+            // Register resident and standard functions
+            Resuint().load(scope.get());
+            Resint().load(scope.get());
+            Stdio().load(scope.get());
+            break;
+
+        case PipelineStage::Fold:
+            // Evaluate what only depends on literals ahead of time
+            Folder(scope.get()).fold();
+            break;
+
+        case PipelineStage::Eliminate: {
+            // Remove what can never run or is never read
+            Eliminator eliminator(scope.get());
+            eliminator.eliminate();
+            warnings.insert(
+                warnings.end(),
+                eliminator.warnings.begin(),
+                eliminator.warnings.end()
+            );
+            break;
+        }
+
+        case PipelineStage::Link:
+            // Bind calls to the functions they invoke
+            Linker(scope.get()).link();
+            break;
+
+        case PipelineStage::Purity:
+            // Find the functions whose result only depends on their arguments
+            Purity(scope.get()).analyze();
+            break;
+
+        case PipelineStage::Hoist:
+            // Compute what loops don't change once before they run
+            Hoister(scope.get()).hoist();
+            break;
+
+        default:
+            throw std::runtime_error(
+                "Pipeline failed: unknow stage."
+            );
+    }
+}
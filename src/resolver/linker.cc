@@ -0,0 +1,226 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdexcept>
+#include <cstdlib>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <map>
+
+#include "cleaner/ast/expressions/expression.h"
+#include "cleaner/ast/definitions/function.h"
+#include "cleaner/ast/statements/statement.h"
+#include "cleaner/ast/statements/return.h"
+#include "cleaner/ast/statements/while.h"
+#include "cleaner/ast/statements/block.h"
+#include "cleaner/ast/statements/for.h"
+#include "cleaner/ast/statements/if.h"
+#include "cleaner/symbols/scope.h"
+#include "intrinsics/reslib.h"
+#include "intrinsics/stdlib.h"
+#include "utils/intrinsics.h"
+#include "resolver/linker.h"
+#include "common/native.h"
+#include "common/value.h"
+
+
+// Undefined functions
+static Value
+failUndefinedCall(NativeArguments)
+{
+    std::fflush(stdout);
+    std::fprintf(stderr, "Call failed: the function called has no definition.\n");
+    std::abort();
+}
+
+static std::unique_ptr<CleanFunctionDefinition>
+undefinedFunction(std::string const& fun_name)
+{
+    // Parameter types are in the mangled name, named so they keep their order
+    std::map<std::string, std::string> params;
+    std::size_t start = fun_name.find('(') + 1;
+    std::size_t end = fun_name.size() - 1;
+    while (start < end) {
+        std::size_t comma = fun_name.find(',', start);
+        if (comma == std::string::npos)
+            comma = end;
+        params["__param" + std::to_string(params.size()) + "__"] =
+            fun_name.substr(start, comma - start);
+        start = comma + 1;
+    }
+
+    std::string mangled_name = fun_name;
+    std::string ret_type = "void";
+    if (ReslibFunctionsSymtable().hasFunctionDefinition(mangled_name))
+        ret_type = ReslibFunctionsSymtable().getReturnType(mangled_name)->getTypeName();
+    else if (StdlibFunctionsSymtable().hasFunctionDefinition(mangled_name))
+        ret_type = StdlibFunctionsSymtable().getReturnType(mangled_name)->getTypeName();
+
+    // It must stay where it is called so it fails when and only when it runs
+    std::unique_ptr<CleanFunctionDefinition> fun_def =
+        intrinsicGenerator(fun_name, params, ret_type, failUndefinedCall);
+    fun_def->is_pure = false;
+    return fun_def;
+}
+
+
+Linker::Linker(
+    CleanScope* scope
+) : scope(scope)
+{}
+
+/**
+ * Binds every call expression to the function definition it calls.
+ *
+ * Intrinsics must be loaded in the global scope first.
+ * Calls to operators the checker accepts but no library implements
+ * are bound to a function that fails when it is called.
+ */
+void
+Linker::link()
+{
+    for (auto& [name, fun_def]: scope->getSymbols<CleanFunctionDefinition>()) {
+        if (! fun_def->is_intrinsic)
+            linkBlock(fun_def->body.get());
+    }
+}
+
+// Statements
+void
+Linker::linkStatement(CleanStatement* stmt)
+{
+    switch (stmt->type) {
+        case CleanStatementType::Block: {
+            linkBlock(static_cast<CleanBlockStatement*>(stmt));
+            break;
+        }
+
+        case CleanStatementType::If: {
+            CleanIfStatement* if_stmt = static_cast<CleanIfStatement*>(stmt);
+            linkExpression(if_stmt->condition.get());
+            linkBlock(if_stmt->body.get());
+            for (auto& elif_branch: if_stmt->elif_branches) {
+                linkExpression(elif_branch->condition.get());
+                linkBlock(elif_branch->body.get());
+            }
+            if (if_stmt->else_branch)
+                linkBlock(if_stmt->else_branch->body.get());
+            break;
+        }
+
+        case CleanStatementType::For: {
+            CleanForStatement* for_stmt = static_cast<CleanForStatement*>(stmt);
+            if (for_stmt->init_clause)
+                linkExpression(for_stmt->init_clause.get());
+            if (for_stmt->term_clause)
+                linkExpression(for_stmt->term_clause.get());
+            if (for_stmt->incr_clause)
+                linkExpression(for_stmt->incr_clause.get());
+            linkBlock(for_stmt->body.get());
+            break;
+        }
+
+        case CleanStatementType::While: {
+            CleanWhileStatement* while_stmt = static_cast<CleanWhileStatement*>(stmt);
+            if (while_stmt->condition)
+                linkExpression(while_stmt->condition.get());
+            linkBlock(while_stmt->body.get());
+            break;
+        }
+
+        case CleanStatementType::Break:
+        case CleanStatementType::Continue:
+            break;
+
+        case CleanStatementType::Return: {
+            CleanReturnStatement* ret_stmt = static_cast<CleanReturnStatement*>(stmt);
+            if (ret_stmt->expression)
+                linkExpression(ret_stmt->expression.get());
+            break;
+        }
+
+        case CleanStatementType::Expression: {
+            linkExpression(static_cast<CleanExpression*>(stmt));
+            break;
+        }
+
+        default:
+            throw std::runtime_error(
+                "Call linking failed: unknow statement type."
+            );
+    }
+}
+
+// Blocks
+void
+Linker::linkBlock(CleanBlockStatement* block_stmt)
+{
+    for (auto& statement: block_stmt->statements)
+        linkStatement(statement.get());
+}
+
+// Expressions
+void
+Linker::linkExpression(CleanExpression* expr)
+{
+    switch (expr->type) {
+        case CleanExpressionType::Group: {
+            linkExpression(static_cast<CleanGroupExpression*>(expr)->expression.get());
+            break;
+        }
+
+        case CleanExpressionType::Call: {
+            CleanCallExpression* call_expr = static_cast<CleanCallExpression*>(expr);
+            if (! scope->hasSymbol<CleanFunctionDefinition>(call_expr->fun_name))
+                scope->addSymbol<CleanFunctionDefinition>(
+                    call_expr->fun_name,
+                    undefinedFunction(call_expr->fun_name)
+                );
+
+            call_expr->fun_def =
+                scope->getSymbol<CleanFunctionDefinition>(call_expr->fun_name).get();
+            for (auto& argument: call_expr->arguments)
+                linkExpression(argument.get());
+            break;
+        }
+
+        case CleanExpressionType::TernaryIf: {
+            CleanTernaryIfExpression* ternif_expr =
+                static_cast<CleanTernaryIfExpression*>(expr);
+            linkExpression(ternif_expr->condition.get());
+            linkExpression(ternif_expr->then_branch.get());
+            linkExpression(ternif_expr->else_branch.get());
+            break;
+        }
+
+        case CleanExpressionType::Assignment: {
+            linkExpression(static_cast<CleanAssignmentExpression*>(expr)->rvalue.get());
+            break;
+        }
+
+        case CleanExpressionType::Operation: {
+            for (auto& operand: static_cast<CleanOperationExpression*>(expr)->operands)
+                linkExpression(operand.get());
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
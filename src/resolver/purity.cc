@@ -0,0 +1,325 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdexcept>
+#include <cstdbool>
+#include <memory>
+#include <string>
+#include <map>
+
+#include "cleaner/ast/expressions/expression.h"
+#include "cleaner/ast/definitions/function.h"
+#include "cleaner/ast/statements/statement.h"
+#include "cleaner/ast/statements/return.h"
+#include "cleaner/ast/statements/while.h"
+#include "cleaner/ast/statements/block.h"
+#include "cleaner/ast/statements/for.h"
+#include "cleaner/ast/statements/if.h"
+#include "cleaner/symbols/scope.h"
+#include "resolver/purity.h"
+
+
+Purity::Purity(
+    CleanScope* scope
+) : scope(scope)
+{}
+
+/**
+ * Marks the user functions whose result only depends on their arguments.
+ *
+ * A pure function doesn't write global variables, doesn't read global
+ * variables written anywhere in the program and only calls pure functions.
+ * The program must have gone through the resolver and the linker.
+ */
+void
+Purity::analyze()
+{
+    std::map<std::string,std::unique_ptr<CleanFunctionDefinition>>& fun_defs =
+        scope->getSymbols<CleanFunctionDefinition>();
+
+    // Recursive functions are pure unless proven otherwise,
+    // so we start from every function being pure and refute until nothing changes
+    for (auto& [name, fun_def]: fun_defs) {
+        if (! fun_def->is_intrinsic) {
+            fun_def->is_pure = true;
+            collectStatement(fun_def->body.get());
+        }
+    }
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (auto& [name, fun_def]: fun_defs) {
+            if (
+                ! fun_def->is_intrinsic &&
+                fun_def->is_pure        &&
+                ! isPureBlock(fun_def->body.get())
+            ) {
+                fun_def->is_pure = false;
+                changed = true;
+            }
+        }
+    }
+}
+
+// Collect the globals written by statements
+void
+Purity::collectStatement(CleanStatement* stmt)
+{
+    switch (stmt->type) {
+        case CleanStatementType::Block: {
+            for (auto& statement: static_cast<CleanBlockStatement*>(stmt)->statements)
+                collectStatement(statement.get());
+            break;
+        }
+
+        case CleanStatementType::If: {
+            CleanIfStatement* if_stmt = static_cast<CleanIfStatement*>(stmt);
+            collectExpression(if_stmt->condition.get());
+            collectStatement(if_stmt->body.get());
+            for (auto& elif_branch: if_stmt->elif_branches) {
+                collectExpression(elif_branch->condition.get());
+                collectStatement(elif_branch->body.get());
+            }
+            if (if_stmt->else_branch)
+                collectStatement(if_stmt->else_branch->body.get());
+            break;
+        }
+
+        case CleanStatementType::For: {
+            CleanForStatement* for_stmt = static_cast<CleanForStatement*>(stmt);
+            if (for_stmt->init_clause)
+                collectExpression(for_stmt->init_clause.get());
+            if (for_stmt->term_clause)
+                collectExpression(for_stmt->term_clause.get());
+            if (for_stmt->incr_clause)
+                collectExpression(for_stmt->incr_clause.get());
+            collectStatement(for_stmt->body.get());
+            break;
+        }
+
+        case CleanStatementType::While: {
+            CleanWhileStatement* while_stmt = static_cast<CleanWhileStatement*>(stmt);
+            if (while_stmt->condition)
+                collectExpression(while_stmt->condition.get());
+            collectStatement(while_stmt->body.get());
+            break;
+        }
+
+        case CleanStatementType::Return: {
+            CleanReturnStatement* ret_stmt = static_cast<CleanReturnStatement*>(stmt);
+            if (ret_stmt->expression)
+                collectExpression(ret_stmt->expression.get());
+            break;
+        }
+
+        case CleanStatementType::Expression: {
+            collectExpression(static_cast<CleanExpression*>(stmt));
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+// Collect the globals written by expressions
+void
+Purity::collectExpression(CleanExpression* expr)
+{
+    switch (expr->type) {
+        case CleanExpressionType::Group: {
+            collectExpression(static_cast<CleanGroupExpression*>(expr)->expression.get());
+            break;
+        }
+
+        case CleanExpressionType::Call: {
+            for (auto& argument: static_cast<CleanCallExpression*>(expr)->arguments)
+                collectExpression(argument.get());
+            break;
+        }
+
+        case CleanExpressionType::TernaryIf: {
+            CleanTernaryIfExpression* ternif_expr =
+                static_cast<CleanTernaryIfExpression*>(expr);
+            collectExpression(ternif_expr->condition.get());
+            collectExpression(ternif_expr->then_branch.get());
+            collectExpression(ternif_expr->else_branch.get());
+            break;
+        }
+
+        case CleanExpressionType::Assignment: {
+            CleanAssignmentExpression* assign_expr =
+                static_cast<CleanAssignmentExpression*>(expr);
+            CleanVariableExpression* lvalue_expr =
+                static_cast<CleanVariableExpression*>(assign_expr->lvalue.get());
+            if (lvalue_expr->depth != 0)
+                written.insert(lvalue_expr->slot);
+            collectExpression(assign_expr->rvalue.get());
+            break;
+        }
+
+        case CleanExpressionType::Operation: {
+            for (auto& operand: static_cast<CleanOperationExpression*>(expr)->operands)
+                collectExpression(operand.get());
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+// Check statements under the current assumptions
+bool
+Purity::isPureStatement(CleanStatement* stmt)
+{
+    switch (stmt->type) {
+        case CleanStatementType::Block:
+            return isPureBlock(static_cast<CleanBlockStatement*>(stmt));
+
+        case CleanStatementType::If: {
+            CleanIfStatement* if_stmt = static_cast<CleanIfStatement*>(stmt);
+            if (
+                ! isPureExpression(if_stmt->condition.get()) ||
+                ! isPureBlock(if_stmt->body.get())
+            )
+                return false;
+            for (auto& elif_branch: if_stmt->elif_branches) {
+                if (
+                    ! isPureExpression(elif_branch->condition.get()) ||
+                    ! isPureBlock(elif_branch->body.get())
+                )
+                    return false;
+            }
+            return ! if_stmt->else_branch || isPureBlock(if_stmt->else_branch->body.get());
+        }
+
+        case CleanStatementType::For: {
+            CleanForStatement* for_stmt = static_cast<CleanForStatement*>(stmt);
+            return
+                (! for_stmt->init_clause || isPureExpression(for_stmt->init_clause.get())) &&
+                (! for_stmt->term_clause || isPureExpression(for_stmt->term_clause.get())) &&
+                (! for_stmt->incr_clause || isPureExpression(for_stmt->incr_clause.get())) &&
+                isPureBlock(for_stmt->body.get());
+        }
+
+        case CleanStatementType::While: {
+            CleanWhileStatement* while_stmt = static_cast<CleanWhileStatement*>(stmt);
+            return
+                (! while_stmt->condition || isPureExpression(while_stmt->condition.get())) &&
+                isPureBlock(while_stmt->body.get());
+        }
+
+        case CleanStatementType::Break:
+        case CleanStatementType::Continue:
+            return true;
+
+        case CleanStatementType::Return: {
+            CleanReturnStatement* ret_stmt = static_cast<CleanReturnStatement*>(stmt);
+            return ! ret_stmt->expression || isPureExpression(ret_stmt->expression.get());
+        }
+
+        case CleanStatementType::Expression:
+            return isPureExpression(static_cast<CleanExpression*>(stmt));
+
+        default:
+            throw std::runtime_error(
+                "Purity analysis failed: unknow statement type."
+            );
+    }
+}
+
+// Check blocks under the current assumptions
+bool
+Purity::isPureBlock(CleanBlockStatement* block_stmt)
+{
+    for (auto& statement: block_stmt->statements) {
+        if (! isPureStatement(statement.get()))
+            return false;
+    }
+
+    return true;
+}
+
+// Check expressions under the current assumptions
+bool
+Purity::isPureExpression(CleanExpression* expr)
+{
+    switch (expr->type) {
+        case CleanExpressionType::Boolean:
+        case CleanExpressionType::SignedInt:
+        case CleanExpressionType::UnsignedInt:
+        case CleanExpressionType::Float:
+        case CleanExpressionType::String:
+        case CleanExpressionType::Intrinsic:
+            return true;
+
+        // Globals nobody writes are as good as constants
+        case CleanExpressionType::Variable: {
+            CleanVariableExpression* var_expr =
+                static_cast<CleanVariableExpression*>(expr);
+            return var_expr->depth == 0 || written.count(var_expr->slot) == 0;
+        }
+
+        case CleanExpressionType::Group:
+            return isPureExpression(
+                static_cast<CleanGroupExpression*>(expr)->expression.get()
+            );
+
+        case CleanExpressionType::Call: {
+            CleanCallExpression* call_expr = static_cast<CleanCallExpression*>(expr);
+            if (! call_expr->fun_def->is_pure)
+                return false;
+            for (auto& argument: call_expr->arguments) {
+                if (! isPureExpression(argument.get()))
+                    return false;
+            }
+            return true;
+        }
+
+        case CleanExpressionType::TernaryIf: {
+            CleanTernaryIfExpression* ternif_expr =
+                static_cast<CleanTernaryIfExpression*>(expr);
+            return
+                isPureExpression(ternif_expr->condition.get()) &&
+                isPureExpression(ternif_expr->then_branch.get()) &&
+                isPureExpression(ternif_expr->else_branch.get());
+        }
+
+        case CleanExpressionType::Assignment: {
+            CleanAssignmentExpression* assign_expr =
+                static_cast<CleanAssignmentExpression*>(expr);
+            CleanVariableExpression* lvalue_expr =
+                static_cast<CleanVariableExpression*>(assign_expr->lvalue.get());
+            return lvalue_expr->depth == 0 && isPureExpression(assign_expr->rvalue.get());
+        }
+
+        case CleanExpressionType::Operation: {
+            for (auto& operand: static_cast<CleanOperationExpression*>(expr)->operands) {
+                if (! isPureExpression(operand.get()))
+                    return false;
+            }
+            return true;
+        }
+
+        default:
+            throw std::runtime_error(
+                "Purity analysis failed: unknow expression type."
+            );
+    }
+}
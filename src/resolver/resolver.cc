@@ -0,0 +1,310 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdexcept>
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <string>
+
+#include "cleaner/ast/expressions/expression.h"
+#include "cleaner/ast/definitions/function.h"
+#include "cleaner/ast/definitions/variable.h"
+#include "cleaner/ast/statements/statement.h"
+#include "cleaner/ast/statements/return.h"
+#include "cleaner/ast/statements/while.h"
+#include "cleaner/ast/statements/block.h"
+#include "cleaner/ast/statements/for.h"
+#include "cleaner/ast/statements/if.h"
+#include "cleaner/symbols/scope.h"
+#include "resolver/resolver.h"
+
+
+Resolver::Resolver(
+    CleanScope* scope
+) : scope(scope),
+    fun_def(nullptr),
+    next_slot(0)
+{}
+
+/**
+ * Assigns a frame slot to every global, parameter and local variable,
+ * and binds every variable expression to the slot it refers to.
+ *
+ * Globals live in the outermost frame, at depth 1 from any function frame.
+ * Parameters occupy the first slots of the function frame and are followed
+ * by locals. Sibling blocks reuse the same slots since their variables
+ * are never alive at the same time.
+ */
+void
+Resolver::resolve()
+{
+    std::size_t slot = 0;
+    for (auto& [name, var_def]: scope->getSymbols<CleanVariableDefinition>())
+        var_def->slot = slot++;
+
+    for (auto& [name, fun_def]: scope->getSymbols<CleanFunctionDefinition>()) {
+        if (! fun_def->is_intrinsic)
+            resolveFunction(fun_def.get());
+    }
+}
+
+// Function definitions
+void
+Resolver::resolveFunction(
+    CleanFunctionDefinition* fun_def
+)
+{
+    this->fun_def = fun_def;
+    next_slot = fun_def->parameters.size();
+    fun_def->frame_size = next_slot;
+
+    resolveBlock(fun_def->body.get());
+
+    this->fun_def = nullptr;
+}
+
+// Statements
+void
+Resolver::resolveStatement(
+    CleanStatement* stmt,
+    CleanScope* scope
+)
+{
+    switch (stmt->type) {
+        case CleanStatementType::Block: {
+            resolveBlock(static_cast<CleanBlockStatement*>(stmt));
+            break;
+        }
+
+        case CleanStatementType::If: {
+            CleanIfStatement* if_stmt = static_cast<CleanIfStatement*>(stmt);
+            resolveExpression(if_stmt->condition.get(), scope);
+            resolveBlock(if_stmt->body.get());
+            for (auto& elif_branch: if_stmt->elif_branches) {
+                resolveExpression(elif_branch->condition.get(), scope);
+                resolveBlock(elif_branch->body.get());
+            }
+            if (if_stmt->else_branch)
+                resolveBlock(if_stmt->else_branch->body.get());
+            break;
+        }
+
+        case CleanStatementType::For: {
+            CleanForStatement* for_stmt = static_cast<CleanForStatement*>(stmt);
+            std::size_t saved_slot = next_slot;
+            allocateSlots(for_stmt->scope.get());
+
+            if (for_stmt->init_clause)
+                resolveExpression(for_stmt->init_clause.get(), for_stmt->scope.get());
+            if (for_stmt->term_clause)
+                resolveExpression(for_stmt->term_clause.get(), for_stmt->scope.get());
+            if (for_stmt->incr_clause)
+                resolveExpression(for_stmt->incr_clause.get(), for_stmt->scope.get());
+            resolveBlock(for_stmt->body.get());
+
+            next_slot = saved_slot;
+            break;
+        }
+
+        case CleanStatementType::While: {
+            CleanWhileStatement* while_stmt = static_cast<CleanWhileStatement*>(stmt);
+            resolveExpression(while_stmt->condition.get(), scope);
+            resolveBlock(while_stmt->body.get());
+            break;
+        }
+
+        case CleanStatementType::Break:
+        case CleanStatementType::Continue:
+            break;
+
+        case CleanStatementType::Return: {
+            CleanReturnStatement* ret_stmt = static_cast<CleanReturnStatement*>(stmt);
+            if (ret_stmt->expression)
+                resolveExpression(ret_stmt->expression.get(), scope);
+            break;
+        }
+
+        case CleanStatementType::Expression: {
+            resolveExpression(static_cast<CleanExpression*>(stmt), scope);
+            break;
+        }
+
+        default:
+            throw std::runtime_error(
+                "Statement resolution failed: unknow statement type."
+            );
+    }
+}
+
+// Blocks
+void
+Resolver::resolveBlock(
+    CleanBlockStatement* block_stmt
+)
+{
+    std::size_t saved_slot = next_slot;
+    allocateSlots(block_stmt->scope.get());
+
+    for (auto& statement: block_stmt->statements)
+        resolveStatement(statement.get(), block_stmt->scope.get());
+
+    next_slot = saved_slot;
+}
+
+// Expressions
+void
+Resolver::resolveExpression(
+    CleanExpression* expr,
+    CleanScope* scope
+)
+{
+    switch (expr->type) {
+        case CleanExpressionType::Boolean:
+        case CleanExpressionType::SignedInt:
+        case CleanExpressionType::UnsignedInt:
+        case CleanExpressionType::Float:
+        case CleanExpressionType::String:
+        case CleanExpressionType::Intrinsic:
+            break;
+
+        case CleanExpressionType::Variable: {
+            bind(static_cast<CleanVariableExpression*>(expr), scope);
+            break;
+        }
+
+        case CleanExpressionType::Group: {
+            CleanGroupExpression* gr_expr =
+                static_cast<CleanGroupExpression*>(expr);
+            resolveExpression(gr_expr->expression.get(), scope);
+            break;
+        }
+
+        case CleanExpressionType::Call: {
+            CleanCallExpression* call_expr =
+                static_cast<CleanCallExpression*>(expr);
+            for (auto& argument: call_expr->arguments)
+                resolveExpression(argument.get(), scope);
+            break;
+        }
+
+        case CleanExpressionType::Operation: {
+            CleanOperationExpression* op_expr =
+                static_cast<CleanOperationExpression*>(expr);
+            for (auto& operand: op_expr->operands)
+                resolveExpression(operand.get(), scope);
+            break;
+        }
+
+        case CleanExpressionType::TernaryIf: {
+            CleanTernaryIfExpression* ternif_expr =
+                static_cast<CleanTernaryIfExpression*>(expr);
+            resolveExpression(ternif_expr->condition.get(), scope);
+            resolveExpression(ternif_expr->then_branch.get(), scope);
+            resolveExpression(ternif_expr->else_branch.get(), scope);
+            break;
+        }
+
+        case CleanExpressionType::Assignment: {
+            resolveAssignment(
+                static_cast<CleanAssignmentExpression*>(expr), scope
+            );
+            break;
+        }
+
+        default:
+            throw std::runtime_error(
+                "Expression resolution failed: unknow expression type."
+            );
+    }
+}
+
+// Assignments
+void
+Resolver::resolveAssignment(
+    CleanAssignmentExpression* assign_expr,
+    CleanScope* scope
+)
+{
+    CleanVariableExpression* lvalue_expr =
+        static_cast<CleanVariableExpression*>(assign_expr->lvalue.get());
+    CleanVariableDefinition* var_def = bind(lvalue_expr, scope);
+
+    // The first assignment to a local variable is where it gets initialized.
+    // If the variable was introduced by the assignment itself, the checker
+    // left the rvalue pointing to the variable: we replace it by the initializer.
+    if (var_def && lvalue_expr->depth == 0 && initialized.count(var_def) == 0) {
+        initialized.insert(var_def);
+
+        if (assign_expr->rvalue->type == CleanExpressionType::Variable) {
+            CleanVariableExpression* rvalue_expr =
+                static_cast<CleanVariableExpression*>(assign_expr->rvalue.get());
+            if (rvalue_expr->var_name == lvalue_expr->var_name)
+                assign_expr->rvalue = copy(var_def->initializer.get());
+        }
+    }
+
+    resolveExpression(assign_expr->rvalue.get(), scope);
+}
+
+// Assign slots to all variables defined in the given scope
+void
+Resolver::allocateSlots(
+    CleanScope* scope
+)
+{
+    for (auto& [name, var_def]: scope->getSymbols<CleanVariableDefinition>())
+        var_def->slot = next_slot++;
+
+    fun_def->frame_size = std::max(fun_def->frame_size, next_slot);
+}
+
+// Find the definition a variable expression refers to and bind it
+CleanVariableDefinition*
+Resolver::bind(
+    CleanVariableExpression* var_expr,
+    CleanScope* scope
+)
+{
+    for (CleanScope* current = scope; current; current = current->parent.get()) {
+        // Parameters are only known to the function definition
+        if (fun_def && current == fun_def->scope.get()) {
+            std::vector<std::unique_ptr<CleanVariableDeclaration>>& params =
+                fun_def->parameters;
+            for (std::size_t i = 0; i < params.size(); ++i) {
+                if (params[i]->name == var_expr->var_name) {
+                    var_expr->depth = 0;
+                    var_expr->slot = i;
+                    return nullptr;
+                }
+            }
+        }
+
+        if (current->hasSymbol<CleanVariableDefinition>(var_expr->var_name)) {
+            std::unique_ptr<CleanVariableDefinition>& var_def =
+                current->getSymbol<CleanVariableDefinition>(var_expr->var_name);
+            var_expr->depth = current->parent ? 0 : 1;
+            var_expr->slot = var_def->slot;
+            return var_def.get();
+        }
+    }
+
+    throw std::runtime_error(
+        "Variable resolution failed: `" + var_expr->var_name + "` could not be found."
+    );
+}
@@ -15,6 +15,7 @@
  *  limitations under the License.
  */
 
+#include <string_view>
 #include <stdexcept>
 #include <cstdbool>
 #include <memory>
@@ -61,7 +62,7 @@ Scope::addVariableDeclaration(
  * the symbol will be searched for in the parent scope.
  */
 std::unique_ptr<Definition>&
-Scope::getDefinition(std::string const& def_name, bool deep)
+Scope::getDefinition(std::string_view def_name, bool deep)
 {
     try {
         std::unique_ptr<Definition>& def =
@@ -77,7 +78,7 @@ Scope::getDefinition(std::string const& def_name, bool deep)
 }
 
 std::unique_ptr<VariableDeclaration>&
-Scope::getVariableDeclaration(std::string const& decl_name, bool deep)
+Scope::getVariableDeclaration(std::string_view decl_name, bool deep)
 {
     try {
         return symtable.getVariableDeclaration(decl_name);
@@ -97,7 +98,7 @@ Scope::getVariableDeclaration(std::string const& decl_name, bool deep)
  * the symbol will be searched for in the parent scope.
  */
 bool
-Scope::hasDefinition(std::string const& def_name, bool deep)
+Scope::hasDefinition(std::string_view def_name, bool deep)
 {
     bool res = symtable.hasDefinition(def_name);
     if (!res && deep && parent)
@@ -107,7 +108,7 @@ Scope::hasDefinition(std::string const& def_name, bool deep)
 }
 
 bool
-Scope::hasVariableDeclaration(std::string const& decl_name, bool deep)
+Scope::hasVariableDeclaration(std::string_view decl_name, bool deep)
 {
     bool res = symtable.hasVariableDeclaration(decl_name);
     if (!res && parent)
@@ -15,6 +15,8 @@
  *  limitations under the License.
  */
 
+#include <string_view>
+#include <functional>
 #include <algorithm>
 #include <stdexcept>
 #include <cstdbool>
@@ -64,18 +66,26 @@ Symtable::addVariableDeclaration(
  * Throws std::out_of_range if no such symbol could be found.
  */
 std::unique_ptr<Definition>&
-Symtable::getDefinition(std::string const& def_name)
+Symtable::getDefinition(std::string_view def_name)
 {
-    auto def_sym = definitions.at(def_name);
+    auto it = definitions.find(def_name);
+    if (it == definitions.end())
+        throw std::out_of_range("No definition named `" + std::string(def_name) + "`.");
+
+    auto def_sym = it->second;
     // Attempting to obtain a definition is equivalent to using it
     def_sym.used = true;
     return def_sym.definition;
 }
 
 std::unique_ptr<VariableDeclaration>&
-Symtable::getVariableDeclaration(std::string const& decl_name)
+Symtable::getVariableDeclaration(std::string_view decl_name)
 {
-    auto decl_sym = declarations.at(decl_name);
+    auto it = declarations.find(decl_name);
+    if (it == declarations.end())
+        throw std::out_of_range("No declaration named `" + std::string(decl_name) + "`.");
+
+    auto decl_sym = it->second;
     // Attempting to obtain a declaration is equivalent to using it
     decl_sym.used = true;
     return decl_sym.declaration;
@@ -85,41 +95,39 @@ Symtable::getVariableDeclaration(std::string const& decl_name)
  * Returns true if the given symbol exists in this table.
  */
 bool
-Symtable::hasDefinition(std::string const& def_name)
+Symtable::hasDefinition(std::string_view def_name)
 {
-    try {
-        auto& def_sym = definitions.at(def_name);
-        // Checking if a definition exists is equivalent to using it
-        def_sym.used = true;
-        return true;
-    } catch (std::out_of_range const& e) {
+    auto it = definitions.find(def_name);
+    if (it == definitions.end())
         return false;
-    }
+
+    // Checking if a definition exists is equivalent to using it
+    it->second.used = true;
+    return true;
 }
 
 bool
-Symtable::hasVariableDeclaration(std::string const& decl_name)
+Symtable::hasVariableDeclaration(std::string_view decl_name)
 {
-    try {
-        auto& decl_sym = declarations.at(decl_name);
-        // Checking if a declaration exists is equivalent to using it
-        decl_sym.used = true;
-        return true;
-    } catch (std::out_of_range const& e) {
+    auto it = declarations.find(decl_name);
+    if (it == declarations.end())
         return false;
-    }
+
+    // Checking if a declaration exists is equivalent to using it
+    it->second.used = true;
+    return true;
 }
 
 /**
  * Returns all the symbols present in this table.
  */
-std::map<std::string, struct DefinitionSymbol>&
+std::map<std::string, struct DefinitionSymbol, std::less<>>&
 Symtable::getDefinitions()
 {
     return definitions;
 }
 
-std::map<std::string, struct VariableDeclarationSymbol>&
+std::map<std::string, struct VariableDeclarationSymbol, std::less<>>&
 Symtable::getVariableDeclarations()
 {
     return declarations;
@@ -173,7 +181,7 @@ VariableDeclarationSymbol::VariableDeclarationSymbol(
 
 // Types symtable
 bool
-BuiltinTypesSymtable::isBuiltinType(std::string const& type)
+BuiltinTypesSymtable::isBuiltinType(std::string_view type)
 {
     return std::find(
         BuiltinTypesSymtable::builtin_types.begin(),
@@ -28,16 +28,19 @@
 #include "cleaner/ast/statements/block.h"
 #include "cleaner/symbols/scope.h"
 #include "utils/intrinsics.h"
+#include "common/native.h"
 
 
 /**
  * Generate an intrinsic function
+ *
+ * Intrinsics are pure unless the library marks them otherwise.
  */
 std::unique_ptr<CleanFunctionDefinition> intrinsicGenerator(
     std::string const& name,
     std::map<std::string, std::string>& params,
     std::string const& ret_type,
-    std::function<std::unique_ptr<CleanExpression>(CleanScope*)> callable
+    NativeFunction callable
 )
 {
     std::shared_ptr<CleanScope> intrinsic_scope =
@@ -48,6 +51,9 @@ std::unique_ptr<CleanFunctionDefinition> intrinsicGenerator(
             name,
             intrinsic_scope
         );
+    intrinsic_fun->is_intrinsic = true;
+    intrinsic_fun->is_pure = true;
+    intrinsic_fun->frame_size = params.size();
     
     // Header
     for (auto&& [name, type]: params) {
@@ -71,7 +77,7 @@ std::unique_ptr<CleanFunctionDefinition> intrinsicGenerator(
         std::make_unique<CleanBlockStatement>(body_scope);
     body->statements.push_back(
         std::make_unique<CleanReturnStatement>(
-            std::make_unique<CleanIntrinsicExpression>(callable)
+            std::make_unique<CleanIntrinsicExpression>(callable, params.size())
         )
     );
     intrinsic_fun->body = std::move(body);
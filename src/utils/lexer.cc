@@ -15,6 +15,7 @@
  *  limitations under the License.
  */
 
+#include <cstddef>
 #include <cstdio>
 #include <string>
 
@@ -37,9 +38,9 @@ printTokens(Lexer& lexer)
 
         if (token.line != line) {
             if (line == 0)
-                printf("%4zu ", token.line);
+                printf("%4zu ", static_cast<std::size_t>(token.line));
             else
-                printf("\n%4zu ", token.line);
+                printf("\n%4zu ", static_cast<std::size_t>(token.line));
             line = token.line;
         } else {
             printf("   \u2502 ");
@@ -50,7 +51,7 @@ printTokens(Lexer& lexer)
         else if (token.type == PROTO_STRING)
             printf("%-20s [string]\n", tokenTypeToString(token.type).c_str());
         else
-            printf("%-20s %.*s\n", tokenTypeToString(token.type).c_str(), static_cast<int>(token.length), &(*token.start));
+            printf("%-20s %s\n", tokenTypeToString(token.type).c_str(), token.getLexeme().c_str());
 
         if (token.type == PROTO_EOF)
             break;
@@ -15,6 +15,7 @@
  *  limitations under the License.
  */
 
+#include <cstddef>
 #include <cstdio>
 #include <string>
 
@@ -24,6 +25,7 @@
 
 /**
  * Given a token and an error message, display that error in a visually appealing way.
+ * The file and the line shown come from the source manager.
  * We stick to using C-style formatted output due to iomap being hard to use.
  */
 void
@@ -31,10 +33,10 @@ printMessage(
     std::string const& title,
     Token const& token,
     std::string const& primary_message,
-    std::string const& secondary_message,
-    std::string const& source_path
+    std::string const& secondary_message
 )
 {
+    std::string const& source_path = token.getSourcePath();
     if (token.type == PROTO_EOF || token.type == PROTO_ERROR) {
         if (title == "error") {
             fprintf(
@@ -67,8 +69,8 @@ printMessage(
             ANSI_BRIGHT_BOLD_RED "error " ANSI_COLOR_RESET
             "[%s:%zu:%zu]: " ANSI_BRIGHT_BOLD_WHITE "%s:\n" ANSI_COLOR_RESET,
             source_path.c_str(),
-            token.line,
-            token.column,
+            static_cast<std::size_t>(token.line),
+            static_cast<std::size_t>(token.column),
             primary_message.c_str()
         );
     }
@@ -78,8 +80,8 @@ printMessage(
             ANSI_BRIGHT_BOLD_MAGNETA "warning " ANSI_COLOR_RESET
             "[%s:%zu:%zu]: " ANSI_BRIGHT_BOLD_WHITE "%s:\n" ANSI_COLOR_RESET,
             source_path.c_str(),
-            token.line,
-            token.column,
+            static_cast<std::size_t>(token.line),
+            static_cast<std::size_t>(token.column),
             primary_message.c_str()
         );
     }
@@ -88,7 +90,7 @@ printMessage(
     }
 
     fprintf(stderr, "%*s|\n", static_cast<int>(title.length() + 1), "");
-    fprintf(stderr, "%5zu", token.line);
+    fprintf(stderr, "%5zu", static_cast<std::size_t>(token.line));
     fprintf(stderr, "%*s%-4s", static_cast<int>(title.length() - 3), "|", "");
     fprintf(stderr, "%s\n", token_line.line.c_str());
     fprintf(stderr, "%*s|", static_cast<int>(title.length() + 1), "");
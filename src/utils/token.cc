@@ -15,26 +15,21 @@
  *  limitations under the License.
  */
 
-#include <utility>
-#include <memory>
 #include <string>
 
 #include "common/token_type.h"
+#include "common/source.h"
 #include "common/token.h"
 
 Token
 createBuiltinToken(enum TokenType token_type, std::string const& lexeme)
 {
-    std::shared_ptr<std::string> source =
-        std::make_shared<std::string>(lexeme);
-
     return Token(
         token_type,
-        source,
-        std::string("__builtin__"),
-        source->begin(),
-        source->length(),
+        SourceManager::builtin,
+        SourceManager::addBuiltin(lexeme),
+        lexeme.length(),
         1,
-        source->length() + 1
+        lexeme.length() + 1
     );
 }
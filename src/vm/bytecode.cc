@@ -0,0 +1,112 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+
+#include "vm/bytecode.h"
+
+
+/**
+ * Returns the string representation of an opcode.
+ *
+ * @param       op the opcode to get the string representation of.
+ *
+ * @return      the string representation of the opcode.
+ */
+std::string
+opCodeToString(enum OpCode op)
+{
+    char const * op_codes[] = {
+        "LOAD_CONST",           // R[a] = K[b]
+        "MOVE",                 // R[a] = R[b]
+        "LOAD_GLOBAL",          // R[a] = G[b]
+        "STORE_GLOBAL",         // G[a] = R[b]
+        "JUMP",                 // pc = a
+        "JUMP_IF_FALSE",        // if not R[b] then pc = a
+        "CALL",                 // R[a] = F[b](R[c], ...)
+        "TAIL_CALL",            // return F[b](R[c], ...) in the current frame
+        "CALL_MEMO",            // R[a] = F[b](R[c], ...) through the function's cache
+        "CALL_NATIVE",          // R[a] = N[b](R[c], ...)
+        "RETURN",               // return R[a]
+        "RETURN_VOID",          // return nothing
+
+        // Typed operations
+        "ADD_I64",
+        "SUB_I64",
+        "MUL_I64",
+        "DIV_I64",
+        "REM_I64",
+        "NEG_I64",
+        "BNOT_I64",
+        "EQ_I64",
+        "NE_I64",
+        "GT_I64",
+        "GE_I64",
+        "LT_I64",
+        "LE_I64",
+        "ADD_U64",
+        "SUB_U64",
+        "MUL_U64",
+        "DIV_U64",
+        "REM_U64",
+        "NEG_U64",
+        "BNOT_U64",
+        "EQ_U64",
+        "NE_U64",
+        "GT_U64",
+        "GE_U64",
+        "LT_U64",
+        "LE_U64",
+        "ADD_F64",
+        "SUB_F64",
+        "MUL_F64",
+        "DIV_F64",
+        "NEG_F64",
+        "EQ_F64",
+        "NE_F64",
+        "GT_F64",
+        "GE_F64",
+        "LT_F64",
+        "LE_F64",
+        "NOT_BOOL",
+        "EQ_BOOL",
+        "NE_BOOL"
+    };
+
+    return std::string(op_codes[(int) op]);
+}
+
+/**
+ * Returns a human readable listing of the given function's instructions.
+ */
+std::string
+disassemble(BytecodeFunction const& fun)
+{
+    std::ostringstream listing;
+    listing << fun.name << " (" << fun.param_count << " params, "
+            << fun.register_count << " registers)\n";
+
+    for (std::size_t pc = 0; pc < fun.code.size(); ++pc) {
+        Instruction const& instr = fun.code[pc];
+        listing << "    " << pc << ": " << opCodeToString(instr.op)
+                << " " << instr.a << " " << instr.b << " " << instr.c << "\n";
+    }
+
+    return listing.str();
+}
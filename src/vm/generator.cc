@@ -0,0 +1,377 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdexcept>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include <string>
+#include <map>
+
+#include "cleaner/ast/definitions/function.h"
+#include "cleaner/ast/statements/return.h"
+#include "common/operation.h"
+#include "ir/allocator.h"
+#include "vm/generator.h"
+#include "common/value.h"
+#include "vm/bytecode.h"
+#include "ir/ir.h"
+
+
+/* Registers, constants and jump targets are 16 bits wide. */
+static const std::size_t max_operand = UINT16_MAX;
+
+/* Typed opcodes follow the order of operations. */
+static_assert(
+    (int) OpCode::NeBool - (int) OpCode::AddI64 ==
+    (int) Operation::NeBool - (int) Operation::AddI64,
+    "Typed opcodes must mirror operations."
+);
+
+BytecodeGenerator::BytecodeGenerator(
+    IRModule& module
+) : module(module),
+    fun(nullptr),
+    scratch(0),
+    arg_base(0)
+{}
+
+/**
+ * Generates register bytecode for every function of the module.
+ *
+ * Values live in the registers linear scan gave them, arguments
+ * are passed in registers above all of them so calls never
+ * overwrite a value of the caller.
+ */
+Bytecode
+BytecodeGenerator::generate()
+{
+    bytecode.globals = module.globals;
+
+    // Number functions first so calls can refer to functions defined later
+    for (auto& function: module.functions) {
+        if (function->name == "main()")
+            bytecode.main_index = bytecode.functions.size();
+
+        function_indices[function->fun_def] = bytecode.functions.size();
+        bytecode.functions.emplace_back(
+            function->name,
+            function->fun_def->parameters.size()
+        );
+        bytecode.functions.back().memo = function->fun_def->memo.get();
+    }
+
+    for (auto& function: module.functions)
+        generateFunction(*function);
+
+    return std::move(bytecode);
+}
+
+// Functions
+void
+BytecodeGenerator::generateFunction(IRFunction& function)
+{
+    fun = &bytecode.functions[function_indices[function.fun_def]];
+    jumps.clear();
+    block_positions.clear();
+
+    splitCriticalEdges(function);
+    allocation = RegisterAllocator(function).allocate();
+
+    // Argument registers come last, after the one used to break copy cycles
+    std::size_t max_arguments = 0;
+    for (auto& block: function.blocks) {
+        for (auto& instr: block->instructions) {
+            if (instr->opcode == IROpcode::Call)
+                max_arguments = std::max(max_arguments, instr->operands.size());
+        }
+    }
+    scratch = allocation.register_count;
+    arg_base = scratch + 1;
+    fun->register_count = arg_base + max_arguments;
+    if (fun->register_count > max_operand)
+        throw std::runtime_error(
+            "Bytecode generation failed: function `" + fun->name + "` is too large."
+        );
+    placeArguments(function);
+
+    std::vector<IRBlock*>& order = allocation.order;
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        IRBlock* next = i + 1 < order.size() ? order[i + 1] : nullptr;
+        block_positions[order[i]] = fun->code.size();
+        for (auto& instr: order[i]->instructions)
+            generateInstruction(instr.get(), next);
+    }
+
+    for (auto& [jump, target]: jumps)
+        fun->code[jump].a = block_positions[target];
+}
+
+// Instructions
+void
+BytecodeGenerator::generateInstruction(IRInstruction* instr, IRBlock* next)
+{
+    switch (instr->opcode) {
+        case IROpcode::Param:
+        case IROpcode::Phi:
+            // Arguments are in place and phis are written by their predecessors
+            break;
+
+        case IROpcode::Const:
+            emit(OpCode::LoadConst, reg(instr), addConstant(instr->value), 0);
+            break;
+
+        case IROpcode::Copy:
+            if (reg(instr) != reg(instr->operands[0]))
+                emit(OpCode::Move, reg(instr), reg(instr->operands[0]), 0);
+            break;
+
+        case IROpcode::LoadGlobal:
+            emit(OpCode::LoadGlobal, reg(instr), instr->index, 0);
+            break;
+
+        case IROpcode::StoreGlobal:
+            emit(OpCode::StoreGlobal, instr->index, reg(instr->operands[0]), 0);
+            break;
+
+        case IROpcode::Operation:
+            emit(
+                static_cast<OpCode>((int) OpCode::AddI64 + (int) instr->operation),
+                reg(instr),
+                reg(instr->operands[0]),
+                instr->operands.size() > 1 ? reg(instr->operands[1]) : 0
+            );
+            break;
+
+        case IROpcode::Call:
+            generateCall(instr);
+            break;
+
+        case IROpcode::Jump:
+            generatePhiCopies(instr->block, instr->targets[0]);
+            generateJump(instr->targets[0], next);
+            break;
+
+        case IROpcode::Branch: {
+            // Critical edges are split so neither target has phis
+            jumps.emplace_back(
+                emit(OpCode::JumpIfFalse, 0, reg(instr->operands[0]), 0),
+                instr->targets[1]
+            );
+            generateJump(instr->targets[0], next);
+            break;
+        }
+
+        case IROpcode::Return:
+            if (instr->operands.size())
+                emit(OpCode::Return, reg(instr->operands[0]), 0, 0);
+            else
+                emit(OpCode::ReturnVoid, 0, 0, 0);
+            break;
+
+        default:
+            throw std::runtime_error(
+                "Bytecode generation failed: unknow instruction."
+            );
+    }
+}
+
+void
+BytecodeGenerator::generateCall(IRInstruction* instr)
+{
+    CleanFunctionDefinition* callee = instr->callee;
+
+    // Arguments go in consecutive registers that become
+    // the first registers of the callee's frame
+    for (std::size_t i = 0; i < instr->operands.size(); ++i) {
+        if (reg(instr->operands[i]) != arg_base + i)
+            emit(OpCode::Move, arg_base + i, reg(instr->operands[i]), 0);
+    }
+
+    if (callee->is_intrinsic)
+        emit(OpCode::CallNative, reg(instr), nativeIndex(callee), arg_base);
+    else if (instr->is_tail_call)
+        emit(OpCode::TailCall, reg(instr), function_indices[callee], arg_base);
+    else if (callee->memo)
+        emit(OpCode::CallMemo, reg(instr), function_indices[callee], arg_base);
+    else
+        emit(OpCode::Call, reg(instr), function_indices[callee], arg_base);
+}
+
+// Compute arguments used nowhere else directly in their argument register
+void
+BytecodeGenerator::placeArguments(IRFunction& function)
+{
+    std::map<IRInstruction*, std::size_t> uses;
+    for (auto& block: function.blocks) {
+        for (auto& instr: block->instructions) {
+            for (IRInstruction* operand: instr->operands)
+                uses[operand]++;
+        }
+    }
+
+    // The argument register must stay untouched until the call,
+    // so the value must be computed after any call before it
+    for (auto& block: function.blocks) {
+        std::map<IRInstruction*, bool> after_call;
+        for (auto& instr: block->instructions) {
+            if (instr->opcode != IROpcode::Call) {
+                after_call[instr.get()] = true;
+                continue;
+            }
+
+            for (std::size_t i = 0; i < instr->operands.size(); ++i) {
+                IRInstruction* argument = instr->operands[i];
+                if (
+                    argument->opcode == IROpcode::Phi   ||
+                    argument->opcode == IROpcode::Param ||
+                    after_call.count(argument) == 0     ||
+                    uses[argument] != 1
+                )
+                    continue;
+                allocation.registers[argument] = arg_base + i;
+            }
+            after_call.clear();
+            after_call[instr.get()] = true;
+        }
+    }
+}
+
+// Copy the values flowing into the phis of a block as if all at once
+void
+BytecodeGenerator::generatePhiCopies(IRBlock* from, IRBlock* to)
+{
+    std::size_t index = std::find(
+        to->predecessors.begin(),
+        to->predecessors.end(),
+        from
+    ) - to->predecessors.begin();
+
+    std::vector<std::pair<std::size_t, std::size_t>> moves;
+    for (auto& instr: to->instructions) {
+        if (instr->opcode != IROpcode::Phi)
+            break;
+
+        std::size_t dst = reg(instr.get());
+        std::size_t src = reg(instr->operands[index]);
+        if (dst != src)
+            moves.emplace_back(dst, src);
+    }
+
+    // A copy waits while another one still reads its destination,
+    // when they all wait on each other one destination is set aside
+    while (moves.size()) {
+        bool progress = false;
+        for (std::size_t i = 0; i < moves.size(); ++i) {
+            std::size_t dst = moves[i].first;
+            bool read = false;
+            for (auto& move: moves)
+                read = read || move.second == dst;
+            if (read)
+                continue;
+
+            emit(OpCode::Move, dst, moves[i].second, 0);
+            moves.erase(moves.begin() + i);
+            progress = true;
+            break;
+        }
+
+        if (progress)
+            continue;
+
+        std::size_t saved = moves[0].first;
+        emit(OpCode::Move, scratch, saved, 0);
+        for (auto& move: moves) {
+            if (move.second == saved)
+                move.second = scratch;
+        }
+    }
+}
+
+// Jump to a block unless it comes next
+void
+BytecodeGenerator::generateJump(IRBlock* target, IRBlock* next)
+{
+    if (target != next)
+        jumps.emplace_back(emit(OpCode::Jump, 0, 0, 0), target);
+}
+
+// Register holding the given value
+std::size_t
+BytecodeGenerator::reg(IRInstruction* value)
+{
+    return allocation.registers.at(value);
+}
+
+// Index of the given intrinsic in the natives table
+std::size_t
+BytecodeGenerator::nativeIndex(CleanFunctionDefinition* fun_def)
+{
+    auto it = native_indices.find(fun_def);
+    if (it != native_indices.end())
+        return it->second;
+
+    // The body of an intrinsic returns the intrinsic expression
+    CleanReturnStatement* ret_stmt = static_cast<CleanReturnStatement*>(
+        fun_def->body->statements[0].get()
+    );
+    CleanIntrinsicExpression* intr_expr =
+        static_cast<CleanIntrinsicExpression*>(ret_stmt->expression.get());
+    BytecodeNative native(
+        fun_def->name,
+        intr_expr->callable,
+        fun_def->parameters.size()
+    );
+
+    std::size_t index = bytecode.natives.size();
+    bytecode.natives.push_back(std::move(native));
+    native_indices[fun_def] = index;
+    return index;
+}
+
+// Append an instruction and return its position
+std::size_t
+BytecodeGenerator::emit(
+    enum OpCode op,
+    std::size_t a,
+    std::size_t b,
+    std::size_t c
+)
+{
+    if (
+        fun->code.size() >= max_operand ||
+        a > max_operand                 ||
+        b > max_operand                 ||
+        c > max_operand
+    )
+        throw std::runtime_error(
+            "Bytecode generation failed: function `" + fun->name + "` is too large."
+        );
+
+    fun->code.emplace_back(op, a, b, c);
+    return fun->code.size() - 1;
+}
+
+// Add a constant to the function's constant table and return its index
+std::size_t
+BytecodeGenerator::addConstant(Value value)
+{
+    fun->constants.push_back(value);
+    return fun->constants.size() - 1;
+}
@@ -0,0 +1,366 @@
+/*  This file is part of the Proto programming language
+ * 
+ *  Copyright (c) 2023- Ntwali Bashige Toussaint
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#include <stdexcept>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <vector>
+
+#include "common/value.h"
+#include "vm/bytecode.h"
+#include "vm/vm.h"
+
+
+VM::VM(
+    Bytecode& bytecode
+) : bytecode(bytecode),
+    registers(stack_capacity)
+{
+    calls.reserve(1024);
+}
+
+/**
+ * Runs the program starting with its main function.
+ */
+int
+VM::run()
+{
+    Value ret_value = call(bytecode.main_index, {});
+
+    if (ret_value.type == ValueType::SignedInt) {
+        // The value will be of type int64_t
+        // But since we are interpreting through C++, we convert to int
+        return (int) ret_value.as_int;
+    }
+
+    // If we got nothing from main, we have an error
+    return -1;
+}
+
+/**
+ * Runs the function at the given index with the given arguments.
+ */
+Value
+VM::call(std::size_t fun_index, std::vector<Value> const& arguments)
+{
+    BytecodeFunction* fun = &bytecode.functions[fun_index];
+    if (fun->register_count > registers.size())
+        throw std::runtime_error("VM execution failed: stack overflow.");
+
+    for (std::size_t i = 0; i < arguments.size(); ++i)
+        registers[i] = arguments[i];
+
+    return execute(fun, registers.data());
+}
+
+// Execute the function whose frame starts at the given register
+Value
+VM::execute(BytecodeFunction* fun, Value* base)
+{
+    Value* stack_end = registers.data() + registers.size();
+    Instruction const* code = fun->code.data();
+    Instruction const* pc = code;
+    Value const* constants = fun->constants.data();
+    Value* globals = bytecode.globals.data();
+    std::size_t call_depth = calls.size();
+
+    while (true) {
+        Instruction const& instr = *pc++;
+
+        switch (instr.op) {
+            case OpCode::LoadConst:
+                base[instr.a] = constants[instr.b];
+                break;
+
+            case OpCode::Move:
+                base[instr.a] = base[instr.b];
+                break;
+
+            case OpCode::LoadGlobal:
+                base[instr.a] = globals[instr.b];
+                break;
+
+            case OpCode::StoreGlobal:
+                globals[instr.a] = base[instr.b];
+                break;
+
+            case OpCode::Jump:
+                pc = code + instr.a;
+                break;
+
+            case OpCode::JumpIfFalse:
+                if (! base[instr.b].as_bool)
+                    pc = code + instr.a;
+                break;
+
+            case OpCode::Call: {
+                BytecodeFunction* callee = &bytecode.functions[instr.b];
+                Value* callee_base = base + instr.c;
+                if (callee->register_count > (std::size_t) (stack_end - callee_base))
+                    throw std::runtime_error("VM execution failed: stack overflow.");
+
+                // The arguments already sit in the callee's first registers
+                calls.push_back(CallInfo{fun, pc, base, instr.a});
+                fun = callee;
+                base = callee_base;
+                code = fun->code.data();
+                pc = code;
+                constants = fun->constants.data();
+                break;
+            }
+
+            case OpCode::TailCall: {
+                BytecodeFunction* callee = &bytecode.functions[instr.b];
+                if (callee->register_count > (std::size_t) (stack_end - base))
+                    throw std::runtime_error("VM execution failed: stack overflow.");
+
+                // The callee takes over the frame, its arguments
+                // move down to the first registers
+                std::copy(base + instr.c, base + instr.c + callee->param_count, base);
+                fun = callee;
+                code = fun->code.data();
+                pc = code;
+                constants = fun->constants.data();
+                break;
+            }
+
+            case OpCode::CallMemo: {
+                BytecodeFunction* callee = &bytecode.functions[instr.b];
+                Value* callee_base = base + instr.c;
+                if (callee->register_count > (std::size_t) (stack_end - callee_base))
+                    throw std::runtime_error("VM execution failed: stack overflow.");
+
+                Value const* cached = callee->memo->find(callee_base);
+                if (cached) {
+                    base[instr.a] = *cached;
+                    break;
+                }
+
+                // Misses run the callee to completion so its result can be cached,
+                // the callee may overwrite its parameters so we keep the key aside
+                std::vector<Value> key(callee_base, callee_base + callee->param_count);
+                Value ret_value = execute(callee, callee_base);
+                callee->memo->insert(key.data(), ret_value);
+                base[instr.a] = ret_value;
+                break;
+            }
+
+            case OpCode::CallNative: {
+                BytecodeNative& native = bytecode.natives[instr.b];
+                base[instr.a] = native.callable(
+                    NativeArguments(base + instr.c, native.arity)
+                );
+                break;
+            }
+
+            case OpCode::Return:
+            case OpCode::ReturnVoid: {
+                Value ret_value = instr.op == OpCode::Return
+                    ? base[instr.a]
+                    : Value();
+                if (calls.size() == call_depth)
+                    return ret_value;
+
+                CallInfo& caller = calls.back();
+                fun = caller.fun;
+                pc = caller.pc;
+                base = caller.base;
+                code = fun->code.data();
+                constants = fun->constants.data();
+                base[caller.dst] = ret_value;
+                calls.pop_back();
+                break;
+            }
+
+            // Typed operations
+            case OpCode::AddI64:
+                base[instr.a] = Value(base[instr.b].as_int + base[instr.c].as_int);
+                break;
+
+            case OpCode::SubI64:
+                base[instr.a] = Value(base[instr.b].as_int - base[instr.c].as_int);
+                break;
+
+            case OpCode::MulI64:
+                base[instr.a] = Value(base[instr.b].as_int * base[instr.c].as_int);
+                break;
+
+            case OpCode::DivI64:
+                if (base[instr.c].as_int == 0)
+                    std::abort();
+                base[instr.a] = Value(base[instr.b].as_int / base[instr.c].as_int);
+                break;
+
+            case OpCode::RemI64:
+                if (base[instr.c].as_int == 0)
+                    std::abort();
+                base[instr.a] = Value(base[instr.b].as_int % base[instr.c].as_int);
+                break;
+
+            case OpCode::NegI64:
+                base[instr.a] = Value(-base[instr.b].as_int);
+                break;
+
+            case OpCode::BnotI64:
+                base[instr.a] = Value(~base[instr.b].as_int);
+                break;
+
+            case OpCode::EqI64:
+                base[instr.a] = Value(base[instr.b].as_int == base[instr.c].as_int);
+                break;
+
+            case OpCode::NeI64:
+                base[instr.a] = Value(base[instr.b].as_int != base[instr.c].as_int);
+                break;
+
+            case OpCode::GtI64:
+                base[instr.a] = Value(base[instr.b].as_int > base[instr.c].as_int);
+                break;
+
+            case OpCode::GeI64:
+                base[instr.a] = Value(base[instr.b].as_int >= base[instr.c].as_int);
+                break;
+
+            case OpCode::LtI64:
+                base[instr.a] = Value(base[instr.b].as_int < base[instr.c].as_int);
+                break;
+
+            case OpCode::LeI64:
+                base[instr.a] = Value(base[instr.b].as_int <= base[instr.c].as_int);
+                break;
+
+            case OpCode::AddU64:
+                base[instr.a] = Value(base[instr.b].as_uint + base[instr.c].as_uint);
+                break;
+
+            case OpCode::SubU64:
+                base[instr.a] = Value(base[instr.b].as_uint - base[instr.c].as_uint);
+                break;
+
+            case OpCode::MulU64:
+                base[instr.a] = Value(base[instr.b].as_uint * base[instr.c].as_uint);
+                break;
+
+            case OpCode::DivU64:
+                if (base[instr.c].as_uint == 0)
+                    std::abort();
+                base[instr.a] = Value(base[instr.b].as_uint / base[instr.c].as_uint);
+                break;
+
+            case OpCode::RemU64:
+                if (base[instr.c].as_uint == 0)
+                    std::abort();
+                base[instr.a] = Value(base[instr.b].as_uint % base[instr.c].as_uint);
+                break;
+
+            case OpCode::NegU64:
+                base[instr.a] = Value((uint64_t) -base[instr.b].as_uint);
+                break;
+
+            case OpCode::BnotU64:
+                base[instr.a] = Value(~base[instr.b].as_uint);
+                break;
+
+            case OpCode::EqU64:
+                base[instr.a] = Value(base[instr.b].as_uint == base[instr.c].as_uint);
+                break;
+
+            case OpCode::NeU64:
+                base[instr.a] = Value(base[instr.b].as_uint != base[instr.c].as_uint);
+                break;
+
+            case OpCode::GtU64:
+                base[instr.a] = Value(base[instr.b].as_uint > base[instr.c].as_uint);
+                break;
+
+            case OpCode::GeU64:
+                base[instr.a] = Value(base[instr.b].as_uint >= base[instr.c].as_uint);
+                break;
+
+            case OpCode::LtU64:
+                base[instr.a] = Value(base[instr.b].as_uint < base[instr.c].as_uint);
+                break;
+
+            case OpCode::LeU64:
+                base[instr.a] = Value(base[instr.b].as_uint <= base[instr.c].as_uint);
+                break;
+
+            case OpCode::AddF64:
+                base[instr.a] = Value(base[instr.b].as_float + base[instr.c].as_float);
+                break;
+
+            case OpCode::SubF64:
+                base[instr.a] = Value(base[instr.b].as_float - base[instr.c].as_float);
+                break;
+
+            case OpCode::MulF64:
+                base[instr.a] = Value(base[instr.b].as_float * base[instr.c].as_float);
+                break;
+
+            case OpCode::DivF64:
+                base[instr.a] = Value(base[instr.b].as_float / base[instr.c].as_float);
+                break;
+
+            case OpCode::NegF64:
+                base[instr.a] = Value(-base[instr.b].as_float);
+                break;
+
+            case OpCode::EqF64:
+                base[instr.a] = Value(base[instr.b].as_float == base[instr.c].as_float);
+                break;
+
+            case OpCode::NeF64:
+                base[instr.a] = Value(base[instr.b].as_float != base[instr.c].as_float);
+                break;
+
+            case OpCode::GtF64:
+                base[instr.a] = Value(base[instr.b].as_float > base[instr.c].as_float);
+                break;
+
+            case OpCode::GeF64:
+                base[instr.a] = Value(base[instr.b].as_float >= base[instr.c].as_float);
+                break;
+
+            case OpCode::LtF64:
+                base[instr.a] = Value(base[instr.b].as_float < base[instr.c].as_float);
+                break;
+
+            case OpCode::LeF64:
+                base[instr.a] = Value(base[instr.b].as_float <= base[instr.c].as_float);
+                break;
+
+            case OpCode::NotBool:
+                base[instr.a] = Value(! base[instr.b].as_bool);
+                break;
+
+            case OpCode::EqBool:
+                base[instr.a] = Value(base[instr.b].as_bool == base[instr.c].as_bool);
+                break;
+
+            case OpCode::NeBool:
+                base[instr.a] = Value(base[instr.b].as_bool != base[instr.c].as_bool);
+                break;
+
+            default:
+                throw std::runtime_error(
+                    "VM execution failed: unknow opcode."
+                );
+        }
+    }
+}
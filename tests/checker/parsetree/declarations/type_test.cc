@@ -5,6 +5,7 @@
 #include "checker/parsetree/declarations/type.h"
 #include "checker/checker_error.h"
 #include "parser/parser.h"
+#include "common/source.h"
 #include "lexer/lexer.h"
 
 
@@ -18,6 +19,7 @@ class TypeDeclarationCheckerTest: public ::testing::Test
         }
 
         std::string source_path = "main.pro";
+        SourceManager sources;
 };
 
 TEST_F(TypeDeclarationCheckerTest, checkTest)
@@ -25,7 +27,7 @@ TEST_F(TypeDeclarationCheckerTest, checkTest)
     // Bad simple type declaration
     {
         std::string source = "int32";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<TypeDeclaration> type_decl = parser.parseTypeDeclaration();
         TypeDeclarationChecker checker(type_decl);
@@ -43,7 +45,7 @@ TEST_F(TypeDeclarationCheckerTest, checkTest)
     // Good simple type declaration
     {
         std::string source = "int";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<TypeDeclaration> type_decl = parser.parseTypeDeclaration();
         TypeDeclarationChecker checker(type_decl);
@@ -12,6 +12,7 @@
 #include "checker/checker_error.h"
 #include "symbols/scope.h"
 #include "parser/parser.h"
+#include "common/source.h"
 #include "lexer/lexer.h"
 
 
@@ -26,6 +27,7 @@ class VariableDefinitionCheckerTest: public ::testing::Test
 
         std::string source_path = "main.pro";
         std::shared_ptr<Scope> scope = std::make_shared<Scope>(nullptr);
+        SourceManager sources;
 };
 
 TEST_F(VariableDefinitionCheckerTest, checkTest)
@@ -33,7 +35,7 @@ TEST_F(VariableDefinitionCheckerTest, checkTest)
     // Correct variable definition
     {
         std::string source = "count: int = 0";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Definition> def = parser.parseDefinition();
         VariableDefinition* var_def = static_cast<VariableDefinition*>(def.get());
@@ -45,7 +47,7 @@ TEST_F(VariableDefinitionCheckerTest, checkTest)
     // Type mismatch between variable type and initializer
     {
         std::string source = "count: uint = true";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Definition> def = parser.parseDefinition();
         VariableDefinition* var_def = static_cast<VariableDefinition*>(def.get());
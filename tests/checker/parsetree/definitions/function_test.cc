@@ -8,6 +8,7 @@
 #include "checker/checker_error.h"
 #include "symbols/scope.h"
 #include "parser/parser.h"
+#include "common/source.h"
 #include "lexer/lexer.h"
 
 
@@ -22,14 +23,14 @@ class FunctionCheckerTest: public ::testing::Test
     
     std::string source_path = "main.pro";
     std::shared_ptr<Scope> scope = std::make_shared<Scope>(nullptr);
+        SourceManager sources;
 };
 
 TEST_F(FunctionCheckerTest, checkTest)
 {
     // All parameters and return types are valid
     {
-        std::shared_ptr<std::string> source =
-            std::make_shared<std::string>("sum1: function(a: uint, b:uint) -> uint{}");
+        std::string source = "sum1: function(a: uint, b:uint) -> uint{}";
         Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Definition> def = parser.parseDefinition();
@@ -41,8 +42,7 @@ TEST_F(FunctionCheckerTest, checkTest)
 
     // We have an invalid type in the parameters
     {
-        std::shared_ptr<std::string> source =
-            std::make_shared<std::string>("sum2: function(a: uint32, b:uint) -> uint{}");
+        std::string source = "sum2: function(a: uint32, b:uint) -> uint{}";
         Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Definition> def = parser.parseDefinition();
@@ -54,8 +54,7 @@ TEST_F(FunctionCheckerTest, checkTest)
 
     // We have an invalid return type
     {
-        std::shared_ptr<std::string> source =
-            std::make_shared<std::string>("sum3: function(a: uint, b:uint) -> int32{}");
+        std::string source = "sum3: function(a: uint, b:uint) -> int32{}";
         Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Definition> def = parser.parseDefinition();
@@ -67,8 +66,7 @@ TEST_F(FunctionCheckerTest, checkTest)
 
     // Header is valid, and body is valid
     {
-        std::shared_ptr<std::string> source =
-            std::make_shared<std::string>("sum4: function(a: uint, b:uint) -> uint{ a + b\n }");
+        std::string source = "sum4: function(a: uint, b:uint) -> uint{ a + b\n }";
         Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Definition> def = parser.parseDefinition();
@@ -80,8 +78,7 @@ TEST_F(FunctionCheckerTest, checkTest)
 
     // Header is valid, and body is invalid
     {
-        std::shared_ptr<std::string> source =
-            std::make_shared<std::string>("sum5: function(a: uint, b:uint) -> uint{ inner: function()->void{}\n }");
+        std::string source = "sum5: function(a: uint, b:uint) -> uint{ inner: function()->void{}\n }";
         Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Definition> def = parser.parseDefinition();
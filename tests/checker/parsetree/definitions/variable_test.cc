@@ -9,6 +9,7 @@
 #include "checker/checker_error.h"
 #include "symbols/scope.h"
 #include "parser/parser.h"
+#include "common/source.h"
 #include "lexer/lexer.h"
 
 
@@ -23,13 +24,13 @@ class VariableCheckerTest: public ::testing::Test
     
     std::string source_path = "main.pro";
     std::shared_ptr<Scope> scope = std::make_shared<Scope>(nullptr);
+        SourceManager sources;
 };
 
 TEST_F(VariableCheckerTest, inferVariableTypeTest) {
     // Variable definition in due form
     {
-        std::shared_ptr<std::string> source =
-            std::make_shared<std::string>("count: int = 0");
+        std::string source = "count: int = 0";
         Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Definition> def = parser.parseDefinition();
@@ -42,8 +43,7 @@ TEST_F(VariableCheckerTest, inferVariableTypeTest) {
 
     // Variable definition already in scope
     {
-        std::shared_ptr<std::string> source =
-            std::make_shared<std::string>("count: int = 0");
+        std::string source = "count: int = 0";
         Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Definition> def = parser.parseDefinition();
@@ -55,8 +55,7 @@ TEST_F(VariableCheckerTest, inferVariableTypeTest) {
 
     // Variable definition has an incorrect type
     {
-        std::shared_ptr<std::string> source =
-            std::make_shared<std::string>("count: uint = 0");
+        std::string source = "count: uint = 0";
         Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Definition> def = parser.parseDefinition();
@@ -68,16 +67,14 @@ TEST_F(VariableCheckerTest, inferVariableTypeTest) {
 
     // Variable definition already in scope
     {
-        std::shared_ptr<std::string> source =
-            std::make_shared<std::string>("other: bool");
+        std::string source = "other: bool";
         Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<VariableDeclaration> decl =
             parser.parseVariableDeclaration();
         scope->addVariableDeclaration("other", decl);
 
-        std::shared_ptr<std::string> defSource =
-            std::make_shared<std::string>("other: bool = true");
+        std::string defSource = "other: bool = true";
         Lexer defLexer(defSource, source_path);
         Parser defParser(defLexer);
         std::unique_ptr<Definition> def = defParser.parseDefinition();
@@ -89,8 +86,7 @@ TEST_F(VariableCheckerTest, inferVariableTypeTest) {
 
     // Global variable definition initialized by computation
     {
-        std::shared_ptr<std::string> source =
-            std::make_shared<std::string>("count: uint = 1 + 2");
+        std::string source = "count: uint = 1 + 2";
         Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Definition> def = parser.parseDefinition();
@@ -6,6 +6,7 @@
 #include "checker/checker_error.h"
 #include "symbols/scope.h"
 #include "parser/parser.h"
+#include "common/source.h"
 #include "lexer/lexer.h"
 
 
@@ -21,6 +22,7 @@ class ExpressionCheckerTest: public ::testing::Test
         std::string source_path = "main.pro";
         std::shared_ptr<Scope> scope = std::make_shared<Scope>(nullptr);
         std::unique_ptr<Definition> var_def = nullptr;
+        SourceManager sources;
 };
 
 TEST_F(ExpressionCheckerTest, checkCastTest)
@@ -28,7 +30,7 @@ TEST_F(ExpressionCheckerTest, checkCastTest)
     // Valid cast expression
     {
         std::string source = "0:uint";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
         std::unique_ptr<TypeDeclaration>& type_decl =
@@ -40,7 +42,7 @@ TEST_F(ExpressionCheckerTest, checkCastTest)
     // Invalid cast expression
     {
         std::string source = "0.5:bool";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
 
@@ -53,7 +55,7 @@ TEST_F(ExpressionCheckerTest, checkTernaryIfTest)
     // Valid ternary if
     {
         std::string source = "1 > 0 ? true <> false";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
         std::unique_ptr<TypeDeclaration>& type_decl =
@@ -65,7 +67,7 @@ TEST_F(ExpressionCheckerTest, checkTernaryIfTest)
     // Invalid ternary if: condition is not boolean
     {
         std::string source = "1 ? true <> false";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
 
@@ -75,7 +77,7 @@ TEST_F(ExpressionCheckerTest, checkTernaryIfTest)
     // Invalid ternary if: mismatched lvalue and rvalue
     {
         std::string source = "1 > 0 ? 1.0 <> 1:int";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
 
@@ -86,8 +88,7 @@ TEST_F(ExpressionCheckerTest, checkTernaryIfTest)
 TEST_F(ExpressionCheckerTest, checkAssignmentTest)
 {
     {
-        std::shared_ptr<std::string> source =
-            std::make_shared<std::string>("count: int = 0");
+        std::string source = "count: int = 0";
         Lexer lexer(source, source_path);
         Parser parser(lexer);
         var_def = parser.parseDefinition();
@@ -97,7 +98,7 @@ TEST_F(ExpressionCheckerTest, checkAssignmentTest)
     // Valid simple assignment with existing variable
     {
         std::string source = "count = 1";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
         std::unique_ptr<TypeDeclaration>& expr_type_decl =
@@ -109,7 +110,7 @@ TEST_F(ExpressionCheckerTest, checkAssignmentTest)
     // Valid simple assignment with non-existent variable
     {
         std::string source = "new_count = 1:uint";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
         std::unique_ptr<TypeDeclaration>& expr_type_decl =
@@ -121,7 +122,7 @@ TEST_F(ExpressionCheckerTest, checkAssignmentTest)
     // Valid in-place assignment
     {
         std::string source = "count += 1";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
         std::unique_ptr<TypeDeclaration>& expr_type_decl =
@@ -133,7 +134,7 @@ TEST_F(ExpressionCheckerTest, checkAssignmentTest)
     // Invalid simple assignment: non-existent variable on the RHS
     {
         std::string source = "count = i + 1";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
 
@@ -143,7 +144,7 @@ TEST_F(ExpressionCheckerTest, checkAssignmentTest)
     // Invalid simple assignment: incompatible types
     {
         std::string source = "count = true";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
 
@@ -153,7 +154,7 @@ TEST_F(ExpressionCheckerTest, checkAssignmentTest)
     // Invalid in-place assignment: non-existent variable on the LHS
     {
         std::string source = "i += 1";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
 
@@ -163,7 +164,7 @@ TEST_F(ExpressionCheckerTest, checkAssignmentTest)
     // Invalid in-place assignment: non-existent variable on the RHS
     {
         std::string source = "count += i";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
 
@@ -173,7 +174,7 @@ TEST_F(ExpressionCheckerTest, checkAssignmentTest)
     // Invalid in-place assignment: incompatible types
     {
         std::string source = "count += true";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
 
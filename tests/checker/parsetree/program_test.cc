@@ -8,6 +8,7 @@
 #include "checker/parsetree/program.h"
 #include "parser/parser.h"
 #include "parsetree/program.h"
+#include "common/source.h"
 #include "lexer/lexer.h"
 
 
@@ -21,6 +22,7 @@ class ProgramCheckerTest: public ::testing::Test
         }
 
         std::string source_path = "main.pro";
+        SourceManager sources;
 };
 
 TEST_F(ProgramCheckerTest, checkTest)
@@ -28,7 +30,7 @@ TEST_F(ProgramCheckerTest, checkTest)
     // Correct program
     {
         std::string source = "count: int = 0\n main: function()->int{return 0\n}\n";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         Program prog = parser.parseProgram();
         ProgramChecker checker(prog);
@@ -39,7 +41,7 @@ TEST_F(ProgramCheckerTest, checkTest)
     // Incorrect program
     {
         std::string source = "count: type = 0\n main: function()->int{return 0\n}\n";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         Program prog = parser.parseProgram();
         ProgramChecker checker(prog);
@@ -57,7 +59,7 @@ TEST_F(ProgramCheckerTest, checkTest)
     // Missing entry point
     {
         std::string source = "count: int = 0\n";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         Program prog = parser.parseProgram();
         ProgramChecker checker(prog);
@@ -78,7 +80,7 @@ TEST_F(ProgramCheckerTest, checkTest)
     // Invalid main function
     {
         std::string source = "main: function()->uint{}\n";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         Program prog = parser.parseProgram();
         ProgramChecker checker(prog);
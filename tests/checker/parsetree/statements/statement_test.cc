@@ -8,6 +8,7 @@
 #include "utils/inference.h"
 #include "symbols/scope.h"
 #include "parser/parser.h"
+#include "common/source.h"
 #include "lexer/lexer.h"
 
 
@@ -24,6 +25,7 @@ class StatementCheckerTest: public ::testing::Test
         std::shared_ptr<Scope> parent_scope = std::make_shared<Scope>(nullptr);
         std::shared_ptr<Scope> scope = std::make_shared<Scope>(parent_scope);
         std::unique_ptr<TypeDeclaration> ret_type_decl = nullptr;
+        SourceManager sources;
 };
 
 TEST_F(StatementCheckerTest, checkBlockTest)
@@ -31,7 +33,7 @@ TEST_F(StatementCheckerTest, checkBlockTest)
     // Valid block statement
     {
         std::string source = "{count: int = 0\n count += 1\n}";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Statement> stmt = parser.parseStatement();
         
@@ -44,7 +46,7 @@ TEST_F(StatementCheckerTest, checkBlockTest)
     // Invalid block statement
     {
         std::string source = "{inner: function()->void{}\n}";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Statement> stmt = parser.parseStatement();
         
@@ -60,7 +62,7 @@ TEST_F(StatementCheckerTest, checkIfTest)
     // Valid if statement
     {
         std::string source = "if (true && true) {counter = 0\n} elif (true && false) {conter = 1\n} elif (false && false) {counter = 2\n}\n";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Statement> stmt = parser.parseStatement();
         
@@ -73,7 +75,7 @@ TEST_F(StatementCheckerTest, checkIfTest)
     // Invalid condition in if statement
     {
         std::string source = "if (1) {counter = 0\n}\n}";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Statement> stmt = parser.parseStatement();
         
@@ -86,7 +88,7 @@ TEST_F(StatementCheckerTest, checkIfTest)
     // Invalid condition in elif branch
     {
         std::string source = "if (true) {} elif (1) {counter = 1\n}\n}";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Statement> stmt = parser.parseStatement();
         
@@ -102,7 +104,7 @@ TEST_F(StatementCheckerTest, checkForTest)
     // Valid for loop without clauses
     {
         std::string source = "for (;;) {count = 0\n}";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Statement> stmt = parser.parseStatement();
         
@@ -115,7 +117,7 @@ TEST_F(StatementCheckerTest, checkForTest)
     // Valid for loop only with initial clause
     {
         std::string source = "for (count = 0;;) {count += 1\n}";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Statement> stmt = parser.parseStatement();
         
@@ -128,7 +130,7 @@ TEST_F(StatementCheckerTest, checkForTest)
     // Valid for loop with initial clause and termination clause
     {
         std::string source = "for (count = 0; count < 10;) {count += 1\n}";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Statement> stmt = parser.parseStatement();
         
@@ -141,7 +143,7 @@ TEST_F(StatementCheckerTest, checkForTest)
     // Valid for loop with initial clause, termination clause and increment clause
     {
         std::string source = "for (count = 0; count < 10; count += 1) {}";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Statement> stmt = parser.parseStatement();
         
@@ -154,7 +156,7 @@ TEST_F(StatementCheckerTest, checkForTest)
     // Invalid init clause
     {
         std::string source = "for (count += 0;;) {}";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Statement> stmt = parser.parseStatement();
         
@@ -167,7 +169,7 @@ TEST_F(StatementCheckerTest, checkForTest)
     // Invalid term clause
     {
         std::string source = "for (count = 0; count = 10;) {}";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Statement> stmt = parser.parseStatement();
         
@@ -183,7 +185,7 @@ TEST_F(StatementCheckerTest, checkWhileTest)
     // Valid while loop
     {
         std::string source = "while (true) {}";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Statement> stmt = parser.parseStatement();
         
@@ -196,7 +198,7 @@ TEST_F(StatementCheckerTest, checkWhileTest)
     // Invalid while loop
     {
         std::string source = "while (1) {}";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Statement> stmt = parser.parseStatement();
         
@@ -212,7 +214,7 @@ TEST_F(StatementCheckerTest, checkBreakTest)
     // Valid break statement
     {
         std::string source = "while (true) { break \n}";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Statement> stmt = parser.parseStatement();
         
@@ -225,7 +227,7 @@ TEST_F(StatementCheckerTest, checkBreakTest)
     // Invalid continue
     {
         std::string source = "break\n";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Statement> stmt = parser.parseStatement();
         
@@ -241,7 +243,7 @@ TEST_F(StatementCheckerTest, checkContinueTest)
     // Valid continue statement
     {
         std::string source = "while (true) { continue \n}";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Statement> stmt = parser.parseStatement();
         
@@ -254,7 +256,7 @@ TEST_F(StatementCheckerTest, checkContinueTest)
     // Invalid continue
     {
         std::string source = "continue\n";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Statement> stmt = parser.parseStatement();
         
@@ -270,7 +272,7 @@ TEST_F(StatementCheckerTest, checkReturnTest)
     // Valid return statement with nothing to return
     {
         std::string source = "return\n";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Statement> stmt = parser.parseStatement();
 
@@ -287,7 +289,7 @@ TEST_F(StatementCheckerTest, checkReturnTest)
     // Valid return statement with int to return
     {
         std::string source = "return 0:uint\n";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Statement> stmt = parser.parseStatement();
 
@@ -304,7 +306,7 @@ TEST_F(StatementCheckerTest, checkReturnTest)
     // Invalid return that returns nothing while the function returns int
     {
         std::string source = "return\n";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Statement> stmt = parser.parseStatement();
 
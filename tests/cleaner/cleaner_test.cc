@@ -3,11 +3,15 @@
 #include <memory>
 #include <string>
 
+#include "cleaner/ast/expressions/expression.h"
+#include "cleaner/ast/definitions/function.h"
+#include "cleaner/ast/statements/return.h"
 #include "cleaner/symbols/scope.h"
 #include "parsetree/program.h"
 #include "cleaner/cleaner.h"
 #include "checker/checker.h"
 #include "parser/parser.h"
+#include "common/source.h"
 #include "lexer/lexer.h"
 
 
@@ -21,6 +25,7 @@ class CleanerTest: public ::testing::Test
         }
 
         std::string source_path = "main.pro";
+        SourceManager sources;
 };
 
 TEST_F(CleanerTest, cleanTest) {
@@ -34,7 +39,7 @@ TEST_F(CleanerTest, cleanTest) {
         "    return 0\n"
         "}\n";
 
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Parser parser(lexer);
     Program prog = parser.parseProgram();
     Checker(prog).check();
@@ -43,3 +48,45 @@ TEST_F(CleanerTest, cleanTest) {
     EXPECT_EQ(cleaner.warnings.size(), 1);
     EXPECT_EQ(scope->fun_defs.symbols.size(), 2);
 }
+
+TEST_F(CleanerTest, tailCallTest) {
+    std::string source =
+        "count: function(n: int) -> int {\n"
+        "    return n == 0 ? n else (count(n - 1))\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    return count(count(3))\n"
+        "}\n";
+
+    Lexer lexer(source, source_path);
+    Parser parser(lexer);
+    Program prog = parser.parseProgram();
+    Checker(prog).check();
+    Cleaner cleaner(prog);
+    std::shared_ptr<CleanScope> scope = cleaner.clean();
+
+    // Calls in the branches of a returned ternary are tail calls
+    CleanReturnStatement* ret_stmt = static_cast<CleanReturnStatement*>(
+        scope->getSymbol<CleanFunctionDefinition>("count(int)")->body->statements[0].get()
+    );
+    CleanTernaryIfExpression* ternif_expr =
+        static_cast<CleanTernaryIfExpression*>(ret_stmt->expression.get());
+    CleanCallExpression* cond_call =
+        static_cast<CleanCallExpression*>(ternif_expr->condition.get());
+    EXPECT_EQ(cond_call->is_tail_call, false);
+    CleanGroupExpression* gr_expr =
+        static_cast<CleanGroupExpression*>(ternif_expr->else_branch.get());
+    EXPECT_EQ(static_cast<CleanCallExpression*>(gr_expr->expression.get())->is_tail_call, true);
+
+    // Arguments of a tail call are not
+    ret_stmt = static_cast<CleanReturnStatement*>(
+        scope->getSymbol<CleanFunctionDefinition>("main()")->body->statements[0].get()
+    );
+    CleanCallExpression* call_expr =
+        static_cast<CleanCallExpression*>(ret_stmt->expression.get());
+    EXPECT_EQ(call_expr->is_tail_call, true);
+    EXPECT_EQ(
+        static_cast<CleanCallExpression*>(call_expr->arguments[0].get())->is_tail_call,
+        false
+    );
+}
@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
+#include <stdexcept>
 #include <cstdint>
 #include <cstddef>
 #include <memory>
@@ -14,6 +15,7 @@
 #include "checker/checker.h"
 #include "parser/parser.h"
 #include "symbols/scope.h"
+#include "common/source.h"
 #include "lexer/lexer.h"
 
 
@@ -30,6 +32,7 @@ class ExpressionCleanerTest: public ::testing::Test
         std::unique_ptr<Definition> var_def = nullptr;
         std::shared_ptr<Scope> scope = std::make_shared<Scope>(nullptr);
         std::shared_ptr<CleanScope> clean_scope = std::make_shared<CleanScope>(nullptr);
+        SourceManager sources;
 };
 
 // Literals
@@ -37,7 +40,7 @@ TEST_F(ExpressionCleanerTest, cleanLiteralTest) {
     // Boolean
     {
         std::string source = "true";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
         std::unique_ptr<CleanExpression> clean_expr =
@@ -52,7 +55,7 @@ TEST_F(ExpressionCleanerTest, cleanLiteralTest) {
     // Unsigned int
     {
         std::string source = "10";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
         std::unique_ptr<CleanExpression> clean_expr =
@@ -67,7 +70,7 @@ TEST_F(ExpressionCleanerTest, cleanLiteralTest) {
     // Signed int
     {
         std::string source = "-10";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
         std::unique_ptr<CleanExpression> clean_expr =
@@ -82,7 +85,7 @@ TEST_F(ExpressionCleanerTest, cleanLiteralTest) {
     // Float
     {
         std::string source = "1.0";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
         std::unique_ptr<CleanExpression> clean_expr =
@@ -97,7 +100,7 @@ TEST_F(ExpressionCleanerTest, cleanLiteralTest) {
     // String
     {
         std::string source = "\"Hello World!\"";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
         std::unique_ptr<CleanExpression> clean_expr =
@@ -108,6 +111,19 @@ TEST_F(ExpressionCleanerTest, cleanLiteralTest) {
             static_cast<CleanStringExpression*>(clean_expr.get());
         EXPECT_EQ(string_expr->value, "Hello World!");
     }
+
+    // Integers that don't fit fail to clean
+    {
+        std::string source = "9223372036854775808";
+        Lexer lexer(source, source_path);
+        Parser parser(lexer);
+        std::unique_ptr<Expression> expr = parser.parseExpression();
+
+        EXPECT_THROW(
+            ExpressionCleaner(clean_scope).clean(expr.get()),
+            std::out_of_range
+        );
+    }
 }
 
 // Cast
@@ -115,7 +131,7 @@ TEST_F(ExpressionCleanerTest, cleanCastTest) {
     // Int to string results in function call
     {
         std::string source = "1:string";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
         ExpressionChecker(scope).checkCast(expr.get());
@@ -131,7 +147,7 @@ TEST_F(ExpressionCleanerTest, cleanCastTest) {
     // Int to unsigned int results in immediate cast to unsigned int literal
     {
         std::string source = "1:uint";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
         ExpressionChecker(scope).checkCast(expr.get());
@@ -143,12 +159,28 @@ TEST_F(ExpressionCleanerTest, cleanCastTest) {
             static_cast<CleanUnsignedIntExpression*>(clean_expr.get());
         EXPECT_EQ(uint_expr->value, (uint64_t) 1);
     }
+
+    // Unsigned int literals span the whole unsigned range
+    {
+        std::string source = "18446744073709551615:uint";
+        Lexer lexer(source, source_path);
+        Parser parser(lexer);
+        std::unique_ptr<Expression> expr = parser.parseExpression();
+        ExpressionChecker(scope).checkCast(expr.get());
+        std::unique_ptr<CleanExpression> clean_expr =
+            ExpressionCleaner(clean_scope).clean(expr.get());
+
+        EXPECT_EQ(clean_expr->type, CleanExpressionType::UnsignedInt);
+        CleanUnsignedIntExpression* uint_expr =
+            static_cast<CleanUnsignedIntExpression*>(clean_expr.get());
+        EXPECT_EQ(uint_expr->value, UINT64_MAX);
+    }
 }
 
 // Variable
 TEST_F(ExpressionCleanerTest, cleanVariableTest) {
     std::string source = "count";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Parser parser(lexer);
     std::unique_ptr<Expression> expr = parser.parseExpression();
     std::unique_ptr<CleanExpression> clean_expr =
@@ -163,7 +195,7 @@ TEST_F(ExpressionCleanerTest, cleanVariableTest) {
 // Group
 TEST_F(ExpressionCleanerTest, cleanGroupTest) {
     std::string source = "(count)";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Parser parser(lexer);
     std::unique_ptr<Expression> expr = parser.parseExpression();
     std::unique_ptr<CleanExpression> clean_expr =
@@ -181,8 +213,7 @@ TEST_F(ExpressionCleanerTest, cleanGroupTest) {
 // Assignment
 TEST_F(ExpressionCleanerTest, cleanAssignmentTest) {
     {
-        std::shared_ptr<std::string> source =
-            std::make_shared<std::string>("count: int = 0");
+        std::string source = "count: int = 0";
         Lexer lexer(source, source_path);
         Parser parser(lexer);
         var_def = parser.parseDefinition();
@@ -192,7 +223,7 @@ TEST_F(ExpressionCleanerTest, cleanAssignmentTest) {
     // Assignment doesn't introduce a definition
     {
         std::string source = "count = 1";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
         ExpressionChecker(scope).check(expr.get());
@@ -211,7 +242,7 @@ TEST_F(ExpressionCleanerTest, cleanAssignmentTest) {
     // Assignment introduces a definition
     {
         std::string source = "new_count = 1";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
         ExpressionChecker(scope).check(expr.get());
@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstddef>
+
+#include "common/value.h"
+#include "common/memo.h"
+
+
+TEST(MemoTable, findInsertTest)
+{
+    MemoTable memo(2, 64);
+    Value args[2] = { Value((int64_t) 3), Value((int64_t) 4) };
+    EXPECT_EQ(memo.find(args), nullptr);
+
+    memo.insert(args, Value((int64_t) 7));
+    Value const* cached = memo.find(args);
+    ASSERT_NE(cached, nullptr);
+    EXPECT_EQ(cached->as_int, (int64_t) 7);
+
+    // Arguments that differ in any position miss
+    Value other_args[2] = { Value((int64_t) 3), Value((int64_t) 5) };
+    EXPECT_EQ(memo.find(other_args), nullptr);
+
+    EXPECT_EQ(memo.getHits(), (std::size_t) 1);
+    EXPECT_EQ(memo.getMisses(), (std::size_t) 2);
+}
+
+TEST(MemoTable, boundTest)
+{
+    // A single entry holds the most recent result only
+    MemoTable memo(1, 1);
+    Value first((int64_t) 1);
+    Value second((int64_t) 2);
+    memo.insert(&first, Value(true));
+    memo.insert(&second, Value(false));
+    EXPECT_EQ(memo.find(&first), nullptr);
+    ASSERT_NE(memo.find(&second), nullptr);
+    EXPECT_EQ(memo.find(&second)->as_bool, false);
+}
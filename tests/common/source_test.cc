@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include <string_view>
+#include <stdexcept>
+#include <fstream>
+#include <cstddef>
+#include <utility>
+#include <string>
+
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "common/source.h"
+
+
+class SourceTest: public ::testing::Test
+{
+    protected:
+        void SetUp() override {
+        }
+
+        void TearDown() override {
+        }
+
+        // Writes the given text to a fresh file and returns its path
+        std::string writeSource(std::string const& name, std::string const& text) {
+            std::string path = ::testing::TempDir() + name;
+            std::ofstream file(path, std::ios::binary);
+            file << text;
+            return path;
+        }
+
+        // The lexer looks one character before and two past the text
+        void expectFramed(std::string_view text) {
+            EXPECT_EQ(text.data()[-1], '\0');
+            EXPECT_EQ(text.data()[text.size()], '\0');
+            EXPECT_EQ(text.data()[text.size() + 1], '\0');
+        }
+
+        SourceManager sources;
+};
+
+TEST_F(SourceTest, openTest)
+{
+    std::string text = "main : function() -> int {\n    return 0\n}\n";
+    SourceBuffer buffer = SourceBuffer::open(writeSource("open.pro", text));
+
+#if defined(__unix__) || defined(__APPLE__)
+    EXPECT_TRUE(buffer.isMapped());
+#endif
+    EXPECT_EQ(buffer.getText(), text);
+    expectFramed(buffer.getText());
+}
+
+TEST_F(SourceTest, openPageTest)
+{
+    // A file filling whole pages still ends on zero characters
+    std::string text(1 << 16, 'a');
+    SourceBuffer buffer = SourceBuffer::open(writeSource("page.pro", text));
+
+    EXPECT_EQ(buffer.getText(), text);
+    expectFramed(buffer.getText());
+}
+
+TEST_F(SourceTest, openEmptyTest)
+{
+    SourceBuffer buffer = SourceBuffer::open(writeSource("empty.pro", ""));
+
+    EXPECT_FALSE(buffer.isMapped());
+    EXPECT_EQ(buffer.getText(), "");
+    expectFramed(buffer.getText());
+}
+
+TEST_F(SourceTest, openMissingTest)
+{
+    EXPECT_THROW(
+        SourceBuffer::open(::testing::TempDir() + "missing.pro"),
+        std::invalid_argument
+    );
+}
+
+TEST_F(SourceTest, openOversizedTest)
+{
+    // Token offsets are 32 bits wide, a sparse file is enough to go past them
+    std::string path = writeSource("oversized.pro", "");
+    ASSERT_EQ(::truncate(path.c_str(), (off_t) SourceBuffer::max_size + 1), 0);
+
+    EXPECT_THROW(SourceBuffer::open(path), std::runtime_error);
+    ::unlink(path.c_str());
+}
+
+TEST_F(SourceTest, textTest)
+{
+    SourceBuffer buffer("var");
+    EXPECT_FALSE(buffer.isMapped());
+    EXPECT_EQ(buffer.getText(), "var");
+    expectFramed(buffer.getText());
+
+    // Moving keeps the text where the new owner can find it
+    SourceBuffer moved = std::move(buffer);
+    EXPECT_EQ(moved.getText(), "var");
+    expectFramed(moved.getText());
+}
+
+TEST_F(SourceTest, managerTest)
+{
+    std::string text = "first\nsecond\n";
+    std::string path = writeSource("manager.pro", text);
+    std::size_t source = SourceManager::add(SourceBuffer::open(path), path);
+
+    EXPECT_EQ(SourceManager::getText(source), text);
+    EXPECT_EQ(SourceManager::getPath(source), path);
+}
+
+TEST_F(SourceTest, managerLifetimeTest)
+{
+    std::size_t outer = SourceManager::add(SourceBuffer("outer"), "outer.pro");
+    {
+        // A nested manager starts over and hands the outer one back when it goes away
+        SourceManager nested;
+        std::size_t inner = SourceManager::add(SourceBuffer("inner"), "inner.pro");
+        EXPECT_EQ(inner, outer);
+        EXPECT_EQ(SourceManager::getText(inner), "inner");
+    }
+    EXPECT_EQ(SourceManager::getText(outer), "outer");
+    EXPECT_EQ(SourceManager::getPath(outer), "outer.pro");
+}
+
+TEST(SourceManagerTest, inactiveTest)
+{
+    EXPECT_THROW(SourceManager::add(SourceBuffer("var"), "var.pro"), std::runtime_error);
+}
+
+TEST_F(SourceTest, builtinTest)
+{
+    std::size_t int_offset = SourceManager::addBuiltin("int");
+    std::string_view text = SourceManager::getText(SourceManager::builtin);
+    EXPECT_EQ(text.substr(int_offset, 3), "int");
+
+    // Lexemes are interned in one source that stays where it is as it grows
+    std::size_t float_offset = SourceManager::addBuiltin("float");
+    EXPECT_NE(float_offset, int_offset);
+    EXPECT_EQ(SourceManager::addBuiltin("int"), int_offset);
+    EXPECT_EQ(SourceManager::getText(SourceManager::builtin).data(), text.data());
+    EXPECT_EQ(SourceManager::getText(SourceManager::builtin).substr(float_offset, 5), "float");
+    EXPECT_EQ(SourceManager::getPath(SourceManager::builtin), "__builtin__");
+}
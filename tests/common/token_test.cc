@@ -1,8 +1,11 @@
 #include <gtest/gtest.h>
-#include <memory>
+#include <type_traits>
+#include <string_view>
+#include <cstddef>
 #include <string>
 
 #include "common/token_type.h"
+#include "common/source.h"
 #include "common/token.h"
 
 
@@ -10,32 +13,55 @@ class TokenTest: public ::testing::Test
 {
     protected:
         void SetUp() override {
-            static std::string _source = "var";
-            source = std::make_shared<std::string>(_source);
+            source_text = "var";
             source_path = "main.pro";
+            source = SourceManager::add(source_text, source_path);
         }
 
         void TearDown() override {
         }
 
-        std::shared_ptr<std::string> source;
+        std::size_t source;
+        std::string source_text;
         std::string source_path;
+        SourceManager sources;
 };
 
+TEST_F(TokenTest, layoutTest)
+{
+    EXPECT_EQ(sizeof(Token), 16);
+    EXPECT_TRUE(std::is_trivially_copyable<Token>::value);
+}
+
 TEST_F(TokenTest, getLexemeTest)
 {
     Token token(
         PROTO_IDENTIFIER,
         source,
-        source_path,
-        source->begin(),
+        0,
         3,
         1,
         1
     );
 
     std::string lexeme = token.getLexeme();
-    EXPECT_EQ(lexeme, *source);
+    EXPECT_EQ(lexeme, source_text);
+}
+
+TEST_F(TokenTest, getLexemeViewTest)
+{
+    Token token(
+        PROTO_IDENTIFIER,
+        source,
+        1,
+        2,
+        1,
+        2
+    );
+
+    std::string_view lexeme = token.getLexemeView();
+    EXPECT_EQ(lexeme, "ar");
+    EXPECT_EQ(lexeme.data(), SourceManager::getText(source).data() + 1);
 }
 
 TEST_F(TokenTest, getLineTest)
@@ -43,13 +69,26 @@ TEST_F(TokenTest, getLineTest)
     Token token(
         PROTO_IDENTIFIER,
         source,
-        source_path,
-        source->begin(),
+        0,
         3,
         1,
         1
     );
 
     TokenLine tok_line = token.getLine();
-    EXPECT_EQ(tok_line.line, *source);
+    EXPECT_EQ(tok_line.line, source_text);
+}
+
+TEST_F(TokenTest, getSourcePathTest)
+{
+    Token token(
+        PROTO_IDENTIFIER,
+        source,
+        0,
+        3,
+        1,
+        1
+    );
+
+    EXPECT_EQ(token.getSourcePath(), source_path);
 }
@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+#include "common/value.h"
+
+
+class ValueTest: public ::testing::Test
+{
+    protected:
+        void SetUp() override {
+        }
+
+        void TearDown() override {
+        }
+};
+
+TEST_F(ValueTest, layoutTest)
+{
+    EXPECT_EQ(sizeof(Value), (std::size_t) 16);
+    EXPECT_TRUE(std::is_trivially_copyable<Value>::value);
+}
+
+TEST_F(ValueTest, constructionTest)
+{
+    Value void_value;
+    EXPECT_EQ(void_value.type, ValueType::Void);
+
+    Value bool_value(true);
+    EXPECT_EQ(bool_value.type, ValueType::Boolean);
+    EXPECT_EQ(bool_value.as_bool, true);
+
+    Value int_value((int64_t) -10);
+    EXPECT_EQ(int_value.type, ValueType::SignedInt);
+    EXPECT_EQ(int_value.as_int, (int64_t) -10);
+
+    Value uint_value((uint64_t) 18446744073709551615u);
+    EXPECT_EQ(uint_value.type, ValueType::UnsignedInt);
+    EXPECT_EQ(uint_value.as_uint, (uint64_t) 18446744073709551615u);
+
+    Value float_value(1.5);
+    EXPECT_EQ(float_value.type, ValueType::Float);
+    EXPECT_EQ(float_value.as_float, 1.5);
+
+    std::string str = "Hello World!";
+    Value string_value(&str);
+    EXPECT_EQ(string_value.type, ValueType::String);
+    EXPECT_EQ(*string_value.as_string, "Hello World!");
+}
@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <string>
+
+#include "cleaner/ast/expressions/expression.h"
+#include "cleaner/ast/definitions/function.h"
+#include "cleaner/ast/statements/while.h"
+#include "cleaner/ast/statements/block.h"
+#include "cleaner/ast/statements/for.h"
+#include "tests/support/pipeline.h"
+#include "cleaner/symbols/scope.h"
+#include "common/source.h"
+
+
+class EliminatorTest: public ::testing::Test
+{
+    protected:
+        void SetUp() override {
+        }
+
+        void TearDown() override {
+        }
+
+        std::shared_ptr<CleanScope> eliminate(std::string const& source) {
+            // Calls are not inlined so the tests can tell which ones are kept
+            Pipeline pipeline = preparePipeline(source, PipelineStage::Eliminate, 0);
+            warnings.clear();
+            notes.clear();
+            for (auto& w: pipeline.warnings) {
+                warnings.push_back(w.getPrimaryMessage());
+                notes.push_back(w.getSecondaryMessage());
+            }
+            return pipeline.getScope();
+        }
+
+        CleanBlockStatement* body(CleanScope* scope, std::string const& fun_name) {
+            return scope->getSymbol<CleanFunctionDefinition>(fun_name)->body.get();
+        }
+
+        std::vector<std::string> warnings;
+        std::vector<std::string> notes;
+        SourceManager sources;
+};
+
+TEST_F(EliminatorTest, unreachableCodeTest) {
+    std::shared_ptr<CleanScope> scope = eliminate(
+        "main: function() -> int {\n"
+        "    x: int = 1\n"
+        "    while (x < 10) {\n"
+        "        x += 1\n"
+        "        continue\n"
+        "        println(x)\n"
+        "    }\n"
+        "    return x\n"
+        "    println(x)\n"
+        "}\n"
+    );
+
+    CleanBlockStatement* main_body = body(scope.get(), "main()");
+    ASSERT_EQ(main_body->statements.size(), 3);
+    EXPECT_EQ(main_body->statements[2]->type, CleanStatementType::Return);
+
+    CleanWhileStatement* while_stmt =
+        static_cast<CleanWhileStatement*>(main_body->statements[1].get());
+    ASSERT_EQ(while_stmt->body->statements.size(), 2);
+    EXPECT_EQ(while_stmt->body->statements[1]->type, CleanStatementType::Continue);
+
+    ASSERT_EQ(warnings.size(), 2);
+    EXPECT_EQ(warnings[0], "unreachable code");
+    EXPECT_EQ(warnings[1], "unreachable code");
+}
+
+TEST_F(EliminatorTest, constantConditionTest) {
+    std::shared_ptr<CleanScope> scope = eliminate(
+        "debug: const bool = false\n"
+        "main: function() -> int {\n"
+        "    if (debug) {\n"
+        "        println(1)\n"
+        "    } else {\n"
+        "        println(2)\n"
+        "    }\n"
+        "    while (debug && true) {\n"
+        "        println(3)\n"
+        "    }\n"
+        "    if (true) {\n"
+        "        println(4)\n"
+        "    }\n"
+        "    if (! debug) {\n"
+        "        println(5)\n"
+        "    } else {\n"
+        "        println(6)\n"
+        "    }\n"
+        "    return 0\n"
+        "}\n"
+    );
+
+    // Only the else branch remains, the loop is gone and the branches
+    // always taken are kept without their condition
+    CleanBlockStatement* main_body = body(scope.get(), "main()");
+    ASSERT_EQ(main_body->statements.size(), 4);
+    EXPECT_EQ(main_body->statements[1]->type, CleanStatementType::Block);
+    EXPECT_EQ(main_body->statements[2]->type, CleanStatementType::Block);
+    ASSERT_EQ(main_body->statements[0]->type, CleanStatementType::Block);
+    CleanBlockStatement* else_body =
+        static_cast<CleanBlockStatement*>(main_body->statements[0].get());
+    ASSERT_EQ(else_body->statements.size(), 1);
+    CleanCallExpression* call_expr =
+        static_cast<CleanCallExpression*>(else_body->statements[0].get());
+    ASSERT_EQ(call_expr->arguments[0]->type, CleanExpressionType::SignedInt);
+    EXPECT_EQ(
+        static_cast<CleanSignedIntExpression*>(call_expr->arguments[0].get())->value,
+        2
+    );
+
+    // Only the condition with an else branch behind it hides branches that can never run
+    ASSERT_EQ(warnings.size(), 4);
+    EXPECT_EQ(warnings[0], "condition is always false");
+    EXPECT_EQ(warnings[1], "condition is always false");
+    EXPECT_EQ(warnings[2], "condition is always true");
+    EXPECT_EQ(notes[2], "the condition is redundant since the branch always runs");
+    EXPECT_EQ(warnings[3], "condition is always true");
+    EXPECT_EQ(notes[3], "the branches that follow can never run");
+}
+
+TEST_F(EliminatorTest, deadStoreTest) {
+    std::shared_ptr<CleanScope> scope = eliminate(
+        "next: function(n: int) -> int {\n"
+        "    println(n)\n"
+        "    return n + 1\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    x: int = 1\n"
+        "    x = 2\n"
+        "    x = 3\n"
+        "    y: int = 0\n"
+        "    step: const int = 1\n"
+        "    for (i: int = 0; i < 3; i += step) {\n"
+        "        y += x\n"
+        "    }\n"
+        "    z: int = next(y)\n"
+        "    w = 4\n"
+        "    return y\n"
+        "}\n"
+    );
+
+    // The first two values of x and the value of w are never read, the call assigned
+    // to z must still happen and the constant is gone quietly since its uses were folded
+    CleanBlockStatement* main_body = body(scope.get(), "main()");
+    ASSERT_EQ(main_body->statements.size(), 5);
+    ASSERT_EQ(main_body->statements[0]->type, CleanStatementType::Expression);
+    CleanAssignmentExpression* assign_expr =
+        static_cast<CleanAssignmentExpression*>(main_body->statements[0].get());
+    ASSERT_EQ(assign_expr->rvalue->type, CleanExpressionType::SignedInt);
+    EXPECT_EQ(static_cast<CleanSignedIntExpression*>(assign_expr->rvalue.get())->value, 3);
+    EXPECT_EQ(
+        static_cast<CleanExpression*>(main_body->statements[3].get())->type,
+        CleanExpressionType::Call
+    );
+
+    // The loop keeps accumulating into y
+    CleanForStatement* for_stmt =
+        static_cast<CleanForStatement*>(main_body->statements[2].get());
+    EXPECT_EQ(for_stmt->body->statements.size(), 1);
+
+    // Definitions need an initializer so only the assignment overwritten is reported
+    ASSERT_EQ(warnings.size(), 1);
+    EXPECT_EQ(warnings[0], "value never read");
+}
+
+TEST_F(EliminatorTest, keepOverflowingDivisionTest) {
+    std::shared_ptr<CleanScope> scope = eliminate(
+        "main: function() -> int {\n"
+        "    a: int = 4\n"
+        "    q: int = 0\n"
+        "    q = a / -1\n"
+        "    q = 5\n"
+        "    return q\n"
+        "}\n"
+    );
+
+    // The value is never read but the division traps if a is the smallest int
+    CleanBlockStatement* main_body = body(scope.get(), "main()");
+    std::size_t divisions = 0;
+    for (auto& stmt: main_body->statements) {
+        if (stmt->type != CleanStatementType::Expression)
+            continue;
+        CleanExpression* expr = static_cast<CleanExpression*>(stmt.get());
+        divisions += expr->type == CleanExpressionType::Operation &&
+            static_cast<CleanOperationExpression*>(expr)->operation == Operation::DivI64;
+    }
+    EXPECT_EQ(divisions, (std::size_t) 1);
+}
@@ -0,0 +1,243 @@
+#include <gtest/gtest.h>
+#include <sys/wait.h>
+#include <csignal>
+#include <cstdlib>
+#include <fstream>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include "interpreter/interpreter.h"
+#include "tests/support/pipeline.h"
+#include "cleaner/symbols/scope.h"
+#include "emitter/assembly.h"
+#include "common/source.h"
+#include "utils/file.h"
+#include "emitter/c.h"
+
+
+/* A program translated to C or to assembly must print what
+ * the interpreter prints and exit with the result of its main function. */
+class EmitterTest: public ::testing::Test
+{
+    protected:
+        void SetUp() override {
+            // The translated programs need a C compiler to run
+            if (std::system("cc --version > /dev/null 2>&1") != 0)
+                GTEST_SKIP() << "no C compiler found";
+        }
+
+        void TearDown() override {
+        }
+
+        void conform(std::string const& source) {
+            std::shared_ptr<CleanScope> interpreter_scope =
+                preparePipeline(source, PipelineStage::Hoist).getScope();
+            testing::internal::CaptureStdout();
+            int interpreter_result = Interpreter(interpreter_scope.get()).interpret();
+            std::string interpreter_output = testing::internal::GetCapturedStdout();
+
+            // The C emitter takes the program once calls are linked
+            std::shared_ptr<CleanScope> c_scope =
+                preparePipeline(source, PipelineStage::Link).getScope();
+            run(
+                "emitter_test.c",
+                "-std=c99 -O2",
+                CEmitter(c_scope.get()).emit(),
+                interpreter_output,
+                interpreter_result
+            );
+
+#if defined(__x86_64__) && defined(__linux__)
+            Pipeline assembly_pipeline = preparePipeline(source, PipelineStage::Hoist);
+            IRModule module = assembly_pipeline.buildModule();
+            run(
+                "emitter_test.s",
+                "",
+                AssemblyEmitter(module, assembly_pipeline.getScope().get()).emit(),
+                interpreter_output,
+                interpreter_result
+            );
+#endif
+        }
+
+        // Build the translated program, run it and compare with the interpreter
+        void run(
+            std::string const& file_name,
+            std::string const& flags,
+            std::string const& translation,
+            std::string const& expected_output,
+            int expected_result
+        ) {
+            std::string source_file = testing::TempDir() + "/" + file_name;
+            std::string binary_path = testing::TempDir() + "/emitter_test";
+            std::ofstream(source_file) << translation;
+            ASSERT_EQ(
+                std::system(("cc " + flags + " -o " + binary_path + " " + source_file).c_str()),
+                0
+            );
+
+            std::string output;
+            FILE* pipe = popen(binary_path.c_str(), "r");
+            ASSERT_NE(pipe, nullptr);
+            char buffer[256];
+            while (std::fgets(buffer, sizeof(buffer), pipe))
+                output += buffer;
+            int status = pclose(pipe);
+
+            EXPECT_EQ(output, expected_output) << file_name;
+            EXPECT_TRUE(WIFEXITED(status));
+            EXPECT_EQ(WEXITSTATUS(status), expected_result & 0xFF) << file_name;
+        }
+
+        SourceManager sources;
+};
+
+TEST_F(EmitterTest, fibonacciTest) {
+    conform(readFile("fibonacci.pro"));
+}
+
+TEST_F(EmitterTest, fibonacciUintTest) {
+    conform(readFile("fibonacci_uint.pro"));
+}
+
+TEST_F(EmitterTest, expressionsTest) {
+    std::string source =
+        "count: int = 2\n"
+        "scale : function(x: float, up: bool) -> float {\n"
+        "    if (up && x > 1.0) {\n"
+        "        return x * 2.5\n"
+        "    } elif (! up) {\n"
+        "        return -x\n"
+        "    }\n"
+        "    return x\n"
+        "}\n"
+        "main : function() -> int {\n"
+        "    println(scale(3.0, true))\n"
+        "    println(scale(3.0, false))\n"
+        "    println(count > 1)\n"
+        "    i: int = 0\n"
+        "    while (i < 4) {\n"
+        "        i += 1\n"
+        "        if (i == 2) { continue }\n"
+        "        print(i)\n"
+        "    }\n"
+        "    println(\"\")\n"
+        "    println(7:uint / 2:uint)\n"
+        "    println(-9223372036854775807 - 2)\n"
+        "    return -count % 3\n"
+        "}\n";
+    conform(source);
+}
+
+TEST_F(EmitterTest, shortCircuitTest) {
+    // The right operand of a logical operator only runs when it decides the result
+    std::string source =
+        "side: function(n: int) -> bool {\n"
+        "    println(n)\n"
+        "    return n > 2\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    d: int = 0\n"
+        "    if (d != 0 && 10 / d > 1) {\n"
+        "        println(0)\n"
+        "    }\n"
+        "    if (d == 0 || 10 / d > 1) {\n"
+        "        println(1)\n"
+        "    }\n"
+        "    a: bool = false && side(2)\n"
+        "    b: bool = true || side(3)\n"
+        "    c: bool = side(4) && side(5)\n"
+        "    println(a || b)\n"
+        "    println(c)\n"
+        "    return 0\n"
+        "}\n";
+    conform(source);
+}
+
+TEST_F(EmitterTest, sequencedOperandsTest) {
+    // Operands that call functions run left to right even though C leaves the order open
+    std::string source =
+        "count: int = 0\n"
+        "side: function(n: int) -> int {\n"
+        "    println(n)\n"
+        "    return n\n"
+        "}\n"
+        "bump: function() -> int {\n"
+        "    count += 10\n"
+        "    return 1\n"
+        "}\n"
+        "pair: function(a: int, b: int) -> int {\n"
+        "    return a * 10 + b\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    println(side(1) + side(2))\n"
+        "    println(pair(side(3), side(4)))\n"
+        "    println(count + bump())\n"
+        "    return side(5) - side(6) * 2\n"
+        "}\n";
+    conform(source);
+}
+
+TEST_F(EmitterTest, spillTest) {
+    // More values are live across the loop than there are registers,
+    // and some arguments are passed on the stack
+    std::string source =
+        "mix : function(a: int, b: int, c: int, d: int, e: int, f: int, g: int, h: int) -> int {\n"
+        "    return a - b + c * d - e + f * g - h\n"
+        "}\n"
+        "double : function(n: int) -> int {\n"
+        "    return n * 2\n"
+        "}\n"
+        "main : function() -> int {\n"
+        "    a: int = 1\n"
+        "    b: int = 2\n"
+        "    c: int = 3\n"
+        "    d: int = 4\n"
+        "    e: int = 5\n"
+        "    f: int = 6\n"
+        "    g: int = 7\n"
+        "    x: float = 0.5\n"
+        "    for (i: int = 0; i < 10; i += 1) {\n"
+        "        a = a + b\n"
+        "        b = b + c\n"
+        "        c = c + d\n"
+        "        d = d + e\n"
+        "        e = e + f\n"
+        "        f = f + g\n"
+        "        g = g + a\n"
+        "        x = x * 1.5\n"
+        "    }\n"
+        "    println(mix(a, b, c, d, e, f, g, double(3)))\n"
+        "    println(mix(g, f, e, d, c, b, a, 7))\n"
+        "    println(x > 10.0)\n"
+        "    return 0\n"
+        "}\n";
+    conform(source);
+}
+
+TEST_F(EmitterTest, overflowingDivisionTest) {
+    // The smallest int over -1 is undefined in C, the translation traps on it like the other backends
+    std::string source =
+        "main: function() -> int {\n"
+        "    m: int = 0 - 9223372036854775807\n"
+        "    m = m - 1\n"
+        "    n: int = -1\n"
+        "    println(7)\n"
+        "    println(m / n)\n"
+        "    return 0\n"
+        "}\n";
+    std::shared_ptr<CleanScope> scope = preparePipeline(source, PipelineStage::Link).getScope();
+    std::string source_file = testing::TempDir() + "/emitter_test.c";
+    std::string binary_path = testing::TempDir() + "/emitter_test";
+    std::ofstream(source_file) << CEmitter(scope.get()).emit();
+    ASSERT_EQ(
+        std::system(("cc -std=c99 -O2 -o " + binary_path + " " + source_file).c_str()),
+        0
+    );
+
+    // The shell hands its process over so the signal is reported as is
+    int status = std::system(("exec " + binary_path + " > /dev/null").c_str());
+    ASSERT_TRUE(WIFSIGNALED(status));
+    EXPECT_EQ(WTERMSIG(status), SIGFPE);
+}
@@ -0,0 +1,193 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+#include "cleaner/ast/expressions/expression.h"
+#include "cleaner/ast/definitions/function.h"
+#include "cleaner/ast/definitions/variable.h"
+#include "cleaner/ast/statements/return.h"
+#include "tests/support/pipeline.h"
+#include "cleaner/symbols/scope.h"
+#include "common/source.h"
+
+
+class FolderTest: public ::testing::Test
+{
+    protected:
+        void SetUp() override {
+        }
+
+        void TearDown() override {
+        }
+
+        std::shared_ptr<CleanScope> fold(std::string const& source) {
+            return preparePipeline(source, PipelineStage::Fold).getScope();
+        }
+
+        CleanExpression* returned(CleanScope* scope, std::string const& fun_name) {
+            CleanReturnStatement* ret_stmt = static_cast<CleanReturnStatement*>(
+                scope->getSymbol<CleanFunctionDefinition>(fun_name)
+                    ->body->statements.back().get()
+            );
+            return ret_stmt->expression.get();
+        }
+
+        SourceManager sources;
+};
+
+TEST_F(FolderTest, foldOperationsTest) {
+    std::shared_ptr<CleanScope> scope = fold(
+        "f: function() -> int {\n"
+        "    return (1 + 2 * 3) - -4\n"
+        "}\n"
+        "g: function() -> bool {\n"
+        "    return 2.0 * 1.5 > 2.5 && ! false\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    f()\n"
+        "    g()\n"
+        "    return +5\n"
+        "}\n"
+    );
+
+    CleanExpression* expr = returned(scope.get(), "f()");
+    ASSERT_EQ(expr->type, CleanExpressionType::SignedInt);
+    EXPECT_EQ(static_cast<CleanSignedIntExpression*>(expr)->value, 11);
+
+    expr = returned(scope.get(), "g()");
+    ASSERT_EQ(expr->type, CleanExpressionType::Boolean);
+    EXPECT_EQ(static_cast<CleanBoolExpression*>(expr)->value, true);
+
+    // Unary plus is not lowered, the intrinsic is called instead
+    expr = returned(scope.get(), "main()");
+    ASSERT_EQ(expr->type, CleanExpressionType::SignedInt);
+    EXPECT_EQ(static_cast<CleanSignedIntExpression*>(expr)->value, 5);
+}
+
+TEST_F(FolderTest, foldCastsTest) {
+    std::shared_ptr<CleanScope> scope = fold(
+        "f: function() -> float {\n"
+        "    return (2 + 3):float\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    f()\n"
+        "    return 7:uint:int\n"
+        "}\n"
+    );
+
+    CleanExpression* expr = returned(scope.get(), "f()");
+    ASSERT_EQ(expr->type, CleanExpressionType::Float);
+    EXPECT_EQ(static_cast<CleanFloatExpression*>(expr)->value, 5.0);
+
+    expr = returned(scope.get(), "main()");
+    ASSERT_EQ(expr->type, CleanExpressionType::SignedInt);
+    EXPECT_EQ(static_cast<CleanSignedIntExpression*>(expr)->value, 7);
+}
+
+TEST_F(FolderTest, propagateConstantsTest) {
+    std::shared_ptr<CleanScope> scope = fold(
+        "width: const int = 4\n"
+        "height: int = 3\n"
+        "area: function() -> int {\n"
+        "    return width * height\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    area()\n"
+        "    size: const int = width * 2\n"
+        "    return size + 1\n"
+        "}\n"
+    );
+
+    // Only the const variable is replaced
+    CleanExpression* expr = returned(scope.get(), "area()");
+    ASSERT_EQ(expr->type, CleanExpressionType::Operation);
+    CleanOperationExpression* mul_expr =
+        static_cast<CleanOperationExpression*>(expr);
+    ASSERT_EQ(mul_expr->operands[0]->type, CleanExpressionType::SignedInt);
+    EXPECT_EQ(static_cast<CleanSignedIntExpression*>(mul_expr->operands[0].get())->value, 4);
+    EXPECT_EQ(mul_expr->operands[1]->type, CleanExpressionType::Variable);
+
+    // Constants propagate through the initializers of other constants
+    expr = returned(scope.get(), "main()");
+    ASSERT_EQ(expr->type, CleanExpressionType::SignedInt);
+    EXPECT_EQ(static_cast<CleanSignedIntExpression*>(expr)->value, 9);
+}
+
+TEST_F(FolderTest, keepDivisionByZeroTest) {
+    std::shared_ptr<CleanScope> scope = fold(
+        "main: function() -> int {\n"
+        "    return true ? 1 / 0 else 2\n"
+        "}\n"
+    );
+
+    // The branch taken is kept but the division must fail when the program runs
+    CleanExpression* expr = returned(scope.get(), "main()");
+    ASSERT_EQ(expr->type, CleanExpressionType::Operation);
+    EXPECT_EQ(
+        static_cast<CleanOperationExpression*>(expr)->operation,
+        Operation::DivI64
+    );
+}
+
+TEST_F(FolderTest, keepOverflowingDivisionTest) {
+    std::shared_ptr<CleanScope> scope = fold(
+        "quotient: function() -> int {\n"
+        "    return (0 - 9223372036854775807 - 1) / -1\n"
+        "}\n"
+        "remainder: function() -> int {\n"
+        "    return (0 - 9223372036854775807 - 1) % -1\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    quotient()\n"
+        "    return remainder()\n"
+        "}\n"
+    );
+
+    // The smallest int over -1 overflows so the program must trap on it instead of the compiler
+    CleanExpression* quotient = returned(scope.get(), "quotient()");
+    ASSERT_EQ(quotient->type, CleanExpressionType::Operation);
+    EXPECT_EQ(
+        static_cast<CleanOperationExpression*>(quotient)->operation,
+        Operation::DivI64
+    );
+
+    CleanExpression* remainder = returned(scope.get(), "remainder()");
+    ASSERT_EQ(remainder->type, CleanExpressionType::Operation);
+    EXPECT_EQ(
+        static_cast<CleanOperationExpression*>(remainder)->operation,
+        Operation::RemI64
+    );
+}
+
+TEST_F(FolderTest, keepOverflowingCastsTest) {
+    std::shared_ptr<CleanScope> scope = fold(
+        "negative: function() -> uint {\n"
+        "    return (-2.5):uint\n"
+        "}\n"
+        "huge: function() -> int {\n"
+        "    return (1000000000000.0 * 100000000000.0):int\n"
+        "}\n"
+        "nan: function() -> int {\n"
+        "    return (0.0 / 0.0):int\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    negative()\n"
+        "    huge()\n"
+        "    nan()\n"
+        "    return (-2.5):int\n"
+        "}\n"
+    );
+
+    // Floats the integer type cannot represent are left for the program to convert
+    CleanExpression* expr = returned(scope.get(), "negative()");
+    EXPECT_EQ(expr->type, CleanExpressionType::Call);
+    expr = returned(scope.get(), "huge()");
+    EXPECT_EQ(expr->type, CleanExpressionType::Call);
+    expr = returned(scope.get(), "nan()");
+    EXPECT_EQ(expr->type, CleanExpressionType::Call);
+
+    // Truncation toward zero is fine when the result is in range
+    expr = returned(scope.get(), "main()");
+    ASSERT_EQ(expr->type, CleanExpressionType::SignedInt);
+    EXPECT_EQ(static_cast<CleanSignedIntExpression*>(expr)->value, -2);
+}
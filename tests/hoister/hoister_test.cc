@@ -0,0 +1,207 @@
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <string>
+
+#include "cleaner/ast/expressions/expression.h"
+#include "cleaner/ast/definitions/function.h"
+#include "cleaner/ast/statements/statement.h"
+#include "cleaner/ast/statements/block.h"
+#include "cleaner/ast/statements/for.h"
+#include "interpreter/interpreter.h"
+#include "tests/support/pipeline.h"
+#include "cleaner/symbols/scope.h"
+#include "closure/compiler.h"
+#include "closure/engine.h"
+#include "common/source.h"
+
+
+class HoisterTest: public ::testing::Test
+{
+    protected:
+        void SetUp() override {
+        }
+
+        void TearDown() override {
+        }
+
+        std::shared_ptr<CleanScope> hoist(std::string const& source) {
+            return preparePipeline(source, PipelineStage::Hoist).getScope();
+        }
+
+        CleanBlockStatement* body(CleanScope* scope, std::string const& fun_name) {
+            return scope->getSymbol<CleanFunctionDefinition>(fun_name)->body.get();
+        }
+
+        // Returns the index of the first loop in the block
+        std::size_t findLoop(CleanBlockStatement* block_stmt) {
+            for (std::size_t i = 0; i < block_stmt->statements.size(); ++i) {
+                CleanStatementType type = block_stmt->statements[i]->type;
+                if (type == CleanStatementType::For || type == CleanStatementType::While)
+                    return i;
+            }
+            return block_stmt->statements.size();
+        }
+
+        SourceManager sources;
+};
+
+TEST_F(HoisterTest, hoistInvariantTest) {
+    std::shared_ptr<CleanScope> scope = hoist(
+        "main: function() -> int {\n"
+        "    a: int = 6\n"
+        "    b: int = 7\n"
+        "    total: int = 0\n"
+        "    for (i: int = 0; i < 10; i += 1) {\n"
+        "        total = total + i + a * b\n"
+        "    }\n"
+        "    return total\n"
+        "}\n"
+    );
+
+    // a * b is computed once right before the loop
+    CleanBlockStatement* main_body = body(scope.get(), "main()");
+    std::size_t loop = findLoop(main_body);
+    ASSERT_LT(loop, main_body->statements.size());
+    ASSERT_GT(loop, (std::size_t) 0);
+    CleanStatement* before = main_body->statements[loop - 1].get();
+    ASSERT_EQ(before->type, CleanStatementType::Expression);
+    ASSERT_EQ(static_cast<CleanExpression*>(before)->type, CleanExpressionType::Assignment);
+    CleanAssignmentExpression* assign_expr = static_cast<CleanAssignmentExpression*>(before);
+    EXPECT_EQ(assign_expr->rvalue->type, CleanExpressionType::Operation);
+    EXPECT_EQ(
+        static_cast<CleanVariableExpression*>(assign_expr->lvalue.get())->var_name.rfind("loop@", 0),
+        (std::size_t) 0
+    );
+
+    Interpreter interpreter(scope.get());
+    EXPECT_EQ(interpreter.interpret(), 465);
+}
+
+TEST_F(HoisterTest, keepVariantTest) {
+    std::shared_ptr<CleanScope> scope = hoist(
+        "count: int = 0\n"
+        "bump: function() -> void {\n"
+        "    count = count + 1\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    n: int = 0\n"
+        "    while (n < 5) {\n"
+        "        bump()\n"
+        "        n = n + count * 2\n"
+        "    }\n"
+        "    return n\n"
+        "}\n"
+    );
+
+    // Nothing is invariant: n is assigned and bump writes count
+    CleanBlockStatement* main_body = body(scope.get(), "main()");
+    std::size_t loop = findLoop(main_body);
+    ASSERT_LT(loop, main_body->statements.size());
+    EXPECT_EQ(loop, (std::size_t) 1);
+
+    Interpreter interpreter(scope.get());
+    EXPECT_EQ(interpreter.interpret(), 6);
+}
+
+TEST_F(HoisterTest, keepEffectsTest) {
+    std::shared_ptr<CleanScope> scope = hoist(
+        "main: function() -> int {\n"
+        "    d: int = 0\n"
+        "    n: int = 12\n"
+        "    total: int = 0\n"
+        "    for (i: int = 0; i < d; i += 1) {\n"
+        "        println(n)\n"
+        "        total = total + n / d\n"
+        "    }\n"
+        "    return total\n"
+        "}\n"
+    );
+
+    // Printing stays in the loop and the division by zero is never run
+    CleanBlockStatement* main_body = body(scope.get(), "main()");
+    std::size_t loop = findLoop(main_body);
+    ASSERT_LT(loop, main_body->statements.size());
+    EXPECT_EQ(main_body->statements[loop - 1]->type, CleanStatementType::Expression);
+    CleanExpression* before = static_cast<CleanExpression*>(main_body->statements[loop - 1].get());
+    ASSERT_EQ(before->type, CleanExpressionType::Assignment);
+    EXPECT_EQ(
+        static_cast<CleanVariableExpression*>(
+            static_cast<CleanAssignmentExpression*>(before)->lvalue.get()
+        )->var_name,
+        "total"
+    );
+
+    CleanForStatement* for_stmt = static_cast<CleanForStatement*>(main_body->statements[loop].get());
+    EXPECT_EQ(for_stmt->body->statements.size(), (std::size_t) 2);
+
+    Interpreter interpreter(scope.get());
+    EXPECT_EQ(interpreter.interpret(), 0);
+}
+
+TEST_F(HoisterTest, countedLoopTest) {
+    std::string source =
+        "main: function() -> int {\n"
+        "    n: int = 10\n"
+        "    total: int = 0\n"
+        "    for (i: int = 0; i < n * 2; i += 1) {\n"
+        "        if (i == 3) {\n"
+        "            continue\n"
+        "        }\n"
+        "        if (i == 15) {\n"
+        "            break\n"
+        "        }\n"
+        "        total = total + i\n"
+        "    }\n"
+        "    for (j: int = 9; 0 != j; j -= 3) {\n"
+        "        total = total * 2 + j\n"
+        "    }\n"
+        "    for (k: int = 0; k < total; k = k + 1) {\n"
+        "        total = total - 1\n"
+        "    }\n"
+        "    for (m: int = 0; m < 3; m += 1) {\n"
+        "        m = m + 1\n"
+        "        total = total + m\n"
+        "    }\n"
+        "    println(total)\n"
+        "    return 0\n"
+        "}\n";
+    std::shared_ptr<CleanScope> scope = hoist(source);
+
+    // The first loop counts up to a bound computed once, the second counts
+    // down, the third has a bound the body changes and the last assigns
+    // its counter in the body so it is left alone
+    CleanBlockStatement* main_body = body(scope.get(), "main()");
+    std::vector<CleanForStatement*> loops;
+    for (auto& statement: main_body->statements) {
+        if (statement->type == CleanStatementType::For)
+            loops.push_back(static_cast<CleanForStatement*>(statement.get()));
+    }
+    ASSERT_EQ(loops.size(), (std::size_t) 4);
+
+    EXPECT_TRUE(loops[0]->is_counted);
+    EXPECT_TRUE(loops[0]->is_bound_invariant);
+    EXPECT_EQ(loops[0]->counter_step, 1);
+    EXPECT_EQ(loops[0]->counter_test, Operation::LtI64);
+
+    EXPECT_TRUE(loops[1]->is_counted);
+    EXPECT_TRUE(loops[1]->is_bound_invariant);
+    EXPECT_EQ(loops[1]->counter_step, -3);
+    EXPECT_EQ(loops[1]->counter_test, Operation::NeI64);
+
+    EXPECT_TRUE(loops[2]->is_counted);
+    EXPECT_FALSE(loops[2]->is_bound_invariant);
+
+    EXPECT_FALSE(loops[3]->is_counted);
+
+    testing::internal::CaptureStdout();
+    EXPECT_EQ(Interpreter(scope.get()).interpret(), 0);
+    EXPECT_EQ(testing::internal::GetCapturedStdout(), "437\n");
+
+    std::shared_ptr<CleanScope> closure_scope = hoist(source);
+    ClosureProgram program = ClosureCompiler(closure_scope.get()).compile();
+    testing::internal::CaptureStdout();
+    EXPECT_EQ(ClosureEngine(program).run(), 0);
+    EXPECT_EQ(testing::internal::GetCapturedStdout(), "437\n");
+}
@@ -14,6 +14,7 @@
 #include "inference/inference.h"
 #include "symbols/scope.h"
 #include "parser/parser.h"
+#include "common/source.h"
 #include "lexer/lexer.h"
 
 
@@ -31,18 +32,17 @@ class InferenceTest: public ::testing::Test
     std::unique_ptr<Definition> var_def = nullptr;
     std::unique_ptr<VariableDeclaration> var_decl = nullptr;
     std::unique_ptr<Definition> fun_def = nullptr;
+        SourceManager sources;
 };
 
 TEST_F(InferenceTest, inferTest) {
 }
 
 TEST_F(InferenceTest, inferLiteralTypeTest) {
-    std::shared_ptr<std::string> source = nullptr;
-
     // Booleans literals
     {
         std::string source = "true";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
 
@@ -58,7 +58,7 @@ TEST_F(InferenceTest, inferLiteralTypeTest) {
     // Integer literals
     {
         std::string source = "0";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
 
@@ -74,7 +74,7 @@ TEST_F(InferenceTest, inferLiteralTypeTest) {
     // Float literals
     {
         std::string source = "0.5";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
 
@@ -90,7 +90,7 @@ TEST_F(InferenceTest, inferLiteralTypeTest) {
     // String literals
     {
         std::string source = "\"Hello World!\"";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
 
@@ -105,8 +105,7 @@ TEST_F(InferenceTest, inferLiteralTypeTest) {
 }
 
 TEST_F(InferenceTest, inferCastTypeTest) {
-    std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("1:uint");
+    std::string source = "1:uint";
 
     Lexer lexer(source, source_path);
     Parser parser(lexer);
@@ -125,7 +124,7 @@ TEST_F(InferenceTest, inferVariableTypeTest) {
     // Variable definition
     {
         std::string source = "count: int = 0";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         var_def.reset(nullptr);
         var_def = parser.parseDefinition();
@@ -135,7 +134,7 @@ TEST_F(InferenceTest, inferVariableTypeTest) {
     // Variable declaration
     {
         std::string source = "other: bool";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         var_decl = parser.parseVariableDeclaration();
         scope->addVariableDeclaration("other", var_decl);
@@ -144,7 +143,7 @@ TEST_F(InferenceTest, inferVariableTypeTest) {
     // Variable definition is in scope
     {
         std::string source = "count";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
 
@@ -160,7 +159,7 @@ TEST_F(InferenceTest, inferVariableTypeTest) {
     // Variable definition is not in scope
     {
         std::string source = "name";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
 
@@ -170,7 +169,7 @@ TEST_F(InferenceTest, inferVariableTypeTest) {
     // Variable declaration is in scope
     {
         std::string source = "other";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
 
@@ -185,8 +184,7 @@ TEST_F(InferenceTest, inferVariableTypeTest) {
 }
 
 TEST_F(InferenceTest, inferGroupTypeTest) {
-    std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("(true)");
+    std::string source = "(true)";
 
     Lexer lexer(source, source_path);
     Parser parser(lexer);
@@ -203,8 +201,7 @@ TEST_F(InferenceTest, inferGroupTypeTest) {
 
 TEST_F(InferenceTest, inferCallTypeTest) {
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("sum: function(a:uint, b: uint) -> uint{}");
+        std::string source = "sum: function(a:uint, b: uint) -> uint{}";
         Lexer lexer(source, source_path);
         Parser parser(lexer);
         fun_def = parser.parseDefinition();
@@ -213,8 +210,7 @@ TEST_F(InferenceTest, inferCallTypeTest) {
 
     // Function was found
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("sum(2:uint, 2:uint)");
+        std::string source = "sum(2:uint, 2:uint)";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -231,8 +227,7 @@ TEST_F(InferenceTest, inferCallTypeTest) {
 
     // Function not in scope
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("mul(2, 2)");
+        std::string source = "mul(2, 2)";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -245,8 +240,7 @@ TEST_F(InferenceTest, inferCallTypeTest) {
 TEST_F(InferenceTest, inferUnaryTypeTest) {
     // Unary positive: unsigned int
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("+10:uint");
+        std::string source = "+10:uint";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -263,8 +257,7 @@ TEST_F(InferenceTest, inferUnaryTypeTest) {
 
     // Unary positive: signed int
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("+-10");
+        std::string source = "+-10";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -281,8 +274,7 @@ TEST_F(InferenceTest, inferUnaryTypeTest) {
 
     // Unary positive: float
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("+0.5");
+        std::string source = "+0.5";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -299,8 +291,7 @@ TEST_F(InferenceTest, inferUnaryTypeTest) {
 
     // Unary negative: unsigned int
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("-10:uint");
+        std::string source = "-10:uint";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -317,8 +308,7 @@ TEST_F(InferenceTest, inferUnaryTypeTest) {
 
     // Unary negative: signed int
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("--10");
+        std::string source = "--10";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -335,8 +325,7 @@ TEST_F(InferenceTest, inferUnaryTypeTest) {
 
     // Unary negative: float
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("-0.5");
+        std::string source = "-0.5";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -353,8 +342,7 @@ TEST_F(InferenceTest, inferUnaryTypeTest) {
 
     // Bitwise not: unsigned int
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("~10:uint");
+        std::string source = "~10:uint";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -371,8 +359,7 @@ TEST_F(InferenceTest, inferUnaryTypeTest) {
 
     // Bitwise not: signed int
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("~(-10)");
+        std::string source = "~(-10)";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -389,8 +376,7 @@ TEST_F(InferenceTest, inferUnaryTypeTest) {
 
     // Logical not: bool
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("!true");
+        std::string source = "!true";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -407,8 +393,7 @@ TEST_F(InferenceTest, inferUnaryTypeTest) {
 
     // Wrong type applied to logical not
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("!0");
+        std::string source = "!0";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -421,8 +406,7 @@ TEST_F(InferenceTest, inferUnaryTypeTest) {
 TEST_F(InferenceTest, inferBinaryTypeTest) {
     // Addition
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("1:uint + 2:uint");
+        std::string source = "1:uint + 2:uint";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -439,8 +423,7 @@ TEST_F(InferenceTest, inferBinaryTypeTest) {
 
     // Substraction
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("1 - 2");
+        std::string source = "1 - 2";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -457,8 +440,7 @@ TEST_F(InferenceTest, inferBinaryTypeTest) {
 
     // Multiplication
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("1:uint * 2:uint");
+        std::string source = "1:uint * 2:uint";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -473,8 +455,7 @@ TEST_F(InferenceTest, inferBinaryTypeTest) {
         EXPECT_EQ(type_decl.getTypeName(), "uint");
     }
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("-1 * -2");
+        std::string source = "-1 * -2";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -489,8 +470,7 @@ TEST_F(InferenceTest, inferBinaryTypeTest) {
         EXPECT_EQ(type_decl.getTypeName(), "int");
     }
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("1.0 * 2.0");
+        std::string source = "1.0 * 2.0";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -507,8 +487,7 @@ TEST_F(InferenceTest, inferBinaryTypeTest) {
 
     // Division
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("1:uint / 2:uint");
+        std::string source = "1:uint / 2:uint";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -523,8 +502,7 @@ TEST_F(InferenceTest, inferBinaryTypeTest) {
         EXPECT_EQ(type_decl.getTypeName(), "uint");
     }
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("-1 / -2");
+        std::string source = "-1 / -2";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -539,8 +517,7 @@ TEST_F(InferenceTest, inferBinaryTypeTest) {
         EXPECT_EQ(type_decl.getTypeName(), "int");
     }
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("1.0 / 2.0");
+        std::string source = "1.0 / 2.0";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -557,8 +534,7 @@ TEST_F(InferenceTest, inferBinaryTypeTest) {
 
     // Remainder
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("1:uint % 2:uint");
+        std::string source = "1:uint % 2:uint";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -573,8 +549,7 @@ TEST_F(InferenceTest, inferBinaryTypeTest) {
         EXPECT_EQ(type_decl.getTypeName(), "uint");
     }
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("-1 % -2");
+        std::string source = "-1 % -2";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -589,8 +564,7 @@ TEST_F(InferenceTest, inferBinaryTypeTest) {
         EXPECT_EQ(type_decl.getTypeName(), "int");
     }
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("1.0 % 2.0");
+        std::string source = "1.0 % 2.0";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -607,8 +581,7 @@ TEST_F(InferenceTest, inferBinaryTypeTest) {
 
     // Power
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("1:uint ** 2:uint");
+        std::string source = "1:uint ** 2:uint";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -623,8 +596,7 @@ TEST_F(InferenceTest, inferBinaryTypeTest) {
         EXPECT_EQ(type_decl.getTypeName(), "uint");
     }
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("-1 ** -2");
+        std::string source = "-1 ** -2";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -639,8 +611,7 @@ TEST_F(InferenceTest, inferBinaryTypeTest) {
         EXPECT_EQ(type_decl.getTypeName(), "float");
     }
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("1.0 ** 2.0");
+        std::string source = "1.0 ** 2.0";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -657,8 +628,7 @@ TEST_F(InferenceTest, inferBinaryTypeTest) {
 
     // Bitwise and
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("1:uint & 2:uint");
+        std::string source = "1:uint & 2:uint";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -673,8 +643,7 @@ TEST_F(InferenceTest, inferBinaryTypeTest) {
         EXPECT_EQ(type_decl.getTypeName(), "uint");
     }
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("-1 & -2");
+        std::string source = "-1 & -2";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -691,8 +660,7 @@ TEST_F(InferenceTest, inferBinaryTypeTest) {
 
     // Bitwise or
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("1:uint | 2:uint");
+        std::string source = "1:uint | 2:uint";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -707,8 +675,7 @@ TEST_F(InferenceTest, inferBinaryTypeTest) {
         EXPECT_EQ(type_decl.getTypeName(), "uint");
     }
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("-1 | -2");
+        std::string source = "-1 | -2";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -725,8 +692,7 @@ TEST_F(InferenceTest, inferBinaryTypeTest) {
 
     // Bitwise xor
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("1:uint ^ 2:uint");
+        std::string source = "1:uint ^ 2:uint";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -741,8 +707,7 @@ TEST_F(InferenceTest, inferBinaryTypeTest) {
         EXPECT_EQ(type_decl.getTypeName(), "uint");
     }
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("-1 ^ -2");
+        std::string source = "-1 ^ -2";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -759,8 +724,7 @@ TEST_F(InferenceTest, inferBinaryTypeTest) {
 
     // Left shift
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("1:uint << 2:uint");
+        std::string source = "1:uint << 2:uint";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -775,8 +739,7 @@ TEST_F(InferenceTest, inferBinaryTypeTest) {
         EXPECT_EQ(type_decl.getTypeName(), "uint");
     }
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("-1 << 2:uint");
+        std::string source = "-1 << 2:uint";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -793,8 +756,7 @@ TEST_F(InferenceTest, inferBinaryTypeTest) {
 
     // Right shift
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("1:uint >> 2:uint");
+        std::string source = "1:uint >> 2:uint";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -809,8 +771,7 @@ TEST_F(InferenceTest, inferBinaryTypeTest) {
         EXPECT_EQ(type_decl.getTypeName(), "uint");
     }
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("-1 >> 2:uint");
+        std::string source = "-1 >> 2:uint";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -827,8 +788,7 @@ TEST_F(InferenceTest, inferBinaryTypeTest) {
 
     // Logical and
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("true && false");
+        std::string source = "true && false";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -845,8 +805,7 @@ TEST_F(InferenceTest, inferBinaryTypeTest) {
 
     // Logical Or
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("true || false");
+        std::string source = "true || false";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -863,8 +822,7 @@ TEST_F(InferenceTest, inferBinaryTypeTest) {
 
     // Equal
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("true == true");
+        std::string source = "true == true";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -881,8 +839,7 @@ TEST_F(InferenceTest, inferBinaryTypeTest) {
 
     // Not Equal
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("0 != 1");
+        std::string source = "0 != 1";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -899,8 +856,7 @@ TEST_F(InferenceTest, inferBinaryTypeTest) {
 
     // Greater than
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("2.0 > 1.0");
+        std::string source = "2.0 > 1.0";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -917,8 +873,7 @@ TEST_F(InferenceTest, inferBinaryTypeTest) {
 
     // Greater or equal
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("2.0 > 2.0");
+        std::string source = "2.0 > 2.0";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -935,8 +890,7 @@ TEST_F(InferenceTest, inferBinaryTypeTest) {
 
     // Less than
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("1 < 2");
+        std::string source = "1 < 2";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -953,8 +907,7 @@ TEST_F(InferenceTest, inferBinaryTypeTest) {
 
     // Less or equal
     {
-        std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("-2 <= -1");
+        std::string source = "-2 <= -1";
 
         Lexer lexer(source, source_path);
         Parser parser(lexer);
@@ -971,8 +924,7 @@ TEST_F(InferenceTest, inferBinaryTypeTest) {
 }
 
 TEST_F(InferenceTest, inferTernaryIfTypeTest) {
-    std::shared_ptr<std::string> source =
-        std::make_shared<std::string>("b == true ? 1 <> -1");
+    std::string source = "b == true ? 1 <> -1";
 
     Lexer lexer(source, source_path);
     Parser parser(lexer);
@@ -990,7 +942,7 @@ TEST_F(InferenceTest, inferTernaryIfTypeTest) {
 TEST_F(InferenceTest, inferAssignmentTypeTest) {
     {
         std::string source = "new_count: int = 0";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         var_def.reset(nullptr);
         var_def = parser.parseDefinition();
@@ -1000,7 +952,7 @@ TEST_F(InferenceTest, inferAssignmentTypeTest) {
     // Simple assignment
     {
         std::string source = "new_count = 1";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
 
@@ -1016,7 +968,7 @@ TEST_F(InferenceTest, inferAssignmentTypeTest) {
     // Correct in-place assignment
     {
         std::string source = "new_count += 1";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
 
@@ -1032,7 +984,7 @@ TEST_F(InferenceTest, inferAssignmentTypeTest) {
     // Incorrect in-place assignment
     {
         std::string source = "new_count += true";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
         EXPECT_THROW(Inference(expr.get(), scope).inferAssignmentType(), InferenceError);
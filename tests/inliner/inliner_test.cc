@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <string>
+
+#include "cleaner/ast/definitions/function.h"
+#include "cleaner/ast/statements/block.h"
+#include "interpreter/interpreter.h"
+#include "tests/support/pipeline.h"
+#include "cleaner/symbols/scope.h"
+#include "common/source.h"
+
+
+class InlinerTest: public ::testing::Test
+{
+    protected:
+        void SetUp() override {
+        }
+
+        void TearDown() override {
+        }
+
+        std::shared_ptr<CleanScope> inlineCalls(
+            std::string const& source,
+            std::size_t threshold = Pipeline::default_inline_threshold
+        ) {
+            Pipeline pipeline = preparePipeline(source, PipelineStage::Link, threshold);
+            report = pipeline.getInlineReport();
+            return pipeline.getScope();
+        }
+
+        CleanBlockStatement* body(CleanScope* scope, std::string const& fun_name) {
+            return scope->getSymbol<CleanFunctionDefinition>(fun_name)->body.get();
+        }
+
+        std::vector<std::string> report;
+        SourceManager sources;
+};
+
+TEST_F(InlinerTest, inlineSmallFunctionTest) {
+    std::shared_ptr<CleanScope> scope = inlineCalls(
+        "square: function(n: int) -> int {\n"
+        "    return n * n\n"
+        "}\n"
+        "show: function(n: int) -> void {\n"
+        "    m: int = square(n)\n"
+        "    println(m)\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    n: int = square(3)\n"
+        "    show(n)\n"
+        "    return square(n) - 20\n"
+        "}\n"
+    );
+
+    // The callee is inlined into show before show is inlined into main
+    // Calls nested in a larger expression are left alone
+    ASSERT_EQ(report.size(), 3);
+    EXPECT_EQ(report[0], "show(int): inlined square(int) (size 5)");
+    EXPECT_EQ(report[1], "main(): inlined square(int) (size 5)");
+    EXPECT_EQ(report[2].rfind("main(): inlined show(int)", 0), 0);
+
+    CleanBlockStatement* main_body = body(scope.get(), "main()");
+    ASSERT_EQ(main_body->statements.size(), 3);
+    EXPECT_EQ(main_body->statements[0]->type, CleanStatementType::Block);
+    EXPECT_EQ(main_body->statements[1]->type, CleanStatementType::Block);
+
+    // Locals of the callees do not clash with the variable n of main
+    testing::internal::CaptureStdout();
+    int result = Interpreter(scope.get()).interpret();
+    EXPECT_EQ(testing::internal::GetCapturedStdout(), "81\n");
+    EXPECT_EQ(result, 61);
+}
+
+TEST_F(InlinerTest, keepCallsTest) {
+    std::shared_ptr<CleanScope> scope = inlineCalls(
+        "g: int = 2\n"
+        "fact: function(n: int) -> int {\n"
+        "    return n < 2 ? 1 else n * fact(n - 1)\n"
+        "}\n"
+        "sign: function(n: int) -> int {\n"
+        "    if (n < 0) {\n"
+        "        return -1\n"
+        "    }\n"
+        "    return 1\n"
+        "}\n"
+        "twice: function(n: int) -> int {\n"
+        "    return n * g\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    g: int = fact(4)\n"
+        "    g = twice(g)\n"
+        "    return g + sign(-5)\n"
+        "}\n"
+    );
+
+    // Recursive functions, early returns and hidden globals prevent inlining
+    EXPECT_EQ(report.size(), 0);
+    EXPECT_EQ(Interpreter(scope.get()).interpret(), 47);
+}
+
+TEST_F(InlinerTest, thresholdTest) {
+    std::string source =
+        "add: function(a: int, b: int) -> int {\n"
+        "    return a + b\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    return add(1, 2)\n"
+        "}\n";
+
+    inlineCalls(source, 0);
+    EXPECT_EQ(report.size(), 0);
+
+    inlineCalls(source, 4);
+    EXPECT_EQ(report.size(), 0);
+
+    std::shared_ptr<CleanScope> scope = inlineCalls(source, 5);
+    ASSERT_EQ(report.size(), 1);
+    EXPECT_EQ(Interpreter(scope.get()).interpret(), 3);
+}
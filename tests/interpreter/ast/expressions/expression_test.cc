@@ -8,10 +8,14 @@
 #include "cleaner/ast/expressions/expression.h"
 #include "interpreter/interpreter.h"
 #include "cleaner/symbols/scope.h"
+#include "resolver/resolver.h"
+#include "resolver/linker.h"
 #include "parsetree/program.h"
 #include "cleaner/cleaner.h"
 #include "checker/checker.h"
 #include "parser/parser.h"
+#include "common/source.h"
+#include "common/value.h"
 #include "lexer/lexer.h"
 
 
@@ -26,92 +30,85 @@ class ExpressionInterpreterTest: public ::testing::Test
 
         std::string source_path = "main.pro";
         std::shared_ptr<CleanScope> clean_scope = std::make_shared<CleanScope>(nullptr);
+        CallStack stack = CallStack(16, 16);
+        Frame frame = Frame(&stack, 0, nullptr);
+        SourceManager sources;
 };
 
 TEST_F(ExpressionInterpreterTest, interpretLiteralTest) {
     // Boolean
     {
         std::string source = "true";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
         std::unique_ptr<CleanExpression> clean_expr =
             ExpressionCleaner(clean_scope).clean(expr.get());
-        std::unique_ptr<CleanExpression> i_clean_expr =
-            ExpressionInterpreter(clean_scope.get()).interpret(clean_expr.get());
+        Value i_value =
+            ExpressionInterpreter(clean_scope.get(), &frame).interpret(clean_expr.get());
 
-        EXPECT_EQ(i_clean_expr->type, CleanExpressionType::Boolean);
-        CleanBoolExpression* bool_expr =
-            static_cast<CleanBoolExpression*>(i_clean_expr.get());
-        EXPECT_EQ(bool_expr->value, true);
+        EXPECT_EQ(i_value.type, ValueType::Boolean);
+        EXPECT_EQ(i_value.as_bool, true);
     }
 
     // Unsigned int
     {
         std::string source = "10";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
         std::unique_ptr<CleanExpression> clean_expr =
             ExpressionCleaner(clean_scope).clean(expr.get());
-        std::unique_ptr<CleanExpression> i_clean_expr =
-            ExpressionInterpreter(clean_scope.get()).interpret(clean_expr.get());
+        Value i_value =
+            ExpressionInterpreter(clean_scope.get(), &frame).interpret(clean_expr.get());
 
-        EXPECT_EQ(i_clean_expr->type, CleanExpressionType::SignedInt);
-        CleanSignedIntExpression* int_expr =
-            static_cast<CleanSignedIntExpression*>(i_clean_expr.get());
-        EXPECT_EQ(int_expr->value, (int64_t) 10);
+        EXPECT_EQ(i_value.type, ValueType::SignedInt);
+        EXPECT_EQ(i_value.as_int, (int64_t) 10);
     }
 
     // Signed int
     {
         std::string source = "-10";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
         std::unique_ptr<CleanExpression> clean_expr =
             ExpressionCleaner(clean_scope).clean(expr.get());
-        std::unique_ptr<CleanExpression> i_clean_expr =
-            ExpressionInterpreter(clean_scope.get()).interpret(clean_expr.get());
+        Value i_value =
+            ExpressionInterpreter(clean_scope.get(), &frame).interpret(clean_expr.get());
 
-        EXPECT_EQ(i_clean_expr->type, CleanExpressionType::SignedInt);
-        CleanSignedIntExpression* int_expr =
-            static_cast<CleanSignedIntExpression*>(i_clean_expr.get());
-        EXPECT_EQ(int_expr->value, (int64_t) -10);
+        EXPECT_EQ(i_value.type, ValueType::SignedInt);
+        EXPECT_EQ(i_value.as_int, (int64_t) -10);
     }
 
     // Float
     {
         std::string source = "1.0";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
         std::unique_ptr<CleanExpression> clean_expr =
             ExpressionCleaner(clean_scope).clean(expr.get());
-        std::unique_ptr<CleanExpression> i_clean_expr =
-            ExpressionInterpreter(clean_scope.get()).interpret(clean_expr.get());
+        Value i_value =
+            ExpressionInterpreter(clean_scope.get(), &frame).interpret(clean_expr.get());
 
-        EXPECT_EQ(i_clean_expr->type, CleanExpressionType::Float);
-        CleanFloatExpression* float_expr =
-            static_cast<CleanFloatExpression*>(i_clean_expr.get());
-        EXPECT_EQ(float_expr->value, (double) 1.0);
+        EXPECT_EQ(i_value.type, ValueType::Float);
+        EXPECT_EQ(i_value.as_float, (double) 1.0);
     }
 
     // String
     {
         std::string source = "\"Hello World!\"";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseExpression();
         std::unique_ptr<CleanExpression> clean_expr =
             ExpressionCleaner(clean_scope).clean(expr.get());
-        std::unique_ptr<CleanExpression> i_clean_expr =
-            ExpressionInterpreter(clean_scope.get()).interpret(clean_expr.get());
+        Value i_value =
+            ExpressionInterpreter(clean_scope.get(), &frame).interpret(clean_expr.get());
 
-        EXPECT_EQ(i_clean_expr->type, CleanExpressionType::String);
-        CleanStringExpression* string_expr =
-            static_cast<CleanStringExpression*>(i_clean_expr.get());
-        EXPECT_EQ(string_expr->value, "Hello World!");
+        EXPECT_EQ(i_value.type, ValueType::String);
+        EXPECT_EQ(*i_value.as_string, "Hello World!");
     }
 }
 
@@ -123,12 +120,14 @@ TEST_F(ExpressionInterpreterTest, interpretCallTest) {
         "main: function()->int{\n"
         "   return twelve()\n"
         "}\n";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Parser parser(lexer);
     Program program = parser.parseProgram();
     Checker checker(program);
     checker.check();
     Cleaner cleaner(program);
     clean_scope = cleaner.clean();
+    Resolver(clean_scope.get()).resolve();
+    Linker(clean_scope.get()).link();
     EXPECT_EQ(Interpreter(clean_scope.get()).interpret(), 12);
 }
@@ -10,6 +10,8 @@
 #include "cleaner/ast/statements/statement.h"
 #include "interpreter/interpreter.h"
 #include "cleaner/symbols/scope.h"
+#include "common/source.h"
+#include "common/value.h"
 #include "cleaner/cleaner.h"
 #include "checker/checker.h"
 #include "parser/parser.h"
@@ -27,26 +29,24 @@ class StatementInterpreterTest: public ::testing::Test
 
         std::string source_path = "main.pro";
         std::shared_ptr<CleanScope> clean_scope = std::make_shared<CleanScope>(nullptr);
+        CallStack stack = CallStack(16, 16);
+        Frame frame = Frame(&stack, 0, nullptr);
+        SourceManager sources;
 };
 
 TEST_F(StatementInterpreterTest, interpretReturnTest) {
     std::string source = "return 1";
 
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Parser parser(lexer);
     std::unique_ptr<Statement> stmt = parser.parseStatement();
     std::unique_ptr<CleanStatement> clean_stmt =
         StatementCleaner().clean(stmt.get(), clean_scope);
-    std::unique_ptr<CleanStatement> i_clean_stmt =
-        StatementInterpreter().interpret(
+    Value i_value =
+        StatementInterpreter(&frame).interpret(
             clean_stmt.get(), clean_scope.get()
         );
     
-    EXPECT_EQ(i_clean_stmt->type, CleanStatementType::Expression);
-    CleanExpression* i_clean_expr =
-        static_cast<CleanExpression*>(i_clean_stmt.get());
-    EXPECT_EQ(i_clean_expr->type, CleanExpressionType::SignedInt);
-    CleanSignedIntExpression* int_expr =
-        static_cast<CleanSignedIntExpression*>(i_clean_expr);
-    EXPECT_EQ(int_expr->value, (int64_t) 1);
+    EXPECT_EQ(i_value.type, ValueType::SignedInt);
+    EXPECT_EQ(i_value.as_int, (int64_t) 1);
 }
@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <cstddef>
+
+#include "interpreter/frame.h"
+#include "common/value.h"
+
+
+TEST(CallStackTest, growTest) {
+    CallStack stack(4, 64);
+    Value* first = stack.push(3);
+    first[0] = Value((int64_t) 1);
+
+    // Slots that do not fit go to a new segment and the ones below stay put
+    Value* second = stack.push(3);
+    second[0] = Value((int64_t) 2);
+    Value* large = stack.push(10);
+    EXPECT_EQ(stack.segments.size(), (std::size_t) 3);
+    EXPECT_EQ(stack.segments[2].size(), (std::size_t) 10);
+    EXPECT_EQ(first[0].as_int, 1);
+    EXPECT_EQ(second[0].as_int, 2);
+
+    // Popping goes back down the segments and pushing again reuses them
+    stack.pop(10);
+    stack.pop(3);
+    EXPECT_EQ(stack.current, (std::size_t) 0);
+    EXPECT_EQ(stack.top, (std::size_t) 3);
+    EXPECT_EQ(stack.push(3), second);
+    EXPECT_EQ(stack.push(10), large);
+}
+
+TEST(CallStackTest, overflowTest) {
+    CallStack stack(4, 8);
+    stack.push(4);
+    stack.push(4);
+    EXPECT_THROW(stack.push(1), std::runtime_error);
+}
+
+TEST(CallStackTest, reuseTest) {
+    CallStack stack(4, 64);
+    Frame frame(&stack, 3, nullptr);
+
+    // The arguments of the tail call land in the next segment
+    Value* arguments = stack.push(2);
+    arguments[0] = Value((int64_t) 7);
+    arguments[1] = Value((int64_t) 8);
+    frame.reuse(4, 2);
+    EXPECT_EQ(frame.slots, stack.segments[0].data());
+    EXPECT_EQ(frame.slots[0].as_int, 7);
+    EXPECT_EQ(frame.slots[1].as_int, 8);
+
+    // A callee too large for the segments so far gets its own
+    // and the arguments are read before anything overwrites them
+    arguments = stack.push(2);
+    arguments[0] = Value((int64_t) 9);
+    arguments[1] = Value((int64_t) 10);
+    frame.reuse(6, 2);
+    EXPECT_EQ(frame.size, (std::size_t) 6);
+    EXPECT_EQ(frame.slots[0].as_int, 9);
+    EXPECT_EQ(frame.slots[1].as_int, 10);
+}
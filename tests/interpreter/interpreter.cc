@@ -1,15 +1,39 @@
 #include <gtest/gtest.h>
 #include <memory>
+#include <vector>
 #include <string>
 
+#include "intrinsics/reslib/resint.h"
+#include "cleaner/ast/definitions/function.h"
 #include "interpreter/interpreter.h"
 #include "cleaner/symbols/scope.h"
+#include "interpreter/tiering.h"
+#include "resolver/resolver.h"
+#include "resolver/linker.h"
 #include "cleaner/cleaner.h"
 #include "checker/checker.h"
 #include "parser/parser.h"
+#include "common/source.h"
 #include "lexer/lexer.h"
 
 
+/* Remembers the functions that got hot instead of compiling them. */
+class RecordingTiering: public Tiering
+{
+    public:
+        RecordingTiering(
+            std::size_t threshold
+        ) : Tiering(threshold)
+        {}
+
+        std::vector<std::string> promoted;
+
+    protected:
+        void promote(CleanFunctionDefinition* fun_def) override {
+            promoted.push_back(fun_def->name);
+        }
+};
+
 class InterpreterTest: public ::testing::Test
 {
     protected:
@@ -20,6 +44,7 @@ class InterpreterTest: public ::testing::Test
         }
 
         std::string source_path = "main.pro";
+        SourceManager sources;
 };
 
 TEST_F(InterpreterTest, interpretTest) {
@@ -28,12 +53,81 @@ TEST_F(InterpreterTest, interpretTest) {
         "    return 12\n"
         "}\n";
 
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Parser parser(lexer);
     Program prog = parser.parseProgram();
     Checker(prog).check();
     Cleaner cleaner(prog);
     std::shared_ptr<CleanScope> scope = cleaner.clean();
+    Resolver(scope.get()).resolve();
+    Linker(scope.get()).link();
     Interpreter interpreter(scope.get());
     EXPECT_EQ(interpreter.interpret(), 12);
 }
+
+TEST_F(InterpreterTest, interpretRecursionTest) {
+    // Each invocation must keep its own parameters and locals
+    // across the recursive calls it makes
+    std::string source =
+        "sum: function(n: int) -> int {\n"
+        "    local: int = n * 10\n"
+        "    if (n == 0) {\n"
+        "        return 0\n"
+        "    }\n"
+        "    rest: int = sum(n - 1)\n"
+        "    return local + n + rest\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    return sum(4)\n"
+        "}\n";
+
+    Lexer lexer(source, source_path);
+    Parser parser(lexer);
+    Program prog = parser.parseProgram();
+    Checker(prog).check();
+    Cleaner cleaner(prog);
+    std::shared_ptr<CleanScope> scope = cleaner.clean();
+    Resolver(scope.get()).resolve();
+    Resint().load(scope.get());
+    Linker(scope.get()).link();
+    Interpreter interpreter(scope.get());
+    EXPECT_EQ(interpreter.interpret(), 110);
+}
+
+TEST_F(InterpreterTest, interpretTieringTest) {
+    // Calls and loop iterations both count, a function is promoted once
+    std::string source =
+        "twice: function(n: int) -> int {\n"
+        "    return n + n\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    total: int = 0\n"
+        "    for (i: int = 0; i < 5; i += 1) {\n"
+        "        total = total + twice(i)\n"
+        "    }\n"
+        "    return total\n"
+        "}\n";
+
+    Lexer lexer(source, source_path);
+    Parser parser(lexer);
+    Program prog = parser.parseProgram();
+    Checker(prog).check();
+    Cleaner cleaner(prog);
+    std::shared_ptr<CleanScope> scope = cleaner.clean();
+    Resolver(scope.get()).resolve();
+    Resint().load(scope.get());
+    Linker(scope.get()).link();
+    RecordingTiering tiering(3);
+    Interpreter interpreter(scope.get(), &tiering);
+    EXPECT_EQ(interpreter.interpret(), 20);
+
+    CleanFunctionDefinition* twice =
+        scope->getSymbol<CleanFunctionDefinition>("twice(int)").get();
+    CleanFunctionDefinition* main_fun =
+        scope->getSymbol<CleanFunctionDefinition>("main()").get();
+    EXPECT_EQ(twice->invocations, 5);
+    EXPECT_EQ(twice->back_edges, 0);
+    EXPECT_EQ(main_fun->invocations, 1);
+    EXPECT_EQ(main_fun->back_edges, 5);
+    EXPECT_EQ(tiering.promoted, std::vector<std::string>({"main()", "twice(int)"}));
+}
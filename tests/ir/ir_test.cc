@@ -0,0 +1,235 @@
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "tests/support/pipeline.h"
+#include "cleaner/symbols/scope.h"
+#include "common/source.h"
+#include "ir/allocator.h"
+#include "ir/builder.h"
+#include "ir/ir.h"
+
+
+class IRTest: public ::testing::Test
+{
+    protected:
+        void SetUp() override {
+        }
+
+        void TearDown() override {
+        }
+
+        IRModule build(std::string const& source, bool optimize) {
+            // Calls are not inlined so the tests can count what each function does
+            Pipeline pipeline = preparePipeline(source, PipelineStage::Hoist, 0);
+            scope = pipeline.getScope();
+            if (optimize)
+                return pipeline.buildModule();
+            return IRBuilder(scope.get()).build();
+        }
+
+        IRFunction* function(IRModule& module, std::string const& name) {
+            for (auto& function: module.functions) {
+                if (function->name == name)
+                    return function.get();
+            }
+            return nullptr;
+        }
+
+        // Returns how many instructions of the function have the given opcode
+        std::size_t count(IRFunction* function, enum IROpcode opcode) {
+            std::size_t total = 0;
+            for (auto& block: function->blocks) {
+                for (auto& instr: block->instructions)
+                    total += instr->opcode == opcode;
+            }
+            return total;
+        }
+
+        std::shared_ptr<CleanScope> scope;
+        SourceManager sources;
+};
+
+TEST_F(IRTest, phiTest) {
+    IRModule module = build(
+        "sum: function(n: int) -> int {\n"
+        "    total: int = 0\n"
+        "    for (i: int = 0; i < n; i += 1) {\n"
+        "        total = total + i\n"
+        "    }\n"
+        "    return total\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    return sum(10)\n"
+        "}\n",
+        false
+    );
+
+    // The loop header merges total and i coming from the entry and from the loop
+    IRFunction* sum = function(module, "sum(int)");
+    ASSERT_NE(sum, nullptr);
+    EXPECT_EQ(count(sum, IROpcode::Phi), (std::size_t) 2);
+    EXPECT_EQ(count(sum, IROpcode::Param), (std::size_t) 1);
+    for (auto& block: sum->blocks) {
+        for (auto& instr: block->instructions) {
+            if (instr->opcode != IROpcode::Phi)
+                continue;
+            EXPECT_EQ(instr->type, ValueType::SignedInt);
+            EXPECT_EQ(instr->operands.size(), block->predecessors.size());
+        }
+    }
+
+    std::string printed = printModule(module);
+    EXPECT_NE(printed.find("function sum(int) {"), std::string::npos);
+    EXPECT_NE(printed.find("PHI int"), std::string::npos);
+}
+
+TEST_F(IRTest, optimizeTest) {
+    IRModule module = build(
+        "scale: function(a: int, b: int) -> int {\n"
+        "    unused: int = a - b\n"
+        "    x: int = a * b + 0\n"
+        "    y: int = b * a\n"
+        "    return x + y + 2 * 3\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    return scale(2, 3)\n"
+        "}\n",
+        true
+    );
+
+    // 2 * 3 is folded, + 0 dropped, b * a shares a * b and a - b is removed
+    IRFunction* scale = function(module, "scale(int,int)");
+    ASSERT_NE(scale, nullptr);
+    EXPECT_EQ(count(scale, IROpcode::Operation), (std::size_t) 3);
+    EXPECT_EQ(count(scale, IROpcode::Copy), (std::size_t) 0);
+    EXPECT_EQ(count(scale, IROpcode::Const), (std::size_t) 1);
+    EXPECT_EQ(printModule(module).find("SUB_I64"), std::string::npos);
+}
+
+TEST_F(IRTest, branchTest) {
+    IRModule module = build(
+        "counter: int = 0\n"
+        "pick: function(n: int) -> int {\n"
+        "    if (1 < 2) {\n"
+        "        counter = n\n"
+        "    }\n"
+        "    else {\n"
+        "        counter = n / 0\n"
+        "    }\n"
+        "    return counter\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    return pick(4)\n"
+        "}\n",
+        true
+    );
+
+    // The condition is known so the else branch and its division disappear,
+    // the store to the global stays
+    IRFunction* pick = function(module, "pick(int)");
+    ASSERT_NE(pick, nullptr);
+    EXPECT_EQ(count(pick, IROpcode::Branch), (std::size_t) 0);
+    EXPECT_EQ(count(pick, IROpcode::Operation), (std::size_t) 0);
+    EXPECT_EQ(count(pick, IROpcode::StoreGlobal), (std::size_t) 1);
+}
+
+TEST_F(IRTest, overflowingDivisionTest) {
+    IRModule module = build(
+        "quotient: function(a: int) -> int {\n"
+        "    n: int = -1\n"
+        "    unused: int = a / n\n"
+        "    m: int = 0 - 9223372036854775807\n"
+        "    m = m - 1\n"
+        "    return m / n\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    return quotient(4)\n"
+        "}\n",
+        true
+    );
+
+    // The smallest int over -1 traps like a zero divisor so neither division
+    // is folded or removed, even though one of them is never read
+    IRFunction* quotient = function(module, "quotient(int)");
+    ASSERT_NE(quotient, nullptr);
+
+    std::size_t divisions = 0;
+    for (auto& block: quotient->blocks) {
+        for (auto& instr: block->instructions)
+            divisions += instr->opcode == IROpcode::Operation && instr->operation == Operation::DivI64;
+    }
+    EXPECT_EQ(divisions, (std::size_t) 2);
+}
+
+TEST_F(IRTest, strengthReductionTest) {
+    IRModule module = build(
+        "scaled: function(n: int, k: int) -> int {\n"
+        "    total: int = 0\n"
+        "    for (i: int = n; i > 0; i -= 2) {\n"
+        "        total = total + i * k + k * i\n"
+        "    }\n"
+        "    return total\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    return scaled(10, 3)\n"
+        "}\n",
+        true
+    );
+
+    // Both products are the same variable, started at n * k and stepped
+    // by -2 * k inside the loop, both products being computed before it
+    IRFunction* scaled = function(module, "scaled(int,int)");
+    ASSERT_NE(scaled, nullptr);
+    EXPECT_EQ(count(scaled, IROpcode::Phi), (std::size_t) 3);
+
+    std::size_t products = 0;
+    for (auto& block: scaled->blocks) {
+        for (auto& instr: block->instructions) {
+            if (instr->opcode != IROpcode::Operation || instr->operation != Operation::MulI64)
+                continue;
+            products++;
+            EXPECT_EQ(instr->block, scaled->blocks.front().get());
+        }
+    }
+    EXPECT_EQ(products, (std::size_t) 2);
+}
+
+TEST_F(IRTest, registerLimitTest) {
+    IRModule module = build(
+        "spread: function(a: int, b: int, c: int) -> int {\n"
+        "    for (i: int = 0; i < 8; i += 1) {\n"
+        "        a = a + b\n"
+        "        b = b + c\n"
+        "        c = c + a\n"
+        "    }\n"
+        "    return a + b + c\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    return spread(1, 2, 3)\n"
+        "}\n",
+        true
+    );
+
+    // Four values live around the loop do not fit in two registers,
+    // constants are left out and every other value is in exactly one place
+    IRFunction* spread = function(module, "spread(int,int,int)");
+    ASSERT_NE(spread, nullptr);
+    splitCriticalEdges(*spread);
+    RegisterAllocation allocation = RegisterAllocator(*spread, 2).allocate();
+    EXPECT_LE(allocation.register_count, (std::size_t) 2);
+    EXPECT_GT(allocation.spill_count, (std::size_t) 0);
+    for (auto& block: spread->blocks) {
+        for (auto& instr: block->instructions) {
+            std::size_t places = allocation.registers.count(instr.get()) +
+                allocation.spills.count(instr.get());
+            if (instr->opcode == IROpcode::Const) {
+                EXPECT_EQ(places, (std::size_t) 0);
+            }
+            else if (instr->opcode == IROpcode::Phi || instr->opcode == IROpcode::Param) {
+                EXPECT_EQ(places, (std::size_t) 1);
+            }
+        }
+    }
+}
@@ -0,0 +1,283 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <string>
+
+#include "cleaner/ast/definitions/function.h"
+#include "interpreter/interpreter.h"
+#include "tests/support/pipeline.h"
+#include "cleaner/symbols/scope.h"
+#include "jit/assembler.h"
+#include "common/source.h"
+#include "jit/compiler.h"
+#include "jit/tiering.h"
+#include "ir/builder.h"
+
+
+/* Every conformance program must behave the same on the interpreter
+ * alone and with the functions the JIT supports running as machine code. */
+class JitTest: public ::testing::Test
+{
+    protected:
+        void SetUp() override {
+        }
+
+        void TearDown() override {
+        }
+
+        // Calls are not inlined so the tests can tell which functions get compiled
+        Pipeline prepare(std::string const& source) {
+            return preparePipeline(source, PipelineStage::Hoist, 0);
+        }
+
+        JitProgram compile(Pipeline& pipeline) {
+            IRModule module = pipeline.buildModule();
+            return JitCompiler(module).compile();
+        }
+
+        void conform(
+            std::string const& source,
+            std::string const& output,
+            int result
+        ) {
+            std::shared_ptr<CleanScope> interpreter_scope = prepare(source).getScope();
+            testing::internal::CaptureStdout();
+            int interpreter_result = Interpreter(interpreter_scope.get()).interpret();
+            EXPECT_EQ(testing::internal::GetCapturedStdout(), output);
+            EXPECT_EQ(interpreter_result, result);
+
+            Pipeline jit_pipeline = prepare(source);
+            std::shared_ptr<CleanScope> jit_scope = jit_pipeline.getScope();
+            JitProgram program = compile(jit_pipeline);
+            program.install();
+            testing::internal::CaptureStdout();
+            int jit_result = Interpreter(jit_scope.get()).interpret();
+            EXPECT_EQ(testing::internal::GetCapturedStdout(), output);
+            EXPECT_EQ(jit_result, result);
+        }
+
+        CleanFunctionDefinition* function(CleanScope* scope, std::string const& name) {
+            return scope->getSymbol<CleanFunctionDefinition>(name).get();
+        }
+
+        SourceManager sources;
+};
+
+TEST_F(JitTest, assemblerTest) {
+    Assembler assembler;
+    Label label = assembler.newLabel();
+    assembler.bind(label);
+    assembler.mov(Register::Rax, Register::Rcx);
+    assembler.load(Register::R8, Register::Rbp, -8);
+    assembler.store(Register::Rsp, 16, Register::Rdx);
+    assembler.mov(Register::R9, static_cast<uint64_t>(1) << 40);
+    assembler.jmp(label);
+
+    std::vector<uint8_t> expected = {
+        0x48, 0x89, 0xC8,
+        0x4C, 0x8B, 0x85, 0xF8, 0xFF, 0xFF, 0xFF,
+        0x48, 0x89, 0x94, 0x24, 0x10, 0x00, 0x00, 0x00,
+        0x49, 0xB9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00,
+        0xE9, 0xDF, 0xFF, 0xFF, 0xFF
+    };
+    EXPECT_EQ(assembler.finish(), expected);
+}
+
+TEST_F(JitTest, fibonacciTest) {
+    std::string source =
+        "iter_fib : function(n: const int) -> int {\n"
+        "    t1:     int = 1\n"
+        "    t2:     int = 0\n"
+        "    result: int = 0\n"
+        "    for (i: int = 0; i < n; i += 1) {\n"
+        "        t2      = result\n"
+        "        result  = t1\n"
+        "        t1      = t1 + t2\n"
+        "    }\n"
+        "    return result\n"
+        "}\n"
+        "rec_fib : function(n: const int) -> int {\n"
+        "    return n < 2 ? n else rec_fib(n - 1) + rec_fib(n - 2)\n"
+        "}\n"
+        "main : function() -> int {\n"
+        "    println(iter_fib(92))\n"
+        "    println(rec_fib(15))\n"
+        "    return 0\n"
+        "}\n";
+    conform(source, "7540113804746346429\n610\n", 0);
+
+    if (! JitCompiler::isAvailable())
+        return;
+    Pipeline pipeline = prepare(source);
+    std::shared_ptr<CleanScope> scope = pipeline.getScope();
+    JitProgram program = compile(pipeline);
+    EXPECT_EQ(program.size(), 3);
+    EXPECT_NE(program.getFunction(function(scope.get(), "main()")), nullptr);
+}
+
+TEST_F(JitTest, controlFlowTest) {
+    conform(
+        "g: int = 10\n"
+        "count: function(n: int) -> int {\n"
+        "    total: int = 0\n"
+        "    for (i: int = 0; i < n; i += 1) {\n"
+        "        for (j: int = 0; j < n; j += 1) {\n"
+        "            if (j == 2) {\n"
+        "                continue\n"
+        "            }\n"
+        "            total += i * j\n"
+        "        }\n"
+        "    }\n"
+        "    return total\n"
+        "}\n"
+        "sum: function(n: int, acc: int) -> int {\n"
+        "    if (n == 0) {\n"
+        "        return acc\n"
+        "    }\n"
+        "    return sum(n - 1, acc + n)\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    println(count(5))\n"
+        "    println(sum(1000000, 0))\n"
+        "    w: int = 0\n"
+        "    while (true) {\n"
+        "        w += 1\n"
+        "        if (w > g) {\n"
+        "            break\n"
+        "        }\n"
+        "    }\n"
+        "    println(w)\n"
+        "    g = 3\n"
+        "    println(g)\n"
+        "    return g\n"
+        "}\n",
+        "80\n500000500000\n11\n3\n",
+        3
+    );
+}
+
+TEST_F(JitTest, valuesTest) {
+    conform(
+        "divide: function(a: int, b: int, u: uint, v: uint) -> int {\n"
+        "    println(a / b)\n"
+        "    println(a % b)\n"
+        "    println(u / v)\n"
+        "    println(u % v)\n"
+        "    println(u > v)\n"
+        "    println(-a)\n"
+        "    return a\n"
+        "}\n"
+        "compare: function(x: float, y: float) -> bool {\n"
+        "    z: float = x / y\n"
+        "    println(z == z)\n"
+        "    println(z != z)\n"
+        "    println(z < x)\n"
+        "    println(x <= y)\n"
+        "    println(-x * 2.5 + y)\n"
+        "    return ! (x > y) && (x >= y || true)\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    divide(-7, 2, 0:uint - 1:uint, 10:uint)\n"
+        "    println(compare(0.0, 0.0))\n"
+        "    println(compare(3.0, 4.0))\n"
+        "    return 0\n"
+        "}\n",
+        "-3\n-1\n1844674407370955161\n5\ntrue\n7\n"
+        "false\ntrue\nfalse\ntrue\n0.000000\ntrue\n"
+        "true\nfalse\ntrue\ntrue\n-3.500000\ntrue\n",
+        0
+    );
+}
+
+TEST_F(JitTest, shortCircuitTest) {
+    // The right operand of a logical operator only runs when it decides the result
+    conform(
+        "side: function(n: int) -> bool {\n"
+        "    println(n)\n"
+        "    return n > 2\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    d: int = 0\n"
+        "    if (d != 0 && 10 / d > 1) {\n"
+        "        println(0)\n"
+        "    }\n"
+        "    if (d == 0 || 10 / d > 1) {\n"
+        "        println(1)\n"
+        "    }\n"
+        "    a: bool = false && side(2)\n"
+        "    b: bool = true || side(3)\n"
+        "    c: bool = side(4) && side(5)\n"
+        "    println(a || b)\n"
+        "    println(c)\n"
+        "    return 0\n"
+        "}\n",
+        "1\n4\n5\ntrue\ntrue\n",
+        0
+    );
+}
+
+TEST_F(JitTest, fallbackTest) {
+    std::string source =
+        "square: function(n: int) -> int {\n"
+        "    return n * n\n"
+        "}\n"
+        "greet: function(n: int) -> int {\n"
+        "    s: string = \"hello\"\n"
+        "    println(s)\n"
+        "    return square(n)\n"
+        "}\n"
+        "twice: function(n: int) -> int {\n"
+        "    return greet(n) + greet(n)\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    println(twice(3))\n"
+        "    return 1\n"
+        "}\n";
+    conform(source, "hello\nhello\n18\n", 1);
+
+    if (! JitCompiler::isAvailable())
+        return;
+    Pipeline pipeline = prepare(source);
+    std::shared_ptr<CleanScope> scope = pipeline.getScope();
+    JitProgram program = compile(pipeline);
+    EXPECT_NE(program.getFunction(function(scope.get(), "square(int)")), nullptr);
+    EXPECT_EQ(program.getFunction(function(scope.get(), "greet(int)")), nullptr);
+    EXPECT_EQ(program.getFunction(function(scope.get(), "twice(int)")), nullptr);
+    EXPECT_EQ(program.getFunction(function(scope.get(), "main()")), nullptr);
+}
+
+TEST_F(JitTest, tieringTest) {
+    std::string source =
+        "square: function(n: int) -> int {\n"
+        "    return n * n\n"
+        "}\n"
+        "show: function(n: int) -> int {\n"
+        "    s: string = \"squares\"\n"
+        "    println(s)\n"
+        "    return n\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    total: int = 0\n"
+        "    for (i: int = 0; i < 100; i += 1) {\n"
+        "        total = total + square(i)\n"
+        "    }\n"
+        "    show(total)\n"
+        "    println(total)\n"
+        "    return 0\n"
+        "}\n";
+
+    std::shared_ptr<CleanScope> scope = prepare(source).getScope();
+    IRModule module = IRBuilder(scope.get()).build();
+    JitTiering tiering(module, 10, false);
+    testing::internal::CaptureStdout();
+    int result = Interpreter(scope.get(), &tiering).interpret();
+    EXPECT_EQ(testing::internal::GetCapturedStdout(), "squares\n328350\n");
+    EXPECT_EQ(result, 0);
+
+    // Calls from the interpreted loop keep counting, they run as machine code once hot
+    CleanFunctionDefinition* square = function(scope.get(), "square(int)");
+    EXPECT_EQ(square->invocations, 100);
+    EXPECT_EQ(square->compiled != nullptr, JitCompiler::isAvailable());
+    EXPECT_EQ(function(scope.get(), "show(int)")->compiled, nullptr);
+}
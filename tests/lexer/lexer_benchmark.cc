@@ -0,0 +1,119 @@
+#include <cstdlib>
+#include <cstddef>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <string>
+#include <chrono>
+
+#include "common/token_type.h"
+#include "common/source.h"
+#include "common/token.h"
+#include "lexer/lexer.h"
+
+
+/* Program lexed when no source is given, repeated up to the requested size. */
+static const std::string sample = R"(/* Fibonacci numbers
+ * The first function uses iteration and the second recursion.
+ */
+iter_fib : function(n: const int) -> int {
+    t1:     int = 1
+    t2:     int = 0
+    result: int = 0
+
+    for (i: int = 0; i < n; i += 1) {
+        t2      = result
+        result  = t1
+        t1      = t1 + t2
+    }
+
+    return result
+}
+
+rec_fib : function(n: const int) -> int {
+    return n < 2 ? n else rec_fib(n - 1) + rec_fib(n - 2)
+}
+
+is_even : function(n: const uint) -> bool {
+    if (n % 2u == 0u) {
+        return true
+    } elif (n == 1u) {
+        return false
+    } else {
+        return false
+    }
+}
+
+main : function() -> int {
+    // Since our signed int is 64 bits max,
+    // our limit is Fib of 92.
+    count: int = 0
+    while (count < 10) {
+        if (count == 5)
+            break
+        count += 1
+        continue
+    }
+    println(iter_fib(92))
+    println(rec_fib(25))
+    println(3.1415 * 2.0)
+    println("done")
+    return 0
+}
+)";
+
+/**
+ * Lexes a source many times and reports the throughput in MB/s.
+ *
+ * Usage: lexer_benchmark [source.pro] [megabytes] [rounds]
+ * Without a source, a sample program is repeated up to the given size.
+ */
+int
+main(int argc, char * argv[])
+{
+    std::string source;
+    if (argc > 1 && std::string(argv[1]) != "-") {
+        std::ifstream file(argv[1]);
+        if (! file) {
+            std::fprintf(stderr, "Could not open `%s`.\n", argv[1]);
+            return 1;
+        }
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        source = buffer.str();
+    }
+    else {
+        std::size_t megabytes = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 16;
+        while (source.size() < megabytes * 1024 * 1024)
+            source += sample;
+    }
+    std::size_t rounds = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 5;
+
+    // Keep the best round, the others pay for page faults and frequency scaling
+    double best = 0;
+    std::size_t tokens = 0;
+    for (std::size_t round = 0; round < rounds; ++round) {
+        SourceManager sources;
+        Lexer lexer(source, "benchmark.pro");
+        tokens = 0;
+
+        auto begin = std::chrono::steady_clock::now();
+        while (lexer.lex().type != PROTO_EOF)
+            tokens++;
+        auto end = std::chrono::steady_clock::now();
+
+        double seconds = std::chrono::duration<double>(end - begin).count();
+        double throughput = source.size() / seconds / (1024 * 1024);
+        if (throughput > best)
+            best = throughput;
+    }
+
+    std::printf(
+        "lexed %zu bytes into %zu tokens, best of %zu rounds: %.1f MB/s\n",
+        source.size(),
+        tokens,
+        rounds,
+        best
+    );
+    return 0;
+}
@@ -4,6 +4,7 @@
 #include <vector>
 
 #include "common/token_type.h"
+#include "common/source.h"
 #include "common/token.h"
 #include "lexer/lexer.h"
 
@@ -18,12 +19,13 @@ class LexerTest: public ::testing::Test
         }
 
         std::string source_path = "main.pro";
+        SourceManager sources;
 };
 
 TEST_F(LexerTest, lexBitwiseNot)
 {
     std::string source = "~";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Token token = lexer.lex();
     EXPECT_EQ(token.type, PROTO_BITWISE_NOT);
     EXPECT_EQ(token.getLexeme(), source);
@@ -32,7 +34,7 @@ TEST_F(LexerTest, lexBitwiseNot)
 TEST_F(LexerTest, lexMinus)
 {
     std::string source = "-";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Token token = lexer.lex();
     EXPECT_EQ(token.type, PROTO_MINUS);
     EXPECT_EQ(token.getLexeme(), source);
@@ -41,7 +43,7 @@ TEST_F(LexerTest, lexMinus)
 TEST_F(LexerTest, lexReturnType)
 {
     std::string source = "->";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Token token = lexer.lex();
     EXPECT_EQ(token.type, PROTO_RETURN_TYPE);
     EXPECT_EQ(token.getLexeme(), source);
@@ -50,7 +52,7 @@ TEST_F(LexerTest, lexReturnType)
 TEST_F(LexerTest, lexInteger)
 {
     std::string source = "12";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Token token = lexer.lex();
     EXPECT_EQ(token.type, PROTO_INT);
     EXPECT_EQ(token.getLexeme(), source);
@@ -59,7 +61,7 @@ TEST_F(LexerTest, lexInteger)
 TEST_F(LexerTest, lexFloat)
 {
     std::string source = "12.5";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Token token = lexer.lex();
     EXPECT_EQ(token.type, PROTO_FLOAT);
     EXPECT_EQ(token.getLexeme(), source);
@@ -68,7 +70,7 @@ TEST_F(LexerTest, lexFloat)
 TEST_F(LexerTest, lexString)
 {
     std::string source = "\"Hello World!\"";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Token token = lexer.lex();
     EXPECT_EQ(token.type, PROTO_STRING);
     EXPECT_EQ(token.getLexeme(), std::string("Hello World!"));
@@ -77,16 +79,69 @@ TEST_F(LexerTest, lexString)
 TEST_F(LexerTest, lexKeyword)
 {
     std::string source = "function";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Token token = lexer.lex();
     EXPECT_EQ(token.type, PROTO_FUNCTION);
     EXPECT_EQ(token.getLexeme(), source);
 }
 
+TEST_F(LexerTest, lexAllKeywords)
+{
+    for (Keyword const& keyword: keywords) {
+        std::string source(keyword.lexeme);
+        Lexer lexer(source, source_path);
+        Token token = lexer.lex();
+        EXPECT_EQ(token.type, keyword.type);
+        EXPECT_EQ(token.getLexeme(), source);
+    }
+}
+
+TEST_F(LexerTest, lexKeywordLookalikes)
+{
+    // Identifiers hashing like keywords or sharing their prefix stay identifiers
+    for (std::string source: {"i", "iff", "fi", "elf", "els", "fo", "functions", "returns", "True", "_if"}) {
+        Lexer lexer(source, source_path);
+        Token token = lexer.lex();
+        EXPECT_EQ(token.type, PROTO_IDENTIFIER);
+        EXPECT_EQ(token.getLexeme(), source);
+    }
+}
+
+TEST_F(LexerTest, lexAfterLongComments)
+{
+    // Comments and blanks long enough to be skipped many characters at a time
+    std::string source =
+        "/* A header comment that spans several lines\n"
+        " * and runs well past a few blocks of characters,\n"
+        " * with /* a nested comment */ inside it.\n"
+        " */\n"
+        "first_identifier_that_is_quite_long_indeed                    second\n"
+        "// a single line comment that also runs past a block of characters\n"
+        "third";
+    Lexer lexer(source, source_path);
+
+    Token first = lexer.lex();
+    EXPECT_EQ(first.type, PROTO_IDENTIFIER);
+    EXPECT_EQ(first.getLexeme(), "first_identifier_that_is_quite_long_indeed");
+    EXPECT_EQ(first.line, 5);
+    EXPECT_EQ(first.column, 43);
+
+    Token second = lexer.lex();
+    EXPECT_EQ(second.getLexeme(), "second");
+    EXPECT_EQ(second.line, 5);
+    EXPECT_EQ(second.column, 69);
+
+    EXPECT_EQ(lexer.lex().type, PROTO_NEWLINE);
+
+    Token third = lexer.lex();
+    EXPECT_EQ(third.getLexeme(), "third");
+    EXPECT_EQ(third.line, 7);
+}
+
 TEST_F(LexerTest, lexIdentifier)
 {
     std::string source = "sum";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Token token = lexer.lex();
     EXPECT_EQ(token.type, PROTO_IDENTIFIER);
     EXPECT_EQ(token.getLexeme(), source);
@@ -95,7 +150,7 @@ TEST_F(LexerTest, lexIdentifier)
 TEST_F(LexerTest, lexDeclaration)
 {
     std::string source = "sum: function(a: const int, b: const int) -> int";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     
     std::vector<Token> tokens;
     while (1) {
@@ -158,7 +213,7 @@ TEST_F(LexerTest, lexDeclaration)
 TEST_F(LexerTest, lexIANDtest)
 {
     std::string source = "&=";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Token token = lexer.lex();
     EXPECT_EQ(token.type, PROTO_IAND);
 }
@@ -166,7 +221,7 @@ TEST_F(LexerTest, lexIANDtest)
 TEST_F(LexerTest, lexIRSHIFTTest)
 {
     std::string source = ">>=";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Token token = lexer.lex();
     EXPECT_EQ(token.type, PROTO_IRSHIFT);
 }
@@ -174,7 +229,7 @@ TEST_F(LexerTest, lexIRSHIFTTest)
 TEST_F(LexerTest, lexIDIVTest)
 {
     std::string source = "/=";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Token token = lexer.lex();
     EXPECT_EQ(token.type, PROTO_IDIV);
 }
@@ -182,7 +237,7 @@ TEST_F(LexerTest, lexIDIVTest)
 TEST_F(LexerTest, lexIMULTest)
 {
     std::string source = "*=";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Token token = lexer.lex();
     EXPECT_EQ(token.type, PROTO_IMUL);
 }
@@ -190,7 +245,7 @@ TEST_F(LexerTest, lexIMULTest)
 TEST_F(LexerTest, lexIPOWTest)
 {
     std::string source = "**=";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Token token = lexer.lex();
     EXPECT_EQ(token.type, PROTO_IPOW);
 }
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <string>
+#include <random>
+
+#include "lexer/scanner.h"
+
+
+class ScannerTest: public ::testing::Test
+{
+    protected:
+        void SetUp() override {
+        }
+
+        void TearDown() override {
+        }
+
+        // Sources mixing every class of characters, long enough to span several blocks
+        std::string randomSource(std::mt19937& generator, std::size_t length) {
+            static const std::string alphabet = "abzAZ09_ \t\r\n/*#\x80\xff";
+            std::uniform_int_distribution<std::size_t> pick(0, alphabet.size() - 1);
+            std::uniform_int_distribution<std::size_t> repeat(1, 40);
+
+            std::string source;
+            while (source.size() < length)
+                source.append(repeat(generator), alphabet[pick(generator)]);
+            source.resize(length);
+            return source;
+        }
+};
+
+TEST_F(ScannerTest, levelTest)
+{
+    Scanner scalar(ScanLevel::Scalar);
+    EXPECT_EQ(scalar.getLevel(), ScanLevel::Scalar);
+
+    // Asking for more than the processor supports falls back to what it does
+    Scanner widest(ScanLevel::AVX2);
+    EXPECT_EQ(widest.getLevel(), Scanner::supportedLevel());
+    EXPECT_EQ(Scanner().getLevel(), Scanner::supportedLevel());
+}
+
+TEST_F(ScannerTest, skipTest)
+{
+    Scanner scanner(ScanLevel::Scalar);
+    std::string source = "  \t\r\rident_42 // comment\n/* a\n b\n c */";
+    char const* begin = source.data();
+    char const* end = source.data() + source.size();
+
+    EXPECT_EQ(scanner.skipBlanks(begin, end), 5);
+    EXPECT_EQ(scanner.skipIdentifier(begin + 5, end), 8);
+    EXPECT_EQ(scanner.skipLine(begin + 14, end), 10);
+
+    ScanRun run = scanner.skipCommentBody(begin + 27, end);
+    EXPECT_EQ(run.length, 9);
+    EXPECT_EQ(run.newlines, 2);
+    EXPECT_EQ(run.line_start, 6);
+
+    // Runs stop at the end of the source
+    EXPECT_EQ(scanner.skipLine(begin + 33, end), source.size() - 33);
+}
+
+TEST_F(ScannerTest, levelsAgreeTest)
+{
+    std::mt19937 generator(42);
+    Scanner scalar(ScanLevel::Scalar);
+
+    for (ScanLevel level: {ScanLevel::SSE2, ScanLevel::AVX2}) {
+        Scanner scanner(level);
+        for (std::size_t i = 0; i < 200; ++i) {
+            std::string source = randomSource(generator, i * 7);
+            char const* end = source.data() + source.size();
+
+            for (std::size_t offset = 0; offset < source.size(); offset += 5) {
+                char const* begin = source.data() + offset;
+                EXPECT_EQ(scanner.skipBlanks(begin, end), scalar.skipBlanks(begin, end));
+                EXPECT_EQ(scanner.skipIdentifier(begin, end), scalar.skipIdentifier(begin, end));
+                EXPECT_EQ(scanner.skipLine(begin, end), scalar.skipLine(begin, end));
+
+                ScanRun run = scanner.skipCommentBody(begin, end);
+                ScanRun expected = scalar.skipCommentBody(begin, end);
+                EXPECT_EQ(run.length, expected.length);
+                EXPECT_EQ(run.newlines, expected.newlines);
+                if (expected.newlines) {
+                    EXPECT_EQ(run.line_start, expected.line_start);
+                }
+            }
+        }
+    }
+}
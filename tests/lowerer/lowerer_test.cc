@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+#include "cleaner/ast/expressions/expression.h"
+#include "cleaner/ast/definitions/function.h"
+#include "cleaner/ast/statements/return.h"
+#include "cleaner/ast/statements/block.h"
+#include "tests/support/pipeline.h"
+#include "cleaner/symbols/scope.h"
+#include "lowerer/lowerer.h"
+#include "common/source.h"
+
+
+class LowererTest: public ::testing::Test
+{
+    protected:
+        void SetUp() override {
+        }
+
+        void TearDown() override {
+        }
+
+        std::shared_ptr<CleanScope> clean(std::string const& source) {
+            return preparePipeline(source, PipelineStage::Resolve).getScope();
+        }
+
+        CleanExpression* returned(CleanScope* scope, std::string const& fun_name) {
+            CleanReturnStatement* ret_stmt = static_cast<CleanReturnStatement*>(
+                scope->getSymbol<CleanFunctionDefinition>(fun_name)
+                    ->body->statements.back().get()
+            );
+            return ret_stmt->expression.get();
+        }
+
+        SourceManager sources;
+};
+
+TEST_F(LowererTest, lowerTypedOperationsTest) {
+    std::shared_ptr<CleanScope> scope = clean(
+        "f: function(a: int, b: uint, c: float) -> bool {\n"
+        "    return a + 1 > 2 && b < 3:uint && c * 2.0 == 1.0\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    f(1, 2:uint, 0.5)\n"
+        "    return 0\n"
+        "}\n"
+    );
+    Lowerer(scope.get()).lower();
+
+    // ((a + 1 > 2) && (b < 3)) && (c * 2.0 == 1.0)
+    CleanExpression* expr = returned(scope.get(), "f(int,uint,float)");
+    ASSERT_EQ(expr->type, CleanExpressionType::TernaryIf);
+    CleanTernaryIfExpression* and_expr =
+        static_cast<CleanTernaryIfExpression*>(expr);
+
+    ASSERT_EQ(and_expr->condition->type, CleanExpressionType::TernaryIf);
+    CleanTernaryIfExpression* left_and =
+        static_cast<CleanTernaryIfExpression*>(and_expr->condition.get());
+    CleanOperationExpression* gt_expr =
+        static_cast<CleanOperationExpression*>(left_and->condition.get());
+    EXPECT_EQ(gt_expr->operation, Operation::GtI64);
+    CleanOperationExpression* add_expr =
+        static_cast<CleanOperationExpression*>(gt_expr->operands[0].get());
+    EXPECT_EQ(add_expr->operation, Operation::AddI64);
+    EXPECT_EQ(add_expr->operands.size(), 2);
+    CleanOperationExpression* lt_expr =
+        static_cast<CleanOperationExpression*>(left_and->then_branch.get());
+    EXPECT_EQ(lt_expr->operation, Operation::LtU64);
+    ASSERT_EQ(left_and->else_branch->type, CleanExpressionType::Boolean);
+    EXPECT_FALSE(static_cast<CleanBoolExpression*>(left_and->else_branch.get())->value);
+
+    CleanOperationExpression* eq_expr =
+        static_cast<CleanOperationExpression*>(and_expr->then_branch.get());
+    EXPECT_EQ(eq_expr->operation, Operation::EqF64);
+    CleanOperationExpression* mul_expr =
+        static_cast<CleanOperationExpression*>(eq_expr->operands[0].get());
+    EXPECT_EQ(mul_expr->operation, Operation::MulF64);
+}
+
+TEST_F(LowererTest, lowerLogicalOperatorsTest) {
+    std::shared_ptr<CleanScope> scope = clean(
+        "f: function(a: bool, b: bool) -> bool {\n"
+        "    return a || b\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    f(true, false)\n"
+        "    return 0\n"
+        "}\n"
+    );
+    Lowerer(scope.get()).lower();
+
+    // a ? true else b
+    CleanExpression* expr = returned(scope.get(), "f(bool,bool)");
+    ASSERT_EQ(expr->type, CleanExpressionType::TernaryIf);
+    CleanTernaryIfExpression* or_expr = static_cast<CleanTernaryIfExpression*>(expr);
+    EXPECT_EQ(or_expr->condition->type, CleanExpressionType::Variable);
+    ASSERT_EQ(or_expr->then_branch->type, CleanExpressionType::Boolean);
+    EXPECT_TRUE(static_cast<CleanBoolExpression*>(or_expr->then_branch.get())->value);
+    ASSERT_EQ(or_expr->else_branch->type, CleanExpressionType::Variable);
+    EXPECT_EQ(
+        static_cast<CleanVariableExpression*>(or_expr->else_branch.get())->var_name,
+        "b"
+    );
+}
+
+TEST_F(LowererTest, lowerOverloadedOperatorTest) {
+    std::shared_ptr<CleanScope> scope = clean(
+        "main: function() -> int {\n"
+        "    return 5 - 2\n"
+        "}\n"
+    );
+
+    // A function defined by the program takes precedence over the operation
+    std::shared_ptr<CleanScope> sub_scope = std::make_shared<CleanScope>(scope);
+    std::unique_ptr<CleanFunctionDefinition> sub_def =
+        std::make_unique<CleanFunctionDefinition>("__sub__(int,int)", sub_scope);
+    sub_def->body = std::make_unique<CleanBlockStatement>(sub_scope);
+    scope->addSymbol<CleanFunctionDefinition>("__sub__(int,int)", std::move(sub_def));
+    Lowerer(scope.get()).lower();
+
+    CleanExpression* expr = returned(scope.get(), "main()");
+    ASSERT_EQ(expr->type, CleanExpressionType::Call);
+    EXPECT_EQ(static_cast<CleanCallExpression*>(expr)->fun_name, "__sub__(int,int)");
+}
@@ -23,6 +23,7 @@
 #include "parsetree/statements/for.h"
 #include "parsetree/statements/if.h"
 #include "parser/parser.h"
+#include "common/source.h"
 #include "common/token.h"
 #include "lexer/lexer.h"
 
@@ -37,6 +38,7 @@ class ParserTest: public ::testing::Test
         }
 
         std::string source_path = "main.pro";
+        SourceManager sources;
 };
 
 
@@ -44,7 +46,7 @@ class ParserTest: public ::testing::Test
 TEST_F(ParserTest, parseEmptyProgramTest)
 {
     std::string source = "";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Parser parser(lexer);
 
     EXPECT_THROW({
@@ -63,7 +65,7 @@ TEST_F(ParserTest, parseDefinitionTest)
 {
     // The definition doesn't start with an identifier that names it
     std::string noIdentifierSource = "function";
-    Lexer noIdentifierLexer(std::make_shared<std::string>(noIdentifierSource), source_path);
+    Lexer noIdentifierLexer(noIdentifierSource, source_path);
     Parser noIdentifierparser(noIdentifierLexer);
 
     EXPECT_THROW({
@@ -77,7 +79,7 @@ TEST_F(ParserTest, parseDefinitionTest)
 
     // Missing colon after definition name
     std::string noColonSource = "name";
-    Lexer noColonLexer(std::make_shared<std::string>(noColonSource), source_path);
+    Lexer noColonLexer(noColonSource, source_path);
     Parser noColonparser(noColonLexer);
     EXPECT_THROW({
         try {
@@ -90,7 +92,7 @@ TEST_F(ParserTest, parseDefinitionTest)
 
     // Otherwise, we have a valid definition
     std::string Source = "name: string = \"John Doe\"";
-    Lexer Lexer(std::make_shared<std::string>(Source), source_path);
+    Lexer Lexer(Source, source_path);
     Parser parser(Lexer);
     std::unique_ptr<Definition> def = parser.parseDefinition();
     EXPECT_EQ(def->getType(), DefinitionType::Variable);
@@ -99,7 +101,7 @@ TEST_F(ParserTest, parseDefinitionTest)
 TEST_F(ParserTest, parseVariableDefinitionTest)
 {
     std::string source = "name: string = \"John Doe\"";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Parser parser(lexer);
     std::unique_ptr<Definition> def = parser.parseDefinition();
     EXPECT_EQ(def->getType(), DefinitionType::Variable);
@@ -125,7 +127,7 @@ TEST_F(ParserTest, parseVariableDefinitionTest)
 TEST_F(ParserTest, parseFunctionDefinitionTest)
 {
     std::string source = "sum: function(a: int, b: int) -> int{}";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Parser parser(lexer);
     std::unique_ptr<Definition> def = parser.parseDefinition();
     EXPECT_EQ(def->getType(), DefinitionType::Function);
@@ -152,7 +154,7 @@ TEST_F(ParserTest, parseFunctionDefinitionTest)
 TEST_F(ParserTest, parseSimpleTypeDeclarationTest)
 {
     std::string source = "string";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Parser parser(lexer);
     std::unique_ptr<SimpleTypeDeclaration> type_decl = parser.parseSimpleTypeDeclaration(true);
 
@@ -163,7 +165,7 @@ TEST_F(ParserTest, parseSimpleTypeDeclarationTest)
 TEST_F(ParserTest, parseVariableDeclarationTest)
 {
     std::string source = "count: int";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Parser parser(lexer);
     std::unique_ptr<VariableDeclaration> var_decl = parser.parseVariableDeclaration();
 
@@ -182,7 +184,7 @@ TEST_F(ParserTest, parseVariableDeclarationTest)
 TEST_F(ParserTest, parseBlockStatementTest)
 {
     std::string source = "{\n\n\nstart: int = 0\n\n step: int = 2}";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Parser parser(lexer);
     std::unique_ptr<BlockStatement> block_stmt = parser.parseBlockStatement();
     EXPECT_EQ(block_stmt->getToken().getLexeme(), "{");
@@ -193,7 +195,7 @@ TEST_F(ParserTest, parseIfStatementTest)
 {
     // We only have an if branch
     std::string ifSource = "if(name == \"John Doe\"){IdentifyHim()}";
-    Lexer ifLexer(std::make_shared<std::string>(ifSource), source_path);
+    Lexer ifLexer(ifSource, source_path);
     Parser ifParser(ifLexer);
     std::unique_ptr<IfStatement> if_stmt = ifParser.parseIfStatement();
     EXPECT_EQ(if_stmt->getToken().getLexeme(), "if");
@@ -202,7 +204,7 @@ TEST_F(ParserTest, parseIfStatementTest)
 
     // We add an elif branch
     std::string elifSource = "if(true){} elif(false){}";
-    Lexer elifLexer(std::make_shared<std::string>(elifSource), source_path);
+    Lexer elifLexer(elifSource, source_path);
     Parser elifParser(elifLexer);
     std::unique_ptr<IfStatement> elif_stmt = elifParser.parseIfStatement();
     EXPECT_EQ(elif_stmt->getElifBranches().size(), 1);
@@ -213,7 +215,7 @@ TEST_F(ParserTest, parseIfStatementTest)
 
     // We add the else branch
     std::string elseSource = "if(true){} elif(false){} else{print()}";
-    Lexer elseLexer(std::make_shared<std::string>(elseSource), source_path);
+    Lexer elseLexer(elseSource, source_path);
     Parser elseParser(elseLexer);
     std::unique_ptr<IfStatement> else_stmt = elseParser.parseIfStatement();
     EXPECT_NE(else_stmt->getElseBranch(), nullptr);
@@ -226,7 +228,7 @@ TEST_F(ParserTest, parseForStatementTest)
 {
     // We have a variable definition as init clause
     std::string defSource = "for(i: int = 10; i > 0; i = i - 1){}";
-    Lexer defLexer(std::make_shared<std::string>(defSource), source_path);
+    Lexer defLexer(defSource, source_path);
     Parser defParser(defLexer);
     std::unique_ptr<ForStatement> def_for_stmt = defParser.parseForStatement();
     EXPECT_EQ(def_for_stmt->getToken().getLexeme(), "for");
@@ -243,7 +245,7 @@ TEST_F(ParserTest, parseForStatementTest)
 
    // We have an expression as init clause
     std::string exprSource = "for(i = 10; i > 0; i = i - 1){}";
-    Lexer exprLexer(std::make_shared<std::string>(exprSource), source_path);
+    Lexer exprLexer(exprSource, source_path);
     Parser exprParser(exprLexer);
     std::unique_ptr<ForStatement> expr_for_stmt = exprParser.parseForStatement();
     std::unique_ptr<Definition>& expr_init_clause = expr_for_stmt->getInitClause();
@@ -254,28 +256,28 @@ TEST_F(ParserTest, parseForStatementTest)
 
    // We have no init clause
     std::string noInitSource = "for(; i > 0; i = i - 1){}";
-    Lexer noInitLexer(std::make_shared<std::string>(noInitSource), source_path);
+    Lexer noInitLexer(noInitSource, source_path);
     Parser noInitParser(noInitLexer);
     std::unique_ptr<ForStatement> noInit_for_stmt = noInitParser.parseForStatement();
     EXPECT_EQ(noInit_for_stmt->getInitClause(), nullptr);
 
    // We have no term clause
     std::string noTermSource = "for(i = 10;; i = i - 1){}";
-    Lexer noTermLexer(std::make_shared<std::string>(noTermSource), source_path);
+    Lexer noTermLexer(noTermSource, source_path);
     Parser noTermParser(noTermLexer);
     std::unique_ptr<ForStatement> noTerm_for_stmt = noTermParser.parseForStatement();
     EXPECT_EQ(noTerm_for_stmt->getTermClause(), nullptr);
 
    // We have no incr clause
     std::string noIncrSource = "for(i = 10; i > 0;){}";
-    Lexer noIncrLexer(std::make_shared<std::string>(noIncrSource), source_path);
+    Lexer noIncrLexer(noIncrSource, source_path);
     Parser noIncrParser(noIncrLexer);
     std::unique_ptr<ForStatement> noIncr_for_stmt = noIncrParser.parseForStatement();
     EXPECT_EQ(noIncr_for_stmt->getIncrClause(), nullptr);
 
    // We have no clauses
     std::string noClausesSource = "for(;;){}";
-    Lexer noClausesLexer(std::make_shared<std::string>(noClausesSource), source_path);
+    Lexer noClausesLexer(noClausesSource, source_path);
     Parser noClausesParser(noClausesLexer);
     std::unique_ptr<ForStatement> noClauses_for_stmt = noClausesParser.parseForStatement();
     EXPECT_EQ(noClauses_for_stmt->getInitClause(), nullptr);
@@ -286,7 +288,7 @@ TEST_F(ParserTest, parseForStatementTest)
 TEST_F(ParserTest, parseWhileStatementTest)
 {
     std::string source = "while(true){makeItHappen()}";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Parser parser(lexer);
     std::unique_ptr<WhileStatement> wh_stmt = parser.parseWhileStatement();
     EXPECT_EQ(wh_stmt->getToken().getLexeme(), "while");
@@ -295,7 +297,7 @@ TEST_F(ParserTest, parseWhileStatementTest)
 
     // We miss the opening parenthesis
     std::string noLeftParenSource = "while true){makeItHappen()}";
-    Lexer noLeftParenLexer(std::make_shared<std::string>(noLeftParenSource), source_path);
+    Lexer noLeftParenLexer(noLeftParenSource, source_path);
     Parser noLeftParenParser(noLeftParenLexer);
     EXPECT_THROW({
         try {
@@ -308,7 +310,7 @@ TEST_F(ParserTest, parseWhileStatementTest)
 
     // We miss the closing parenthesis
     std::string noRightParenSource = "while(true{makeItHappen()}";
-    Lexer noRightParenLexer(std::make_shared<std::string>(noRightParenSource), source_path);
+    Lexer noRightParenLexer(noRightParenSource, source_path);
     Parser noRightParenParser(noRightParenLexer);
     EXPECT_THROW({
         try {
@@ -323,7 +325,7 @@ TEST_F(ParserTest, parseWhileStatementTest)
 TEST_F(ParserTest, parseContinueStatementTest)
 {
     std::string source = "continue";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Parser parser(lexer);
     std::unique_ptr<ContinueStatement> cont_stmt = parser.parseContinueStatement();
     EXPECT_EQ(cont_stmt->getToken().getLexeme(), "continue");
@@ -332,7 +334,7 @@ TEST_F(ParserTest, parseContinueStatementTest)
 TEST_F(ParserTest, parseBreakStatementTest)
 {
     std::string source = "break";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Parser parser(lexer);
     std::unique_ptr<BreakStatement> br_stmt = parser.parseBreakStatement();
     EXPECT_EQ(br_stmt->getToken().getLexeme(), "break");
@@ -343,7 +345,7 @@ TEST_F(ParserTest, parseReturnStatementTest)
     // Expression is returned
     {
         std::string source = "return a + b";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<ReturnStatement> ret_stmt = parser.parseReturnStatement();
         EXPECT_EQ(ret_stmt->getToken().getLexeme(), "return");
@@ -353,7 +355,7 @@ TEST_F(ParserTest, parseReturnStatementTest)
     // No expression is returned
     {
         std::string source = "return\n";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<ReturnStatement> ret_stmt = parser.parseReturnStatement();
         EXPECT_EQ(ret_stmt->getToken().getLexeme(), "return");
@@ -366,7 +368,7 @@ TEST_F(ParserTest, parseReturnStatementTest)
 TEST_F(ParserTest, parseExpressionTest)
 {
     std::string source = "2 * 5 + 1";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Parser parser(lexer);
     std::unique_ptr<Expression> expr = parser.parseExpression();
 
@@ -397,7 +399,7 @@ TEST_F(ParserTest, parseAssignmentExpressionTest)
     // Simple assignment
     {
         std::string source = "a = b = 0";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseAssignmentExpression();
 
@@ -415,7 +417,7 @@ TEST_F(ParserTest, parseAssignmentExpressionTest)
     // In-place addition
     {
         std::string source = "i += 1";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseAssignmentExpression();
 
@@ -434,7 +436,7 @@ TEST_F(ParserTest, parseAssignmentExpressionTest)
 TEST_F(ParserTest, parseTernaryIfExpressionTest)
 {
     std::string source = "a == 1 ? \"one\" <> a == 2 ? \"two\" <> \"many\"";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Parser parser(lexer);
     std::unique_ptr<Expression> expr = parser.parseTernaryIfExpression();
 
@@ -452,7 +454,7 @@ TEST_F(ParserTest, parseTernaryIfExpressionTest)
 TEST_F(ParserTest, parseLogicalOrExpressionTest)
 {
     std::string source = "true || false";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Parser parser(lexer);
     std::unique_ptr<Expression> expr = parser.parseLogicalOrExpression();
 
@@ -470,7 +472,7 @@ TEST_F(ParserTest, parseLogicalOrExpressionTest)
 TEST_F(ParserTest, parseLogicalAndExpressionTest)
 {
     std::string source = "true && false";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Parser parser(lexer);
     std::unique_ptr<Expression> expr = parser.parseLogicalAndExpression();
 
@@ -488,7 +490,7 @@ TEST_F(ParserTest, parseLogicalAndExpressionTest)
 TEST_F(ParserTest, parseComparisonExpressionTest)
 {
     std::string source = "counter != 0";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Parser parser(lexer);
     std::unique_ptr<Expression> expr = parser.parseComparisonExpression();
 
@@ -506,7 +508,7 @@ TEST_F(ParserTest, parseComparisonExpressionTest)
 TEST_F(ParserTest, parseBitwiseOrExpressionTest)
 {
     std::string source = "1 | 0";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Parser parser(lexer);
     std::unique_ptr<Expression> expr = parser.parseBitwiseOrExpression();
 
@@ -524,7 +526,7 @@ TEST_F(ParserTest, parseBitwiseOrExpressionTest)
 TEST_F(ParserTest, parseBitwiseXorExpressionTest)
 {
     std::string source = "1 ^ 0";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Parser parser(lexer);
     std::unique_ptr<Expression> expr = parser.parseBitwiseXorExpression();
 
@@ -542,7 +544,7 @@ TEST_F(ParserTest, parseBitwiseXorExpressionTest)
 TEST_F(ParserTest, parseBitwiseAndExpressionTest)
 {
     std::string source = "1 & 0";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Parser parser(lexer);
     std::unique_ptr<Expression> expr = parser.parseBitwiseAndExpression();
 
@@ -560,7 +562,7 @@ TEST_F(ParserTest, parseBitwiseAndExpressionTest)
 TEST_F(ParserTest, parseBitshiftExpressionTest)
 {
     std::string source = "uint << 5";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Parser parser(lexer);
     std::unique_ptr<Expression> expr = parser.parseBitshiftExpression();
 
@@ -578,7 +580,7 @@ TEST_F(ParserTest, parseBitshiftExpressionTest)
 TEST_F(ParserTest, parseTermExpressionTest)
 {
     std::string source = "(2 * counter) + 1";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Parser parser(lexer);
     std::unique_ptr<Expression> expr = parser.parseTermExpression();
 
@@ -596,7 +598,7 @@ TEST_F(ParserTest, parseTermExpressionTest)
 TEST_F(ParserTest, parseFactorExpressionTest)
 {
     std::string source = "2 * counter";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Parser parser(lexer);
     std::unique_ptr<Expression> expr = parser.parseFactorExpression();
 
@@ -616,7 +618,7 @@ TEST_F(ParserTest, parseUnaryExpressionTest)
     // Unary plus
     {
         std::string source = "+10";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseUnaryExpression();
 
@@ -633,7 +635,7 @@ TEST_F(ParserTest, parseUnaryExpressionTest)
     // Unary minus
     {
         std::string source = "-10";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseUnaryExpression();
 
@@ -650,7 +652,7 @@ TEST_F(ParserTest, parseUnaryExpressionTest)
     // Bitwise not
     {
         std::string source = "~~1";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseUnaryExpression();
 
@@ -667,7 +669,7 @@ TEST_F(ParserTest, parseUnaryExpressionTest)
     // Logical not
     {
         std::string source = "!false";
-        Lexer lexer(std::make_shared<std::string>(source), source_path);
+        Lexer lexer(source, source_path);
         Parser parser(lexer);
         std::unique_ptr<Expression> expr = parser.parseUnaryExpression();
 
@@ -685,7 +687,7 @@ TEST_F(ParserTest, parseUnaryExpressionTest)
 TEST_F(ParserTest, parseCastExpressionTest)
 {
     std::string source = "2:int";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Parser parser(lexer);
     std::unique_ptr<Expression> expr = parser.parseCastExpression();
 
@@ -702,7 +704,7 @@ TEST_F(ParserTest, parseCastExpressionTest)
 TEST_F(ParserTest, parsePrimaryExpressionTest)
 {
     std::string source = "name";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Parser parser(lexer);
     std::unique_ptr<Expression> expr = parser.parsePrimaryExpression();
 
@@ -717,7 +719,7 @@ TEST_F(ParserTest, parsePrimaryExpressionTest)
 TEST_F(ParserTest, parseCallExpressionTest)
 {
     std::string source = "sum(1, 2)";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Parser parser(lexer);
     std::unique_ptr<CallExpression> call_expr = parser.parseCallExpression();
     EXPECT_EQ(call_expr->getToken().getLexeme(), "sum");
@@ -727,7 +729,7 @@ TEST_F(ParserTest, parseCallExpressionTest)
 TEST_F(ParserTest, parseGroupExpressionTest)
 {
     std::string source = "(name)";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Parser parser(lexer);
     std::unique_ptr<GroupExpression> group_expr = parser.parseGroupExpression();
     EXPECT_EQ(group_expr->getToken().getLexeme(), "(");
@@ -737,7 +739,7 @@ TEST_F(ParserTest, parseGroupExpressionTest)
 TEST_F(ParserTest, parseVariableExpressionTest)
 {
     std::string source = "name";
-    Lexer lexer(std::make_shared<std::string>(source), source_path);
+    Lexer lexer(source, source_path);
     Parser parser(lexer);
     std::unique_ptr<VariableExpression> var_expr = parser.parseVariableExpression();
     EXPECT_EQ(var_expr->getToken().getLexeme(), "name");
@@ -747,7 +749,7 @@ TEST_F(ParserTest, parseLiteralExpressionTest)
 {
     // Boolean literal
     std::string booleanSource = "false";
-    Lexer booleanLexer(std::make_shared<std::string>(booleanSource), source_path);
+    Lexer booleanLexer(booleanSource, source_path);
     Parser booleanParser(booleanLexer);
     std::unique_ptr<LiteralExpression> boolean_lit = booleanParser.parseLiteralExpression();
     EXPECT_EQ(boolean_lit->getToken().getLexeme(), "false");
@@ -755,7 +757,7 @@ TEST_F(ParserTest, parseLiteralExpressionTest)
 
     // Integer literal
     std::string intSource = "0";
-    Lexer intLexer(std::make_shared<std::string>(intSource), source_path);
+    Lexer intLexer(intSource, source_path);
     Parser intParser(intLexer);
     std::unique_ptr<LiteralExpression> int_lit = intParser.parseLiteralExpression();
     EXPECT_EQ(int_lit->getToken().getLexeme(), "0");
@@ -763,7 +765,7 @@ TEST_F(ParserTest, parseLiteralExpressionTest)
 
     // Float literal
     std::string floatSource = "0.5";
-    Lexer floatLexer(std::make_shared<std::string>(floatSource), source_path);
+    Lexer floatLexer(floatSource, source_path);
     Parser floatParser(floatLexer);
     std::unique_ptr<LiteralExpression> float_lit = floatParser.parseLiteralExpression();
     EXPECT_EQ(float_lit->getToken().getLexeme(), "0.5");
@@ -771,7 +773,7 @@ TEST_F(ParserTest, parseLiteralExpressionTest)
 
     // String literal
     std::string stringSource = "\"string\"";
-    Lexer stringLexer(std::make_shared<std::string>(stringSource), source_path);
+    Lexer stringLexer(stringSource, source_path);
     Parser stringParser(stringLexer);
     std::unique_ptr<LiteralExpression> string_lit = stringParser.parseLiteralExpression();
     EXPECT_EQ(string_lit->getToken().getLexeme(), "string");
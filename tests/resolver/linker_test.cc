@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+#include "cleaner/ast/expressions/expression.h"
+#include "cleaner/ast/definitions/function.h"
+#include "cleaner/ast/statements/return.h"
+#include "cleaner/symbols/scope.h"
+#include "resolver/resolver.h"
+#include "parsetree/program.h"
+#include "resolver/linker.h"
+#include "cleaner/cleaner.h"
+#include "checker/checker.h"
+#include "parser/parser.h"
+#include "common/native.h"
+#include "common/source.h"
+#include "common/value.h"
+#include "lexer/lexer.h"
+
+
+class LinkerTest: public ::testing::Test
+{
+    protected:
+        void SetUp() override {
+        }
+
+        void TearDown() override {
+        }
+
+        std::shared_ptr<CleanScope> clean(std::string const& source) {
+            Lexer lexer(source, source_path);
+            Parser parser(lexer);
+            Program prog = parser.parseProgram();
+            Checker(prog).check();
+            Cleaner cleaner(prog);
+            std::shared_ptr<CleanScope> scope = cleaner.clean();
+            Resolver(scope.get()).resolve();
+            return scope;
+        }
+
+        std::string source_path = "main.pro";
+        SourceManager sources;
+};
+
+TEST_F(LinkerTest, linkTest) {
+    std::shared_ptr<CleanScope> scope = clean(
+        "twelve: function() -> int {\n"
+        "    return 12\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    return twelve()\n"
+        "}\n"
+    );
+    Linker(scope.get()).link();
+
+    std::unique_ptr<CleanFunctionDefinition>& main_def =
+        scope->getSymbol<CleanFunctionDefinition>("main()");
+    CleanReturnStatement* ret_stmt =
+        static_cast<CleanReturnStatement*>(main_def->body->statements[0].get());
+    CleanCallExpression* call_expr =
+        static_cast<CleanCallExpression*>(ret_stmt->expression.get());
+    EXPECT_EQ(
+        call_expr->fun_def,
+        scope->getSymbol<CleanFunctionDefinition>("twelve()").get()
+    );
+}
+
+TEST_F(LinkerTest, linkMissingTest) {
+    // Operators are intrinsics so they are undefined until they are loaded,
+    // their calls fail only when they run
+    std::shared_ptr<CleanScope> scope = clean(
+        "main: function() -> int {\n"
+        "    return 1 + 2\n"
+        "}\n"
+    );
+    Linker(scope.get()).link();
+
+    ASSERT_TRUE(scope->hasSymbol<CleanFunctionDefinition>("__add__(int,int)"));
+    std::unique_ptr<CleanFunctionDefinition>& add_def =
+        scope->getSymbol<CleanFunctionDefinition>("__add__(int,int)");
+    EXPECT_TRUE(add_def->is_intrinsic);
+    EXPECT_FALSE(add_def->is_pure);
+    EXPECT_EQ(add_def->parameters.size(), 2);
+
+    CleanReturnStatement* ret_stmt =
+        static_cast<CleanReturnStatement*>(add_def->body->statements[0].get());
+    CleanIntrinsicExpression* intrinsic_expr =
+        static_cast<CleanIntrinsicExpression*>(ret_stmt->expression.get());
+    Value arguments[2] = {Value((int64_t) 1), Value((int64_t) 2)};
+    EXPECT_DEATH(
+        intrinsic_expr->callable(NativeArguments(arguments, 2)),
+        "has no definition"
+    );
+}
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+#include "cleaner/ast/definitions/function.h"
+#include "tests/support/pipeline.h"
+#include "cleaner/symbols/scope.h"
+#include "common/source.h"
+
+
+class PurityTest: public ::testing::Test
+{
+    protected:
+        void SetUp() override {
+        }
+
+        void TearDown() override {
+        }
+
+        std::shared_ptr<CleanScope> analyze(std::string const& source) {
+            return preparePipeline(source, PipelineStage::Purity).getScope();
+        }
+
+        bool isPure(std::shared_ptr<CleanScope>& scope, std::string const& name) {
+            return scope->getSymbol<CleanFunctionDefinition>(name)->is_pure;
+        }
+
+        SourceManager sources;
+};
+
+TEST_F(PurityTest, analyzeTest) {
+    std::shared_ptr<CleanScope> scope = analyze(
+        "limit: int = 10\n"
+        "counter: int = 0\n"
+        "fib: function(n: int) -> int {\n"
+        "    return n < 2 ? n else fib(n - 1) + fib(n - 2)\n"
+        "}\n"
+        "bounded: function(n: int) -> int {\n"
+        "    return n < limit ? fib(n) else limit\n"
+        "}\n"
+        "tick: function() -> int {\n"
+        "    counter += 1\n"
+        "    return counter\n"
+        "}\n"
+        "peek: function() -> int {\n"
+        "    return counter\n"
+        "}\n"
+        "show: function(n: int) -> int {\n"
+        "    println(n)\n"
+        "    return n\n"
+        "}\n"
+        "twice: function(n: int) -> int {\n"
+        "    return show(n) * 2\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    return bounded(5) + tick() + peek() + twice(1)\n"
+        "}\n"
+    );
+
+    // Recursion and reading globals nobody writes keep a function pure
+    EXPECT_TRUE(isPure(scope, "fib(int)"));
+    EXPECT_TRUE(isPure(scope, "bounded(int)"));
+
+    // Writing globals, reading written globals and printing don't
+    EXPECT_FALSE(isPure(scope, "tick()"));
+    EXPECT_FALSE(isPure(scope, "peek()"));
+    EXPECT_FALSE(isPure(scope, "show(int)"));
+
+    // Neither does calling an impure function
+    EXPECT_FALSE(isPure(scope, "twice(int)"));
+    EXPECT_FALSE(isPure(scope, "main()"));
+}
@@ -0,0 +1,128 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "cleaner/ast/expressions/expression.h"
+#include "cleaner/ast/statements/return.h"
+#include "cleaner/ast/statements/if.h"
+#include "cleaner/symbols/scope.h"
+#include "resolver/resolver.h"
+#include "parsetree/program.h"
+#include "cleaner/cleaner.h"
+#include "checker/checker.h"
+#include "parser/parser.h"
+#include "common/source.h"
+#include "lexer/lexer.h"
+
+
+class ResolverTest: public ::testing::Test
+{
+    protected:
+        void SetUp() override {
+        }
+
+        void TearDown() override {
+        }
+
+        std::shared_ptr<CleanScope> resolve(std::string const& source) {
+            Lexer lexer(source, source_path);
+            Parser parser(lexer);
+            Program prog = parser.parseProgram();
+            Checker(prog).check();
+            Cleaner cleaner(prog);
+            std::shared_ptr<CleanScope> scope = cleaner.clean();
+            Resolver(scope.get()).resolve();
+            return scope;
+        }
+
+        std::string source_path = "main.pro";
+        SourceManager sources;
+};
+
+TEST_F(ResolverTest, resolveSlotsTest) {
+    std::shared_ptr<CleanScope> scope = resolve(
+        "g: int = 7\n"
+        "f: function(a: int, b: int) -> int {\n"
+        "    c: int = a\n"
+        "    if (true) {\n"
+        "        d: int = b\n"
+        "        c = d\n"
+        "    }\n"
+        "    else {\n"
+        "        e: int = g\n"
+        "        c = e\n"
+        "    }\n"
+        "    return c\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    return f(1, 2)\n"
+        "}\n"
+    );
+
+    std::unique_ptr<CleanFunctionDefinition>& fun_def =
+        scope->getSymbol<CleanFunctionDefinition>("f(int,int)");
+
+    // Two parameters, one local and the branches share one slot
+    EXPECT_EQ(fun_def->frame_size, 4);
+
+    // The local is initialized from the first parameter
+    std::vector<std::unique_ptr<CleanStatement>>& statements =
+        fun_def->body->statements;
+    ASSERT_EQ(statements[0]->type, CleanStatementType::Expression);
+    CleanAssignmentExpression* init_expr =
+        static_cast<CleanAssignmentExpression*>(statements[0].get());
+    CleanVariableExpression* c_expr =
+        static_cast<CleanVariableExpression*>(init_expr->lvalue.get());
+    CleanVariableExpression* a_expr =
+        static_cast<CleanVariableExpression*>(init_expr->rvalue.get());
+    EXPECT_EQ(c_expr->depth, 0);
+    EXPECT_EQ(c_expr->slot, 2);
+    EXPECT_EQ(a_expr->depth, 0);
+    EXPECT_EQ(a_expr->slot, 0);
+
+    // Variables in sibling blocks reuse the same slot
+    ASSERT_EQ(statements[1]->type, CleanStatementType::If);
+    CleanIfStatement* if_stmt = static_cast<CleanIfStatement*>(statements[1].get());
+    CleanAssignmentExpression* d_init =
+        static_cast<CleanAssignmentExpression*>(if_stmt->body->statements[0].get());
+    CleanAssignmentExpression* e_init =
+        static_cast<CleanAssignmentExpression*>(
+            if_stmt->else_branch->body->statements[0].get());
+    EXPECT_EQ(static_cast<CleanVariableExpression*>(d_init->lvalue.get())->slot, 3);
+    EXPECT_EQ(static_cast<CleanVariableExpression*>(e_init->lvalue.get())->slot, 3);
+
+    // Globals are found one frame up
+    CleanVariableExpression* g_expr =
+        static_cast<CleanVariableExpression*>(e_init->rvalue.get());
+    EXPECT_EQ(g_expr->depth, 1);
+    EXPECT_EQ(g_expr->slot, 0);
+}
+
+TEST_F(ResolverTest, resolveIntroducedDefinitionTest) {
+    std::shared_ptr<CleanScope> scope = resolve(
+        "main: function() -> int {\n"
+        "    x = 5\n"
+        "    return x\n"
+        "}\n"
+    );
+
+    std::unique_ptr<CleanFunctionDefinition>& main_fun =
+        scope->getSymbol<CleanFunctionDefinition>("main()");
+    EXPECT_EQ(main_fun->frame_size, 1);
+
+    // The assignment that introduced the variable now carries its initializer
+    CleanAssignmentExpression* assign_expr =
+        static_cast<CleanAssignmentExpression*>(main_fun->body->statements[0].get());
+    ASSERT_EQ(assign_expr->rvalue->type, CleanExpressionType::SignedInt);
+    CleanSignedIntExpression* int_expr =
+        static_cast<CleanSignedIntExpression*>(assign_expr->rvalue.get());
+    EXPECT_EQ(int_expr->value, (int64_t) 5);
+
+    CleanReturnStatement* ret_stmt =
+        static_cast<CleanReturnStatement*>(main_fun->body->statements[1].get());
+    CleanVariableExpression* var_expr =
+        static_cast<CleanVariableExpression*>(ret_stmt->expression.get());
+    EXPECT_EQ(var_expr->depth, 0);
+    EXPECT_EQ(var_expr->slot, 0);
+}
@@ -0,0 +1,36 @@
+#ifndef PROTO_TESTS_SUPPORT_PIPELINE_H
+#define PROTO_TESTS_SUPPORT_PIPELINE_H
+
+#include <cstddef>
+#include <string>
+
+#include "pipeline/pipeline.h"
+#include "parsetree/program.h"
+#include "cleaner/cleaner.h"
+#include "checker/checker.h"
+#include "parser/parser.h"
+#include "lexer/lexer.h"
+
+
+/**
+ * Cleans the given source then runs the passes the compiler
+ * runs on it, up to the given one included.
+ */
+inline Pipeline
+preparePipeline(
+    std::string const& source,
+    enum PipelineStage last,
+    std::size_t inline_threshold = Pipeline::default_inline_threshold
+)
+{
+    Lexer lexer(source, "main.pro");
+    Parser parser(lexer);
+    Program program = parser.parseProgram();
+    Checker(program).check();
+    Cleaner cleaner(program);
+    Pipeline pipeline(cleaner.clean(), inline_threshold);
+    pipeline.runUntil(last);
+    return pipeline;
+}
+
+#endif
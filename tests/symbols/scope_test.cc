@@ -6,6 +6,7 @@
 #include "parsetree/definitions/definition.h"
 #include "symbols/scope.h"
 #include "parser/parser.h"
+#include "common/source.h"
 #include "lexer/lexer.h"
 
 
@@ -19,7 +20,7 @@ class ScopeTest: public ::testing::Test
             {
                 std::string source = "count: bool = true";
                 std::string source_path = "main.pro";
-                Lexer lexer(std::make_shared<std::string>(source), source_path);
+                Lexer lexer(source, source_path);
                 Parser parser(lexer);
                 var_bool = parser.parseDefinition();
                 parent_scope->addDefinition("var_bool", var_bool);
@@ -28,7 +29,7 @@ class ScopeTest: public ::testing::Test
             {
                 std::string source = "count: uint = 0";
                 std::string source_path = "main.pro";
-                Lexer lexer(std::make_shared<std::string>(source), source_path);
+                Lexer lexer(source, source_path);
                 Parser parser(lexer);
                 var_uint = parser.parseDefinition();
                 child_scope->addDefinition("var_uint", var_uint);
@@ -43,6 +44,7 @@ class ScopeTest: public ::testing::Test
 
         std::unique_ptr<Definition> var_bool = nullptr;
         std::unique_ptr<Definition> var_uint = nullptr;
+        SourceManager sources;
 };
 
 TEST_F(ScopeTest, getDefinitionTest)
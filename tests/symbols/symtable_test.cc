@@ -7,6 +7,7 @@
 #include "parsetree/definitions/definition.h"
 #include "symbols/symtable.h"
 #include "parser/parser.h"
+#include "common/source.h"
 #include "lexer/lexer.h"
 
 
@@ -16,7 +17,7 @@ class SymtableTest: public ::testing::Test
         void SetUp() override {
             std::string source = "count: bool = true";
             std::string source_path = "main.pro";
-            Lexer lexer(std::make_shared<std::string>(source), source_path);
+            Lexer lexer(source, source_path);
             Parser parser(lexer);
             var = parser.parseDefinition();
         }
@@ -28,6 +29,7 @@ class SymtableTest: public ::testing::Test
         Symtable symtable;
         std::unique_ptr<Definition> var = nullptr;
         std::unique_ptr<Definition> nil = nullptr;
+        SourceManager sources;
 };
 
 TEST_F(SymtableTest, addGetDefinitionsTest)
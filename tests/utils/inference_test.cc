@@ -17,5 +17,5 @@ TEST(createSimpleTypeDeclaration, createSimpleTypeDeclarationTest)
     EXPECT_EQ(type_decl->isConst(), true);
     EXPECT_EQ(type_decl->getToken().type, PROTO_IDENTIFIER);
     EXPECT_EQ(type_decl->getToken().getLexeme(), "bool");
-    EXPECT_EQ(type_decl->getToken().source_path, "__builtin__");
+    EXPECT_EQ(type_decl->getToken().getSourcePath(), "__builtin__");
 }
@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <map>
+
+#include "cleaner/ast/expressions/expression.h"
+#include "cleaner/ast/definitions/function.h"
+#include "cleaner/ast/statements/return.h"
+#include "cleaner/ast/statements/block.h"
+#include "utils/intrinsics.h"
+#include "common/native.h"
+#include "common/value.h"
+
+
+TEST(intrinsicGenerator, intrinsicGeneratorTest)
+{
+    std::map<std::string, std::string> params{
+        {"__param1__", "int"},
+        {"__param2__", "int"}
+    };
+    std::unique_ptr<CleanFunctionDefinition> fun_def = intrinsicGenerator(
+        "__sub__(int,int)",
+        params,
+        "int",
+        [](NativeArguments args)->Value {
+            return Value(args[0].as_int - args[1].as_int);
+        }
+    );
+    EXPECT_EQ(fun_def->is_intrinsic, true);
+    EXPECT_EQ(fun_def->parameters.size(), (std::size_t) 2);
+    EXPECT_EQ(fun_def->frame_size, (std::size_t) 2);
+
+    // The native function reads its arguments from the span in order
+    CleanReturnStatement* ret_stmt = static_cast<CleanReturnStatement*>(
+        fun_def->body->statements[0].get()
+    );
+    CleanIntrinsicExpression* intr_expr =
+        static_cast<CleanIntrinsicExpression*>(ret_stmt->expression.get());
+    EXPECT_EQ(intr_expr->arity, (std::size_t) 2);
+
+    Value args[2] = { Value((int64_t) 7), Value((int64_t) 3) };
+    Value result = intr_expr->callable(NativeArguments(args, 2));
+    EXPECT_EQ(result.type, ValueType::SignedInt);
+    EXPECT_EQ(result.as_int, (int64_t) 4);
+}
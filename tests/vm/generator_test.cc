@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+#include "tests/support/pipeline.h"
+#include "common/source.h"
+#include "vm/generator.h"
+#include "vm/bytecode.h"
+#include "ir/ir.h"
+
+
+class BytecodeGeneratorTest: public ::testing::Test
+{
+    protected:
+        void SetUp() override {
+        }
+
+        void TearDown() override {
+        }
+
+        // Calls are not inlined so every function keeps its own code
+        Bytecode generate(std::string const& source) {
+            Pipeline pipeline = preparePipeline(source, PipelineStage::Hoist, 0);
+            IRModule module = pipeline.buildModule();
+            return BytecodeGenerator(module).generate();
+        }
+
+        SourceManager sources;
+};
+
+TEST_F(BytecodeGeneratorTest, generateFunctionTest) {
+    Bytecode bytecode = generate(
+        "g: int = 7\n"
+        "add: function(a: int, b: int) -> int {\n"
+        "    c: int = a + b\n"
+        "    return c\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    println(add(g, 2))\n"
+        "    return 0\n"
+        "}\n"
+    );
+
+    ASSERT_EQ(bytecode.functions.size(), (std::size_t) 2);
+    EXPECT_EQ(bytecode.globals[0].as_int, (int64_t) 7);
+    EXPECT_EQ(bytecode.functions[bytecode.main_index].name, "main()");
+
+    // The sum is computed in the register of its value and returned from there
+    BytecodeFunction& add = bytecode.functions[0];
+    EXPECT_EQ(add.name, "add(int,int)");
+    EXPECT_EQ(add.param_count, (std::size_t) 2);
+    ASSERT_EQ(add.code.size(), (std::size_t) 2);
+    EXPECT_EQ(add.code[0].op, OpCode::AddI64);
+    EXPECT_EQ(add.code[1].op, OpCode::Return);
+    EXPECT_EQ(add.code[1].a, add.code[0].a);
+
+    // Arguments are written into consecutive registers above the caller's values
+    BytecodeFunction& main = bytecode.functions[bytecode.main_index];
+    ASSERT_GE(main.code.size(), (std::size_t) 4);
+    EXPECT_EQ(main.code[0].op, OpCode::LoadGlobal);
+    EXPECT_EQ(main.code[1].op, OpCode::LoadConst);
+    EXPECT_EQ(main.code[1].a, main.code[0].a + 1);
+    EXPECT_EQ(main.code[2].op, OpCode::Call);
+    EXPECT_EQ(main.code[2].b, 0);
+    EXPECT_EQ(main.code[2].c, main.code[0].a);
+    EXPECT_EQ(main.code[3].op, OpCode::CallNative);
+    EXPECT_EQ(bytecode.natives.size(), (std::size_t) 1);
+}
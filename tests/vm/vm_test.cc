@@ -0,0 +1,300 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+#include "cleaner/ast/definitions/function.h"
+#include "interpreter/interpreter.h"
+#include "tests/support/pipeline.h"
+#include "cleaner/symbols/scope.h"
+#include "common/source.h"
+#include "vm/generator.h"
+#include "common/memo.h"
+#include "vm/vm.h"
+
+
+/* Every conformance program must behave the same on the interpreter
+ * and on bytecode generated from the IR. */
+class VMTest: public ::testing::Test
+{
+    protected:
+        void SetUp() override {
+        }
+
+        void TearDown() override {
+        }
+
+        std::shared_ptr<CleanScope> prepare(std::string const& source) {
+            return preparePipeline(source, PipelineStage::Hoist).getScope();
+        }
+
+        void conform(
+            std::string const& source,
+            std::string const& output,
+            int result
+        ) {
+            std::shared_ptr<CleanScope> interpreter_scope = prepare(source);
+            testing::internal::CaptureStdout();
+            int interpreter_result = Interpreter(interpreter_scope.get()).interpret();
+            EXPECT_EQ(testing::internal::GetCapturedStdout(), output);
+            EXPECT_EQ(interpreter_result, result);
+
+            Pipeline ir_pipeline = preparePipeline(source, PipelineStage::Hoist);
+            IRModule module = ir_pipeline.buildModule();
+            Bytecode generated = BytecodeGenerator(module).generate();
+            testing::internal::CaptureStdout();
+            int generated_result = VM(generated).run();
+            EXPECT_EQ(testing::internal::GetCapturedStdout(), output);
+            EXPECT_EQ(generated_result, result);
+        }
+
+        SourceManager sources;
+};
+
+TEST_F(VMTest, fibonacciTest) {
+    conform(
+        "iter_fib : function(n: const int) -> int {\n"
+        "    t1:     int = 1\n"
+        "    t2:     int = 0\n"
+        "    result: int = 0\n"
+        "    for (i: int = 0; i < n; i += 1) {\n"
+        "        t2      = result\n"
+        "        result  = t1\n"
+        "        t1      = t1 + t2\n"
+        "    }\n"
+        "    return result\n"
+        "}\n"
+        "rec_fib : function(n: const int) -> int {\n"
+        "    return n < 2 ? n else rec_fib(n - 1) + rec_fib(n - 2)\n"
+        "}\n"
+        "main : function() -> int {\n"
+        "    println(iter_fib(92))\n"
+        "    println(rec_fib(15))\n"
+        "    return 0\n"
+        "}\n",
+        "7540113804746346429\n610\n",
+        0
+    );
+}
+
+TEST_F(VMTest, controlFlowTest) {
+    conform(
+        "g: int = 10\n"
+        "count: function(n: int) -> int {\n"
+        "    total: int = 0\n"
+        "    for (i: int = 0; i < n; i += 1) {\n"
+        "        for (j: int = 0; j < n; j += 1) {\n"
+        "            if (j == 2) {\n"
+        "                continue\n"
+        "            }\n"
+        "            k: int = i * j\n"
+        "            total += k\n"
+        "        }\n"
+        "    }\n"
+        "    return total\n"
+        "}\n"
+        "classify: function(n: int) -> int {\n"
+        "    if (n < 0) {\n"
+        "        return -1\n"
+        "    } elif (n == 0) {\n"
+        "        return 0\n"
+        "    } else {\n"
+        "        return 1\n"
+        "    }\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    println(count(5))\n"
+        "    println(classify(-3))\n"
+        "    println(classify(0))\n"
+        "    println(classify(8))\n"
+        "    w: int = 0\n"
+        "    while (true) {\n"
+        "        w += 1\n"
+        "        if (w > g) {\n"
+        "            break\n"
+        "        }\n"
+        "    }\n"
+        "    println(w)\n"
+        "    g = 3\n"
+        "    println(g)\n"
+        "    return g\n"
+        "}\n",
+        "80\n-1\n0\n1\n11\n3\n",
+        3
+    );
+}
+
+TEST_F(VMTest, recursionTest) {
+    conform(
+        "fact: function(n: int) -> int {\n"
+        "    acc: int = 1\n"
+        "    if (n > 1) {\n"
+        "        acc = n * fact(n - 1)\n"
+        "    }\n"
+        "    return acc\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    println(fact(10))\n"
+        "    return 0\n"
+        "}\n",
+        "3628800\n",
+        0
+    );
+}
+
+TEST_F(VMTest, valuesTest) {
+    conform(
+        "main: function() -> int {\n"
+        "    s: string = \"done\"\n"
+        "    println(s)\n"
+        "    u: uint = 7:uint\n"
+        "    println(u * 6:uint)\n"
+        "    println(-5 / 2)\n"
+        "    println(17 % 5)\n"
+        "    println(3 < 4)\n"
+        "    return 0\n"
+        "}\n",
+        "done\n42\n-2\n2\ntrue\n",
+        0
+    );
+}
+
+TEST_F(VMTest, operationsTest) {
+    conform(
+        "main: function() -> int {\n"
+        "    f: float = 1.5\n"
+        "    println(f * 2.0)\n"
+        "    println(f < 2.0)\n"
+        "    println(-f)\n"
+        "    println(true && false)\n"
+        "    println(! false)\n"
+        "    u: uint = 10:uint\n"
+        "    println(u / 4:uint)\n"
+        "    println(u > 3:uint)\n"
+        "    i: int = 7\n"
+        "    i = i + (i = 1)\n"
+        "    println(i)\n"
+        "    println(~i)\n"
+        "    return 0\n"
+        "}\n",
+        "3.000000\ntrue\n-1.500000\nfalse\ntrue\n2\ntrue\n8\n-9\n",
+        0
+    );
+}
+
+TEST_F(VMTest, shortCircuitTest) {
+    // The right operand of a logical operator only runs when it decides the result
+    conform(
+        "side: function(n: int) -> bool {\n"
+        "    println(n)\n"
+        "    return n > 2\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    d: int = 0\n"
+        "    if (d != 0 && 10 / d > 1) {\n"
+        "        println(0)\n"
+        "    }\n"
+        "    if (d == 0 || 10 / d > 1) {\n"
+        "        println(1)\n"
+        "    }\n"
+        "    a: bool = false && side(2)\n"
+        "    b: bool = true || side(3)\n"
+        "    c: bool = side(4) && side(5)\n"
+        "    println(a || b)\n"
+        "    println(c)\n"
+        "    return 0\n"
+        "}\n",
+        "1\n4\n5\ntrue\ntrue\n",
+        0
+    );
+}
+
+TEST_F(VMTest, undefinedCallTest) {
+    // Strings have no ordering yet, the call only fails if it runs
+    conform(
+        "check: function(n: int) -> int {\n"
+        "    if (n > 100) {\n"
+        "        println(\"a\" < \"b\")\n"
+        "    }\n"
+        "    return n == 0 ? 0 else (check(n - 1))\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    println(55)\n"
+        "    return check(3)\n"
+        "}\n",
+        "55\n",
+        0
+    );
+}
+
+TEST_F(VMTest, tailCallTest) {
+    // Tail calls reuse the frame, so deep tail recursion runs in constant stack
+    conform(
+        "widen: function(a: int, b: int, c: int) -> int {\n"
+        "    return a + b + c\n"
+        "}\n"
+        "sum: function(n: int, acc: int) -> int {\n"
+        "    if (n == 0) {\n"
+        "        return acc\n"
+        "    }\n"
+        "    return sum(n - 1, acc + n)\n"
+        "}\n"
+        "count: function(n: int) -> int {\n"
+        "    return n == 0 ? widen(1, 2, 3) else (count(n - 1))\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    println(sum(1000000, 0))\n"
+        "    println(count(1000000))\n"
+        "    return 0\n"
+        "}\n",
+        "500000500000\n6\n",
+        0
+    );
+}
+
+TEST_F(VMTest, swapTest) {
+    // Loop variables exchanged every iteration are copied all at once
+    conform(
+        "main: function() -> int {\n"
+        "    a: int = 1\n"
+        "    b: int = 2\n"
+        "    c: int = 3\n"
+        "    for (i: int = 0; i < 5; i += 1) {\n"
+        "        t: int = a\n"
+        "        a = b\n"
+        "        b = c\n"
+        "        c = t\n"
+        "        println(a * 100 + b * 10 + c)\n"
+        "    }\n"
+        "    return a\n"
+        "}\n",
+        "231\n312\n123\n231\n312\n",
+        3
+    );
+}
+
+TEST_F(VMTest, memoizeTest) {
+    Pipeline pipeline = preparePipeline(
+        "fib: function(n: int) -> int {\n"
+        "    return n < 2 ? n else fib(n - 1) + fib(n - 2)\n"
+        "}\n"
+        "main: function() -> int {\n"
+        "    println(fib(80))\n"
+        "    return 0\n"
+        "}\n",
+        PipelineStage::Hoist
+    );
+    std::unique_ptr<CleanFunctionDefinition>& fib =
+        pipeline.getScope()->getSymbol<CleanFunctionDefinition>("fib(int)");
+    ASSERT_TRUE(fib->is_pure);
+    fib->memo = std::make_unique<MemoTable>(1, 128);
+
+    IRModule module = pipeline.buildModule();
+    Bytecode bytecode = BytecodeGenerator(module).generate();
+    testing::internal::CaptureStdout();
+    EXPECT_EQ(VM(bytecode).run(), 0);
+    EXPECT_EQ(testing::internal::GetCapturedStdout(), "23416728348467685\n");
+
+    // Every argument misses once and is found on its second use
+    EXPECT_EQ(fib->memo->getMisses(), (std::size_t) 81);
+    EXPECT_EQ(fib->memo->getHits(), (std::size_t) 78);
+}